@@ -0,0 +1,49 @@
+#ifndef AABB_H
+#define AABB_H
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/*
+   The AABB class is used to represent axis-aligned bounding boxes in 3 dimensions.
+
+   An AABB is described by its minimum and maximum corners:
+
+              +--------* max
+             /|       /|
+            / |      / |
+           +--------+  |
+           |  +-----|--+
+           | /      | /
+           |/       |/
+       min *--------+
+
+   A default constructed AABB is empty, which means that its minimum corner is larger than its maximum corner.
+   Expanding an empty AABB with a point results in a degenerate AABB that only contains that point.
+*/
+
+struct AABB
+{
+   AABB();
+   AABB(const glm::vec3& minCorner, const glm::vec3& maxCorner);
+
+   bool      IsEmpty() const;
+
+   void      Expand(const glm::vec3& point);
+   void      Expand(const AABB& aabb);
+
+   glm::vec3 GetCenter() const;
+   glm::vec3 GetExtents() const;
+
+   glm::vec3 min;
+   glm::vec3 max;
+};
+
+AABB TransformAABB(const glm::mat4& transform, const AABB& aabb);
+
+AABB CalculateSkinnedAABB(const std::vector<AABB>& jointBounds, const std::vector<glm::mat4>& skinMatrices);
+
+float CalculateDistanceToAABB(const glm::vec3& point, const AABB& aabb);
+
+#endif
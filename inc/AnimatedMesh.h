@@ -1,10 +1,13 @@
 #ifndef ANIMATED_MESH_H
 #define ANIMATED_MESH_H
 
-#include <array>
+#include <vector>
 
 #include "Skeleton.h"
 #include "Pose.h"
+#include "AABB.h"
+#include "MorphTarget.h"
+#include "Clip.h"
 
 class AnimatedMesh
 {
@@ -19,6 +22,8 @@ public:
    AnimatedMesh(AnimatedMesh&& rhs) noexcept;
    AnimatedMesh& operator=(AnimatedMesh&& rhs) noexcept;
 
+   // These functions give access to the arrays of the mesh itself, which are filled in when it's loaded
+   // A mesh that shares the data of another mesh (see ShareMeshData) leaves them empty, so its shape must be read through the const functions below
    std::vector<glm::vec3>&    GetPositions()  { return mPositions;  }
    std::vector<glm::vec3>&    GetNormals()    { return mNormals;    }
    std::vector<glm::vec2>&    GetTexCoords()  { return mTexCoords;  }
@@ -26,7 +31,32 @@ public:
    std::vector<glm::ivec4>&   GetInfluences() { return mInfluences; }
    std::vector<unsigned int>& GetIndices()    { return mIndices;    }
 
+   // The indices of the LODs that are coarser than the original mesh and the errors that they introduce (see MeshSimplifier.h)
+   // LOD 0 is always the original mesh, so the LOD with index i is stored in mLODIndices[i - 1]
+   std::vector<std::vector<unsigned int>>& GetLODIndices() { return mLODIndices; }
+   std::vector<float>&                     GetLODErrors()  { return mLODErrors;  }
+
+   const std::vector<float>&  GetLODErrors() const    { return GetMeshData().mLODErrors; }
+   unsigned int               GetNumberOfLODs() const { return static_cast<unsigned int>(GetMeshData().mLODIndices.size()) + 1; }
+
+   // The morph targets of the mesh, the default weights of those morph targets and the index of the glTF node that the mesh belongs to
+   // The node index is used to find the tracks that animate the weights of the morph targets in a clip
+   std::vector<MorphTarget>&  GetMorphTargets()        { return mMorphTargets;        }
+   std::vector<float>&        GetDefaultMorphWeights() { return mDefaultMorphWeights; }
+   const std::vector<float>&  GetDefaultMorphWeights() const  { return GetMeshData().mDefaultMorphWeights; }
+   unsigned int               GetNumberOfMorphTargets() const { return static_cast<unsigned int>(GetMeshData().mMorphTargets.size()); }
+   unsigned int               GetNodeIndex() const            { return GetMeshData().mNodeIndex; }
+   void                       SetNodeIndex(unsigned int nodeIndex) { mNodeIndex = nodeIndex; }
+
+   const AABB&                GetBounds() const      { return GetMeshData().mBounds;      }
+   const std::vector<AABB>&   GetJointBounds() const { return GetMeshData().mJointBounds; }
+
+   void                       ShareMeshData(const AnimatedMesh& source);
+   void                       CalculateBounds();
+
    void                       LoadBuffers();
+   void                       LoadDynamicBuffer();
+   void                       LoadStaticBuffer() const;
 
    void                       ConfigureVAO(int posAttribLocation,
                                            int normalAttribLocation,
@@ -40,19 +70,32 @@ public:
                                              int weightsAttribLocation,
                                              int influencesAttribLocation);
 
-   void                       BindFloatAttribute(int attribLocation, unsigned int VBO, int numComponents);
-   void                       BindIntAttribute(int attribLocation, unsigned int VBO, int numComponents);
+   void                       BindFloatAttribute(int attribLocation, unsigned int VBO, int numComponents, int stride, unsigned int offset);
+   void                       BindIntAttribute(int attribLocation, unsigned int VBO, int numComponents, int stride, unsigned int offset);
    void                       UnbindAttribute(int attribLocation, unsigned int VBO);
 
    void                       Render();
+   void                       RenderLOD(unsigned int lodIndex);
    void                       RenderInstanced(unsigned int numInstances);
 
+   void                       ApplyMorphTargets(const std::vector<float>& morphWeights);
+   void                       LoadMorphedVerticesIntoDynamicBuffer();
+   void                       ApplyMorphTargetsOfClip(const FastClip& clip, float time, bool uploadToDynamicBuffer);
+
    void                       SkinMeshOnTheCPUUsingMatrices(Skeleton& skeleton, Pose& animatedPose);
    void                       SkinMeshOnTheCPUUsingTransforms(Skeleton& skeleton, Pose& animatedPose);
    void                       SkinMeshOnTheCPU(std::vector<glm::mat4>& skinMatrices);
 
 private:
 
+   // The mesh whose vertices, indices, static buffer and index buffer are used by this one, which is the mesh itself if it doesn't share them
+   const AnimatedMesh&         GetMeshData() const { return (mSharedMesh != nullptr) ? *mSharedMesh : *this; }
+
+   void                        LoadSharedBuffers() const;
+   void                        LoadIndexBuffer() const;
+
+   const AnimatedMesh*         mSharedMesh;
+
    std::vector<glm::vec3>      mPositions;
    std::vector<glm::vec3>      mNormals;
    std::vector<glm::vec2>      mTexCoords;
@@ -60,22 +103,60 @@ private:
    std::vector<glm::ivec4>     mInfluences;
    std::vector<unsigned int>   mIndices;
 
-   enum VBOTypes : unsigned int
+   std::vector<std::vector<unsigned int>> mLODIndices;
+   std::vector<float>                     mLODErrors;
+
+   std::vector<MorphTarget>    mMorphTargets;
+   std::vector<float>          mDefaultMorphWeights;
+   unsigned int                mNodeIndex;
+
+   // The bounds of the mesh in the bind pose and the bounds of the vertices that are influenced by each joint in the bind pose
+   AABB                        mBounds;
+   std::vector<AABB>           mJointBounds;
+
+   // The attributes of the vertices are split into two interleaved buffers:
+   // - The dynamic buffer contains the positions and normals, which are overwritten every frame when skinning on the CPU
+   // - The static buffer contains the texture coordinates, weights and influences, which never change after loading
+   // That way skinning on the CPU only needs to upload one buffer, and the meshes that share the data of another mesh can share its static buffer
+
+   struct DynamicVertex
    {
-      positions  = 0,
-      normals    = 1,
-      texCoords  = 2,
-      weights    = 3,
-      influences = 4
+      glm::vec3 position;
+      glm::vec3 normal;
+   };
+
+   struct StaticVertex
+   {
+      glm::vec2  texCoord;
+      glm::vec4  weights;
+      glm::ivec4 influences;
    };
 
    unsigned int                mNumIndices; // TODO: Unused and never initialized for now
    unsigned int                mVAO;
-   std::array<unsigned int, 5> mVBOs;
-   unsigned int                mEBO;
-
-   std::vector<glm::vec3>      mSkinnedPositions;
-   std::vector<glm::vec3>      mSkinnedNormals;
+   unsigned int                mDynamicVBO;
+
+   // The static buffer and the index buffer belong to the mesh that owns the data, and they are loaded the first time that it or a mesh that shares it is loaded
+   // That's why they can be modified through a const mesh, which is how the meshes of a CharacterAsset are shared
+   // Like every other OpenGL object, they are only touched by the main thread
+   // All the LODs are stored one after the other in the same index buffer, so we need to remember where each one starts
+   mutable unsigned int              mStaticVBO;
+   mutable unsigned int              mEBO;
+   mutable bool                      mUse16BitIndices;
+   mutable std::vector<unsigned int> mLODFirstIndices;
+
+   std::vector<DynamicVertex>  mSkinnedVertices;
+
+   // The positions and normals of the bind pose with the active morph targets applied
+   // Each vector has one extra element at the end, since the SIMD code that adds the deltas reads and writes one float past the last vertex
+   // mDisplacedVertices stores the indices of the vertices that were displaced the last time the morph targets were applied,
+   // which are the only ones that need to be restored before applying them again
+   std::vector<glm::vec3>      mMorphedPositions;
+   std::vector<glm::vec3>      mMorphedNormals;
+   std::vector<unsigned int>   mDisplacedVertices;
+   std::vector<float>          mMorphWeights;
+   unsigned int                mFirstDirtyMorphedVertex;
+   unsigned int                mLastDirtyMorphedVertex;
    std::vector<glm::mat4>      mAnimatedPosePalette;
 };
 
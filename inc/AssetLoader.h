@@ -0,0 +1,97 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "CharacterAssetCache.h"
+#include "ParallelFor.h"
+#include "texture_loader.h"
+
+/*
+   An AssetLoader performs the parts of loading an asset that don't need an OpenGL context on worker threads:
+   reading files, parsing glTF files, decoding images and optimizing clips
+
+   Each Load function returns a handle (std::shared_future) to the asset right away, and the asset becomes available once a worker thread
+   has loaded it
+   Requesting the same asset again returns the same handle, so a state can request everything it needs early on, and its constructor
+   can request the same assets again later and receive them without waiting for them, if they are ready
+
+   Everything that needs an OpenGL context (uploading buffers and textures, compiling shaders, etc.) is still done on the main thread,
+   which is what the LoadingState is for (see LoadingState.h)
+
+   WebAssembly only supports threads when the page is cross-origin isolated, which isn't the case for the web build, so in that case
+   the AssetLoader doesn't create any worker threads
+   Instead, the main thread runs the jobs itself by calling RunJobs every frame with a time budget, which keeps the page responsive
+
+   When there are worker threads, the jobs run with a task scheduler that queues the tasks of ParallelFor as jobs (see ParallelFor.h),
+   so a job that splits its work into tasks shares the worker threads with the other jobs instead of starting threads of its own
+*/
+
+class AssetLoader
+{
+public:
+
+   explicit AssetLoader(unsigned int numWorkerThreads);
+   ~AssetLoader();
+
+   AssetLoader(const AssetLoader&) = delete;
+   AssetLoader& operator=(const AssetLoader&) = delete;
+
+   AssetLoader(AssetLoader&&) = delete;
+   AssetLoader& operator=(AssetLoader&&) = delete;
+
+   std::shared_future<std::shared_ptr<const DecodedImage>>   LoadImage(const std::string& path);
+   std::shared_future<std::shared_ptr<const CharacterAsset>> LoadCharacter(const std::string& gltfPath, const std::string& bakedPath);
+
+   // These functions are identical to the ones above, except that they wait for the asset to be loaded
+   // While it waits, the calling thread runs the jobs that haven't been picked up by a worker thread yet,
+   // so they can't wait forever, even when there are no worker threads
+   std::shared_ptr<const DecodedImage>                       GetImage(const std::string& path);
+   std::shared_ptr<const CharacterAsset>                     GetCharacter(const std::string& gltfPath, const std::string& bakedPath);
+
+   // This function runs the jobs that are waiting for a worker thread on the calling thread until the budget is exceeded
+   // It only does something when there are no worker threads, in which case it must be called every frame
+   void                                                      RunJobs(double budgetInMs);
+
+   bool                                                      IsIdle() const;
+   float                                                     GetProgress() const;
+
+   // The handles that are stored by the AssetLoader keep their assets in memory, so this function must be called
+   // once the assets have been uploaded
+   void                                                      ReleaseLoadedAssets();
+
+private:
+
+   void                                                      Enqueue(std::function<void()>&& job);
+   bool                                                      RunNextJob();
+   void                                                      RunWorkerThread();
+
+   template<typename T>
+   T                                                         Wait(const std::shared_future<T>& handle);
+
+   std::vector<std::thread>                                  mWorkerThreads;
+   TaskScheduler                                             mTaskScheduler;
+
+   std::deque<std::function<void()>>                         mJobs;
+   std::mutex                                                mJobsMutex;
+   std::condition_variable                                   mJobAvailable;
+   bool                                                      mStopWorkerThreads;
+
+   std::atomic<unsigned int>                                 mNumJobs;
+   std::atomic<unsigned int>                                 mNumFinishedJobs;
+
+   // The handles are only accessed by the main thread, while the cache is accessed by the worker threads, which is why it's thread-safe
+   std::unordered_map<std::string, std::shared_future<std::shared_ptr<const DecodedImage>>>   mImages;
+   std::unordered_map<std::string, std::shared_future<std::shared_ptr<const CharacterAsset>>> mCharacters;
+
+   CharacterAssetCache                                       mCharacterAssetCache;
+};
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef BAKED_ASSET_H
+#define BAKED_ASSET_H
+
+#include <cstdint>
+
+#include "CharacterAsset.h"
+
+/*
+   A baked asset is a binary file that stores a CharacterAsset exactly as it's laid out in memory once it has been loaded and processed
+
+   The file starts with a header, which is followed by a table of sections
+   Each section is an array of fixed-size records (one skeleton, one record per mesh and one record per clip):
+
+   +--------+-------------------+---------------------------------+-----------------+--------------+--------------+
+   | Header | Table of sections | Arrays (positions, frames, ...) | Skeleton record | Mesh records | Clip records |
+   +--------+-------------------+---------------------------------+-----------------+--------------+--------------+
+
+   The records don't contain any variable-length data
+   Instead, they refer to arrays (positions, frames, joint names, etc.) through BakedArrays, which store the offset of an array from the start of the file
+   and the number of elements in it
+   Every array starts at an offset that is a multiple of 16 bytes, so once the file is mapped into memory, an array can be used by adding its offset
+   to the address of the mapping, which is the only fixup that's needed to use the data of the file
+   That also means that the elements of the arrays must have the same layout in the file and in memory, so the format assumes a little-endian machine
+   with 32-bit floats and integers, which covers x86, ARM and WebAssembly
+
+   The header stores a version number that must be incremented every time the layout of the file or the processing of the asset changes
+   A baked asset with a different version is rejected, in which case LoadCharacterAsset falls back to the glTF file that it was baked from
+
+   Note that the classes of the runtime (Skeleton, AnimatedMesh, FastClip, etc.) own their memory, so each array is copied out of the mapping with a single memcpy
+   Nothing is parsed, decoded or recalculated while loading, except for the bounds of the meshes, which are cheap to calculate
+
+   The clips are the exception to copying everything while loading: their arrays are only validated, and each clip is copied out of the mapping
+   the first time that it's requested from the ClipLibrary of the asset, which keeps the file mapped (see ClipLibrary.h)
+*/
+
+namespace BakedAssetFormat
+{
+   // The bytes "BAKE" in little-endian order
+   const uint32_t magic   = 0x454B4142;
+   const uint32_t version = 1;
+
+   const uint32_t alignment = 16;
+
+   enum SectionType : uint32_t
+   {
+      skeletonSection = 0,
+      meshSection     = 1,
+      clipSection     = 2,
+      numSections     = 3
+   };
+
+   struct Header
+   {
+      uint32_t magic;
+      uint32_t version;
+      uint32_t fileSize;
+      uint32_t numSections;
+   };
+
+   // The offset is measured from the start of the file
+   struct BakedArray
+   {
+      uint32_t offset;
+      uint32_t count;
+   };
+
+   // The records of a section are stored in an array, and this is what the table of sections points to
+   typedef BakedArray Section;
+
+   struct BakedSkeleton
+   {
+      BakedArray parentIndices;         // int32_t
+      BakedArray restPose;              // Transform
+      BakedArray bindPose;              // Transform
+      BakedArray invBindPose;           // glm::mat4
+      BakedArray jointNames;            // BakedArray of chars
+   };
+
+   struct BakedMorphTarget
+   {
+      BakedArray name;                  // char
+      BakedArray vertexIndices;         // uint32_t
+      BakedArray positionDeltas;        // glm::vec4
+      BakedArray normalDeltas;          // glm::vec4
+   };
+
+   struct BakedMesh
+   {
+      BakedArray positions;             // glm::vec3
+      BakedArray normals;               // glm::vec3
+      BakedArray texCoords;             // glm::vec2
+      BakedArray weights;               // glm::vec4
+      BakedArray influences;            // glm::ivec4
+      BakedArray indices;               // uint32_t
+      BakedArray lodIndices;            // BakedArray of uint32_t
+      BakedArray lodErrors;             // float
+      BakedArray morphTargets;          // BakedMorphTarget
+      BakedArray defaultMorphWeights;   // float
+      uint32_t   nodeIndex;
+      uint32_t   padding;
+   };
+
+   struct BakedTrack
+   {
+      BakedArray frames;                // Frame<N>
+      BakedArray sampleToFrameIndexMap; // uint32_t
+      uint32_t   interpolation;
+      uint32_t   padding;
+   };
+
+   struct BakedTransformTrack
+   {
+      uint32_t   jointID;
+      uint32_t   padding;
+      BakedTrack position;
+      BakedTrack rotation;
+      BakedTrack scale;
+   };
+
+   struct BakedMorphWeightsTrack
+   {
+      uint32_t   nodeID;
+      uint32_t   padding;
+      BakedArray weightTracks;          // BakedTrack
+   };
+
+   struct BakedClip
+   {
+      BakedArray name;                  // char
+      BakedArray transformTracks;       // BakedTransformTrack
+      BakedArray morphWeightsTracks;    // BakedMorphWeightsTrack
+      uint32_t   looping;
+      uint32_t   padding;
+   };
+}
+
+// This function writes a CharacterAsset into a baked asset
+bool WriteBakedCharacterAsset(CharacterAsset& asset, const char* path);
+
+// This function maps a baked asset into memory and copies its arrays into a CharacterAsset, except for the ones of the clips, which are streamed
+// It returns false if the file doesn't exist, if it's corrupt or if it was baked with a different version of the format
+bool LoadBakedCharacterAsset(const char* path, CharacterAsset& outAsset);
+
+// This function is what the asset baker runs (see main.cpp)
+// It loads a character from a glTF file, writes it into a baked asset and loads it back to verify it,
+// and it prints how long it takes to load the character from the glTF file and from the baked asset
+bool BakeCharacterAsset(const char* gltfPath, const char* bakedPath);
+
+#endif
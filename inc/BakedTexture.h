@@ -0,0 +1,95 @@
+#ifndef BAKED_TEXTURE_H
+#define BAKED_TEXTURE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "texture_loader.h"
+
+/*
+   A baked texture is a binary file that stores an image exactly as it's uploaded to the GPU, including all of its mip levels
+
+   Loading a PNG or a JPG means decoding it with stb_image and then generating its mip levels on the GPU with glGenerateMipmap
+   A baked texture skips both steps: the baker decodes the image once, generates the mip levels on the CPU and writes them into a file,
+   which is mapped into memory at runtime so that each level can be passed straight to glTexImage2D
+
+   The file starts with a header, which is followed by a table of mip levels and by the pixels of each level:
+
+   +--------+---------------------+---------+---------+-----+
+   | Header | Table of mip levels | Level 0 | Level 1 | ... |
+   +--------+---------------------+---------+---------+-----+
+
+   Every level starts at an offset that is a multiple of 16 bytes, and its rows are tightly packed
+
+   The mip levels of color textures are generated in linear space, which means that the sRGB values of the source image are converted into
+   linear values before they are averaged, and the averages are converted back into sRGB values
+   Averaging the sRGB values directly, which is what glGenerateMipmap does for our textures, darkens the smaller levels
+   Data textures (e.g. normal maps and DuDv maps) must be baked as linear textures, since their values are not colors
+
+   The levels can optionally be compressed into BC1 blocks (RGB textures) or BC3 blocks (RGBA textures), which take up 4 and 8 bits per pixel
+   The GPUs that don't support those formats (e.g. most mobile GPUs) receive the levels decompressed on the CPU by TextureLoader
+   WebGL only accepts compressed levels whose sizes are multiples of 4 (except for levels of 1x1 and 2x2), so only textures whose sizes are
+   powers of two can be compressed
+
+   At runtime, TextureLoader::decodeImage looks for a baked texture next to each image (e.g. grass.tex next to grass.png) and falls back
+   to decoding the image if there isn't one
+   Since the baked textures are much larger than the images they are baked from, baking is a trade-off between the time it takes
+   to decode the images and the time it takes to download them, which is why it's optional
+*/
+
+namespace BakedTextureFormat
+{
+   // The bytes "BTEX" in little-endian order
+   const uint32_t magic   = 0x58455442;
+   const uint32_t version = 1;
+
+   const uint32_t alignment = 16;
+
+   enum PixelFormat : uint32_t
+   {
+      rgb8  = 0,
+      rgba8 = 1,
+      bc1   = 2,
+      bc3   = 3
+   };
+
+   struct Header
+   {
+      uint32_t magic;
+      uint32_t version;
+      uint32_t fileSize;
+      uint32_t pixelFormat;
+      uint32_t width;
+      uint32_t height;
+      uint32_t numMipLevels;
+      uint32_t padding;
+   };
+
+   // The offset is measured from the start of the file
+   struct MipLevel
+   {
+      uint32_t offset;
+      uint32_t size;
+      uint32_t width;
+      uint32_t height;
+   };
+}
+
+// This function returns the path of the baked texture that corresponds to an image (e.g. grass.tex for grass.png)
+std::string                   GetBakedTexturePath(const std::string& imagePath);
+
+// This function maps a baked texture into memory and returns an image whose mip levels point into the mapping
+// It returns a nullptr if the file doesn't exist, if it's corrupt or if it was baked with a different version of the format
+std::shared_ptr<DecodedImage> LoadBakedTexture(const std::string& path);
+
+// This function decompresses a mip level that consists of BC1 or BC3 blocks into RGBA pixels
+std::vector<unsigned char>    DecompressMipLevel(const DecodedImage::MipLevel& mipLevel, unsigned int compressedFormat);
+
+// This function is what the texture baker runs (see main.cpp)
+// It decodes an image, generates its mip levels, optionally compresses them, writes them into a baked texture and loads it back to verify it,
+// and it prints how long it takes to decode the image and to load the baked texture
+bool                          BakeTexture(const char* imagePath, const char* bakedPath, bool linear, bool compress);
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+/*
+   The benchmarks compare the acceleration structures, solvers and clip storage of the experiments against the simpler versions that they replace,
+   and they print how much faster they are and how closely their results match
+
+   They only need the CPU side of the assets, so they run without a window or an OpenGL context
+   That's why they are only available in the native builds, through the benchmark mode (see main.cpp):
+
+   Animation-Experiments --benchmark
+
+   They load the same assets as the states, using the same relative paths, so they must be run from the root of the repository
+*/
+
+// This function runs every benchmark and returns false if an asset can't be loaded
+bool RunBenchmarks();
+
+#endif
@@ -24,6 +24,14 @@ public:
    float        GetThreshold();
    void         SetThreshold(float threshold);
 
+   // If the distance between the end effector and the goal shrinks by less than this fraction in an iteration, the solver stops iterating
+   // A value of zero disables this kind of termination
+   float        GetMinImprovementPerIteration();
+   void         SetMinImprovementPerIteration(float minImprovement);
+
+   // This function returns the number of iterations that were performed by the last call to Solve
+   unsigned int GetNumberOfIterationsPerformed();
+
    bool         Solve(const Transform& goal);
 
 private:
@@ -31,6 +39,8 @@ private:
    std::vector<Transform> mIKChain;
    unsigned int           mNumIterations;
    float                  mConvergenceThreshold;
+   float                  mMinImprovementPerIteration;
+   unsigned int           mNumIterationsPerformed;
 };
 
 #endif
@@ -0,0 +1,49 @@
+#ifndef CHARACTER_ASSET_H
+#define CHARACTER_ASSET_H
+
+#include <memory>
+#include <vector>
+
+#include "Skeleton.h"
+#include "AnimatedMesh.h"
+#include "ClipLibrary.h"
+
+/*
+   A CharacterAsset contains everything that the states need to animate a character:
+   its skeleton, its meshes and its clips, already processed so that they can be used right away
+
+   Loading a character from a glTF file involves the following steps:
+
+   - Parse the JSON of the file and decode its base64 buffers
+   - Read the skeleton, the meshes and the clips
+   - Optimize the meshes and generate their LODs
+   - Rearrange the joints of the skeleton, the influences of the meshes and the tracks of the clips
+   - Optimize the clips
+
+   Processing the meshes and processing each clip don't depend on each other, so LoadCharacterAssetFromGLTF runs them as parallel tasks (see ParallelFor.h),
+   which the idle worker threads of the AssetLoader help with
+
+   None of those steps depends on anything that changes at run-time, so the asset baker performs them once
+   and stores their results in a baked asset (see BakedAsset.h), which can be loaded without repeating any of them
+
+   The meshes are loaded without their VBOs, so an asset can be loaded and baked without an OpenGL context
+   AnimatedMesh::LoadBuffers must be called on each mesh before it's rendered
+
+   The clips are stored in a ClipLibrary, which loads the clips of a baked asset the first time they are requested (see ClipLibrary.h)
+*/
+
+struct CharacterAsset
+{
+   Skeleton                     skeleton;
+   std::vector<AnimatedMesh>    meshes;
+   std::shared_ptr<ClipLibrary> clips;
+};
+
+// This function loads a character from a glTF file and processes it so that it's identical to one that was loaded from a baked asset
+bool LoadCharacterAssetFromGLTF(const char* path, CharacterAsset& outAsset);
+
+// This function loads a character from a baked asset if it exists and is up to date, and from a glTF file otherwise
+// It prints the path that was used and how long it took, which is the cold start time of the character
+bool LoadCharacterAsset(const char* gltfPath, const char* bakedPath, CharacterAsset& outAsset);
+
+#endif
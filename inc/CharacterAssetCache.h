@@ -0,0 +1,52 @@
+#ifndef CHARACTER_ASSET_CACHE_H
+#define CHARACTER_ASSET_CACHE_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "CharacterAsset.h"
+
+/*
+   A CharacterAssetCache lets several states share a character instead of loading it once per state
+
+   The states receive immutable handles to the assets (std::shared_ptr<const CharacterAsset>), which count the references to each asset
+   The cache itself only keeps weak references, so an asset is destroyed as soon as the last state that uses it releases its handle,
+   and loading it again after that reads it from disk again
+
+   Since the assets are immutable, everything that changes while a character is animated must be stored by each state:
+   - The poses, the playback times and the crossfade controllers
+   - The settings of the clips, like whether they loop (a state that needs a different setting must copy the clip)
+   - The VAOs and the dynamic buffers of the meshes, along with their morphed and skinned vertices (see AnimatedMesh::ShareMeshData)
+
+   The skeleton, the clips and the vertices, indices, static buffers and index buffers of the meshes are shared
+*/
+
+class CharacterAssetCache
+{
+public:
+
+   CharacterAssetCache() = default;
+   ~CharacterAssetCache() = default;
+
+   CharacterAssetCache(const CharacterAssetCache&) = delete;
+   CharacterAssetCache& operator=(const CharacterAssetCache&) = delete;
+
+   CharacterAssetCache(CharacterAssetCache&&) = delete;
+   CharacterAssetCache& operator=(CharacterAssetCache&&) = delete;
+
+   // This function returns the asset that was loaded from the given glTF file if it's still in use,
+   // and it loads it using LoadCharacterAsset otherwise (see CharacterAsset.h)
+   // It returns a nullptr if the asset can't be loaded
+   // It can be called by several threads at the same time, and it only locks the cache while it looks up or stores an asset,
+   // so loading one character doesn't block the threads that load other characters
+   std::shared_ptr<const CharacterAsset> Load(const std::string& gltfPath, const std::string& bakedPath);
+
+private:
+
+   std::unordered_map<std::string, std::weak_ptr<const CharacterAsset>> mAssets;
+   std::mutex                                                           mAssetsMutex;
+};
+
+#endif
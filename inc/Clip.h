@@ -4,11 +4,12 @@
 #include <vector>
 #include <string>
 #include "TransformTrack.h"
+#include "MorphWeightsTrack.h"
 #include "Pose.h"
 
 // TODO: If we unify the Track and FastTrack classes, this wouldn't have to be a template anymore
 //       and we could delete the OptimizeClip function
-template <typename TRACK>
+template <typename TRACK, typename WTRACK>
 class TClip
 {
 public:
@@ -23,6 +24,13 @@ public:
    TRACK&       GetTransformTrackOfJoint(unsigned int jointID);
    void         SetTransformTrackOfJoint(unsigned int jointID, const TRACK& transfTrack);
 
+   unsigned int GetNumberOfMorphWeightsTracks() const;
+
+   unsigned int GetNodeIDOfMorphWeightsTrack(unsigned int weightsTrackIndex) const;
+
+   WTRACK&      GetMorphWeightsTrackOfNode(unsigned int nodeID);
+   void         SetMorphWeightsTrackOfNode(unsigned int nodeID, const WTRACK& weightsTrack);
+
    std::string  GetName() const;
    void         SetName(const std::string& name);
 
@@ -30,27 +38,34 @@ public:
    float        GetEndTime() const;
    float        GetDuration() const;
    void         RecalculateDuration();
-   bool         IsTimePastEnd(float time);
+   bool         IsTimePastEnd(float time) const;
 
    bool         GetLooping() const;
    void         SetLooping(bool looping);
 
    float        Sample(Pose& ioPose, float time) const;
+   void         SampleMorphWeights(unsigned int nodeID, std::vector<float>& ioWeights, float time) const;
 
 private:
 
    float        AdjustTimeToBeWithinClip(float time) const;
 
-   std::vector<TRACK> mTransformTracks;
-   std::string        mName;
-   float              mStartTime;
-   float              mEndTime;
-   bool               mLooping;
+   std::vector<TRACK>  mTransformTracks;
+   std::vector<WTRACK> mMorphWeightsTracks;
+   std::string         mName;
+   float               mStartTime;
+   float               mEndTime;
+   bool                mLooping;
 };
 
-typedef TClip<TransformTrack> Clip;
-typedef TClip<FastTransformTrack> FastClip;
+typedef TClip<TransformTrack, MorphWeightsTrack> Clip;
+typedef TClip<FastTransformTrack, FastMorphWeightsTrack> FastClip;
 
 FastClip OptimizeClip(Clip& clip);
 
+// This function makes the tracks of a fast clip whose frames have identical times share a single Timeline (see Timeline.h)
+// The tracks that don't have a map yet get one from their timeline, which is generated once per unique array of times
+// It returns the number of unique timelines
+unsigned int ShareTimelines(FastClip& clip);
+
 #endif
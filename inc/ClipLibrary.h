@@ -0,0 +1,106 @@
+#ifndef CLIP_LIBRARY_H
+#define CLIP_LIBRARY_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Clip.h"
+
+/*
+   A ClipLibrary stores the clips of a character and loads them the first time they are requested
+
+   It stores two kinds of clips:
+
+   - Resident clips, which are added with AddClip and never evicted
+     The clips of a glTF file are resident, since they can only be loaded all at once
+   - Streamed clips, which are added with AddStreamedClip along with a function that loads them
+     The clips of a baked asset are streamed, since each of them can be read from the mapped file on its own (see BakedAsset.h)
+     Only their names and sizes are known until they are requested
+
+   GetClip returns a handle to a clip, loading it first if it's not in memory
+   A clip is considered to be playing for as long as a handle to it exists outside of the library, so the states must hold the handles
+   of the clips that they are playing and release them once they stop playing them (the crossfade controllers only store raw pointers)
+
+   Once the streamed clips take up more memory than the budget allows, the library evicts the ones that are not playing,
+   starting with the one that was requested the longest time ago, until they fit within the budget again
+   The clips that are playing are never evicted, so the budget can be exceeded while many clips are playing
+
+   Prefetch queues a clip so that it's loaded before it's requested (e.g. the running clip while the character is walking),
+   and Update loads the clips in the queue, one per call, so that prefetching doesn't load more than one clip per frame
+   A clip that doesn't fit within the budget along with the clips that are playing is not prefetched
+
+   The CharacterAssets are immutable, but their libraries change as they load and evict clips, which is why CharacterAsset stores its library
+   through a pointer
+   A library is only used by the main thread once its character has been loaded, so it's not thread-safe
+*/
+
+class ClipLibrary
+{
+public:
+
+   // The budget only applies to the streamed clips
+   ClipLibrary(size_t budgetInBytes = defaultBudgetInBytes);
+   ~ClipLibrary() = default;
+
+   ClipLibrary(const ClipLibrary&) = delete;
+   ClipLibrary& operator=(const ClipLibrary&) = delete;
+
+   ClipLibrary(ClipLibrary&&) = default;
+   ClipLibrary& operator=(ClipLibrary&&) = default;
+
+   void                            AddClip(FastClip&& clip);
+   void                            AddStreamedClip(const std::string& name, size_t sizeInBytes, std::function<bool(FastClip&)>&& loadClip);
+
+   unsigned int                    GetNumberOfClips() const;
+   const std::string&              GetClipName(unsigned int clipIndex) const;
+
+   // This function returns -1 if there isn't a clip with the given name
+   int                             GetClipIndex(const std::string& name) const;
+
+   // These functions return a nullptr if the clip doesn't exist or if it can't be loaded
+   std::shared_ptr<const FastClip> GetClip(unsigned int clipIndex);
+   std::shared_ptr<const FastClip> GetClip(const std::string& name);
+
+   void                            Prefetch(const std::string& name);
+   void                            Update();
+
+   size_t                          GetBudget() const;
+   void                            SetBudget(size_t budgetInBytes);
+
+   size_t                          GetSizeOfStreamedClips() const;
+   unsigned int                    GetNumberOfLoadedClips() const;
+
+   static const size_t             defaultBudgetInBytes = 4 * 1024 * 1024;
+
+private:
+
+   struct Entry
+   {
+      std::string                    name;
+      std::shared_ptr<FastClip>      clip;
+      std::function<bool(FastClip&)> loadClip;
+      size_t                         sizeInBytes;
+      uint64_t                       lastRequest;
+   };
+
+   size_t                                        GetSizeOfPlayingClips() const;
+   bool                                          LoadClip(Entry& entry);
+   void                                          EvictClipsThatExceedBudget();
+
+   std::vector<Entry>                            mEntries;
+   std::unordered_map<std::string, unsigned int> mClipIndices;
+   std::deque<unsigned int>                      mPrefetchQueue;
+
+   size_t                                        mBudgetInBytes;
+   size_t                                        mSizeOfStreamedClips;
+
+   // Every request increments this counter, which orders the clips from the least recently requested one to the most recently requested one
+   uint64_t                                      mNumRequests;
+};
+
+#endif
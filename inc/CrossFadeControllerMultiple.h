@@ -14,12 +14,13 @@ public:
 
    void SetSkeleton(Skeleton& skeleton);
 
-   void Play(CLIP* clip, bool lock);
-   void FadeTo(CLIP* targetClip, float fadeDuration, bool lock);
+   void Play(const CLIP* clip, bool lock);
+   void FadeTo(const CLIP* targetClip, float fadeDuration, bool lock);
    void Update(float dt);
    void ClearTargets();
 
-   CLIP* GetCurrentClip();
+   const CLIP* GetCurrentClip();
+   bool  IsPlaying(const CLIP* clip);
    Pose& GetCurrentPose();
 
    bool  IsCurrentClipFinished();
@@ -30,7 +31,7 @@ public:
 
 private:
 
-   CLIP*                               mCurrentClip;
+   const CLIP*                         mCurrentClip;
    float                               mPlaybackTime;
    Skeleton                            mSkeleton;
    Pose                                mCurrentPose;
@@ -15,16 +15,16 @@ public:
 
    void SetSkeleton(Skeleton& skeleton);
 
-   void Play(CLIP* clip);
-   void FadeTo(CLIP* targetClip, float fadeDuration);
+   void Play(const CLIP* clip);
+   void FadeTo(const CLIP* targetClip, float fadeDuration);
    void Update(float dt);
 
-   CLIP* GetCurrentClip();
+   const CLIP* GetCurrentClip();
    Pose& GetCurrentPose();
 
 private:
 
-   CLIP*                              mCurrentClip;
+   const CLIP*                        mCurrentClip;
    float                              mPlaybackTime;
    Skeleton                           mSkeleton;
    Pose                               mCurrentPose;
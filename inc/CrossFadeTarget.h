@@ -8,14 +8,14 @@ template <typename CLIP>
 struct TCrossFadeTarget
 {
    TCrossFadeTarget();
-   TCrossFadeTarget(CLIP* clip, Pose& pose, float fadeDuration, bool lock);
+   TCrossFadeTarget(const CLIP* clip, Pose& pose, float fadeDuration, bool lock);
 
-   CLIP* mClip;
-   Pose  mPose;
-   float mPlaybackTime;
-   float mFadeDuration;
-   float mFadeTime;
-   bool  mLock;
+   const CLIP* mClip;
+   Pose        mPose;
+   float       mPlaybackTime;
+   float       mFadeDuration;
+   float       mFadeTime;
+   bool        mLock;
 };
 
 typedef TCrossFadeTarget<Clip> CrossFadeTarget;
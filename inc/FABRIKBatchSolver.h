@@ -0,0 +1,94 @@
+#ifndef FABRIK_BATCH_SOLVER_H
+#define FABRIK_BATCH_SOLVER_H
+
+#include <vector>
+
+#include "Transform.h"
+
+/*
+   The FABRIKBatchSolver class solves many IK chains of the same length at once, which is what we need to animate a crowd of characters
+
+   FABRIKSolver stores a single chain as an array of transforms, and its backward and forward iterations move one joint at a time
+   This solver only stores the world positions of the joints, and it groups the chains into groups of four that are stored as a structure of arrays (SoA):
+
+   Joint 0 of group 0: x: | c0 | c1 | c2 | c3 |   y: | c0 | c1 | c2 | c3 |   z: | c0 | c1 | c2 | c3 |
+   Joint 1 of group 0: x: | c0 | c1 | c2 | c3 |   y: | c0 | c1 | c2 | c3 |   z: | c0 | c1 | c2 | c3 |
+   ...
+
+   This layout allows us to move the same joint of four chains with the same number of SIMD instructions that it would take to move it in one chain
+   WebAssembly only supports 128-bit vectors, which is why the groups contain four chains instead of eight
+
+   Each chain converges after a different number of iterations, so each group keeps a mask of the chains that are still being solved
+   The chains that have converged stop moving, and a group stops iterating as soon as all of its chains have converged
+
+   The solver doesn't know anything about rotations or constraints, so the chains must be converted back into rotations once they are solved,
+   which is what FABRIKSolver::SetWorldPositionsOfIKChain does
+*/
+
+class FABRIKBatchSolver
+{
+public:
+
+   FABRIKBatchSolver();
+
+   unsigned int GetNumberOfJointsInIKChains() const;
+   void         SetNumberOfJointsInIKChains(unsigned int numJoints);
+
+   unsigned int GetNumberOfIterations() const;
+   void         SetNumberOfIterations(unsigned int numIterations);
+
+   float        GetThreshold() const;
+   void         SetThreshold(float threshold);
+
+   // This function removes all the chains from the batch, but it keeps the memory that they used so that it can be reused in the next frame
+   void         Clear();
+
+   // This function adds a chain to the batch and returns its index
+   // worldPositions must contain the world positions of all the joints of the chain, starting with the root
+   unsigned int AddIKChain(const glm::vec3* worldPositions, const glm::vec3& goalPos);
+   unsigned int GetNumberOfIKChains() const;
+
+   void         Solve();
+
+   glm::vec3    GetWorldPosition(unsigned int chainIndex, unsigned int jointIndex) const;
+   bool         HasConverged(unsigned int chainIndex) const;
+   // The chains of a group are solved together, so this function returns the number of iterations that were performed on the group of the chain
+   unsigned int GetNumberOfIterationsPerformed(unsigned int chainIndex) const;
+
+private:
+
+   // The positions of the same joint of the four chains of a group
+   struct Vec3Lanes
+   {
+      alignas(16) float x[4];
+      alignas(16) float y[4];
+      alignas(16) float z[4];
+   };
+
+   // The distances between the same joint of the four chains of a group and its parent
+   struct FloatLanes
+   {
+      alignas(16) float v[4];
+   };
+
+   void         SolveGroup(unsigned int groupIndex);
+
+   // The joints of group g are stored between mWorldPositions[g * numJoints] and mWorldPositions[(g + 1) * numJoints]
+   std::vector<Vec3Lanes>    mWorldPositions;
+   std::vector<FloatLanes>   mDistancesBetweenJoints;
+   std::vector<Vec3Lanes>    mGoalPositions;
+   std::vector<Vec3Lanes>    mRootPositions;
+   // Bit i of the mask of a group is set if chain i of that group has converged
+   std::vector<int>          mConvergedMasks;
+   std::vector<unsigned int> mNumIterationsPerformed;
+   unsigned int              mNumJoints;
+   unsigned int              mNumChains;
+   unsigned int              mNumIterations;
+   float                     mConvergenceThreshold;
+};
+
+// This function measures how many chains per second the batch solver can solve compared to FABRIKSolver::Solve,
+// and prints the results along with the largest distance between the end effectors that both solvers calculated
+void BenchmarkFABRIKBatchSolver(const Transform& hip, const Transform& knee, const Transform& ankle, unsigned int numIterations, unsigned int numChains);
+
+#endif
@@ -23,9 +23,23 @@ public:
    float        GetThreshold();
    void         SetThreshold(float threshold);
 
+   // If the distance between the end effector and the goal shrinks by less than this fraction in an iteration, the solver stops iterating
+   // A value of zero disables this kind of termination
+   float        GetMinImprovementPerIteration();
+   void         SetMinImprovementPerIteration(float minImprovement);
+
+   // This function returns the number of iterations that were performed by the last call to Solve or SolveThreeJointLegWithConstraints
+   unsigned int GetNumberOfIterationsPerformed();
+
    bool         Solve(const Transform& target);
    bool         SolveThreeJointLegWithConstraints(const Transform& target, int indexOfKnee, const glm::vec3& characterRight);
 
+   // This function rotates the joints of the IK chain so that they end up at the given world positions
+   // It's used to apply the results of a FABRIKBatchSolver, which only solves the world positions of the joints
+   void         SetWorldPositionsOfIKChain(const glm::vec3* worldPositions);
+
+   void         ApplyBackwardsKneeCorrection(int indexOfKneeJoint, const glm::vec3& referenceNormal);
+
 private:
 
    void         IKChainToWorld();
@@ -36,13 +50,14 @@ private:
 
    void         ApplyHingeConstraint(int indexOfConstrainedJoint, const glm::vec3& localHingeAxis, const glm::vec3& worldHingeAxis);
    void         ApplyBallAndSocketConstraint(int indexOfConstrainedJoint, float limitOfRotationInDeg);
-   void         ApplyBackwardsKneeCorrection(int indexOfKneeJoint, const glm::vec3& referenceNormal);
 
    std::vector<Transform> mIKChain;
    std::vector<glm::vec3> mWorldPositionsChain;
    std::vector<float>     mDistancesBetweenJoints;
    unsigned int           mNumIterations;
    float                  mConvergenceThreshold;
+   float                  mMinImprovementPerIteration;
+   unsigned int           mNumIterationsPerformed;
 };
 
 #endif
@@ -0,0 +1,122 @@
+#ifndef FOOT_PLACEMENT_SYSTEM_H
+#define FOOT_PLACEMENT_SYSTEM_H
+
+#include <vector>
+
+#include "IKLeg.h"
+#include "GroundProbe.h"
+
+/*
+   The FootPlacementSystem class places the feet of many characters on the ground at once
+
+   Placing the feet of a character involves finding the ground below its ankles, solving its legs so that the ankles reach the ground,
+   and then finding the ground in front of its ankles to rotate them so that the toes also reach the ground
+   Doing all of that one character at a time means jumping between ground queries and IK solves, so instead the system runs in phases,
+   and each phase processes all the characters before the next one starts:
+
+   1. Gather the points below which we look for the ground for the ankles of all the characters
+   2. Find the ground below all of those points with a single call to GetGroundPointsBelow
+   3. Calculate the targets of the ankles and solve all the legs
+   4. Gather the points below which we look for the ground for the toes, which depend on the solved ankles
+   5. Find the ground below all of those points with a single call to GetGroundPointsBelow
+   6. Rotate all the ankles towards the ground below the toes
+
+   The inputs and outputs of the system are plain arrays with one element per character, and it doesn't keep any state of its own between calls
+   other than the memory of its queries, so it can be benchmarked without a window, and a crowd can be split into ranges of characters
+   that are processed in parallel by giving each thread its own system
+*/
+
+// The values that describe how the feet of all the characters are placed
+struct FootPlacementSettings
+{
+   // The height above the ankles from which we look for the ground below them
+   float        heightOfHip;
+   // The height above the toes from which we look for the ground below them
+   float        heightOfKnees;
+   float        distanceFromAnkleToToe;
+
+   bool         solveAnalytically;
+   bool         solveInBatch;
+   bool         solveWithConstraints;
+   bool         warmStart;
+   int          numIterations;
+};
+
+// The state of a character that the system needs to remember between frames
+struct FootPlacementCharacter
+{
+   IKLeg        leftLeg;
+   IKLeg        rightLeg;
+
+   // Each point that we look for the ground below has its own probe, so that it can remember the last triangle it hit
+   GroundProbe  leftAnkleGroundProbe;
+   GroundProbe  rightAnkleGroundProbe;
+   GroundProbe  leftToeGroundProbe;
+   GroundProbe  rightToeGroundProbe;
+};
+
+// The values of a character that change every frame
+struct FootPlacementInput
+{
+   Transform    modelTransform;
+   // The values of the pin tracks, which tell us how much each foot should be on the ground
+   float        leftFootPinTrackValue;
+   float        rightFootPinTrackValue;
+};
+
+struct FootPlacementOutput
+{
+   glm::vec3    leftAnkleTarget;
+   glm::vec3    rightAnkleTarget;
+   // The number of iterations that the IK solver needed to solve both legs
+   unsigned int numIKIterations;
+};
+
+class FootPlacementSystem
+{
+public:
+
+   FootPlacementSystem();
+
+   // This function places the feet of numCharacters characters, where the feet of character i are placed by modifying poses[i]
+   void Run(const HeightQueryGrid&       grid,
+            const FootPlacementSettings& settings,
+            const FootPlacementInput*    inputs,
+            FootPlacementCharacter*      characters,
+            Pose*                        poses,
+            FootPlacementOutput*         outputs,
+            unsigned int                 numCharacters);
+
+private:
+
+   // This function stores the points below which we look for the ground in mQueryOrigins, and the probes that look for it in mQueryProbes
+   void GatherAnkleQueries(const FootPlacementSettings& settings, const FootPlacementInput* inputs, FootPlacementCharacter* characters, const Pose* poses, unsigned int numCharacters);
+   void GatherToeQueries(const FootPlacementSettings& settings, const FootPlacementInput* inputs, FootPlacementCharacter* characters, const Pose* poses, unsigned int numCharacters);
+
+   void ResolveQueries(const HeightQueryGrid& grid);
+
+   void SolveLegs(const FootPlacementSettings& settings, const FootPlacementInput* inputs, FootPlacementCharacter* characters, Pose* poses, FootPlacementOutput* outputs, unsigned int numCharacters);
+
+   // The queries of the left foot of character i are stored at index 2 * i, and the ones of its right foot are stored at index 2 * i + 1
+   std::vector<glm::vec3>     mQueryOrigins;
+   std::vector<GroundProbe*>  mQueryProbes;
+   std::vector<glm::vec3>     mGroundPoints;
+   std::vector<unsigned char> mHits;
+
+   // The world transforms of the ankles and the world positions of the toes, which are stored in the same order as the queries
+   std::vector<Transform>     mWorldTransfsOfAnkles;
+   std::vector<glm::vec3>     mWorldPosOfToes;
+
+   // The legs of all the characters are solved together by this solver when they are solved in a batch
+   FABRIKBatchSolver          mLegBatchSolver;
+};
+
+// This function measures how many characters per second the system can place the feet of when it processes them one at a time
+// and when it processes all of them at once, using copies of the given character that are spread over the ground
+void BenchmarkFootPlacementSystem(const HeightQueryGrid&       grid,
+                                  const FootPlacementSettings& settings,
+                                  const FootPlacementCharacter& character,
+                                  const Pose&                  pose,
+                                  unsigned int                 numCharacters);
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <array>
+
+#include "AABB.h"
+
+/*
+   The Frustum class is used to determine if an object is inside of the volume that a camera can see.
+
+   The frustum is described by 6 planes whose normals point towards its interior:
+
+                    far
+              +-------------+
+               \           /
+          left  \         /  right
+                 \       /
+                  +-----+
+                   near
+                    *
+                  camera
+
+   The planes are extracted directly from the rows of the projection * view matrix (Gribb/Hartmann method)
+   Since they are in world space, AABBs must be in world space too before they are tested
+
+   Optionally, a seventh plane can be added to represent the horizontal clipping plane that is used when rendering
+   the reflection and refraction textures of water. Anything on the wrong side of that plane is discarded by the
+   fragment shaders anyway, so there is no point in submitting it
+*/
+
+class Frustum
+{
+public:
+
+   Frustum();
+   Frustum(const glm::mat4& projectionViewMatrix);
+   Frustum(const glm::mat4& projectionViewMatrix, const glm::vec2& horizontalClippingPlaneYNormalAndHeight);
+
+   bool IsAABBVisible(const AABB& aabb) const;
+
+private:
+
+   void ExtractPlanes(const glm::mat4& projectionViewMatrix);
+
+   // Each plane is stored as (normal.x, normal.y, normal.z, distance)
+   // A point p is in front of a plane when dot(normal, p) + distance >= 0
+   std::array<glm::vec4, 7> mPlanes;
+   unsigned int             mNumPlanes;
+};
+
+#endif
@@ -5,6 +5,8 @@
 #include "Pose.h"
 #include "Skeleton.h"
 #include "AnimatedMesh.h"
+#include "StaticMesh.h"
+#include "IndexedTriangleStore.h"
 #include "Clip.h"
 #include <vector>
 #include <string>
@@ -15,9 +17,16 @@ void                      FreeGLTFFile(cgltf_data* handle);
 Pose                      LoadRestPose(cgltf_data* data);
 std::vector<std::string>  LoadJointNames(cgltf_data* data);
 std::vector<Clip>         LoadClips(cgltf_data* data);
+Clip                      LoadClip(cgltf_data* data, unsigned int clipIndex);
 Pose                      LoadBindPose(cgltf_data* data);
 Skeleton                  LoadSkeleton(cgltf_data* data);
 std::vector<AnimatedMesh> LoadAnimatedMeshes(cgltf_data* data);
-std::vector<AnimatedMesh> LoadStaticMeshes(cgltf_data* data);
+std::vector<StaticMesh>   LoadStaticMeshes(cgltf_data* data);
+
+// This function reads the triangles of the static meshes straight into a store, without creating the meshes or their buffers,
+// so it can be called without an OpenGL context (e.g. by the benchmarks)
+void                      LoadTrianglesOfStaticMeshes(cgltf_data* data, IndexedTriangleStore& outTriangles);
+
+bool                      ConvertGLTFFileToGLB(const char* gltfPath, const char* glbPath);
 
 #endif
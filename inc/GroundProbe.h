@@ -0,0 +1,63 @@
+#ifndef GROUND_PROBE_H
+#define GROUND_PROBE_H
+
+#include "HeightQueryGrid.h"
+
+/*
+   A GroundProbe finds the ground below a point that moves continuously, like a foot or the root of a character
+
+   Those points only move a few centimeters per frame, so the triangle that was hit the last time is almost always hit again
+   Each probe remembers that triangle, and before searching the grid, it tests that triangle and the ones that share its edges:
+
+        /\----/\
+       /  \ N/  \
+      /    \/    \
+      \ N  /\  N /
+       \  / L\  /
+        \/----\/
+
+   Where L is the last triangle that was hit and N are its neighbors
+   The grid is only searched when none of those triangles are below the point, which happens when it crosses a vertex of the ground,
+   or when it jumps far away (e.g. when the character is teleported)
+
+   Note that this assumes that the ground is a heightfield, since the first triangle that is found below the point is the one that is used
+*/
+
+class GroundProbe
+{
+public:
+
+   GroundProbe();
+
+   bool         GetGroundPointBelow(const HeightQueryGrid& grid, const glm::vec3& origin, glm::vec3& outGroundPoint);
+
+   // This function forgets the last triangle that was hit, which must be done when the ground changes
+   void         Reset();
+
+   unsigned int GetNumberOfQueries() const;
+   unsigned int GetNumberOfCacheHits() const;
+   unsigned int GetNumberOfNeighborHits() const;
+   void         ResetStatistics();
+
+private:
+
+   int          mLastTriangleIndex;
+
+   unsigned int mNumQueries;
+   // The number of queries that hit the last triangle
+   unsigned int mNumCacheHits;
+   // The number of queries that hit one of the neighbors of the last triangle
+   unsigned int mNumNeighborHits;
+};
+
+// This function finds the ground below many points at once, where the ground below origins[i] is found by probes[i]
+// outHits[i] is set to 1 if the ground was found below origins[i], in which case outGroundPoints[i] is set to the point on the ground, and to 0 otherwise
+// Processing all the points together keeps the grid and the probes in the cache, which is why FootPlacementSystem gathers its points before calling it
+unsigned int GetGroundPointsBelow(const HeightQueryGrid& grid,
+                                  GroundProbe* const*    probes,
+                                  const glm::vec3*       origins,
+                                  unsigned int           numPoints,
+                                  glm::vec3*             outGroundPoints,
+                                  unsigned char*         outHits);
+
+#endif
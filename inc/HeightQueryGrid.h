@@ -0,0 +1,78 @@
+#ifndef HEIGHT_QUERY_GRID_H
+#define HEIGHT_QUERY_GRID_H
+
+#include <vector>
+
+#include "AABB.h"
+#include "IndexedTriangleStore.h"
+
+/*
+   The HeightQueryGrid class answers the question "how high is the ground at this X and Z position?"
+
+   All the ground queries of the IK states are rays that shoot straight down, so they don't need a 3D acceleration structure
+   Instead, the ground is projected onto the XZ plane and divided into a uniform grid of cells,
+   and each cell stores the indices of the triangles whose projections overlap it:
+
+   +-----+-----+-----+-----+
+   |     |  /\ |     |     |
+   |     | /  \|     |     |
+   +-----+/----\-----+-----+
+   |     /     |\    |     |
+   |    /______|_\   |     |
+   +-----+-----+-----+-----+
+
+   Finding the cell that contains a point is a couple of multiplications, so the cost of a query is proportional to the number of triangles
+   in a single cell, and those triangles are still tested exactly, which means that the results match the ones of a downward ray
+*/
+
+class HeightQueryGrid
+{
+public:
+
+   HeightQueryGrid();
+
+   // The grid keeps its own copy of the triangles, so the second overload lets the caller hand over a store that it no longer needs
+   void         Build(const IndexedTriangleStore& triangles);
+   void         Build(IndexedTriangleStore&& triangles);
+
+   // This function returns the height of the highest triangle at the given X and Z position
+   bool         GetGroundHeight(float x, float z, float& outHeight) const;
+
+   // This function returns the point where a ray that shoots straight down from the given origin would hit the ground
+   // In other words, it returns the highest point of the ground that is below the origin
+   bool         GetGroundPointBelow(const glm::vec3& origin, glm::vec3& outGroundPoint) const;
+   bool         GetGroundPointBelow(const glm::vec3& origin, glm::vec3& outGroundPoint, unsigned int& outTriangleIndex) const;
+
+   // This function is identical to the one above, except that it only tests a single triangle
+   // It allows us to test the triangle that was hit the last time before searching the grid
+   bool         GetGroundPointBelowOnTriangle(unsigned int triangleIndex, const glm::vec3& origin, glm::vec3& outGroundPoint) const;
+
+   // This function returns the indices of the triangles that share the edges AB, BC and CA of a triangle, or -1 for the edges that aren't shared
+   const glm::ivec3& GetNeighborsOfTriangle(unsigned int triangleIndex) const;
+
+   unsigned int GetNumberOfTriangles() const;
+   unsigned int GetNumberOfCellsAlongX() const;
+   unsigned int GetNumberOfCellsAlongZ() const;
+   float        GetAverageNumberOfTrianglesPerCell() const;
+   AABB         GetBounds() const;
+
+private:
+
+   bool         FindHighestTriangleBelow(float x, float z, float maxHeight, float& outHeight, unsigned int& outTriangleIndex) const;
+
+   IndexedTriangleStore      mTriangles;
+   std::vector<glm::ivec3>   mTriangleNeighbors;
+
+   // The triangles of the cells are stored one after the other, and mCellOffsets stores where the triangles of each cell start
+   // The triangles of cell i are the ones between mCellOffsets[i] and mCellOffsets[i + 1]
+   std::vector<unsigned int> mCellOffsets;
+   std::vector<unsigned int> mCellTriangleIndices;
+
+   AABB                      mBounds;
+   float                     mCellSize;
+   float                     mInverseCellSize;
+   unsigned int              mNumCellsAlongX;
+   unsigned int              mNumCellsAlongZ;
+};
+
+#endif
@@ -14,12 +14,13 @@ public:
 
    void SetSkeleton(Skeleton& skeleton);
 
-   void Play(CLIP* clip, ScalarTrack* leftFootPinTrack, ScalarTrack* rightFootPinTrack, bool lock);
-   void FadeTo(CLIP* targetClip, ScalarTrack* leftFootPinTrack, ScalarTrack* rightFootPinTrack, float fadeDuration, bool lock);
+   void Play(const CLIP* clip, ScalarTrack* leftFootPinTrack, ScalarTrack* rightFootPinTrack, bool lock);
+   void FadeTo(const CLIP* targetClip, ScalarTrack* leftFootPinTrack, ScalarTrack* rightFootPinTrack, float fadeDuration, bool lock);
    void Update(float dt);
    void ClearTargets();
 
-   CLIP* GetCurrentClip();
+   const CLIP* GetCurrentClip();
+   bool  IsPlaying(const CLIP* clip);
    Pose& GetCurrentPose();
    float GetCurrentLeftFootPinTrackValue();
    float GetCurrentRightFootPinTrackValue();
@@ -32,7 +33,7 @@ public:
 
 private:
 
-   CLIP*                                 mCurrentClip;
+   const CLIP*                           mCurrentClip;
    ScalarTrack*                          mCurrentLeftFootPinTrack;
    ScalarTrack*                          mCurrentRightFootPinTrack;
    float                                 mPlaybackTime;
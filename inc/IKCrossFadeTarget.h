@@ -8,14 +8,14 @@ template <typename CLIP>
 struct TIKCrossFadeTarget
 {
    TIKCrossFadeTarget();
-   TIKCrossFadeTarget(CLIP*        clip,
+   TIKCrossFadeTarget(const CLIP*  clip,
                       ScalarTrack* leftFootPinTrack,
                       ScalarTrack* rightFootPinTrack,
                       Pose&        pose,
                       float        fadeDuration,
                       bool         lock);
 
-   CLIP*        mClip;
+   const CLIP*  mClip;
    ScalarTrack* mLeftFootPinTrack;
    ScalarTrack* mRightFootPinTrack;
    Pose         mPose;
@@ -4,6 +4,8 @@
 #include "Skeleton.h"
 #include "Track.h"
 #include "FABRIKSolver.h"
+#include "FABRIKBatchSolver.h"
+#include "TwoBoneIKSolver.h"
 
 class IKLeg
 {
@@ -12,7 +14,18 @@ public:
    IKLeg();
    IKLeg(Skeleton& skeleton, const std::string& hipName, const std::string& kneeName, const std::string& ankleName, const std::string& toeName);
 
-   void               Solve(const Transform& modelTransform, Pose& pose, const glm::vec3& ankleTargetPosition, bool constrained, int numIterations);
+   // If warmStart is true and the target barely moved since the last frame, the solver starts from the chain that was solved in the last frame
+   // instead of the animated pose, which is usually so close to the solution that only a couple of iterations are needed
+   void               Solve(const Transform& modelTransform, Pose& pose, const glm::vec3& ankleTargetPosition, bool constrained, int numIterations, bool warmStart);
+   // This function solves the leg in closed form instead of with FABRIK, so it doesn't need a number of iterations
+   void               SolveAnalytically(const Transform& modelTransform, Pose& pose, const glm::vec3& ankleTargetPosition);
+
+   // These functions allow many legs to be solved together by a FABRIKBatchSolver
+   // SubmitToBatch adds the chain of the leg to the batch, and once the batch is solved, RetrieveFromBatch applies the result to the leg
+   // Both functions must be called with the same pose
+   // The batch can't apply the hinge constraints on every iteration, so when constrained is true only the backwards knee correction is applied
+   void               SubmitToBatch(FABRIKBatchSolver& batchSolver, const Transform& modelTransform, Pose& pose, const glm::vec3& ankleTargetPosition);
+   void               RetrieveFromBatch(const FABRIKBatchSolver& batchSolver, const Transform& modelTransform, Pose& pose, bool constrained);
 
    unsigned int       GetHipIndex();
    unsigned int       GetKneeIndex();
@@ -20,20 +33,39 @@ public:
    unsigned int       GetToeIndex();
 
    void               SetAnkleOffset(float ankleOffset);
+   void               SetWarmStartThreshold(float warmStartThreshold);
+
+   // This function writes the hip, knee and ankle of the solved chain into a pose, which is all that changes when a leg is solved
+   void               ApplySolvedChainToPose(Pose& pose) const;
 
-   const Pose&        GetAdjustedPose();
+   // This function returns the number of iterations that the last solve needed
+   unsigned int       GetNumberOfIterationsOfLastSolve() const;
 
 private:
 
-   unsigned int mHipIndex;
-   unsigned int mKneeIndex;
-   unsigned int mAnkleIndex;
-   unsigned int mToeIndex;
+   unsigned int    mHipIndex;
+   unsigned int    mKneeIndex;
+   unsigned int    mAnkleIndex;
+   unsigned int    mToeIndex;
+
+   float           mAnkleToGroundOffset;
+
+   unsigned int    mIndexInBatch;
+
+   FABRIKSolver    mSolver;
+   TwoBoneIKSolver mTwoBoneSolver;
 
-   float        mAnkleToGroundOffset;
+   // The local transforms of the joints of the solved chain
+   // Note that the local transform of the hip is relative to its parent in the pose, not to the world
+   Transform       mSolvedLocalTransfOfHip;
+   Transform       mSolvedLocalTransfOfKnee;
+   Transform       mSolvedLocalTransfOfAnkle;
+   unsigned int    mNumIterationsOfLastSolve;
 
-   FABRIKSolver mSolver;
-   Pose         mIKPose;
+   // The target of the last frame is stored in the space of the parent of the hip, so that the movement of the character doesn't prevent warm starts
+   glm::vec3       mPrevTargetInSpaceOfParentOfHip;
+   bool            mHasPrevSolution;
+   float           mWarmStartThreshold;
 };
 
 #endif
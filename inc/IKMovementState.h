@@ -6,20 +6,25 @@
 #include "window.h"
 #include "texture.h"
 #include "AnimatedMesh.h"
+#include "StaticMesh.h"
 #include "SkeletonViewerClipped.h"
 #include "Clip.h"
-#include "IKLeg.h"
+#include "AssetLoader.h"
+#include "FootPlacementSystem.h"
 #include "IKCrossFadeController.h"
 #include "Camera3.h"
 #include "Water.h"
 #include "Sky.h"
+#include "Frustum.h"
+#include "HeightQueryGrid.h"
 
 class IKMovementState : public State
 {
 public:
 
    IKMovementState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
-                   const std::shared_ptr<Window>&             window);
+                   const std::shared_ptr<Window>&             window,
+                   const std::shared_ptr<AssetLoader>&        assetLoader);
    ~IKMovementState() = default;
 
    IKMovementState(const IKMovementState&) = delete;
@@ -43,7 +48,11 @@ private:
    void switchFromGPUToCPU();
    void switchFromCPUToGPU();
 
-   void renderScene(const glm::vec2& horizontalClippingPlaneYNormalAndHeight, const glm::mat4& viewMat, const glm::mat4 perspMat, bool renderWater);
+   void renderScene(const glm::vec2& horizontalClippingPlaneYNormalAndHeight, const glm::mat4& viewMat, const glm::mat4 perspMat, bool renderWater, unsigned int minLODIndex);
+
+   bool isVisible(const Frustum& frustum, const AABB& worldBounds);
+
+   unsigned int selectLOD(const std::vector<float>& lodErrors, const AABB& worldBounds, const glm::vec3& cameraPosition, const glm::mat4& perspMat, unsigned int minLODIndex);
 
    void userInterface();
 
@@ -51,6 +60,10 @@ private:
 
    void resetCamera();
 
+   const FastClip* getClip(const std::string& name);
+   void releaseClipsThatAreNotPlaying();
+   void prefetchNextClips();
+
    std::shared_ptr<FiniteStateMachine> mFSM;
 
    std::shared_ptr<Window>             mWindow;
@@ -68,6 +81,8 @@ private:
    std::shared_ptr<Shader>   mStaticMeshShader;
    std::shared_ptr<Texture>  mDiffuseTexture;
 
+   std::shared_ptr<const CharacterAsset> mCharacter;
+
    Skeleton                  mSkeleton;
    std::vector<AnimatedMesh> mAnimatedMeshes;
    SkeletonViewerClipped     mSkeletonViewer;
@@ -84,6 +99,14 @@ private:
    bool                      mWireframeModeForTerrain;
    bool                      mPerformDepthTesting;
 #endif
+   bool                      mPerformFrustumCulling;
+   bool                      mPerformLODSelection;
+   float                     mMaxScreenSpaceErrorInPix;
+   int                       mWaterPassLODBias;
+   bool                      mSolveAnalytically;
+   bool                      mSolveInBatch;
+   bool                      mWarmStartIK;
+   float                     mAverageIKIterationsPerFrame;
    bool                      mSolveWithConstraints;
    int                       mSelectedNumberOfIterations;
    float                     mSelectedEmissiveTextureBrightnessScaleFactor;
@@ -91,13 +114,22 @@ private:
 
    // --- --- ---
 
-   std::map<std::string, FastClip>    mClips;
-   std::map<std::string, ScalarTrack> mLeftFootPinTracks;
-   std::map<std::string, ScalarTrack> mRightFootPinTracks;
+   // The clips are loaded on demand by the clip library of the character, and the state holds the handles of the ones that it's playing
+   // so that they aren't evicted
+   // The jumps don't loop in this state, so it uses its own copies of them instead of the shared ones
+   std::map<std::string, std::shared_ptr<const FastClip>> mClipsInUse;
+   FastClip                                               mJumpClip;
+   FastClip                                               mJump2Clip;
+   std::map<std::string, ScalarTrack>     mLeftFootPinTracks;
+   std::map<std::string, ScalarTrack>     mRightFootPinTracks;
 
    FastIKCrossFadeController mIKCrossFadeController;
    std::vector<glm::mat4>    mPosePalette;
    std::vector<glm::mat4>    mSkinMatrices;
+   std::vector<AABB>         mAnimatedMeshWorldBounds;
+   unsigned int              mNumMeshesSubmitted;
+   unsigned int              mNumMeshesCulled;
+   unsigned int              mCharacterLODIndex;
 
    Transform                 mModelTransform;
    float                     mCharacterWalkingSpeed = 4.0f;
@@ -113,13 +145,18 @@ private:
 
    // --- --- ---
 
-   std::vector<AnimatedMesh> mGroundMeshes;
+   std::vector<StaticMesh>   mGroundMeshes;
    std::shared_ptr<Texture>  mGroundDiffuseTexture;
    std::shared_ptr<Texture>  mGroundEmissiveTexture;
-   std::vector<Triangle>     mGroundTriangles;
+   HeightQueryGrid           mGroundHeightGrid;
 
-   IKLeg                     mLeftLeg;
-   IKLeg                     mRightLeg;
+   // The root has its own probe, so that it can remember the last triangle it hit
+   // The probes of the feet are stored along with the legs in mFootPlacementCharacter
+   GroundProbe               mRootGroundProbe;
+
+   FootPlacementCharacter    mFootPlacementCharacter;
+   // This system could place the feet of a whole crowd of characters, but here it only places the ones of our character
+   FootPlacementSystem       mFootPlacementSystem;
 
    float                     mHeightOfOriginOfYPositionRay;
    float                     mPreviousYPositionOfCharacter;
@@ -129,9 +166,6 @@ private:
    float                     mDistanceFromAnkleToToe;
    float                     mAnkleVerticalOffset;
 
-   glm::vec3                 mLeftAnkleFinalTarget;
-   glm::vec3                 mRightAnkleFinalTarget;
-
    Water                     mWater;
    Sky                       mSky;
 
@@ -141,6 +175,8 @@ private:
 
    void determineYPosition();
 
+   FootPlacementSettings getFootPlacementSettings() const;
+
    glm::mat4 calculateReflectionViewMatrix();
 };
 
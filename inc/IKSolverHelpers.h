@@ -0,0 +1,12 @@
+#ifndef IK_SOLVER_HELPERS_H
+#define IK_SOLVER_HELPERS_H
+
+// This function returns true if an iteration of an iterative IK solver (CCD or FABRIK) barely moved the end effector towards the goal,
+// which happens when the goal is out of reach, so the solver can stop iterating
+// An iteration has stalled when the distance to the goal shrank by less than minImprovementPerIteration, which is a fraction of the previous distance
+// An iteration that made things worse doesn't count as a stall, since the constraints can push the end effector away from the goal
+// for an iteration or two before it starts moving towards it again
+// A minImprovementPerIteration of zero disables this kind of termination
+bool HasIKSolverStalled(float squaredDistToGoal, float prevSquaredDistToGoal, float minImprovementPerIteration);
+
+#endif
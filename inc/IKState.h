@@ -11,10 +11,13 @@
 #endif
 #include "texture.h"
 #include "AnimatedMesh.h"
+#include "StaticMesh.h"
 #include "SkeletonViewer.h"
 #include "Clip.h"
-#include "Triangle.h"
+#include "AssetLoader.h"
 #include "IKLeg.h"
+#include "Frustum.h"
+#include "HeightQueryGrid.h"
 
 class IKState : public State
 {
@@ -22,10 +25,12 @@ public:
 
 #ifdef USE_THIRD_PERSON_CAMERA
    IKState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
-           const std::shared_ptr<Window>&             window);
+           const std::shared_ptr<Window>&             window,
+           const std::shared_ptr<AssetLoader>&        assetLoader);
 #else
    IKState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
            const std::shared_ptr<Window>&             window,
+           const std::shared_ptr<AssetLoader>&        assetLoader,
            const std::shared_ptr<Camera>&             camera);
 #endif
    ~IKState() = default;
@@ -51,6 +56,8 @@ private:
    void switchFromGPUToCPU();
    void switchFromCPUToGPU();
 
+   bool isVisible(const Frustum& frustum, const AABB& worldBounds);
+
    void userInterface();
 
    void resetScene();
@@ -86,6 +93,9 @@ private:
       unsigned int           currentClipIndex;
       SkinningMode           currentSkinningMode;
 
+      // The handle of the current clip keeps the clip library from evicting it
+      std::shared_ptr<const FastClip> currentClip;
+
       float                  playbackTime;
       Pose                   animatedPose;
       std::vector<glm::mat4> animatedPosePalette;
@@ -96,10 +106,11 @@ private:
    std::shared_ptr<Shader>   mStaticMeshShader;
    std::shared_ptr<Texture>  mDiffuseTexture;
 
+   std::shared_ptr<const CharacterAsset> mCharacter;
+
    Skeleton                  mSkeleton;
    std::vector<AnimatedMesh> mAnimatedMeshes;
    SkeletonViewer            mSkeletonViewer;
-   std::vector<FastClip>     mClips;
    std::string               mClipNames;
    int                       mSelectedState;
    int                       mSelectedClip;
@@ -114,20 +125,30 @@ private:
    bool                      mWireframeModeForTerrain;
    bool                      mPerformDepthTesting;
 #endif
+   bool                      mPerformFrustumCulling;
+   bool                      mSolveAnalytically;
+   bool                      mSolveInBatch;
+   bool                      mWarmStartIK;
+   float                     mAverageIKIterationsPerFrame;
    bool                      mSolveWithConstraints;
    int                       mSelectedNumberOfIterations;
 
    AnimationData             mAnimationData;
+   std::vector<AABB>         mAnimatedMeshWorldBounds;
+   unsigned int              mNumMeshesSubmitted;
+   unsigned int              mNumMeshesCulled;
 
    // --- --- ---
 
-   std::vector<AnimatedMesh> mGroundMeshes;
+   std::vector<StaticMesh>   mGroundMeshes;
    std::shared_ptr<Texture>  mGroundTexture;
-   std::vector<Triangle>     mGroundTriangles;
+   HeightQueryGrid           mGroundHeightGrid;
 
    VectorTrack               mMotionTrack;
    IKLeg                     mLeftLeg;
    IKLeg                     mRightLeg;
+   // Both legs can be solved together by this solver, which would also be shared by all the characters of a crowd
+   FABRIKBatchSolver         mLegBatchSolver;
    ScalarTrack               mLeftFootPinTrack;
    ScalarTrack               mRightFootPinTrack;
 
@@ -0,0 +1,80 @@
+#ifndef INDEXED_TRIANGLE_STORE_H
+#define INDEXED_TRIANGLE_STORE_H
+
+#include <vector>
+
+#include "Triangle.h"
+#include "StaticMesh.h"
+
+/*
+   The TriangleView class lets us read the triangles of a mesh without copying its positions and indices
+   It only stores pointers to the arrays of the mesh, so the mesh must outlive the view and it must not be modified while the view is in use
+
+   If the mesh doesn't have indices, each sequential set of 3 positions makes up a triangle, just like in GetTrianglesFromMesh
+*/
+
+class TriangleView
+{
+public:
+
+   TriangleView();
+   TriangleView(const StaticMesh& mesh);
+   TriangleView(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices);
+
+   unsigned int      GetNumberOfTriangles() const;
+   unsigned int      GetNumberOfVertices() const;
+
+   const glm::vec3&  GetPosition(unsigned int vertexIndex) const;
+   glm::uvec3        GetIndicesOfTriangle(unsigned int triangleIndex) const;
+   Triangle          GetTriangle(unsigned int triangleIndex) const;
+
+private:
+
+   const glm::vec3*    mPositions;
+   const unsigned int* mIndices;
+   unsigned int        mNumVertices;
+   unsigned int        mNumTriangles;
+};
+
+/*
+   The IndexedTriangleStore class stores the triangles that the acceleration structures are built from
+
+   A Triangle stores its three vertices and its normal, which adds up to 48 bytes, and the vertices that are shared by neighboring triangles are stored many times
+   This class stores each vertex once and each triangle as three 4-byte indices, so a triangle costs 12 bytes plus its share of the vertices:
+
+   mPositions: | v0 | v1 | v2 | v3 | v4 | ...
+   mTriangles: | 0 1 2 | 2 1 3 | 3 1 4 | ...
+
+   It's filled straight from the arrays of the meshes, so the positions and indices of a mesh are only copied once, into their final place
+   The normal of a triangle is calculated when the triangle is requested, so it's always identical to the one that the Triangle constructor would calculate
+*/
+
+class IndexedTriangleStore
+{
+public:
+
+   IndexedTriangleStore();
+
+   void              Build(const std::vector<StaticMesh>& meshes);
+
+   void              Clear();
+   void              Reserve(unsigned int numVertices, unsigned int numTriangles);
+   void              AddTriangles(const TriangleView& view);
+
+   unsigned int      GetNumberOfTriangles() const;
+   unsigned int      GetNumberOfVertices() const;
+
+   const glm::vec3&  GetPosition(unsigned int vertexIndex) const;
+   const glm::uvec3& GetIndicesOfTriangle(unsigned int triangleIndex) const;
+   Triangle          GetTriangle(unsigned int triangleIndex) const;
+
+   // This function returns the number of bytes that are used by the positions and the indices
+   size_t            GetSizeInBytes() const;
+
+private:
+
+   std::vector<glm::vec3>  mPositions;
+   std::vector<glm::uvec3> mTriangles;
+};
+
+#endif
@@ -5,11 +5,24 @@
 
 #include "Ray.h"
 #include "Triangle.h"
-#include "AnimatedMesh.h"
+#include "StaticMesh.h"
 
 bool DoesRayIntersectTriangle(const Ray& ray, const Triangle& triangle, glm::vec3& hitPoint);
+bool DoesRayIntersectTriangle(const Ray& ray, const Triangle& triangle, glm::vec3& hitPoint, float& distAlongRayToHit);
+bool DoesRayIntersectTriangle(const Ray& ray, const PrecomputedTriangle& triangle, glm::vec3& hitPoint, float& distAlongRayToHit);
 
-std::vector<Triangle> GetTrianglesFromMesh(AnimatedMesh& mesh);
-std::vector<Triangle> GetTrianglesFromMeshes(std::vector<AnimatedMesh>& mesh);
+glm::vec3 CalculateClosestPointOnTriangle(const glm::vec3& point, const Triangle& triangle);
+// This function returns the squared distance between the closest points
+float CalculateClosestPointsBetweenSegments(const glm::vec3& start1, const glm::vec3& end1, const glm::vec3& start2, const glm::vec3& end2,
+                                            glm::vec3& outClosestPoint1, glm::vec3& outClosestPoint2);
+
+// The time of impact is the fraction of the displacement that the sphere can travel before it touches the triangle
+bool SweepSphereAgainstTriangle(const glm::vec3& start, const glm::vec3& displacement, float radius, const Triangle& triangle,
+                                float& outTimeOfImpact, glm::vec3& outContactPoint);
+bool OverlapCapsuleWithTriangle(const glm::vec3& segmentStart, const glm::vec3& segmentEnd, float radius, const Triangle& triangle,
+                                glm::vec3& outContactPoint, glm::vec3& outNormal, float& outPenetrationDepth);
+
+std::vector<Triangle> GetTrianglesFromMesh(StaticMesh& mesh);
+std::vector<Triangle> GetTrianglesFromMeshes(std::vector<StaticMesh>& mesh);
 
 #endif
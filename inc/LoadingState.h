@@ -0,0 +1,73 @@
+#ifndef LOADING_STATE_H
+#define LOADING_STATE_H
+
+#include <chrono>
+#include <functional>
+
+#include "state.h"
+#include "finite_state_machine.h"
+#include "window.h"
+#include "AssetLoader.h"
+
+/*
+   The LoadingState is the first state of the FSM, and it's what lets the first frame appear right away
+
+   Creating the other states takes a long time, because they load characters, textures and meshes, compile shaders and build acceleration
+   structures, so instead of creating them before the first frame, the LoadingState creates them over several frames:
+
+   - While the AssetLoader loads the assets that were requested in Game::initialize on its worker threads, the LoadingState only draws
+     a progress bar
+   - Once they have all been loaded, it creates the states, which receive their assets without waiting and upload them to the GPU
+     The states are created one after the other until the budget of the frame is exceeded, and the rest are created in the following frames
+     Since the constructor of a state can't be split, a frame always creates at least one state, even if that exceeds the budget
+
+   Once all the states have been created, the LoadingState releases the assets that are held by the AssetLoader and switches to the initial state
+*/
+
+class LoadingState : public State
+{
+public:
+
+   typedef std::function<std::shared_ptr<State>()> StateFactory;
+
+   LoadingState(const std::shared_ptr<FiniteStateMachine>&          finiteStateMachine,
+                const std::shared_ptr<Window>&                      window,
+                const std::shared_ptr<AssetLoader>&                 assetLoader,
+                std::vector<std::pair<std::string, StateFactory>>&& stateFactories,
+                const std::string&                                  initialStateID);
+   ~LoadingState() = default;
+
+   LoadingState(const LoadingState&) = delete;
+   LoadingState& operator=(const LoadingState&) = delete;
+
+   LoadingState(LoadingState&&) = delete;
+   LoadingState& operator=(LoadingState&&) = delete;
+
+   void enter() override;
+   void processInput(float deltaTime) override;
+   void update(float deltaTime) override;
+   void render() override;
+   void exit() override;
+
+private:
+
+   void userInterface();
+
+   std::shared_ptr<FiniteStateMachine>                mFSM;
+
+   std::shared_ptr<Window>                            mWindow;
+
+   std::shared_ptr<AssetLoader>                       mAssetLoader;
+
+   std::vector<std::pair<std::string, StateFactory>>  mStateFactories;
+   unsigned int                                       mNumCreatedStates;
+   std::string                                        mInitialStateID;
+
+   // The time that the LoadingState can spend loading every frame
+   double                                             mBudgetPerFrameInMs;
+
+   std::chrono::steady_clock::time_point              mStartTime;
+   double                                             mTimeToLoadAssetsInMs;
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+
+/*
+   A MappedFile maps a whole file into memory as read-only
+
+   Mapping a file instead of reading it avoids copying its contents into a buffer that we allocate ourselves,
+   and the operating system only reads the pages that are actually touched
+   The baked assets (see BakedAsset.h) and the binary buffers of glTF files (see GLTFLoader.cpp) are read this way
+
+   Note that Emscripten implements mmap on top of its in-memory file system by copying the file, so in the web build
+   mapping a file is only as expensive as reading it
+*/
+
+class MappedFile
+{
+public:
+
+   MappedFile();
+   ~MappedFile();
+
+   MappedFile(const MappedFile&) = delete;
+   MappedFile& operator=(const MappedFile&) = delete;
+
+   MappedFile(MappedFile&&) = delete;
+   MappedFile& operator=(MappedFile&&) = delete;
+
+   // This function fails for empty files, since they can't be mapped
+   bool        Open(const char* path);
+   void        Close();
+
+   const char* GetData() const;
+   size_t      GetSize() const;
+
+private:
+
+   const char* mData;
+   size_t      mSize;
+#ifdef _WIN32
+   // These are HANDLEs, which are stored as void pointers so that this header doesn't have to include windows.h
+   void*       mFile;
+   void*       mMapping;
+#endif
+};
+
+#endif
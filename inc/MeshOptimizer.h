@@ -0,0 +1,54 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <vector>
+
+#include "AnimatedMesh.h"
+#include "StaticMesh.h"
+
+/*
+   The functions below optimize the index and vertex buffers of a mesh at load time so that the GPU has to do less work when rendering it.
+
+   When a GPU renders an indexed mesh, it keeps a small cache of the vertices it has recently transformed (the post-transform vertex cache)
+   If the index of the vertex it needs next is in that cache, it can skip running the vertex shader for it
+   The order of the triangles in the index buffer determines how often that happens, so we reorder them to maximize cache hits
+
+   Two metrics are used to measure the efficiency of an index buffer:
+
+   - ACMR (Average Cache Miss Ratio)         = Number of vertex shader invocations / Number of triangles
+   - ATVR (Average Transformed Vertex Ratio) = Number of vertex shader invocations / Number of vertices
+
+   The best possible ACMR is around 0.5 for a regular grid, and the worst is 3.0 (every vertex of every triangle is a miss)
+   The best possible ATVR is 1.0 (every vertex is transformed exactly once)
+
+   Once the triangles are reordered, we also reorder the vertices so that they appear in memory in the same order in which they are first
+   referenced by the index buffer, which improves the locality of the vertex fetches
+*/
+
+struct VertexCacheStatistics
+{
+   VertexCacheStatistics()
+      : ACMR(0.0f)
+      , ATVR(0.0f)
+   {
+
+   }
+
+   float ACMR;
+   float ATVR;
+};
+
+VertexCacheStatistics     AnalyzeVertexCache(const std::vector<unsigned int>& indices, unsigned int numVertices, unsigned int cacheSize);
+
+std::vector<unsigned int> OptimizeVertexCache(const std::vector<unsigned int>& indices, unsigned int numVertices);
+std::vector<unsigned int> GenerateVertexFetchRemap(const std::vector<unsigned int>& indices, unsigned int numVertices);
+
+void                      OptimizeMesh(AnimatedMesh& mesh);
+void                      OptimizeMesh(StaticMesh& mesh);
+
+// This function measures how much OptimizeVertexCache improves the ACMR and ATVR of an index buffer whose triangles are in a random order,
+// and compares the result with the original order of the given index buffer
+// It's used by the benchmark mode (see Benchmarks.h) instead of reporting the statistics of every mesh that is loaded
+void                      BenchmarkMeshOptimizer(const std::vector<unsigned int>& indices, unsigned int numVertices);
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "AnimatedMesh.h"
+#include "StaticMesh.h"
+
+/*
+   The functions below generate a chain of levels of detail (LODs) for a mesh at load time
+
+   Each LOD is produced with the quadric error metric (QEM) of Garland and Heckbert:
+
+   - Every triangle defines a plane, and the squared distance from a point to that plane can be written as a quadratic form (a quadric)
+   - Each vertex starts with the sum of the quadrics of the triangles that touch it, so evaluating its quadric at a point tells us
+     how far that point is from the surface that surrounded the vertex in the original mesh
+   - The edges are then collapsed in order of increasing error until the mesh has as many triangles as we want,
+     and the quadric of a vertex that absorbs another one becomes the sum of both quadrics
+
+   We only ever collapse a vertex onto one of its neighbours (a half-edge collapse), so the vertices of every LOD are a subset of the
+   vertices of the original mesh. This has two big advantages:
+
+   - All the LODs can share the vertex buffers of the original mesh, so a LOD is just an extra range of indices
+   - The attributes of the vertices are never interpolated, so the weights and influences of skinned meshes are preserved exactly
+
+   glTF meshes often duplicate vertices along UV seams and hard edges, so the collapses are calculated on a welded version of the mesh
+   where all the vertices that share a position are treated as one. When a welded vertex is collapsed, each of the triangle corners that
+   referenced it is moved to the duplicate of the target vertex whose normal and texture coordinates are the most similar to its own
+*/
+
+std::vector<unsigned int> SimplifyMesh(const std::vector<unsigned int>& indices,
+                                       const std::vector<glm::vec3>&    positions,
+                                       const std::vector<glm::vec3>&    normals,
+                                       const std::vector<glm::vec2>&    texCoords,
+                                       const std::vector<glm::vec4>&    weights,
+                                       const std::vector<glm::ivec4>&   influences,
+                                       unsigned int                     targetIndexCount,
+                                       float                            maxError,
+                                       float&                           resultError);
+
+void                      GenerateLODs(AnimatedMesh& mesh);
+void                      GenerateLODs(StaticMesh& mesh);
+
+// This function returns the coarsest LOD whose error, once projected onto the screen, is smaller than maxScreenSpaceErrorInPix
+// The result is never finer than minLODIndex, which allows render passes that don't need much detail to force a coarser LOD
+unsigned int              SelectLOD(const std::vector<float>& lodErrors,
+                                    float                     distanceToCamera,
+                                    float                     pixelsPerUnitAtUnitDistance,
+                                    float                     maxScreenSpaceErrorInPix,
+                                    unsigned int              minLODIndex);
+
+// This function measures how long it takes to generate the LODs of a mesh and reports the number of triangles and the error of each one
+// It's used by the benchmark mode (see Benchmarks.h) instead of reporting the LODs of every mesh that is loaded
+void                      BenchmarkMeshSimplifier(AnimatedMesh& mesh);
+
+#endif
@@ -11,8 +11,10 @@
 #endif
 #include "texture.h"
 #include "AnimatedMesh.h"
+#include "StaticMesh.h"
 #include "SkeletonViewer.h"
 #include "Clip.h"
+#include "AssetLoader.h"
 
 class ModelViewerState : public State
 {
@@ -20,10 +22,12 @@ public:
 
 #ifdef USE_THIRD_PERSON_CAMERA
    ModelViewerState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
-                    const std::shared_ptr<Window>&             window);
+                    const std::shared_ptr<Window>&             window,
+                    const std::shared_ptr<AssetLoader>&        assetLoader);
 #else
    ModelViewerState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
                     const std::shared_ptr<Window>&             window,
+                    const std::shared_ptr<AssetLoader>&        assetLoader,
                     const std::shared_ptr<Camera>&             camera);
 #endif
    ~ModelViewerState() = default;
@@ -65,7 +69,7 @@ private:
    std::shared_ptr<Camera>             mCamera;
 #endif
 
-   std::vector<AnimatedMesh>           mGroundMeshes;
+   std::vector<StaticMesh>             mGroundMeshes;
    std::shared_ptr<Texture>            mGroundTexture;
    std::shared_ptr<Shader>             mGroundShader;
 
@@ -88,6 +92,9 @@ private:
       unsigned int           currentClipIndex;
       SkinningMode           currentSkinningMode;
 
+      // The handle of the current clip keeps the clip library from evicting it
+      std::shared_ptr<const FastClip> currentClip;
+
       float                  playbackTime;
       Pose                   animatedPose;
       std::vector<glm::mat4> animatedPosePalette;
@@ -99,10 +106,11 @@ private:
    std::shared_ptr<Shader>   mStaticMeshShader;
    std::shared_ptr<Texture>  mDiffuseTexture;
 
+   std::shared_ptr<const CharacterAsset> mCharacter;
+
    Skeleton                  mSkeleton;
    std::vector<AnimatedMesh> mAnimatedMeshes;
    SkeletonViewer            mSkeletonViewer;
-   std::vector<FastClip>     mClips;
    std::string               mClipNames;
    int                       mSelectedState;
    int                       mSelectedClip;
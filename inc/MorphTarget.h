@@ -0,0 +1,36 @@
+#ifndef MORPH_TARGET_H
+#define MORPH_TARGET_H
+
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/*
+   A morph target (also known as a blend shape) describes a deformed version of a mesh as a set of displacements of its vertices
+   The final shape of the mesh is calculated like this:
+
+   finalPosition = bindPosition + (weight0 * delta0) + (weight1 * delta1) + ... + (weightN * deltaN)
+
+   glTF stores a delta for every vertex of the mesh, but most morph targets only displace a small part of it
+   (e.g. a smile only moves the vertices around the mouth), so we only store the deltas of the vertices that move:
+
+   vertexIndices:  |  12  |  13  |  27  | ...
+   positionDeltas: | d12  | d13  | d27  | ...
+   normalDeltas:   | n12  | n13  | n27  | ...
+
+   That way the cost of applying a morph target is proportional to the number of vertices that it displaces instead of the size of the mesh
+
+   The deltas are stored as vec4s with a W of zero so that each one can be added to a vec3 with a single 4-wide SIMD instruction
+   The vertex indices are sorted, which makes the accesses to the positions and normals of the mesh as linear as possible
+*/
+
+struct MorphTarget
+{
+   std::string               name;
+   std::vector<unsigned int> vertexIndices;
+   std::vector<glm::vec4>    positionDeltas;
+   std::vector<glm::vec4>    normalDeltas;
+};
+
+#endif
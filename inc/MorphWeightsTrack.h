@@ -0,0 +1,48 @@
+#ifndef MORPH_WEIGHTS_TRACK_H
+#define MORPH_WEIGHTS_TRACK_H
+
+#include <vector>
+
+#include "Track.h"
+
+// A glTF file animates the weights of the morph targets of a mesh through a channel whose path is "weights"
+// Each key frame of such a channel contains one weight for each morph target, so we split it into one scalar track per morph target
+// TODO: If we unify the Track and FastTrack classes, this wouldn't have to be a template anymore
+//       and we could delete the OptimizeMorphWeightsTrack function
+template <typename STRACK>
+class TMorphWeightsTrack
+{
+public:
+
+   TMorphWeightsTrack();
+
+   unsigned int GetNodeID() const;
+   void         SetNodeID(unsigned int id);
+
+   unsigned int GetNumberOfTargets() const;
+   void         SetNumberOfTargets(unsigned int numTargets);
+
+   STRACK&      GetWeightTrack(unsigned int targetIndex);
+   void         SetWeightTrack(unsigned int targetIndex, const STRACK& weightTrack);
+
+   float        GetStartTime() const;
+   float        GetEndTime() const;
+
+   bool         IsValid() const;
+
+   void         Sample(std::vector<float>& ioWeights, float time, bool looping) const;
+
+private:
+
+   // Each MorphWeightsTrack stores the ID of the node whose mesh it animates
+   unsigned int        mNodeID;
+
+   std::vector<STRACK> mWeightTracks;
+};
+
+typedef TMorphWeightsTrack<ScalarTrack>     MorphWeightsTrack;
+typedef TMorphWeightsTrack<FastScalarTrack> FastMorphWeightsTrack;
+
+FastMorphWeightsTrack OptimizeMorphWeightsTrack(MorphWeightsTrack& morphWeightsTrack);
+
+#endif
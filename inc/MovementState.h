@@ -6,17 +6,21 @@
 #include "window.h"
 #include "texture.h"
 #include "AnimatedMesh.h"
+#include "StaticMesh.h"
 #include "SkeletonViewer.h"
 #include "Clip.h"
+#include "AssetLoader.h"
 #include "CrossFadeControllerMultiple.h"
 #include "Camera3.h"
+#include "Frustum.h"
 
 class MovementState : public State
 {
 public:
 
    MovementState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
-                 const std::shared_ptr<Window>&             window);
+                 const std::shared_ptr<Window>&             window,
+                 const std::shared_ptr<AssetLoader>&        assetLoader);
    ~MovementState() = default;
 
    MovementState(const MovementState&) = delete;
@@ -40,19 +44,27 @@ private:
    void switchFromGPUToCPU();
    void switchFromCPUToGPU();
 
+   bool isVisible(const Frustum& frustum, const AABB& worldBounds);
+
+   unsigned int selectLOD(const std::vector<float>& lodErrors, const AABB& worldBounds);
+
    void userInterface();
 
    void resetScene();
 
    void resetCamera();
 
+   const FastClip* getClip(const std::string& name);
+   void releaseClipsThatAreNotPlaying();
+   void prefetchNextClips();
+
    std::shared_ptr<FiniteStateMachine> mFSM;
 
    std::shared_ptr<Window>             mWindow;
 
    Camera3                             mCamera3;
 
-   std::vector<AnimatedMesh>           mGroundMeshes;
+   std::vector<StaticMesh>             mGroundMeshes;
    std::shared_ptr<Texture>            mGroundTexture;
 
    enum SkinningMode : int
@@ -65,6 +77,8 @@ private:
    std::shared_ptr<Shader>   mStaticMeshShader;
    std::shared_ptr<Texture>  mDiffuseTexture;
 
+   std::shared_ptr<const CharacterAsset> mCharacter;
+
    Skeleton                  mSkeleton;
    std::vector<AnimatedMesh> mAnimatedMeshes;
    SkeletonViewer            mSkeletonViewer;
@@ -83,14 +97,26 @@ private:
    bool                      mWireframeModeForJoints;
    bool                      mPerformDepthTesting;
 #endif
+   bool                      mPerformFrustumCulling;
+   bool                      mPerformLODSelection;
+   float                     mMaxScreenSpaceErrorInPix;
 
    // --- --- ---
 
-   std::map<std::string, FastClip> mClips;
+   // The clips are loaded on demand by the clip library of the character, and the state holds the handles of the ones that it's playing
+   // so that they aren't evicted
+   // The jumps don't loop in this state, so it uses its own copies of them instead of the shared ones
+   std::map<std::string, std::shared_ptr<const FastClip>> mClipsInUse;
+   FastClip                                               mJumpClip;
+   FastClip                                               mJump2Clip;
 
    FastCrossFadeControllerMultiple mCrossFadeController;
    std::vector<glm::mat4>          mPosePalette;
    std::vector<glm::mat4>          mSkinMatrices;
+   std::vector<AABB>               mAnimatedMeshWorldBounds;
+   unsigned int                    mNumMeshesSubmitted;
+   unsigned int                    mNumMeshesCulled;
+   unsigned int                    mCharacterLODIndex;
 
    Transform                       mModelTransform;
    float                           mCharacterWalkingSpeed = 4.0f;
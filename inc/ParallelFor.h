@@ -0,0 +1,34 @@
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <functional>
+
+/*
+   ParallelFor runs a task once for every index from 0 to numTasks - 1, spreading the indices across the threads that are available to help
+
+   It's meant for the independent parts of loading an asset (e.g. optimizing each clip of a character), which are too coarse to be split any further
+   and too few to be worth queueing as separate jobs in the AssetLoader
+
+   ParallelFor doesn't create any threads of its own, since it's called from the jobs of the AssetLoader, whose worker threads already occupy every core
+   Instead, it hands helpers to the task scheduler of the calling thread, which the AssetLoader sets while it runs a job (see AssetLoader.h)
+   The scheduler queues the helpers as jobs, so they run on the worker threads that are idle, while the busy ones keep loading other assets
+   The calling thread runs tasks too, and each thread takes the next index that hasn't been taken yet,
+   so a long task doesn't hold up the shorter ones that come after it, and the calling thread finishes the tasks on its own if no helper ever starts
+   ParallelFor returns once every task has finished, and a helper that starts after that returns right away
+
+   The tasks must not write to anything that another task reads or writes, except through their own index (e.g. into their own element of a vector)
+
+   If the calling thread doesn't have a task scheduler (e.g. the web build, where the AssetLoader doesn't have any worker threads, or the asset baker),
+   the tasks run one after the other on the calling thread
+*/
+
+typedef std::function<void(std::function<void()>&&)> TaskScheduler;
+
+// This function sets the scheduler that ParallelFor uses on the calling thread, which can be a nullptr, and returns the previous one
+// The scheduler must outlive the tasks that it runs
+const TaskScheduler* SetTaskScheduler(const TaskScheduler* scheduler);
+
+// If maxNumThreads is 0, up to one thread per core is used, including the calling thread
+void ParallelFor(unsigned int numTasks, const std::function<void(unsigned int)>& task, unsigned int maxNumThreads = 0);
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef SEGMENTED_CLIP_H
+#define SEGMENTED_CLIP_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Clip.h"
+
+/*
+   A SegmentedClip stores a long clip (e.g. a motion capture take that lasts several minutes) as a sequence of segments of a fixed duration
+
+   A FastClip stores the frames of each track contiguously, so sampling it touches the frames and the sample to frame index map of the whole take,
+   even though only a few frames around the sampled time are needed
+   A SegmentedClip splits every track at the same times instead:
+
+   Clip:     |f f f f f f f f f f f f f f f f f f f f f f f f f f f f f f f f f f f f|
+   Segments: |f f f f f f f f f f f f f|
+                                   |f f f f f f f f f f f f f f|
+                                                              |f f f f f f f f f f f|
+
+   Each segment is self-contained: it stores the frames of every track that fall within it, along with the last frame before it and the first frame after it,
+   so that any time within the segment can be interpolated without looking at the other segments
+
+   The frames of each segment are compressed independently of the other segments
+   Each float of a frame (a value, a slope or the time) is quantized to 16 bits using the range that it covers over the frames of its track within the segment,
+   which halves the size of the frames, and the floats that don't change within a segment (e.g. the slopes of linear tracks) are stored exactly
+   The ranges are local to each segment, so they are small, and so is the quantization error
+
+   Sampling decompresses the segment that contains the sampled time into a FastClip that only covers that segment, and stores it in a SegmentCache
+   The cache is keyed by the clip and the index of the segment, so it can be shared by all the clips of a character and by all the characters
+   that play them, which means that a crowd that plays the same take decompresses each segment once
+   Once a segment is in the cache, sampling it costs the same as sampling a FastClip that is as long as the segment, no matter how long the take is
+
+   For now, SegmentedClip is only used by the benchmark mode (see Benchmarks.h): BenchmarkSegmentedClip builds a long take by repeating the walking clip,
+   and it compares the memory and the sampling cost of that take when it's stored as a FastClip and as a SegmentedClip
+
+   The tracks of a segment are never sampled outside of it, so they are sampled without looping
+   This matches the FastClip as long as each track covers the whole clip, which is the case for the clips of a motion capture take
+*/
+
+class SegmentCache;
+
+class SegmentedClip
+{
+public:
+
+   SegmentedClip();
+
+   // The clip isn't modified, but the tracks of a FastClip can only be accessed through non-const references
+   SegmentedClip(FastClip& clip, float segmentDuration, const std::shared_ptr<SegmentCache>& cache);
+
+   unsigned int GetID() const;
+
+   unsigned int GetNumberOfSegments() const;
+   float        GetSegmentDuration() const;
+
+   // This function returns the size of the compressed segments
+   size_t       GetSizeInBytes() const;
+
+   // This function decompresses a segment into a FastClip that covers its duration
+   // It's called by the SegmentCache when the segment isn't in it
+   FastClip     DecompressSegment(unsigned int segmentIndex) const;
+
+   std::string  GetName() const;
+   void         SetName(const std::string& name);
+
+   float        GetStartTime() const;
+   float        GetEndTime() const;
+   float        GetDuration() const;
+   bool         IsTimePastEnd(float time) const;
+
+   bool         GetLooping() const;
+   void         SetLooping(bool looping);
+
+   float        Sample(Pose& ioPose, float time) const;
+   void         SampleMorphWeights(unsigned int nodeID, std::vector<float>& ioWeights, float time) const;
+
+private:
+
+   struct CompressedTrack
+   {
+      uint32_t numFrames;
+      uint32_t interpolation;
+      uint32_t offsetOfRanges;
+      uint32_t offsetOfValues;
+   };
+
+   // The tracks of a segment are stored in the following order:
+   // The position, rotation and scale tracks of each transform track, followed by the weight tracks of each morph weights track
+   // Each track stores the minimum and the extent of each float of its frames in the ranges,
+   // and the quantized floats of its frames, one frame after the other, in the values
+   struct Segment
+   {
+      std::vector<CompressedTrack> tracks;
+      std::vector<float>           ranges;
+      std::vector<uint16_t>        values;
+   };
+
+   template <typename T, unsigned int N>
+   static void  CompressTrack(const FastTrack<T, N>& track, float segmentStartTime, float segmentEndTime, Segment& ioSegment);
+   template <typename T, unsigned int N>
+   static void  DecompressTrack(const Segment& segment, unsigned int trackIndex, FastTrack<T, N>& outTrack);
+
+   unsigned int GetSegmentIndex(float time) const;
+   float        AdjustTimeToBeWithinClip(float time) const;
+
+   unsigned int                  mID;
+   std::vector<unsigned int>     mJointIDs;
+   std::vector<unsigned int>     mNodeIDs;
+   std::vector<unsigned int>     mNumTargets;
+   std::vector<Segment>          mSegments;
+   std::shared_ptr<SegmentCache> mCache;
+   std::string                   mName;
+   float                         mStartTime;
+   float                         mEndTime;
+   float                         mSegmentDuration;
+   bool                          mLooping;
+};
+
+/*
+   A SegmentCache stores the decompressed segments of SegmentedClips, up to a maximum number of segments
+   Once it's full, it evicts the segment that was requested the longest time ago
+
+   The segments are returned through handles, so a segment that is evicted while it's being sampled stays alive until the sample is done
+   Like the ClipLibrary, a cache is only used by the main thread, so it's not thread-safe
+*/
+
+class SegmentCache
+{
+public:
+
+   SegmentCache(unsigned int maxNumSegments = defaultMaxNumSegments);
+
+   std::shared_ptr<const FastClip> GetSegment(const SegmentedClip& clip, unsigned int segmentIndex);
+
+   unsigned int                    GetNumberOfSegments() const;
+   unsigned int                    GetMaxNumberOfSegments() const;
+
+   unsigned long long              GetNumberOfHits() const;
+   unsigned long long              GetNumberOfMisses() const;
+
+   static const unsigned int       defaultMaxNumSegments = 64;
+
+private:
+
+   typedef std::pair<uint64_t, std::shared_ptr<const FastClip>> Entry;
+
+   // The most recently requested segment is at the front of the list
+   std::list<Entry>                                         mSegments;
+   std::unordered_map<uint64_t, std::list<Entry>::iterator> mSegmentsByKey;
+   unsigned int                                             mMaxNumSegments;
+   unsigned long long                                       mNumHits;
+   unsigned long long                                       mNumMisses;
+};
+
+// This function builds a take of the given duration by repeating a clip, stores it as a FastClip and as a SegmentedClip,
+// and prints their sizes, how long it takes to sample a window of the take with each of them, and the largest difference between their samples
+void BenchmarkSegmentedClip(FastClip& clip, const Pose& restPose, float durationOfTake, float segmentDuration);
+
+#endif
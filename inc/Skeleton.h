@@ -13,6 +13,8 @@ public:
    Skeleton(const Pose& restPose, const Pose& bindPose, const std::vector<std::string>& jointNames);
 
    void                      Set(const Pose& restPose, const Pose& bindPose, const std::vector<std::string>& jointNames);
+   // This function is identical to the one above, except that it uses an inverse bind pose that was calculated beforehand (e.g. by the asset baker)
+   void                      Set(const Pose& restPose, const Pose& bindPose, const std::vector<glm::mat4>& invBindPose, const std::vector<std::string>& jointNames);
 
    Pose&                     GetRestPose();
    Pose&                     GetBindPose();
@@ -2,12 +2,13 @@
 #define SKY_H
 
 #include "shader.h"
+#include "AssetLoader.h"
 
 class Sky
 {
 public:
 
-   Sky();
+   Sky(AssetLoader& assetLoader);
    ~Sky();
 
    void Render(const glm::mat4& projectionView);
@@ -15,7 +16,7 @@ public:
 private:
 
    void ConfigureVAO();
-   unsigned int LoadCubemap(const std::vector<std::string>& faces);
+   unsigned int LoadCubemap(AssetLoader& assetLoader, const std::vector<std::string>& faces);
 
    unsigned int             mSkyVAO;
    unsigned int             mSkyVBO;
@@ -0,0 +1,106 @@
+#ifndef STATIC_COLLISION_WORLD_H
+#define STATIC_COLLISION_WORLD_H
+
+#include <vector>
+
+#include "AABB.h"
+#include "IndexedTriangleStore.h"
+
+/*
+   The StaticCollisionWorld class answers the collision queries of a character controller against the static geometry of a scene,
+   like the platform of MovementState or the catwalk of IKState
+
+   HeightQueryGrid only answers downward rays, and TriangleBVH only answers rays, but a character is a volume that needs to find the ground under its feet
+   and the walls in front of it, so this class supports two volume queries:
+
+   - Sphere sweeps, which find the first triangle that a sphere touches when it moves from one point to another
+   - Capsule overlaps, which find all the triangles that a capsule touches and how far it needs to move to stop touching them
+
+   The space is divided into cubic cells, but instead of storing a 3D array of cells, which would be mostly empty for a scene made of floors and walls,
+   the cells are hashed into a fixed number of buckets, and each bucket stores the indices of the triangles whose bounds overlap the cells that map to it:
+
+   cell (x, y, z) -> hash(x, y, z) % numBuckets -> | bucket 0 | bucket 1 | bucket 2 | ... |
+                                                        |          |
+                                                        v          v
+                                                     t3, t7     t0, t1, t9
+
+   A query only visits the buckets of the cells that are overlapped by its bounds, so its cost depends on the size of the query instead of the size of the scene
+   Two cells can map to the same bucket, and a triangle can be stored in many buckets, so the triangles are tagged with the number of the query that tested them last,
+   which ensures that they are tested once per query, and they are always tested exactly, which means that collisions in the hash never change the results
+*/
+
+struct SweepHit
+{
+   // The fraction of the displacement that the sphere traveled before it touched the triangle
+   float        timeOfImpact;
+   glm::vec3    contactPoint;
+   // The normal points from the contact point towards the center of the sphere at the time of impact
+   glm::vec3    normal;
+   unsigned int triangleIndex;
+};
+
+struct OverlapContact
+{
+   glm::vec3    contactPoint;
+   // Moving the capsule along the normal by the penetration depth separates it from the triangle
+   glm::vec3    normal;
+   float        penetrationDepth;
+   unsigned int triangleIndex;
+};
+
+class StaticCollisionWorld
+{
+public:
+
+   StaticCollisionWorld();
+
+   void                Build(const std::vector<StaticMesh>& meshes);
+   void                Build(const IndexedTriangleStore& triangles);
+
+   // This function moves a sphere from start to end and returns the first triangle that it touches
+   // A ground query is a sweep that points down, and a wall query is a sweep that points in the direction in which the character is moving
+   bool                SweepSphere(const glm::vec3& start, const glm::vec3& end, float radius, SweepHit& outHit) const;
+
+   // This function returns the number of triangles that overlap the capsule, and it appends a contact to outContacts for each one of them
+   unsigned int        OverlapCapsule(const glm::vec3& segmentStart, const glm::vec3& segmentEnd, float radius, std::vector<OverlapContact>& outContacts) const;
+
+   Triangle            GetTriangle(unsigned int triangleIndex) const;
+   unsigned int        GetNumberOfTriangles() const;
+   unsigned int        GetNumberOfBuckets() const;
+   float               GetCellSize() const;
+   AABB                GetBounds() const;
+
+   // The number of triangles that were tested by the queries since the world was built, which tells us how well the hash is culling them
+   unsigned long long  GetNumberOfTrianglesTested() const;
+
+private:
+
+   // This function stores the indices of the triangles whose bounds might overlap the given bounds in mCandidateTriangleIndices
+   void                GatherCandidateTriangles(const AABB& bounds) const;
+
+   IndexedTriangleStore      mTriangles;
+   std::vector<AABB>         mTriangleBounds;
+
+   // The triangles of the buckets are stored one after the other, and mBucketOffsets stores where the triangles of each bucket start
+   // The triangles of bucket i are the ones between mBucketOffsets[i] and mBucketOffsets[i + 1]
+   std::vector<unsigned int> mBucketOffsets;
+   std::vector<unsigned int> mBucketTriangleIndices;
+
+   AABB                      mBounds;
+   float                     mCellSize;
+   float                     mInverseCellSize;
+   unsigned int              mNumBuckets;
+
+   // These members are modified by the queries, which is why they are mutable
+   // They make the queries unsafe to call from multiple threads at the same time
+   mutable std::vector<unsigned int> mQueryIndexOfTriangle;
+   mutable std::vector<unsigned int> mCandidateTriangleIndices;
+   mutable unsigned int              mQueryIndex;
+   mutable unsigned long long        mNumTrianglesTested;
+};
+
+// This function measures how many sphere sweeps and capsule overlaps per second the world can process compared to testing every triangle,
+// and prints the results along with the number of queries whose results didn't match between both methods
+void BenchmarkStaticCollisionWorld(const StaticCollisionWorld& world, unsigned int numQueries);
+
+#endif
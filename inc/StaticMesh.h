@@ -0,0 +1,102 @@
+#ifndef STATIC_MESH_H
+#define STATIC_MESH_H
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "AABB.h"
+
+/*
+   The StaticMesh class is used to represent meshes that are never skinned, like the ground.
+
+   Unlike an AnimatedMesh, a StaticMesh stores all the attributes of its vertices in a single interleaved vertex buffer:
+
+   | position | normal | texCoord | position | normal | texCoord | ...
+   |<--------- vertex 0 -------->|<--------- vertex 1 -------->|
+
+   This means that a single buffer is bound when the VAO is configured, and that all the attributes of a vertex
+   are next to each other in memory, which is friendlier to the vertex fetch hardware
+*/
+
+class StaticMesh
+{
+public:
+
+   StaticMesh();
+   ~StaticMesh();
+
+   StaticMesh(const StaticMesh&) = delete;
+   StaticMesh& operator=(const StaticMesh&) = delete;
+
+   StaticMesh(StaticMesh&& rhs) noexcept;
+   StaticMesh& operator=(StaticMesh&& rhs) noexcept;
+
+   std::vector<glm::vec3>&    GetPositions() { return mPositions; }
+   std::vector<glm::vec3>&    GetNormals()   { return mNormals;   }
+   std::vector<glm::vec2>&    GetTexCoords() { return mTexCoords; }
+   std::vector<unsigned int>& GetIndices()   { return mIndices;   }
+
+   const std::vector<glm::vec3>&    GetPositions() const { return mPositions; }
+   const std::vector<unsigned int>& GetIndices() const   { return mIndices;   }
+
+   // The indices of the LODs that are coarser than the original mesh and the errors that they introduce (see MeshSimplifier.h)
+   // LOD 0 is always the original mesh, so the LOD with index i is stored in mLODIndices[i - 1]
+   std::vector<std::vector<unsigned int>>& GetLODIndices() { return mLODIndices; }
+   std::vector<float>&                     GetLODErrors()  { return mLODErrors;  }
+
+   const std::vector<float>&  GetLODErrors() const { return mLODErrors; }
+   unsigned int               GetNumberOfLODs() const { return static_cast<unsigned int>(mLODIndices.size()) + 1; }
+
+   const AABB&                GetBounds() const { return mBounds; }
+
+   void                       CalculateBounds();
+
+   void                       LoadBuffers();
+
+   void                       ConfigureVAO(int posAttribLocation,
+                                           int normalAttribLocation,
+                                           int texCoordsAttribLocation);
+
+   void                       UnconfigureVAO(int posAttribLocation,
+                                             int normalAttribLocation,
+                                             int texCoordsAttribLocation);
+
+   void                       Render();
+   void                       RenderLOD(unsigned int lodIndex);
+   void                       RenderInstanced(unsigned int numInstances);
+
+private:
+
+   void                       LoadIndexBuffer();
+
+   void                       BindFloatAttribute(int attribLocation, int numComponents, unsigned int offset);
+   void                       UnbindAttribute(int attribLocation);
+
+   struct InterleavedVertex
+   {
+      glm::vec3 position;
+      glm::vec3 normal;
+      glm::vec2 texCoord;
+   };
+
+   std::vector<glm::vec3>    mPositions;
+   std::vector<glm::vec3>    mNormals;
+   std::vector<glm::vec2>    mTexCoords;
+   std::vector<unsigned int> mIndices;
+
+   std::vector<std::vector<unsigned int>> mLODIndices;
+   std::vector<float>                     mLODErrors;
+
+   // All the LODs are stored one after the other in the same index buffer, so we need to remember where each one starts
+   std::vector<unsigned int> mLODFirstIndices;
+
+   AABB                      mBounds;
+
+   unsigned int              mVAO;
+   unsigned int              mVBO;
+   unsigned int              mEBO;
+   bool                      mUse16BitIndices;
+};
+
+#endif
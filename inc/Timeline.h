@@ -0,0 +1,53 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <vector>
+
+/*
+   A Timeline stores the times of the frames of one or more FastTracks, along with the map of samples to frame indices that FastTrack uses to find its frames
+
+   The samplers of a glTF clip frequently share the same times: the translation, rotation and scale channels of a joint, and often the channels of every joint,
+   read their times from the same accessor
+   The tracks of such a clip have identical times, so they would find the same frame and calculate the same interpolation factor every time they are sampled,
+   and each of them would store an identical map
+
+   ShareTimelines (see Clip.h) gives the tracks of a clip whose times are identical a single Timeline, which means that:
+   - The clip stores one map per unique array of times instead of one map per track
+   - The Timeline remembers the frame index and the interpolation factor of the last time it was looked up with,
+     so when a clip is sampled, only the first track of each Timeline looks them up, and every other track that shares it reuses them
+
+   The frames still store their own times, since Track needs them and they are part of the baked assets, so the times of a Timeline are a copy of them
+   A Timeline is immutable once it's created, except for the result of its last lookup, which makes looking it up unsafe from multiple threads at the same time
+   That's fine because clips are only sampled by the main thread
+*/
+
+class Timeline
+{
+public:
+
+   Timeline(const std::vector<float>& times, const std::vector<unsigned int>& sampleToFrameIndexMap);
+
+   const std::vector<float>&        GetTimes() const;
+   const std::vector<unsigned int>& GetSampleToFrameIndexMap() const;
+
+   // This function finds the frame that comes before the given time and the interpolation factor between that frame and the next one
+   // Its results are identical to the ones of FastTrack::GetIndexOfLastFrameBeforeTime and Track::SampleLinear
+   // It returns -1 if there isn't a pair of frames to interpolate between
+   int                              GetIndexOfLastFrameBeforeTime(float time, bool looping, float& outInterpolationFactor) const;
+
+private:
+
+   int                              FindIndexOfLastFrameBeforeTime(float time, bool looping) const;
+   float                            AdjustTimeToBeWithinTimeline(float time, bool looping) const;
+
+   std::vector<float>               mTimes;
+   std::vector<unsigned int>        mSampleToFrameIndexMap;
+
+   // The result of the last lookup
+   mutable float                    mTimeOfLastLookup;
+   mutable bool                     mLoopingOfLastLookup;
+   mutable int                      mFrameIndexOfLastLookup;
+   mutable float                    mInterpolationFactorOfLastLookup;
+};
+
+#endif
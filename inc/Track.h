@@ -1,9 +1,11 @@
 #ifndef TRACK_H
 #define TRACK_H
 
+#include <memory>
 #include <vector>
 
 #include "Frame.h"
+#include "Timeline.h"
 #include "quat.h"
 #include "Interpolation.h"
 
@@ -23,6 +25,10 @@ public:
    unsigned int    GetNumberOfFrames() const;
    void            SetNumberOfFrames(unsigned int numFrames);
 
+   // These functions give access to all the frames at once, which allows a track to be baked and loaded with a single copy
+   const Frame<N>* GetFrames() const;
+   void            SetFrames(const Frame<N>* frames, unsigned int numFrames);
+
    Interpolation   GetInterpolation() const;
    void            SetInterpolation(Interpolation interpolation);
 
@@ -45,6 +51,10 @@ protected:
    T               SampleLinear(float time, bool looping) const;
    T               SampleCubic(float time, bool looping) const;
 
+   // These functions interpolate between a frame and the next one once the frame and the interpolation factor have been found
+   T               InterpolateLinear(int thisFrame, float t) const;
+   T               InterpolateCubic(int thisFrame, float t) const;
+
    std::vector<Frame<N>> mFrames;
    Interpolation         mInterpolation;
 };
@@ -68,6 +78,7 @@ typedef Track<Q::quat, 4>   QuaternionTrack;
 //   transform the time into its closest sample, and then we can use the map we generated at
 //   load-time to find the right frame
 // The only drawback of this technique is the additional memory used by the map of samples to frame indices
+// That memory is shared by the tracks of a clip whose frames have identical times, which share a single Timeline that stores the map (see Timeline.h)
 
 // TODO: We can probably unify the Track and FastTrack classes, which would allow us to delete the OptimizeTrack function
 template<typename T, unsigned int N>
@@ -80,11 +91,25 @@ public:
 
    void        GenerateSampleToFrameIndexMap();
 
+   // The map is stored in baked assets so that it doesn't have to be generated again when they are loaded
+   // If the track shares a timeline, the map of the timeline is returned
+   const std::vector<unsigned int>& GetSampleToFrameIndexMap() const;
+   void        SetSampleToFrameIndexMap(const unsigned int* sampleToFrameIndexMap, unsigned int numSamples);
+
+   // A track that shares a timeline frees its own map, so the times of its frames must match the ones of the timeline
+   // Generating or setting the map of the track stops it from sharing the timeline
+   const std::shared_ptr<const Timeline>& GetTimeline() const;
+   void        SetTimeline(const std::shared_ptr<const Timeline>& timeline);
+
+   // This function hides Track::Sample so that a track that shares a timeline can reuse the frame and the interpolation factor that the timeline found
+   T           Sample(float time, bool looping) const;
+
 protected:
 
    virtual int GetIndexOfLastFrameBeforeTime(float time, bool looping) const override;
 
-   std::vector<unsigned int> mSampleToFrameIndexMap;
+   std::vector<unsigned int>       mSampleToFrameIndexMap;
+   std::shared_ptr<const Timeline> mTimeline;
 };
 
 typedef FastTrack<float, 1>     FastScalarTrack;
@@ -23,4 +23,27 @@ struct Triangle
    glm::vec3 normal;
 };
 
+/*
+   The Moller-Trumbore ray-triangle intersection test expresses the hit point in terms of the edges that start at vertex A:
+
+   origin + (direction * t) = A + (u * (B - A)) + (v * (C - A))
+
+   And solves for t, u and v using Cramer's rule
+   Those two edges are the same for every ray, so this variant of the Triangle struct stores them instead of the other two vertices
+*/
+
+struct PrecomputedTriangle
+{
+   PrecomputedTriangle();
+   PrecomputedTriangle(const Triangle& triangle);
+
+   glm::vec3 vertexA;
+   glm::vec3 edgeAB;
+   glm::vec3 edgeAC;
+};
+
+// If the determinant of the Moller-Trumbore test is smaller than this, the ray is parallel to the triangle or it's hitting its backface
+// The scalar test (see Intersection.h) and the packet test (see TrianglePacket.h) share it so that they reject the same triangles
+const float minMollerTrumboreDeterminant = 0.0000000001f;
+
 #endif
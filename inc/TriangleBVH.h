@@ -0,0 +1,86 @@
+#ifndef TRIANGLE_BVH_H
+#define TRIANGLE_BVH_H
+
+#include <vector>
+
+#include "AABB.h"
+#include "Ray.h"
+#include "IndexedTriangleStore.h"
+#include "TrianglePacket.h"
+
+/*
+   The TriangleBVH class is a bounding volume hierarchy that accelerates ray queries against a static set of triangles
+
+   Testing a ray against every triangle of the ground is simple, but its cost grows linearly with the number of triangles
+   A BVH groups the triangles into a tree of nested AABBs, so a ray only needs to be tested against the triangles
+   whose boxes it passes through, which makes the cost of a query roughly logarithmic in the number of triangles
+
+   The tree is built with the surface area heuristic (SAH), which estimates the cost of splitting a node as:
+
+   cost = traversalCost + (areaOfLeftChild / areaOfNode) * numTrianglesInLeftChild + (areaOfRightChild / areaOfNode) * numTrianglesInRightChild
+
+   The ratio of the areas is the probability that a random ray that hits the node also hits the child
+   Evaluating every possible split is expensive, so the centroids of the triangles are sorted into a small number of bins along each axis,
+   and only the splits between the bins are evaluated (binned SAH)
+
+   Once built, the tree is stored in a flat array of 32-byte nodes where the two children of a node are always next to each other,
+   and the triangles are reordered so that the ones that belong to the same leaf are contiguous in memory
+
+   The triangles of each leaf are stored in packets of four, which are tested against a ray with SIMD instructions,
+   so the SAH measures the cost of a leaf in packets instead of triangles
+*/
+
+class TriangleBVH
+{
+public:
+
+   TriangleBVH();
+
+   void                         Build(const IndexedTriangleStore& triangles);
+
+   // This function returns the hit that is closest to the origin of the ray
+   // triangleIndex is the index of the triangle that was hit in the IndexedTriangleStore that was passed to the Build function
+   bool                         IntersectRayClosest(const Ray& ray, glm::vec3& hitPoint) const;
+   bool                         IntersectRayClosest(const Ray& ray, glm::vec3& hitPoint, unsigned int& triangleIndex) const;
+
+   // This function returns as soon as it finds a hit whose distance along the ray is smaller than maxDistance,
+   // which makes it faster than the one above when we only need to know if something is in the way
+   bool                         IntersectRayAny(const Ray& ray, float maxDistance) const;
+
+   AABB                         GetBounds() const;
+   unsigned int                 GetNumberOfNodes() const;
+   unsigned int                 GetNumberOfTriangles() const;
+
+private:
+
+   // Each node stores its bounds and two integers that are interpreted differently depending on whether the node is a leaf or not:
+   // - If numTriangles is zero, the node is an interior node and firstChildOrPacket is the index of its left child
+   //   Its right child is always stored right after its left child
+   // - If numTriangles is larger than zero, the node is a leaf and firstChildOrPacket is the index of its first packet of triangles
+   //   The leaf has (numTriangles + 3) / 4 packets
+   struct Node
+   {
+      glm::vec3    min;
+      unsigned int firstChildOrPacket;
+      glm::vec3    max;
+      unsigned int numTriangles;
+   };
+
+   void                         Subdivide(unsigned int               nodeIndex,
+                                          unsigned int               depth,
+                                          std::vector<Triangle>&     triangles,
+                                          std::vector<unsigned int>& originalTriangleIndices,
+                                          std::vector<glm::vec3>&    centroids);
+
+   std::vector<Node>            mNodes;
+   std::vector<TrianglePacket>  mPackets;
+   // This vector stores the index of the original triangle of each lane of each packet
+   std::vector<unsigned int>    mOriginalTriangleIndices;
+   unsigned int                 mNumTriangles;
+};
+
+// This function measures how many rays per second the BVH can process compared to testing every triangle,
+// and prints the results along with the number of hits that didn't match between both methods
+void BenchmarkTriangleBVH(const TriangleBVH& bvh, const IndexedTriangleStore& triangles, unsigned int numRays);
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef TRIANGLE_PACKET_H
+#define TRIANGLE_PACKET_H
+
+#include <vector>
+
+#include "Ray.h"
+#include "Triangle.h"
+
+/*
+   A TrianglePacket stores four precomputed triangles as a structure of arrays (SoA):
+
+   vertexAX: | A0.x | A1.x | A2.x | A3.x |
+   vertexAY: | A0.y | A1.y | A2.y | A3.y |
+   ...
+   edgeACZ:  | AC0.z | AC1.z | AC2.z | AC3.z |
+
+   This layout allows us to load the same component of the four triangles into a single SIMD register,
+   so that one ray can be tested against four triangles with the same number of instructions that it would take to test it against one
+   Unused lanes are filled with degenerate triangles whose edges have a length of zero, which are always missed
+*/
+
+struct TrianglePacket
+{
+   TrianglePacket();
+
+   void  SetTriangle(unsigned int lane, const PrecomputedTriangle& triangle);
+
+   alignas(16) float vertexAX[4];
+   alignas(16) float vertexAY[4];
+   alignas(16) float vertexAZ[4];
+   alignas(16) float edgeABX[4];
+   alignas(16) float edgeABY[4];
+   alignas(16) float edgeABZ[4];
+   alignas(16) float edgeACX[4];
+   alignas(16) float edgeACY[4];
+   alignas(16) float edgeACZ[4];
+};
+
+// This function tests a ray against the four triangles of a packet using the Moller-Trumbore algorithm
+// It returns a bit mask where bit i is set if the ray hits the triangle in lane i at a distance along the ray that is smaller than maxDistance,
+// and it stores the distances along the ray to the hit points in outDistances
+int  IntersectRayWithTrianglePacket(const Ray& ray, const TrianglePacket& packet, float maxDistance, float outDistances[4]);
+
+// This function packs an array of triangles into packets of four
+std::vector<TrianglePacket> CreateTrianglePackets(const std::vector<Triangle>& triangles);
+
+#endif
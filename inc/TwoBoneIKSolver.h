@@ -0,0 +1,54 @@
+#ifndef TWO_BONE_IK_SOLVER_H
+#define TWO_BONE_IK_SOLVER_H
+
+#include "Transform.h"
+
+/*
+   The TwoBoneIKSolver class solves an IK chain of three joints (e.g. a hip, a knee and an ankle) in closed form
+
+   Since the lengths of the two bones are fixed, the distance between the root and the target is all we need to know how much the middle joint must bend
+   The law of cosines relates that distance to the interior angle at the middle joint:
+
+                Knee
+                 /\
+       thigh    /  \    shin
+               /    \
+          Hip *------* Target
+                dist
+
+   dist^2 = thigh^2 + shin^2 - 2 * thigh * shin * cos(interiorAngle)
+
+   Once the middle joint is bent by the right amount, the root only needs to be rotated so that the end effector points at the target,
+   and twisted around the line that goes from the root to the target so that the plane of the leg contains the pole vector
+   For legs, the pole vector is the right vector of the character, which makes the knee bend forward just like the hinge constraints of
+   FABRIKSolver::SolveThreeJointLegWithConstraints and its backwards knee correction do
+
+   Unlike FABRIK, this solver doesn't iterate, so its cost is constant and its result is exact whenever the target is within reach
+*/
+
+class TwoBoneIKSolver
+{
+public:
+
+   TwoBoneIKSolver();
+
+   // Joint 0 is the root of the chain, and its local transform must be its world transform
+   Transform    GetLocalTransform(unsigned int jointIndex) const;
+   void         SetLocalTransform(unsigned int jointIndex, const Transform& transform);
+   Transform    GetGlobalTransform(unsigned int jointIndex) const;
+
+   // This function returns false if the target is out of reach, in which case the chain is stretched towards it
+   bool         Solve(const Transform& target, const glm::vec3& characterRight);
+
+private:
+
+   void         ApplyWorldRotation(unsigned int jointIndex, const Q::quat& worldRotation);
+
+   Transform    mIKChain[3];
+};
+
+// This function measures how many three-joint legs per second the analytic solver and FABRIKSolver::SolveThreeJointLegWithConstraints can solve,
+// and prints how far the ankles end up from their targets and how different the knee positions of both solvers are
+void BenchmarkTwoBoneIKSolver(const Transform& hip, const Transform& knee, const Transform& ankle, const glm::vec3& characterRight, unsigned int numIterations, unsigned int numTargets);
+
+#endif
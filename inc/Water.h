@@ -3,12 +3,13 @@
 
 #include "Transform.h"
 #include "shader.h"
+#include "AssetLoader.h"
 
 class Water
 {
 public:
 
-   Water(const Transform& modelTransform);
+   Water(const Transform& modelTransform, AssetLoader& assetLoader);
    ~Water();
 
    void BindReflectionFBO();
@@ -26,6 +26,9 @@ public:
    void                   renderCurrentState() const;
    void                   changeState(const std::string& newStateID);
 
+   // This function adds a state after the FSM has been initialized (see LoadingState.h)
+   void                   addState(const std::string& stateID, const std::shared_ptr<State>& state);
+
    std::shared_ptr<State> getPreviousState();
 
    std::string            getPreviousStateID() const;
@@ -7,6 +7,7 @@
 #include "window.h"
 #include "state.h"
 #include "finite_state_machine.h"
+#include "AssetLoader.h"
 
 class Game
 {
@@ -34,6 +35,8 @@ private:
 
    std::shared_ptr<Window>                 mWindow;
 
+   std::shared_ptr<AssetLoader>            mAssetLoader;
+
 #ifndef USE_THIRD_PERSON_CAMERA
    std::shared_ptr<Camera>                 mCamera;
 #endif
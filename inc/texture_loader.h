@@ -3,9 +3,39 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "texture.h"
 
+class MappedFile;
+
+// The pixels of an image that has been decoded but not uploaded to the GPU
+// Decoding doesn't need an OpenGL context, so it can be done on any thread (see AssetLoader.h)
+// An image that is decoded with stb_image owns its pixels and only has one mip level,
+// while an image that is loaded from a baked texture points into the mapping of the file and may have several (see BakedTexture.h)
+struct DecodedImage
+{
+   struct MipLevel
+   {
+      int                  width;
+      int                  height;
+      const unsigned char* data;
+      size_t               size;
+   };
+
+   DecodedImage(unsigned char* pixels, int width, int height, int numComponents);
+   DecodedImage(const std::shared_ptr<const MappedFile>& bakedFile, int numComponents, unsigned int compressedFormat, std::vector<MipLevel>&& mipLevels);
+
+   std::unique_ptr<unsigned char, void(*)(void*)> pixels;
+   std::shared_ptr<const MappedFile>              bakedFile;
+   int                                            width;
+   int                                            height;
+   int                                            numComponents;
+   // The OpenGL enum of the block compression format of the mip levels, or 0 if they are uncompressed
+   unsigned int                                   compressedFormat;
+   std::vector<MipLevel>                          mipLevels;
+};
+
 class TextureLoader
 {
 public:
@@ -26,17 +56,32 @@ public:
                                          unsigned int       magFilter = GL_LINEAR,
                                          bool               genMipmap = true) const;
 
+   std::shared_ptr<Texture> loadResource(const std::shared_ptr<const DecodedImage>& image,
+                                         unsigned int                               wrapS     = GL_REPEAT,
+                                         unsigned int                               wrapT     = GL_REPEAT,
+                                         unsigned int                               minFilter = GL_LINEAR_MIPMAP_LINEAR,
+                                         unsigned int                               magFilter = GL_LINEAR,
+                                         bool                                       genMipmap = true) const;
+
+   // This function decodes an image without uploading it, and it returns a nullptr if the image can't be decoded
+   // If the image has been baked, the baked texture is loaded instead (see BakedTexture.h)
+   static std::shared_ptr<DecodedImage> decodeImage(const std::string& texFilePath);
+
+   // This function uploads the mip levels of an image to the texture that is bound to the given target
+   // If uploadAllMipLevels is false, only the first level is uploaded
+   // It returns the number of levels that were uploaded
+   static unsigned int uploadImage(unsigned int target, const DecodedImage& image, bool uploadAllMipLevels);
+
 private:
 
-   unsigned int generateTexture(const std::unique_ptr<unsigned char, void(*)(void*)>& texData,
-                                int          width,
-                                int          height,
-                                int          numComponents,
-                                unsigned int wrapS,
-                                unsigned int wrapT,
-                                unsigned int minFilter,
-                                unsigned int magFilter,
-                                bool         genMipmap) const;
+   static bool supportsBlockCompression();
+
+   unsigned int generateTexture(const DecodedImage& image,
+                                unsigned int        wrapS,
+                                unsigned int        wrapT,
+                                unsigned int        minFilter,
+                                unsigned int        magFilter,
+                                bool                genMipmap) const;
 };
 
 #endif
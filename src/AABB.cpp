@@ -0,0 +1,124 @@
+#include <cfloat>
+
+#include "AABB.h"
+
+AABB::AABB()
+   : min(FLT_MAX)
+   , max(-FLT_MAX)
+{
+
+}
+
+AABB::AABB(const glm::vec3& minCorner, const glm::vec3& maxCorner)
+   : min(minCorner)
+   , max(maxCorner)
+{
+
+}
+
+bool AABB::IsEmpty() const
+{
+   return (min.x > max.x) || (min.y > max.y) || (min.z > max.z);
+}
+
+void AABB::Expand(const glm::vec3& point)
+{
+   min = glm::min(min, point);
+   max = glm::max(max, point);
+}
+
+void AABB::Expand(const AABB& aabb)
+{
+   if (aabb.IsEmpty())
+   {
+      return;
+   }
+
+   min = glm::min(min, aabb.min);
+   max = glm::max(max, aabb.max);
+}
+
+glm::vec3 AABB::GetCenter() const
+{
+   return (min + max) * 0.5f;
+}
+
+glm::vec3 AABB::GetExtents() const
+{
+   return (max - min) * 0.5f;
+}
+
+/*
+   Transforming the 8 corners of an AABB and then finding the AABB that contains them is expensive
+   Instead, we can transform the center of the AABB as a point and project its extents onto the axes of the new space:
+
+   newCenter  = transform * center
+   newExtents = |transform| * extents
+
+   Where |transform| is the upper 3x3 part of the transform with the absolute value of each element
+   The result is exactly the AABB that contains the 8 transformed corners
+*/
+AABB TransformAABB(const glm::mat4& transform, const AABB& aabb)
+{
+   if (aabb.IsEmpty())
+   {
+      return AABB();
+   }
+
+   glm::vec3 center  = aabb.GetCenter();
+   glm::vec3 extents = aabb.GetExtents();
+
+   glm::vec3 newCenter = glm::vec3(transform * glm::vec4(center, 1.0f));
+
+   glm::mat3 absoluteLinearPart = glm::mat3(glm::abs(glm::vec3(transform[0])),
+                                            glm::abs(glm::vec3(transform[1])),
+                                            glm::abs(glm::vec3(transform[2])));
+   glm::vec3 newExtents = absoluteLinearPart * extents;
+
+   return AABB(newCenter - newExtents, newCenter + newExtents);
+}
+
+/*
+   A skinned vertex is a weighted average of the vertex transformed by the skin matrices of the joints that influence it:
+
+   skinnedVertex = (w0 * S0 * v) + (w1 * S1 * v) + (w2 * S2 * v) + (w3 * S3 * v)
+
+   Since the weights add up to 1.0, the skinned vertex lies inside the convex hull of the points Si * v
+   If we know the bind pose AABB of all the vertices that are influenced by joint i, then Si * v must lie inside of
+   that AABB transformed by Si, so the union of the transformed AABBs of all the joints is a conservative bound of the skinned mesh
+
+   This lets us bound a skinned mesh by looping over its joints instead of its vertices
+*/
+AABB CalculateSkinnedAABB(const std::vector<AABB>& jointBounds, const std::vector<glm::mat4>& skinMatrices)
+{
+   AABB skinnedAABB;
+
+   for (unsigned int jointIndex = 0,
+        numJoints = static_cast<unsigned int>(glm::min(jointBounds.size(), skinMatrices.size()));
+        jointIndex < numJoints;
+        ++jointIndex)
+   {
+      // Joints that don't influence any vertices have empty bounds
+      if (jointBounds[jointIndex].IsEmpty())
+      {
+         continue;
+      }
+
+      skinnedAABB.Expand(TransformAABB(skinMatrices[jointIndex], jointBounds[jointIndex]));
+   }
+
+   return skinnedAABB;
+}
+
+// This function returns the distance between a point and the closest point of an AABB, which is zero if the point is inside it
+// The closest point is found by clamping the point to the AABB one axis at a time
+float CalculateDistanceToAABB(const glm::vec3& point, const AABB& aabb)
+{
+   if (aabb.IsEmpty())
+   {
+      return 0.0f;
+   }
+
+   glm::vec3 closestPoint = glm::clamp(point, aabb.min, aabb.max);
+   return glm::length(point - closestPoint);
+}
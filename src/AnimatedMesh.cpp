@@ -4,108 +4,372 @@
 #include <glad/glad.h>
 #endif
 
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define ANIMATED_MESH_USE_SSE
+#endif
+
 #include "AnimatedMesh.h"
 #include "Transform.h"
 
+namespace MorphTargetHelpers
+{
+   // Morph targets whose weights are smaller than this don't displace the vertices enough to be visible, so they are skipped
+   const float minMorphWeight = 0.0001f;
+
+   /*
+      This function adds the weighted deltas of a morph target to an array of vec3s:
+
+      destination[vertexIndices[i]] += weight * deltas[i]
+
+      Each delta is a vec4 with a W of zero, so it can be added to a vec3 with a single 4-wide SIMD operation
+      that reads and writes the vec3 and the first float of the next vec3, which it leaves untouched since it adds zero to it
+      That's why the destination array must have one extra element at the end
+   */
+   void AddWeightedDeltas(float*                           destination,
+                          const std::vector<unsigned int>& vertexIndices,
+                          const std::vector<glm::vec4>&    deltas,
+                          float                            weight)
+   {
+#if defined(__wasm_simd128__)
+      v128_t weights = wasm_f32x4_splat(weight);
+#elif defined(ANIMATED_MESH_USE_SSE)
+      __m128 weights = _mm_set1_ps(weight);
+#endif
+
+      for (unsigned int i = 0,
+           numDeltas = static_cast<unsigned int>(vertexIndices.size());
+           i < numDeltas;
+           ++i)
+      {
+         float*       vertex = destination + (vertexIndices[i] * 3);
+         const float* delta  = &deltas[i].x;
+
+#if defined(__wasm_simd128__)
+         wasm_v128_store(vertex, wasm_f32x4_add(wasm_v128_load(vertex), wasm_f32x4_mul(wasm_v128_load(delta), weights)));
+#elif defined(ANIMATED_MESH_USE_SSE)
+         _mm_storeu_ps(vertex, _mm_add_ps(_mm_loadu_ps(vertex), _mm_mul_ps(_mm_loadu_ps(delta), weights)));
+#else
+         vertex[0] += delta[0] * weight;
+         vertex[1] += delta[1] * weight;
+         vertex[2] += delta[2] * weight;
+#endif
+      }
+   }
+}
+
+// The VAO and the buffers are only generated when the buffers are loaded for the first time,
+// which allows a mesh to be loaded and processed without an OpenGL context (e.g. by the asset baker)
 AnimatedMesh::AnimatedMesh()
 {
-   glGenVertexArrays(1, &mVAO);
-   glGenBuffers(5, &mVBOs[0]);
-   glGenBuffers(1, &mEBO);
+   mSharedMesh = nullptr;
+   mVAO = 0;
+   mDynamicVBO = 0;
+   mStaticVBO = 0;
+   mEBO = 0;
+   mUse16BitIndices = false;
+   mNodeIndex = 0;
+   mFirstDirtyMorphedVertex = 0;
+   mLastDirtyMorphedVertex = 0;
 }
 
 AnimatedMesh::~AnimatedMesh()
 {
-   glDeleteVertexArrays(1, &mVAO);
-   glDeleteBuffers(5, &mVBOs[0]);
-   glDeleteBuffers(1, &mEBO);
+   if (mVAO != 0)
+   {
+      glDeleteVertexArrays(1, &mVAO);
+      glDeleteBuffers(1, &mDynamicVBO);
+   }
+
+   // The shared buffers can exist even if this mesh was never loaded, since a mesh that shares its data may have loaded them
+   if (mStaticVBO != 0)
+   {
+      glDeleteBuffers(1, &mStaticVBO);
+      glDeleteBuffers(1, &mEBO);
+   }
 }
 
 AnimatedMesh::AnimatedMesh(AnimatedMesh&& rhs) noexcept
-   : mPositions(std::move(rhs.mPositions))
+   : mSharedMesh(std::exchange(rhs.mSharedMesh, nullptr))
+   , mPositions(std::move(rhs.mPositions))
    , mNormals(std::move(rhs.mNormals))
    , mTexCoords(std::move(rhs.mTexCoords))
    , mWeights(std::move(rhs.mWeights))
    , mInfluences(std::move(rhs.mInfluences))
    , mIndices(std::move(rhs.mIndices))
+   , mLODIndices(std::move(rhs.mLODIndices))
+   , mLODErrors(std::move(rhs.mLODErrors))
+   , mMorphTargets(std::move(rhs.mMorphTargets))
+   , mDefaultMorphWeights(std::move(rhs.mDefaultMorphWeights))
+   , mNodeIndex(rhs.mNodeIndex)
+   , mBounds(rhs.mBounds)
+   , mJointBounds(std::move(rhs.mJointBounds))
    , mNumIndices(std::exchange(rhs.mNumIndices, 0))
    , mVAO(std::exchange(rhs.mVAO, 0))
-   , mVBOs(std::exchange(rhs.mVBOs, std::array<unsigned int, 5>()))
+   , mDynamicVBO(std::exchange(rhs.mDynamicVBO, 0))
+   , mStaticVBO(std::exchange(rhs.mStaticVBO, 0))
    , mEBO(std::exchange(rhs.mEBO, 0))
+   , mUse16BitIndices(rhs.mUse16BitIndices)
+   , mLODFirstIndices(std::move(rhs.mLODFirstIndices))
+   , mMorphedPositions(std::move(rhs.mMorphedPositions))
+   , mMorphedNormals(std::move(rhs.mMorphedNormals))
+   , mDisplacedVertices(std::move(rhs.mDisplacedVertices))
+   , mMorphWeights(std::move(rhs.mMorphWeights))
+   , mFirstDirtyMorphedVertex(rhs.mFirstDirtyMorphedVertex)
+   , mLastDirtyMorphedVertex(rhs.mLastDirtyMorphedVertex)
 {
 
 }
 
 AnimatedMesh& AnimatedMesh::operator=(AnimatedMesh&& rhs) noexcept
 {
-   mPositions  = std::move(rhs.mPositions);
-   mNormals    = std::move(rhs.mNormals);
-   mTexCoords  = std::move(rhs.mTexCoords);
-   mWeights    = std::move(rhs.mWeights);
-   mInfluences = std::move(rhs.mInfluences);
-   mIndices    = std::move(rhs.mIndices);
-   mNumIndices = std::exchange(rhs.mNumIndices, 0);
-   mVAO        = std::exchange(rhs.mVAO, 0);
-   mVBOs       = std::exchange(rhs.mVBOs, std::array<unsigned int, 5>());
-   mEBO        = std::exchange(rhs.mEBO, 0);
+   mSharedMesh              = std::exchange(rhs.mSharedMesh, nullptr);
+   mPositions               = std::move(rhs.mPositions);
+   mNormals                 = std::move(rhs.mNormals);
+   mTexCoords               = std::move(rhs.mTexCoords);
+   mWeights                 = std::move(rhs.mWeights);
+   mInfluences              = std::move(rhs.mInfluences);
+   mIndices                 = std::move(rhs.mIndices);
+   mLODIndices              = std::move(rhs.mLODIndices);
+   mLODErrors               = std::move(rhs.mLODErrors);
+   mMorphTargets            = std::move(rhs.mMorphTargets);
+   mDefaultMorphWeights     = std::move(rhs.mDefaultMorphWeights);
+   mNodeIndex               = rhs.mNodeIndex;
+   mBounds                  = rhs.mBounds;
+   mJointBounds             = std::move(rhs.mJointBounds);
+   mNumIndices              = std::exchange(rhs.mNumIndices, 0);
+   mVAO                     = std::exchange(rhs.mVAO, 0);
+   mDynamicVBO              = std::exchange(rhs.mDynamicVBO, 0);
+   mStaticVBO               = std::exchange(rhs.mStaticVBO, 0);
+   mEBO                     = std::exchange(rhs.mEBO, 0);
+   mUse16BitIndices         = rhs.mUse16BitIndices;
+   mLODFirstIndices         = std::move(rhs.mLODFirstIndices);
+   mMorphedPositions        = std::move(rhs.mMorphedPositions);
+   mMorphedNormals          = std::move(rhs.mMorphedNormals);
+   mDisplacedVertices       = std::move(rhs.mDisplacedVertices);
+   mMorphWeights            = std::move(rhs.mMorphWeights);
+   mFirstDirtyMorphedVertex = rhs.mFirstDirtyMorphedVertex;
+   mLastDirtyMorphedVertex  = rhs.mLastDirtyMorphedVertex;
    return *this;
 }
 
-// TODO: Experiment with GL_STATIC_DRAW, GL_STREAM_DRAW and GL_DYNAMIC_DRAW to see which is faster
-void AnimatedMesh::LoadBuffers()
+// This function makes the mesh use everything that describes the shape of another mesh without copying it:
+// its vertices, indices, morph targets and bounds, along with its static buffer and its index buffer, which never change
+// The mesh only stores what changes when it's animated, which is its VAO, its dynamic buffer and the results of morphing and skinning it
+// The source must outlive the mesh, and the mesh must call LoadBuffers before it's rendered, just like a mesh that was just loaded
+void AnimatedMesh::ShareMeshData(const AnimatedMesh& source)
 {
-   glBindVertexArray(mVAO);
+   // If the source shares the data of another mesh, we share the data of that mesh directly
+   mSharedMesh = (source.mSharedMesh != nullptr) ? source.mSharedMesh : &source;
+}
+
+// This function calculates the bounds of the mesh in the bind pose and the bounds of each joint in the bind pose
+// The bounds of a joint contain all the vertices that are influenced by that joint with a non-zero weight
+// Combined with the skin matrices, the bounds of the joints let us bound the animated mesh without skinning its vertices
+// Note that this function must be called again if the influences are modified (e.g. after rearranging the skeleton)
+void AnimatedMesh::CalculateBounds()
+{
+   mBounds = AABB();
+   mJointBounds.clear();
+
+   unsigned int numVertices = static_cast<unsigned int>(mPositions.size());
+   for (unsigned int vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+   {
+      mBounds.Expand(mPositions[vertexIndex]);
+   }
+
+   // Static meshes don't have influences or weights
+   if (mInfluences.size() != numVertices || mWeights.size() != numVertices)
+   {
+      return;
+   }
+
+   // Find the largest joint index so that we know how many joint bounds we need
+   int maxJointIndex = -1;
+   for (unsigned int vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+   {
+      const glm::ivec4& influencesOfCurrVertex = mInfluences[vertexIndex];
+      maxJointIndex = glm::max(maxJointIndex, glm::max(glm::max(influencesOfCurrVertex.x, influencesOfCurrVertex.y),
+                                                       glm::max(influencesOfCurrVertex.z, influencesOfCurrVertex.w)));
+   }
 
-   // Load the mesh's data into the buffers
+   mJointBounds.resize(static_cast<unsigned int>(maxJointIndex + 1));
 
-   // Positions
-   glBindBuffer(GL_ARRAY_BUFFER, mVBOs[VBOTypes::positions]);
-   glBufferData(GL_ARRAY_BUFFER, mPositions.size() * sizeof(glm::vec3), &mPositions[0], GL_STATIC_DRAW);
-   // Normals
-   glBindBuffer(GL_ARRAY_BUFFER, mVBOs[VBOTypes::normals]);
-   glBufferData(GL_ARRAY_BUFFER, mNormals.size() * sizeof(glm::vec3), &mNormals[0], GL_STATIC_DRAW);
-   // Texture coordinates
-   glBindBuffer(GL_ARRAY_BUFFER, mVBOs[VBOTypes::texCoords]);
-   glBufferData(GL_ARRAY_BUFFER, mTexCoords.size() * sizeof(glm::vec2), &mTexCoords[0], GL_STATIC_DRAW);
-   // TODO: The checks below are necessary because this class currently represents animated and static meshes. It must be split
-   // Weights
-   if (mWeights.size() != 0)
+   for (unsigned int vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
    {
-      glBindBuffer(GL_ARRAY_BUFFER, mVBOs[VBOTypes::weights]);
-      glBufferData(GL_ARRAY_BUFFER, mWeights.size() * sizeof(glm::vec4), &mWeights[0], GL_STATIC_DRAW);
+      const glm::ivec4& influencesOfCurrVertex = mInfluences[vertexIndex];
+      const glm::vec4&  weightsOfCurrVertex    = mWeights[vertexIndex];
+
+      for (int component = 0; component < 4; ++component)
+      {
+         // Joints with a weight of zero don't move the vertex, so they don't need to contain it
+         if (weightsOfCurrVertex[component] > 0.0f && influencesOfCurrVertex[component] >= 0)
+         {
+            mJointBounds[influencesOfCurrVertex[component]].Expand(mPositions[vertexIndex]);
+         }
+      }
    }
-   // Influences
-   if (mInfluences.size() != 0)
+}
+
+void AnimatedMesh::LoadBuffers()
+{
+   if (mVAO == 0)
    {
-      glBindBuffer(GL_ARRAY_BUFFER, mVBOs[VBOTypes::influences]);
-      glBufferData(GL_ARRAY_BUFFER, mInfluences.size() * sizeof(glm::ivec4), &mInfluences[0], GL_STATIC_DRAW);
+      glGenVertexArrays(1, &mVAO);
+      glGenBuffers(1, &mDynamicVBO);
    }
 
-   glBindBuffer(GL_ARRAY_BUFFER, 0);
+   // The shared buffers are loaded before the VAO is bound, since loading the index buffer would attach it to the VAO
+   const AnimatedMesh& meshData = GetMeshData();
+   meshData.LoadSharedBuffers();
 
-   // Indices
-   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
-   glBufferData(GL_ELEMENT_ARRAY_BUFFER, mIndices.size() * sizeof(unsigned int), &mIndices[0], GL_STATIC_DRAW);
+   glBindVertexArray(mVAO);
+
+   // Load the mesh's data into the dynamic buffer
+   LoadDynamicBuffer();
+
+   // The index buffer that is bound while the VAO is bound becomes part of the state of the VAO
+   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshData.mEBO);
 
    // Unbind the VAO first, then the EBO
    glBindVertexArray(0);
    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
+// This function loads the static buffer and the index buffer of a mesh that owns its data the first time that it or a mesh that shares its data is loaded
+void AnimatedMesh::LoadSharedBuffers() const
+{
+   if (mStaticVBO != 0)
+   {
+      return;
+   }
+
+   glGenBuffers(1, &mStaticVBO);
+   glGenBuffers(1, &mEBO);
+
+   LoadStaticBuffer();
+   LoadIndexBuffer();
+
+   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+/*
+   If a mesh has fewer than 65535 vertices, all of its indices fit in 16 bits, which halves the size of its index buffer
+   Note that we can't use 65535 itself as an index, since WebGL 2 always enables primitive restart with a fixed index,
+   which means that the largest index of the type (0xFFFF for 16-bit indices) is interpreted as the end of a primitive
+*/
+void AnimatedMesh::LoadIndexBuffer() const
+{
+   mUse16BitIndices = false;
+   mLODFirstIndices.clear();
+
+   if (mIndices.size() == 0)
+   {
+      return;
+   }
+
+   // Concatenate the indices of all the LODs
+   std::vector<unsigned int> indicesOfAllLODs(mIndices.begin(), mIndices.end());
+   mLODFirstIndices.push_back(0);
+   for (unsigned int lodIndex = 0,
+        numLODs = static_cast<unsigned int>(mLODIndices.size());
+        lodIndex < numLODs;
+        ++lodIndex)
+   {
+      mLODFirstIndices.push_back(static_cast<unsigned int>(indicesOfAllLODs.size()));
+      indicesOfAllLODs.insert(indicesOfAllLODs.end(), mLODIndices[lodIndex].begin(), mLODIndices[lodIndex].end());
+   }
+
+   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
+
+   if (mPositions.size() < 65535)
+   {
+      std::vector<unsigned short> indices16Bit(indicesOfAllLODs.begin(), indicesOfAllLODs.end());
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices16Bit.size() * sizeof(unsigned short), &indices16Bit[0], GL_STATIC_DRAW);
+      mUse16BitIndices = true;
+   }
+   else
+   {
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, indicesOfAllLODs.size() * sizeof(unsigned int), &indicesOfAllLODs[0], GL_STATIC_DRAW);
+   }
+}
+
+// This function loads the positions and normals of the bind pose into the dynamic buffer
+// It's also used to restore the bind pose after skinning on the CPU, since the CPU skinning functions overwrite the dynamic buffer
+// The dynamic buffer uses GL_DYNAMIC_DRAW because its contents are replaced every frame when skinning on the CPU
+void AnimatedMesh::LoadDynamicBuffer()
+{
+   const AnimatedMesh& meshData = GetMeshData();
+
+   unsigned int numVertices = static_cast<unsigned int>(meshData.mPositions.size());
+   if (numVertices == 0)
+   {
+      return;
+   }
+
+   // If the morph targets have been applied, we load the morphed positions and normals instead of the ones of the bind pose
+   const std::vector<glm::vec3>& positions = (mMorphedPositions.size() > 0) ? mMorphedPositions : meshData.mPositions;
+   const std::vector<glm::vec3>& normals   = (mMorphedNormals.size() > 0)   ? mMorphedNormals   : meshData.mNormals;
+
+   std::vector<DynamicVertex> dynamicVertices(numVertices);
+   for (unsigned int vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+   {
+      dynamicVertices[vertexIndex].position = positions[vertexIndex];
+      dynamicVertices[vertexIndex].normal   = (vertexIndex < normals.size()) ? normals[vertexIndex] : glm::vec3(0.0f, 1.0f, 0.0f);
+   }
+
+   glBindBuffer(GL_ARRAY_BUFFER, mDynamicVBO);
+   glBufferData(GL_ARRAY_BUFFER, dynamicVertices.size() * sizeof(DynamicVertex), &dynamicVertices[0], GL_DYNAMIC_DRAW);
+   glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// This function loads the texture coordinates, weights and influences into the static buffer
+// Note that a glTF file is not required to contain all of these attributes, so we fill in the missing ones with zeroes
+void AnimatedMesh::LoadStaticBuffer() const
+{
+   const AnimatedMesh& meshData = GetMeshData();
+
+   unsigned int numVertices = static_cast<unsigned int>(meshData.mPositions.size());
+   if (numVertices == 0)
+   {
+      return;
+   }
+
+   std::vector<StaticVertex> staticVertices(numVertices);
+   for (unsigned int vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+   {
+      staticVertices[vertexIndex].texCoord   = (vertexIndex < meshData.mTexCoords.size())  ? meshData.mTexCoords[vertexIndex]  : glm::vec2(0.0f);
+      staticVertices[vertexIndex].weights    = (vertexIndex < meshData.mWeights.size())    ? meshData.mWeights[vertexIndex]    : glm::vec4(0.0f);
+      staticVertices[vertexIndex].influences = (vertexIndex < meshData.mInfluences.size()) ? meshData.mInfluences[vertexIndex] : glm::ivec4(0);
+   }
+
+   glBindBuffer(GL_ARRAY_BUFFER, meshData.mStaticVBO);
+   glBufferData(GL_ARRAY_BUFFER, staticVertices.size() * sizeof(StaticVertex), &staticVertices[0], GL_STATIC_DRAW);
+   glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 void AnimatedMesh::ConfigureVAO(int posAttribLocation,
                                 int normalAttribLocation,
                                 int texCoordsAttribLocation,
                                 int weightsAttribLocation,
                                 int influencesAttribLocation)
 {
+   const AnimatedMesh& meshData = GetMeshData();
+
    glBindVertexArray(mVAO);
 
    // Set the vertex attribute pointers
-   BindFloatAttribute(posAttribLocation,       mVBOs[VBOTypes::positions], 3);
-   BindFloatAttribute(normalAttribLocation,    mVBOs[VBOTypes::normals], 3);
-   BindFloatAttribute(texCoordsAttribLocation, mVBOs[VBOTypes::texCoords], 2);
-   BindFloatAttribute(weightsAttribLocation,   mVBOs[VBOTypes::weights], 4);
-   BindIntAttribute(influencesAttribLocation,  mVBOs[VBOTypes::influences], 4);
+   BindFloatAttribute(posAttribLocation,       mDynamicVBO,          3, sizeof(DynamicVertex), offsetof(DynamicVertex, position));
+   BindFloatAttribute(normalAttribLocation,    mDynamicVBO,          3, sizeof(DynamicVertex), offsetof(DynamicVertex, normal));
+   BindFloatAttribute(texCoordsAttribLocation, meshData.mStaticVBO,  2, sizeof(StaticVertex),  offsetof(StaticVertex, texCoord));
+   BindFloatAttribute(weightsAttribLocation,   meshData.mStaticVBO,  4, sizeof(StaticVertex),  offsetof(StaticVertex, weights));
+   BindIntAttribute(influencesAttribLocation,  meshData.mStaticVBO,  4, sizeof(StaticVertex),  offsetof(StaticVertex, influences));
 
    glBindVertexArray(0);
 }
@@ -116,36 +380,38 @@ void AnimatedMesh::UnconfigureVAO(int posAttribLocation,
                                   int weightsAttribLocation,
                                   int influencesAttribLocation)
 {
+   const AnimatedMesh& meshData = GetMeshData();
+
    glBindVertexArray(mVAO);
 
    // Unset the vertex attribute pointers
-   UnbindAttribute(posAttribLocation,        mVBOs[VBOTypes::positions]);
-   UnbindAttribute(normalAttribLocation,     mVBOs[VBOTypes::normals]);
-   UnbindAttribute(texCoordsAttribLocation,  mVBOs[VBOTypes::texCoords]);
-   UnbindAttribute(weightsAttribLocation,    mVBOs[VBOTypes::weights]);
-   UnbindAttribute(influencesAttribLocation, mVBOs[VBOTypes::influences]);
+   UnbindAttribute(posAttribLocation,        mDynamicVBO);
+   UnbindAttribute(normalAttribLocation,     mDynamicVBO);
+   UnbindAttribute(texCoordsAttribLocation,  meshData.mStaticVBO);
+   UnbindAttribute(weightsAttribLocation,    meshData.mStaticVBO);
+   UnbindAttribute(influencesAttribLocation, meshData.mStaticVBO);
 
    glBindVertexArray(0);
 }
 
-void AnimatedMesh::BindFloatAttribute(int attribLocation, unsigned int VBO, int numComponents)
+void AnimatedMesh::BindFloatAttribute(int attribLocation, unsigned int VBO, int numComponents, int stride, unsigned int offset)
 {
    if (attribLocation >= 0)
    {
       glBindBuffer(GL_ARRAY_BUFFER, VBO);
       glEnableVertexAttribArray(attribLocation);
-      glVertexAttribPointer(attribLocation, numComponents, GL_FLOAT, GL_FALSE, 0, (void*)0);
+      glVertexAttribPointer(attribLocation, numComponents, GL_FLOAT, GL_FALSE, stride, (void*)static_cast<std::size_t>(offset));
       glBindBuffer(GL_ARRAY_BUFFER, 0);
    }
 }
 
-void AnimatedMesh::BindIntAttribute(int attribLocation, unsigned int VBO, int numComponents)
+void AnimatedMesh::BindIntAttribute(int attribLocation, unsigned int VBO, int numComponents, int stride, unsigned int offset)
 {
    if (attribLocation >= 0)
    {
       glBindBuffer(GL_ARRAY_BUFFER, VBO);
       glEnableVertexAttribArray(attribLocation);
-      glVertexAttribIPointer(attribLocation, numComponents, GL_INT, 0, (void*)0);
+      glVertexAttribIPointer(attribLocation, numComponents, GL_INT, stride, (void*)static_cast<std::size_t>(offset));
       glBindBuffer(GL_ARRAY_BUFFER, 0);
    }
 }
@@ -160,20 +426,34 @@ void AnimatedMesh::UnbindAttribute(int attribLocation, unsigned int VBO)
    }
 }
 
+void AnimatedMesh::Render()
+{
+   RenderLOD(0);
+}
+
 // TODO: GL_TRIANGLES shouldn't be hardcoded here
 //       Can we load that from the GLTF file?
-void AnimatedMesh::Render()
+void AnimatedMesh::RenderLOD(unsigned int lodIndex)
 {
+   const AnimatedMesh& meshData = GetMeshData();
+
    glBindVertexArray(mVAO);
 
-   if (mIndices.size() > 0)
+   if (meshData.mIndices.size() > 0)
    {
-      // TODO: Use mNumIndices here
-      glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(mIndices.size()), GL_UNSIGNED_INT, 0);
+      // The first index of each LOD is only known once the index buffer is loaded, and until then only the original mesh can be rendered
+      unsigned int numLODsInIndexBuffer = static_cast<unsigned int>(meshData.mLODFirstIndices.size());
+      lodIndex = (numLODsInIndexBuffer > 0) ? glm::min(lodIndex, numLODsInIndexBuffer - 1) : 0;
+
+      unsigned int numIndices  = (lodIndex == 0) ? static_cast<unsigned int>(meshData.mIndices.size()) : static_cast<unsigned int>(meshData.mLODIndices[lodIndex - 1].size());
+      std::size_t  indexSize   = meshData.mUse16BitIndices ? sizeof(unsigned short) : sizeof(unsigned int);
+      std::size_t  indexOffset = (lodIndex == 0) ? 0 : (meshData.mLODFirstIndices[lodIndex] * indexSize);
+
+      glDrawElements(GL_TRIANGLES, numIndices, meshData.mUse16BitIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)indexOffset);
    }
    else
    {
-      glDrawArrays(GL_TRIANGLES, 0, static_cast<unsigned int>(mPositions.size()));
+      glDrawArrays(GL_TRIANGLES, 0, static_cast<unsigned int>(meshData.mPositions.size()));
    }
 
    glBindVertexArray(0);
@@ -183,21 +463,156 @@ void AnimatedMesh::Render()
 //       Can we load that from the GLTF file?
 void AnimatedMesh::RenderInstanced(unsigned int numInstances)
 {
+   const AnimatedMesh& meshData = GetMeshData();
+
    glBindVertexArray(mVAO);
 
-   if (mIndices.size() > 0)
+   if (meshData.mIndices.size() > 0)
    {
       // TODO: Use mNumIndices here
-      glDrawElementsInstanced(GL_TRIANGLES, static_cast<unsigned int>(mIndices.size()), GL_UNSIGNED_INT, 0, numInstances);
+      glDrawElementsInstanced(GL_TRIANGLES, static_cast<unsigned int>(meshData.mIndices.size()), meshData.mUse16BitIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, 0, numInstances);
    }
    else
    {
-      glDrawArraysInstanced(GL_TRIANGLES, 0, static_cast<unsigned int>(mPositions.size()), numInstances);
+      glDrawArraysInstanced(GL_TRIANGLES, 0, static_cast<unsigned int>(meshData.mPositions.size()), numInstances);
    }
 
    glBindVertexArray(0);
 }
 
+/*
+   Morph targets are applied before skinning, since their deltas are defined in the space of the bind pose
+
+   Instead of recalculating the morphed positions and normals of every vertex each time the weights change, we keep them around and only touch the vertices
+   that are displaced by the active morph targets:
+
+   1) The vertices that were displaced the last time are restored to their bind pose values
+   2) The weighted deltas of each morph target whose weight isn't zero are added to the vertices that it displaces
+
+   This means that the cost of this function is proportional to the number of displaced vertices, not to the size of the mesh
+*/
+void AnimatedMesh::ApplyMorphTargets(const std::vector<float>& morphWeights)
+{
+   using namespace MorphTargetHelpers;
+
+   const AnimatedMesh& meshData = GetMeshData();
+
+   unsigned int numVertices = static_cast<unsigned int>(meshData.mPositions.size());
+   if (numVertices == 0 || meshData.mMorphTargets.size() == 0)
+   {
+      return;
+   }
+
+   // Initialize the morphed positions and normals with the ones of the bind pose the first time this function is called
+   // Note the extra element at the end of each vector, which is needed by AddWeightedDeltas
+   if (mMorphedPositions.size() != (numVertices + 1))
+   {
+      mMorphedPositions.assign(meshData.mPositions.begin(), meshData.mPositions.end());
+      mMorphedPositions.push_back(glm::vec3(0.0f));
+
+      mMorphedNormals.assign(numVertices + 1, glm::vec3(0.0f, 1.0f, 0.0f));
+      std::copy(meshData.mNormals.begin(), meshData.mNormals.begin() + std::min(meshData.mNormals.size(), static_cast<std::size_t>(numVertices)), mMorphedNormals.begin());
+
+      mDisplacedVertices.clear();
+   }
+
+   // Keep track of the range of vertices that change, which is what needs to be uploaded when skinning on the GPU
+   mFirstDirtyMorphedVertex = numVertices;
+   mLastDirtyMorphedVertex  = 0;
+
+   // Restore the vertices that were displaced the last time
+   for (unsigned int i = 0,
+        numDisplacedVertices = static_cast<unsigned int>(mDisplacedVertices.size());
+        i < numDisplacedVertices;
+        ++i)
+   {
+      unsigned int vertexIndex = mDisplacedVertices[i];
+      mMorphedPositions[vertexIndex] = meshData.mPositions[vertexIndex];
+      mMorphedNormals[vertexIndex]   = (vertexIndex < meshData.mNormals.size()) ? meshData.mNormals[vertexIndex] : glm::vec3(0.0f, 1.0f, 0.0f);
+
+      mFirstDirtyMorphedVertex = std::min(mFirstDirtyMorphedVertex, vertexIndex);
+      mLastDirtyMorphedVertex  = std::max(mLastDirtyMorphedVertex, vertexIndex);
+   }
+
+   mDisplacedVertices.clear();
+
+   // Add the weighted deltas of the active morph targets
+   for (unsigned int targetIndex = 0,
+        numTargets = static_cast<unsigned int>(std::min(meshData.mMorphTargets.size(), morphWeights.size()));
+        targetIndex < numTargets;
+        ++targetIndex)
+   {
+      const MorphTarget& target = meshData.mMorphTargets[targetIndex];
+      float weight = morphWeights[targetIndex];
+      if (glm::abs(weight) < minMorphWeight || target.vertexIndices.size() == 0)
+      {
+         continue;
+      }
+
+      AddWeightedDeltas(&mMorphedPositions[0].x, target.vertexIndices, target.positionDeltas, weight);
+
+      if (target.normalDeltas.size() > 0)
+      {
+         AddWeightedDeltas(&mMorphedNormals[0].x, target.vertexIndices, target.normalDeltas, weight);
+      }
+
+      mDisplacedVertices.insert(mDisplacedVertices.end(), target.vertexIndices.begin(), target.vertexIndices.end());
+
+      // The vertex indices of a morph target are sorted, so its first and last indices define its range
+      mFirstDirtyMorphedVertex = std::min(mFirstDirtyMorphedVertex, target.vertexIndices.front());
+      mLastDirtyMorphedVertex  = std::max(mLastDirtyMorphedVertex, target.vertexIndices.back());
+   }
+}
+
+// This function uploads the vertices that were modified by the last call to ApplyMorphTargets into the dynamic buffer
+// It's only needed when skinning on the GPU, since the CPU skinning functions read the morphed vertices directly
+void AnimatedMesh::LoadMorphedVerticesIntoDynamicBuffer()
+{
+   const AnimatedMesh& meshData = GetMeshData();
+
+   if (mMorphedPositions.size() == 0 || mFirstDirtyMorphedVertex > mLastDirtyMorphedVertex)
+   {
+      return;
+   }
+
+   unsigned int numDirtyVertices = mLastDirtyMorphedVertex - mFirstDirtyMorphedVertex + 1;
+
+   std::vector<DynamicVertex> dirtyVertices(numDirtyVertices);
+   for (unsigned int i = 0; i < numDirtyVertices; ++i)
+   {
+      dirtyVertices[i].position = mMorphedPositions[mFirstDirtyMorphedVertex + i];
+      dirtyVertices[i].normal   = mMorphedNormals[mFirstDirtyMorphedVertex + i];
+   }
+
+   glBindBuffer(GL_ARRAY_BUFFER, mDynamicVBO);
+   glBufferSubData(GL_ARRAY_BUFFER, mFirstDirtyMorphedVertex * sizeof(DynamicVertex), dirtyVertices.size() * sizeof(DynamicVertex), &dirtyVertices[0]);
+   glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+   // The dirty range has been uploaded, so there's nothing left to upload until the morph targets are applied again
+   mFirstDirtyMorphedVertex = static_cast<unsigned int>(meshData.mPositions.size());
+   mLastDirtyMorphedVertex  = 0;
+}
+
+// This function samples the weights of the morph targets of the mesh from a clip and applies them
+// The sampling starts from the default weights, so the clip only overwrites the weights that it animates
+// It must be called before skinning, and uploadToDynamicBuffer must be true when skinning on the GPU
+void AnimatedMesh::ApplyMorphTargetsOfClip(const FastClip& clip, float time, bool uploadToDynamicBuffer)
+{
+   if (GetNumberOfMorphTargets() == 0)
+   {
+      return;
+   }
+
+   mMorphWeights = GetDefaultMorphWeights();
+   clip.SampleMorphWeights(GetNodeIndex(), mMorphWeights, time);
+   ApplyMorphTargets(mMorphWeights);
+
+   if (uploadToDynamicBuffer)
+   {
+      LoadMorphedVerticesIntoDynamicBuffer();
+   }
+}
+
 /*
    Deforming a mesh to match an animated pose is called "skinning"
    To skin a mesh, the mesh must be "rigged", which means that each of its vertices must have:
@@ -259,16 +674,21 @@ void AnimatedMesh::RenderInstanced(unsigned int numInstances)
 
 void AnimatedMesh::SkinMeshOnTheCPUUsingMatrices(Skeleton& skeleton, Pose& animatedPose)
 {
+   const AnimatedMesh& meshData = GetMeshData();
+
    // If the mesh doesn't have any vertices we can't skin it
-   unsigned int numVertices = static_cast<unsigned int>(mPositions.size());
+   unsigned int numVertices = static_cast<unsigned int>(meshData.mPositions.size());
    if (numVertices == 0)
    {
       return;
    }
 
-   // Resize the containers that will store the skinned positions and normals
-   mSkinnedPositions.resize(numVertices);
-   mSkinnedNormals.resize(numVertices);
+   // Resize the container that will store the skinned positions and normals
+   mSkinnedVertices.resize(numVertices);
+
+   // If the morph targets have been applied, we skin the morphed positions and normals instead of the ones of the bind pose
+   const std::vector<glm::vec3>& positions = (mMorphedPositions.size() > 0) ? mMorphedPositions : meshData.mPositions;
+   const std::vector<glm::vec3>& normals   = (mMorphedNormals.size() > 0)   ? mMorphedNormals   : meshData.mNormals;
 
    // Get the palettes of the inverse bind pose and the animated pose
    // Remember that a palette contains the global transform matrices of each joint
@@ -280,8 +700,8 @@ void AnimatedMesh::SkinMeshOnTheCPUUsingMatrices(Skeleton& skeleton, Pose& anima
    {
       // Get the influences and weights of the current vertex
       // The influences are the IDs of the joints that affect it
-      const glm::ivec4& influencesOfCurrVertex = mInfluences[vertexIndex];
-      const glm::vec4&  weightsOfCurrVertex    = mWeights[vertexIndex];
+      const glm::ivec4& influencesOfCurrVertex = meshData.mInfluences[vertexIndex];
+      const glm::vec4&  weightsOfCurrVertex    = meshData.mWeights[vertexIndex];
 
       // Calculate the skin matrix of each influencing joint independently
       // A skin matrix takes a vertex from the bind pose to skin space and then to the animated pose
@@ -298,36 +718,37 @@ void AnimatedMesh::SkinMeshOnTheCPUUsingMatrices(Skeleton& skeleton, Pose& anima
 
       // Calculate the skinned position and normal of the current vertex
       // Remember that the position is a point while the normal is a vector
-      mSkinnedPositions[vertexIndex] = skinMatrix * glm::vec4(mPositions[vertexIndex], 1.0f);
-      mSkinnedNormals[vertexIndex]   = skinMatrix * glm::vec4(mNormals[vertexIndex], 0.0f);
+      mSkinnedVertices[vertexIndex].position = skinMatrix * glm::vec4(positions[vertexIndex], 1.0f);
+      mSkinnedVertices[vertexIndex].normal   = skinMatrix * glm::vec4(normals[vertexIndex], 0.0f);
    }
 
    // TODO: Should I bind the VAO here?
 
-   // Load the skinned positions and normals into the buffers
-
-   // Positions
-   glBindBuffer(GL_ARRAY_BUFFER, mVBOs[VBOTypes::positions]);
-   glBufferSubData(GL_ARRAY_BUFFER, 0, mSkinnedPositions.size() * sizeof(glm::vec3), &mSkinnedPositions[0]);
-   // Normals
-   glBindBuffer(GL_ARRAY_BUFFER, mVBOs[VBOTypes::normals]);
-   glBufferSubData(GL_ARRAY_BUFFER, 0, mSkinnedNormals.size() * sizeof(glm::vec3), &mSkinnedNormals[0]);
+   // Load the skinned positions and normals into the dynamic buffer
+   // The texture coordinates, weights and influences live in the static buffer, so they don't need to be uploaded again
+   glBindBuffer(GL_ARRAY_BUFFER, mDynamicVBO);
+   glBufferSubData(GL_ARRAY_BUFFER, 0, mSkinnedVertices.size() * sizeof(DynamicVertex), &mSkinnedVertices[0]);
 
    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void AnimatedMesh::SkinMeshOnTheCPUUsingTransforms(Skeleton& skeleton, Pose& animatedPose)
 {
+   const AnimatedMesh& meshData = GetMeshData();
+
    // If the mesh doesn't have any vertices we can't skin it
-   unsigned int numVertices = static_cast<unsigned int>(mPositions.size());
+   unsigned int numVertices = static_cast<unsigned int>(meshData.mPositions.size());
    if (numVertices == 0)
    {
       return;
    }
 
-   // Resize the containers that will store the skinned positions and normals
-   mSkinnedPositions.resize(numVertices);
-   mSkinnedNormals.resize(numVertices);
+   // Resize the container that will store the skinned positions and normals
+   mSkinnedVertices.resize(numVertices);
+
+   // If the morph targets have been applied, we skin the morphed positions and normals instead of the ones of the bind pose
+   const std::vector<glm::vec3>& positions = (mMorphedPositions.size() > 0) ? mMorphedPositions : meshData.mPositions;
+   const std::vector<glm::vec3>& normals   = (mMorphedNormals.size() > 0)   ? mMorphedNormals   : meshData.mNormals;
 
    // Get the bind pose
    const Pose& bindPose = skeleton.GetBindPose();
@@ -337,105 +758,102 @@ void AnimatedMesh::SkinMeshOnTheCPUUsingTransforms(Skeleton& skeleton, Pose& ani
    {
       // Get the influences and weights of the current vertex
       // The influences are the IDs of the joints that affect it
-      const glm::ivec4& influencesOfCurrVertex = mInfluences[vertexIndex];
-      const glm::vec4&  weightsOfCurrVertex    = mWeights[vertexIndex];
+      const glm::ivec4& influencesOfCurrVertex = meshData.mInfluences[vertexIndex];
+      const glm::vec4&  weightsOfCurrVertex    = meshData.mWeights[vertexIndex];
 
       // Calculate the skin transform of each influencing joint independently and use it to calculate the skinned positions and normals
       Transform skinTransform0   = combine(animatedPose.GetGlobalTransform(influencesOfCurrVertex.x), inverse(bindPose.GetGlobalTransform(influencesOfCurrVertex.x)));
-      glm::vec3 skinnedPosition0 = transformPoint(skinTransform0, mPositions[vertexIndex]);
-      glm::vec3 skinnedNormal0   = transformVector(skinTransform0, mNormals[vertexIndex]);
+      glm::vec3 skinnedPosition0 = transformPoint(skinTransform0, positions[vertexIndex]);
+      glm::vec3 skinnedNormal0   = transformVector(skinTransform0, normals[vertexIndex]);
 
       Transform skinTransform1   = combine(animatedPose.GetGlobalTransform(influencesOfCurrVertex.y), inverse(bindPose.GetGlobalTransform(influencesOfCurrVertex.y)));
-      glm::vec3 skinnedPosition1 = transformPoint(skinTransform1, mPositions[vertexIndex]);
-      glm::vec3 skinnedNormal1   = transformVector(skinTransform1, mNormals[vertexIndex]);
+      glm::vec3 skinnedPosition1 = transformPoint(skinTransform1, positions[vertexIndex]);
+      glm::vec3 skinnedNormal1   = transformVector(skinTransform1, normals[vertexIndex]);
 
       Transform skinTransform2   = combine(animatedPose.GetGlobalTransform(influencesOfCurrVertex.z), inverse(bindPose.GetGlobalTransform(influencesOfCurrVertex.z)));
-      glm::vec3 skinnedPosition2 = transformPoint(skinTransform2, mPositions[vertexIndex]);
-      glm::vec3 skinnedNormal2   = transformVector(skinTransform2, mNormals[vertexIndex]);
+      glm::vec3 skinnedPosition2 = transformPoint(skinTransform2, positions[vertexIndex]);
+      glm::vec3 skinnedNormal2   = transformVector(skinTransform2, normals[vertexIndex]);
 
       Transform skinTransform3   = combine(animatedPose.GetGlobalTransform(influencesOfCurrVertex.w), inverse(bindPose.GetGlobalTransform(influencesOfCurrVertex.w)));
-      glm::vec3 skinnedPosition3 = transformPoint(skinTransform3, mPositions[vertexIndex]);
-      glm::vec3 skinnedNormal3   = transformVector(skinTransform3, mNormals[vertexIndex]);
+      glm::vec3 skinnedPosition3 = transformPoint(skinTransform3, positions[vertexIndex]);
+      glm::vec3 skinnedNormal3   = transformVector(skinTransform3, normals[vertexIndex]);
 
       // Combine the skinned positions and normals using the weights to obtain the final skinned position and normal
-      mSkinnedPositions[vertexIndex] = (skinnedPosition0 * weightsOfCurrVertex.x) +
-                                       (skinnedPosition1 * weightsOfCurrVertex.y) +
-                                       (skinnedPosition2 * weightsOfCurrVertex.z) +
-                                       (skinnedPosition3 * weightsOfCurrVertex.w);
-      mSkinnedNormals[vertexIndex] = (skinnedNormal0 * weightsOfCurrVertex.x) +
-                                     (skinnedNormal1 * weightsOfCurrVertex.y) +
-                                     (skinnedNormal2 * weightsOfCurrVertex.z) +
-                                     (skinnedNormal3 * weightsOfCurrVertex.w);
+      mSkinnedVertices[vertexIndex].position = (skinnedPosition0 * weightsOfCurrVertex.x) +
+                                               (skinnedPosition1 * weightsOfCurrVertex.y) +
+                                               (skinnedPosition2 * weightsOfCurrVertex.z) +
+                                               (skinnedPosition3 * weightsOfCurrVertex.w);
+      mSkinnedVertices[vertexIndex].normal = (skinnedNormal0 * weightsOfCurrVertex.x) +
+                                             (skinnedNormal1 * weightsOfCurrVertex.y) +
+                                             (skinnedNormal2 * weightsOfCurrVertex.z) +
+                                             (skinnedNormal3 * weightsOfCurrVertex.w);
    }
 
    // TODO: Should I bind the VAO here?
 
-   // Load the skinned positions and normals into the buffers
-
-   // Positions
-   glBindBuffer(GL_ARRAY_BUFFER, mVBOs[VBOTypes::positions]);
-   glBufferSubData(GL_ARRAY_BUFFER, 0, mSkinnedPositions.size() * sizeof(glm::vec3), &mSkinnedPositions[0]);
-   // Normals
-   glBindBuffer(GL_ARRAY_BUFFER, mVBOs[VBOTypes::normals]);
-   glBufferSubData(GL_ARRAY_BUFFER, 0, mSkinnedNormals.size() * sizeof(glm::vec3), &mSkinnedNormals[0]);
+   // Load the skinned positions and normals into the dynamic buffer
+   // The texture coordinates, weights and influences live in the static buffer, so they don't need to be uploaded again
+   glBindBuffer(GL_ARRAY_BUFFER, mDynamicVBO);
+   glBufferSubData(GL_ARRAY_BUFFER, 0, mSkinnedVertices.size() * sizeof(DynamicVertex), &mSkinnedVertices[0]);
 
    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void AnimatedMesh::SkinMeshOnTheCPU(std::vector<glm::mat4>& skinMatrices)
 {
+   const AnimatedMesh& meshData = GetMeshData();
+
    // If the mesh doesn't have any vertices we can't skin it
-   unsigned int numVertices = static_cast<unsigned int>(mPositions.size());
+   unsigned int numVertices = static_cast<unsigned int>(meshData.mPositions.size());
    if (numVertices == 0)
    {
       return;
    }
 
-   // Resize the containers that will store the skinned positions and normals
-   mSkinnedPositions.resize(numVertices);
-   mSkinnedNormals.resize(numVertices);
+   // Resize the container that will store the skinned positions and normals
+   mSkinnedVertices.resize(numVertices);
+
+   // If the morph targets have been applied, we skin the morphed positions and normals instead of the ones of the bind pose
+   const std::vector<glm::vec3>& positions = (mMorphedPositions.size() > 0) ? mMorphedPositions : meshData.mPositions;
+   const std::vector<glm::vec3>& normals   = (mMorphedNormals.size() > 0)   ? mMorphedNormals   : meshData.mNormals;
 
    // Loop over the vertices of the mesh
    for (unsigned int vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
    {
       // Get the influences and weights of the current vertex
       // The influences are the IDs of the joints that affect it
-      glm::ivec4& influencesOfCurrVertex = mInfluences[vertexIndex];
-      glm::vec4&  weightsOfCurrVertex    = mWeights[vertexIndex];
+      const glm::ivec4& influencesOfCurrVertex = meshData.mInfluences[vertexIndex];
+      const glm::vec4&  weightsOfCurrVertex    = meshData.mWeights[vertexIndex];
 
       // Calculate the skinned positions
-      glm::vec3 skinnedPosition0 = skinMatrices[influencesOfCurrVertex.x] * glm::vec4(mPositions[vertexIndex], 1.0f);
-      glm::vec3 skinnedPosition1 = skinMatrices[influencesOfCurrVertex.y] * glm::vec4(mPositions[vertexIndex], 1.0f);
-      glm::vec3 skinnedPosition2 = skinMatrices[influencesOfCurrVertex.z] * glm::vec4(mPositions[vertexIndex], 1.0f);
-      glm::vec3 skinnedPosition3 = skinMatrices[influencesOfCurrVertex.w] * glm::vec4(mPositions[vertexIndex], 1.0f);
+      glm::vec3 skinnedPosition0 = skinMatrices[influencesOfCurrVertex.x] * glm::vec4(positions[vertexIndex], 1.0f);
+      glm::vec3 skinnedPosition1 = skinMatrices[influencesOfCurrVertex.y] * glm::vec4(positions[vertexIndex], 1.0f);
+      glm::vec3 skinnedPosition2 = skinMatrices[influencesOfCurrVertex.z] * glm::vec4(positions[vertexIndex], 1.0f);
+      glm::vec3 skinnedPosition3 = skinMatrices[influencesOfCurrVertex.w] * glm::vec4(positions[vertexIndex], 1.0f);
       // Combine the skinned positions using the weights to obtain the final skinned position
-      mSkinnedPositions[vertexIndex] = (skinnedPosition0 * weightsOfCurrVertex.x) +
-                                       (skinnedPosition1 * weightsOfCurrVertex.y) +
-                                       (skinnedPosition2 * weightsOfCurrVertex.z) +
-                                       (skinnedPosition3 * weightsOfCurrVertex.w);
+      mSkinnedVertices[vertexIndex].position = (skinnedPosition0 * weightsOfCurrVertex.x) +
+                                               (skinnedPosition1 * weightsOfCurrVertex.y) +
+                                               (skinnedPosition2 * weightsOfCurrVertex.z) +
+                                               (skinnedPosition3 * weightsOfCurrVertex.w);
 
       // Calculate the skinned normals
-      glm::vec3 skinnedNormal0 = skinMatrices[influencesOfCurrVertex.x] * glm::vec4(mNormals[vertexIndex], 0.0f);
-      glm::vec3 skinnedNormal1 = skinMatrices[influencesOfCurrVertex.y] * glm::vec4(mNormals[vertexIndex], 0.0f);
-      glm::vec3 skinnedNormal2 = skinMatrices[influencesOfCurrVertex.z] * glm::vec4(mNormals[vertexIndex], 0.0f);
-      glm::vec3 skinnedNormal3 = skinMatrices[influencesOfCurrVertex.w] * glm::vec4(mNormals[vertexIndex], 0.0f);
+      glm::vec3 skinnedNormal0 = skinMatrices[influencesOfCurrVertex.x] * glm::vec4(normals[vertexIndex], 0.0f);
+      glm::vec3 skinnedNormal1 = skinMatrices[influencesOfCurrVertex.y] * glm::vec4(normals[vertexIndex], 0.0f);
+      glm::vec3 skinnedNormal2 = skinMatrices[influencesOfCurrVertex.z] * glm::vec4(normals[vertexIndex], 0.0f);
+      glm::vec3 skinnedNormal3 = skinMatrices[influencesOfCurrVertex.w] * glm::vec4(normals[vertexIndex], 0.0f);
       // Combine the skinned normals using the weights to obtain the final skinned normal
-      mSkinnedNormals[vertexIndex] = (skinnedNormal0 * weightsOfCurrVertex.x) +
-                                     (skinnedNormal1 * weightsOfCurrVertex.y) +
-                                     (skinnedNormal2 * weightsOfCurrVertex.z) +
-                                     (skinnedNormal3 * weightsOfCurrVertex.w);
+      mSkinnedVertices[vertexIndex].normal = (skinnedNormal0 * weightsOfCurrVertex.x) +
+                                             (skinnedNormal1 * weightsOfCurrVertex.y) +
+                                             (skinnedNormal2 * weightsOfCurrVertex.z) +
+                                             (skinnedNormal3 * weightsOfCurrVertex.w);
    }
 
    // TODO: Should I bind the VAO here?
 
-   // Load the skinned positions and normals into the buffers
-
-   // Positions
-   glBindBuffer(GL_ARRAY_BUFFER, mVBOs[VBOTypes::positions]);
-   glBufferSubData(GL_ARRAY_BUFFER, 0, mSkinnedPositions.size() * sizeof(glm::vec3), &mSkinnedPositions[0]);
-   // Normals
-   glBindBuffer(GL_ARRAY_BUFFER, mVBOs[VBOTypes::normals]);
-   glBufferSubData(GL_ARRAY_BUFFER, 0, mSkinnedNormals.size() * sizeof(glm::vec3), &mSkinnedNormals[0]);
+   // Load the skinned positions and normals into the dynamic buffer
+   // The texture coordinates, weights and influences live in the static buffer, so they don't need to be uploaded again
+   glBindBuffer(GL_ARRAY_BUFFER, mDynamicVBO);
+   glBufferSubData(GL_ARRAY_BUFFER, 0, mSkinnedVertices.size() * sizeof(DynamicVertex), &mSkinnedVertices[0]);
 
    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
@@ -0,0 +1,211 @@
+#include <chrono>
+
+#include "AssetLoader.h"
+
+AssetLoader::AssetLoader(unsigned int numWorkerThreads)
+   : mWorkerThreads()
+   , mTaskScheduler([this](std::function<void()>&& job) { Enqueue(std::move(job)); })
+   , mJobs()
+   , mJobsMutex()
+   , mJobAvailable()
+   , mStopWorkerThreads(false)
+   , mNumJobs(0)
+   , mNumFinishedJobs(0)
+   , mImages()
+   , mCharacters()
+   , mCharacterAssetCache()
+{
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+   // Without threads, the main thread runs the jobs in RunJobs
+   numWorkerThreads = 0;
+#endif
+
+   for (unsigned int threadIndex = 0; threadIndex < numWorkerThreads; ++threadIndex)
+   {
+      mWorkerThreads.emplace_back(&AssetLoader::RunWorkerThread, this);
+   }
+}
+
+// The jobs that are still queued are finished before the AssetLoader is destroyed, since destroying them would break their promises,
+// and anyone who is waiting on one of their handles would receive an exception instead of an asset
+AssetLoader::~AssetLoader()
+{
+   {
+      std::lock_guard<std::mutex> lock(mJobsMutex);
+      mStopWorkerThreads = true;
+   }
+   mJobAvailable.notify_all();
+
+   // The worker threads only stop once the queue is empty
+   for (std::thread& workerThread : mWorkerThreads)
+   {
+      workerThread.join();
+   }
+   mWorkerThreads.clear();
+
+   // Without worker threads, the jobs that RunJobs didn't get to are run here
+   while (RunNextJob())
+   {
+   }
+}
+
+std::shared_future<std::shared_ptr<const DecodedImage>> AssetLoader::LoadImage(const std::string& path)
+{
+   auto it = mImages.find(path);
+   if (it != mImages.end())
+   {
+      return it->second;
+   }
+
+   std::shared_ptr<std::promise<std::shared_ptr<const DecodedImage>>> promise = std::make_shared<std::promise<std::shared_ptr<const DecodedImage>>>();
+   std::shared_future<std::shared_ptr<const DecodedImage>> image = promise->get_future().share();
+   mImages[path] = image;
+
+   Enqueue([promise, path]()
+   {
+      promise->set_value(TextureLoader::decodeImage(path));
+   });
+
+   return image;
+}
+
+std::shared_future<std::shared_ptr<const CharacterAsset>> AssetLoader::LoadCharacter(const std::string& gltfPath, const std::string& bakedPath)
+{
+   auto it = mCharacters.find(gltfPath);
+   if (it != mCharacters.end())
+   {
+      return it->second;
+   }
+
+   std::shared_ptr<std::promise<std::shared_ptr<const CharacterAsset>>> promise = std::make_shared<std::promise<std::shared_ptr<const CharacterAsset>>>();
+   std::shared_future<std::shared_ptr<const CharacterAsset>> character = promise->get_future().share();
+   mCharacters[gltfPath] = character;
+
+   Enqueue([this, promise, gltfPath, bakedPath]()
+   {
+      promise->set_value(mCharacterAssetCache.Load(gltfPath, bakedPath));
+   });
+
+   return character;
+}
+
+std::shared_ptr<const DecodedImage> AssetLoader::GetImage(const std::string& path)
+{
+   return Wait(LoadImage(path));
+}
+
+std::shared_ptr<const CharacterAsset> AssetLoader::GetCharacter(const std::string& gltfPath, const std::string& bakedPath)
+{
+   return Wait(LoadCharacter(gltfPath, bakedPath));
+}
+
+void AssetLoader::RunJobs(double budgetInMs)
+{
+   if (!mWorkerThreads.empty())
+   {
+      return;
+   }
+
+   // We always run at least one job so that loading makes progress even if a single job exceeds the budget
+   auto start = std::chrono::steady_clock::now();
+   while (RunNextJob())
+   {
+      if (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() > budgetInMs)
+      {
+         break;
+      }
+   }
+}
+
+bool AssetLoader::IsIdle() const
+{
+   return mNumFinishedJobs == mNumJobs;
+}
+
+float AssetLoader::GetProgress() const
+{
+   unsigned int numJobs = mNumJobs;
+   return (numJobs == 0) ? 1.0f : static_cast<float>(mNumFinishedJobs) / static_cast<float>(numJobs);
+}
+
+void AssetLoader::ReleaseLoadedAssets()
+{
+   mImages.clear();
+   mCharacters.clear();
+}
+
+void AssetLoader::Enqueue(std::function<void()>&& job)
+{
+   ++mNumJobs;
+
+   {
+      std::lock_guard<std::mutex> lock(mJobsMutex);
+      mJobs.push_back(std::move(job));
+   }
+   mJobAvailable.notify_one();
+}
+
+bool AssetLoader::RunNextJob()
+{
+   std::function<void()> job;
+
+   {
+      std::lock_guard<std::mutex> lock(mJobsMutex);
+      if (mJobs.empty())
+      {
+         return false;
+      }
+
+      job = std::move(mJobs.front());
+      mJobs.pop_front();
+   }
+
+   // When there are worker threads, they can help with the tasks of a job that runs on the calling thread
+   const TaskScheduler* previousScheduler = SetTaskScheduler(mWorkerThreads.empty() ? nullptr : &mTaskScheduler);
+   job();
+   SetTaskScheduler(previousScheduler);
+
+   ++mNumFinishedJobs;
+   return true;
+}
+
+void AssetLoader::RunWorkerThread()
+{
+   SetTaskScheduler(&mTaskScheduler);
+
+   while (true)
+   {
+      std::function<void()> job;
+
+      {
+         std::unique_lock<std::mutex> lock(mJobsMutex);
+         mJobAvailable.wait(lock, [this]() { return mStopWorkerThreads || !mJobs.empty(); });
+         if (mJobs.empty())
+         {
+            // The queue is only empty here if the worker threads are being stopped
+            return;
+         }
+
+         job = std::move(mJobs.front());
+         mJobs.pop_front();
+      }
+
+      job();
+      ++mNumFinishedJobs;
+   }
+}
+
+template<typename T>
+T AssetLoader::Wait(const std::shared_future<T>& handle)
+{
+   while (handle.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+   {
+      // If there are no jobs left to run, then the asset is being loaded by a worker thread
+      if (!RunNextJob())
+      {
+         handle.wait();
+      }
+   }
+
+   return handle.get();
+}
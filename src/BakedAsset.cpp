@@ -0,0 +1,685 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+#include "BakedAsset.h"
+#include "MappedFile.h"
+
+namespace BakedAssetHelpers
+{
+   using namespace BakedAssetFormat;
+
+   // The arrays are copied between the file and memory byte by byte, so their elements can't have constructors that do anything
+   static_assert(std::is_trivially_copyable<Transform>::value,       "Transforms must be trivially copyable to be baked");
+   static_assert(std::is_trivially_copyable<QuaternionFrame>::value, "Frames must be trivially copyable to be baked");
+   static_assert(sizeof(Transform) == 40,                            "The layout of Transform doesn't match the one of the baked assets");
+   static_assert(sizeof(glm::mat4) == 64,                            "The layout of glm::mat4 doesn't match the one of the baked assets");
+
+   // This class turns the BakedArrays of a mapped file into pointers, which is the only fixup that the data of a baked asset needs
+   // Every array is checked against the bounds of the file, and if one of them is out of bounds, the reader is marked as invalid
+   // and it returns empty arrays from then on, so that a corrupt file is rejected instead of being read out of bounds
+   // Note that the contents of the arrays are trusted, since baked assets are produced by the asset baker
+   class Reader
+   {
+   public:
+
+      Reader(const char* data, size_t size)
+         : mData(data)
+         , mSize(size)
+         , mIsValid(true)
+      {
+
+      }
+
+      template<typename T>
+      const T* Resolve(const BakedArray& array, unsigned int& outCount)
+      {
+         outCount = 0;
+         if (!mIsValid || array.count == 0)
+         {
+            return nullptr;
+         }
+
+         uint64_t endOfArray = static_cast<uint64_t>(array.offset) + (static_cast<uint64_t>(array.count) * sizeof(T));
+         if ((array.offset % alignment) != 0 || endOfArray > mSize)
+         {
+            mIsValid = false;
+            return nullptr;
+         }
+
+         outCount = array.count;
+         return reinterpret_cast<const T*>(mData + array.offset);
+      }
+
+      template<typename T>
+      void Read(const BakedArray& array, std::vector<T>& outVector)
+      {
+         unsigned int count;
+         const T* elements = Resolve<T>(array, count);
+         outVector.assign(elements, elements + count);
+      }
+
+      std::string ReadString(const BakedArray& array)
+      {
+         unsigned int count;
+         const char* characters = Resolve<char>(array, count);
+         return std::string(characters, count);
+      }
+
+      template<typename T, unsigned int N>
+      void ReadTrack(const BakedTrack& bakedTrack, FastTrack<T, N>& outTrack)
+      {
+         unsigned int numFrames;
+         const Frame<N>* frames = Resolve<Frame<N>>(bakedTrack.frames, numFrames);
+         outTrack.SetFrames(frames, numFrames);
+
+         unsigned int numSamples;
+         const unsigned int* sampleToFrameIndexMap = Resolve<unsigned int>(bakedTrack.sampleToFrameIndexMap, numSamples);
+         outTrack.SetSampleToFrameIndexMap(sampleToFrameIndexMap, numSamples);
+
+         if (bakedTrack.interpolation > static_cast<uint32_t>(Interpolation::Cubic))
+         {
+            mIsValid = false;
+            return;
+         }
+
+         outTrack.SetInterpolation(static_cast<Interpolation>(bakedTrack.interpolation));
+      }
+
+      void Invalidate() { mIsValid = false; }
+      bool IsValid() const { return mIsValid; }
+
+   private:
+
+      const char* mData;
+      size_t      mSize;
+      bool        mIsValid;
+   };
+
+   // This class builds a baked asset in memory
+   // The header and the table of sections are stored at the start of the buffer, and they are filled in when the buffer is saved
+   class Writer
+   {
+   public:
+
+      Writer()
+         : mData(sizeof(Header) + (numSections * sizeof(Section)), 0)
+      {
+
+      }
+
+      // This function appends an array to the buffer at the next offset that is a multiple of the alignment
+      template<typename T>
+      BakedArray WriteArray(const T* elements, size_t count)
+      {
+         mData.resize(((mData.size() + alignment - 1) / alignment) * alignment, 0);
+
+         BakedArray array;
+         array.offset = static_cast<uint32_t>(mData.size());
+         array.count  = static_cast<uint32_t>(count);
+
+         if (count > 0)
+         {
+            const char* bytes = reinterpret_cast<const char*>(elements);
+            mData.insert(mData.end(), bytes, bytes + (count * sizeof(T)));
+         }
+
+         return array;
+      }
+
+      template<typename T>
+      BakedArray WriteArray(const std::vector<T>& elements)
+      {
+         return WriteArray(elements.data(), elements.size());
+      }
+
+      BakedArray WriteString(const std::string& string)
+      {
+         return WriteArray(string.data(), string.size());
+      }
+
+      template<typename T, unsigned int N>
+      BakedTrack WriteTrack(const FastTrack<T, N>& track)
+      {
+         BakedTrack bakedTrack;
+         bakedTrack.frames                = WriteArray(track.GetFrames(), track.GetNumberOfFrames());
+         bakedTrack.sampleToFrameIndexMap = WriteArray(track.GetSampleToFrameIndexMap());
+         bakedTrack.interpolation         = static_cast<uint32_t>(track.GetInterpolation());
+         bakedTrack.padding               = 0;
+         return bakedTrack;
+      }
+
+      void SetSection(SectionType type, const BakedArray& records)
+      {
+         memcpy(&mData[sizeof(Header) + (type * sizeof(Section))], &records, sizeof(Section));
+      }
+
+      bool Save(const char* path)
+      {
+         Header header;
+         header.magic       = magic;
+         header.version     = version;
+         header.fileSize    = static_cast<uint32_t>(mData.size());
+         header.numSections = numSections;
+         memcpy(&mData[0], &header, sizeof(Header));
+
+         FILE* file = fopen(path, "wb");
+         if (file == nullptr)
+         {
+            std::cout << "Could not open the following file for writing: " << path << '\n';
+            return false;
+         }
+
+         size_t numBytesWritten = fwrite(mData.data(), 1, mData.size(), file);
+         fclose(file);
+
+         if (numBytesWritten != mData.size())
+         {
+            std::cout << "Could not write the following baked asset: " << path << '\n';
+            return false;
+         }
+
+         return true;
+      }
+
+      size_t GetSize() const { return mData.size(); }
+
+   private:
+
+      std::vector<char> mData;
+   };
+
+   // These functions check that the arrays of a clip are within the bounds of the file without copying them,
+   // and they add up their sizes, which is how much memory the clip takes up once it's copied out of the mapping
+   template<unsigned int N>
+   size_t ValidateTrack(Reader& reader, const BakedTrack& bakedTrack)
+   {
+      unsigned int numFrames, numSamples;
+      reader.Resolve<Frame<N>>(bakedTrack.frames, numFrames);
+      reader.Resolve<unsigned int>(bakedTrack.sampleToFrameIndexMap, numSamples);
+
+      if (bakedTrack.interpolation > static_cast<uint32_t>(Interpolation::Cubic))
+      {
+         reader.Invalidate();
+      }
+
+      return (numFrames * sizeof(Frame<N>)) + (numSamples * sizeof(unsigned int));
+   }
+
+   size_t ValidateClip(Reader& reader, const BakedClip& bakedClip, unsigned int numJoints)
+   {
+      size_t sizeInBytes = 0;
+
+      unsigned int numTransfTracks;
+      const BakedTransformTrack* bakedTransformTracks = reader.Resolve<BakedTransformTrack>(bakedClip.transformTracks, numTransfTracks);
+      for (unsigned int transfTrackIndex = 0; transfTrackIndex < numTransfTracks; ++transfTrackIndex)
+      {
+         const BakedTransformTrack& bakedTransformTrack = bakedTransformTracks[transfTrackIndex];
+         if (bakedTransformTrack.jointID >= numJoints)
+         {
+            reader.Invalidate();
+            break;
+         }
+
+         sizeInBytes += ValidateTrack<3>(reader, bakedTransformTrack.position);
+         sizeInBytes += ValidateTrack<4>(reader, bakedTransformTrack.rotation);
+         sizeInBytes += ValidateTrack<3>(reader, bakedTransformTrack.scale);
+      }
+
+      unsigned int numWeightsTracks;
+      const BakedMorphWeightsTrack* bakedMorphWeightsTracks = reader.Resolve<BakedMorphWeightsTrack>(bakedClip.morphWeightsTracks, numWeightsTracks);
+      for (unsigned int weightsTrackIndex = 0; weightsTrackIndex < numWeightsTracks; ++weightsTrackIndex)
+      {
+         unsigned int numTargets;
+         const BakedTrack* bakedWeightTracks = reader.Resolve<BakedTrack>(bakedMorphWeightsTracks[weightsTrackIndex].weightTracks, numTargets);
+         for (unsigned int targetIndex = 0; targetIndex < numTargets; ++targetIndex)
+         {
+            sizeInBytes += ValidateTrack<1>(reader, bakedWeightTracks[targetIndex]);
+         }
+      }
+
+      return sizeInBytes;
+   }
+
+   // This function copies the arrays of a clip out of a mapped file
+   void ReadClip(Reader& reader, const BakedClip& bakedClip, unsigned int numJoints, FastClip& outClip)
+   {
+      outClip.SetName(reader.ReadString(bakedClip.name));
+      outClip.SetLooping(bakedClip.looping != 0);
+
+      unsigned int numTransfTracks;
+      const BakedTransformTrack* bakedTransformTracks = reader.Resolve<BakedTransformTrack>(bakedClip.transformTracks, numTransfTracks);
+      for (unsigned int transfTrackIndex = 0; transfTrackIndex < numTransfTracks; ++transfTrackIndex)
+      {
+         const BakedTransformTrack& bakedTransformTrack = bakedTransformTracks[transfTrackIndex];
+         if (bakedTransformTrack.jointID >= numJoints)
+         {
+            reader.Invalidate();
+            break;
+         }
+
+         FastTransformTrack& transformTrack = outClip.GetTransformTrackOfJoint(bakedTransformTrack.jointID);
+         reader.ReadTrack(bakedTransformTrack.position, transformTrack.GetPositionTrack());
+         reader.ReadTrack(bakedTransformTrack.rotation, transformTrack.GetRotationTrack());
+         reader.ReadTrack(bakedTransformTrack.scale, transformTrack.GetScaleTrack());
+      }
+
+      unsigned int numWeightsTracks;
+      const BakedMorphWeightsTrack* bakedMorphWeightsTracks = reader.Resolve<BakedMorphWeightsTrack>(bakedClip.morphWeightsTracks, numWeightsTracks);
+      for (unsigned int weightsTrackIndex = 0; weightsTrackIndex < numWeightsTracks; ++weightsTrackIndex)
+      {
+         const BakedMorphWeightsTrack& bakedMorphWeightsTrack = bakedMorphWeightsTracks[weightsTrackIndex];
+
+         unsigned int numTargets;
+         const BakedTrack* bakedWeightTracks = reader.Resolve<BakedTrack>(bakedMorphWeightsTrack.weightTracks, numTargets);
+
+         FastMorphWeightsTrack& morphWeightsTrack = outClip.GetMorphWeightsTrackOfNode(bakedMorphWeightsTrack.nodeID);
+         morphWeightsTrack.SetNumberOfTargets(numTargets);
+         for (unsigned int targetIndex = 0; targetIndex < numTargets; ++targetIndex)
+         {
+            reader.ReadTrack(bakedWeightTracks[targetIndex], morphWeightsTrack.GetWeightTrack(targetIndex));
+         }
+      }
+
+      outClip.RecalculateDuration();
+
+      // The baked maps are identical for tracks with identical times, so only one of them is kept for each timeline
+      ShareTimelines(outClip);
+   }
+
+   // These functions count the differences between two assets, which is how the asset baker verifies the assets that it bakes
+   template<typename T>
+   unsigned int CountMismatches(const std::vector<T>& a, const std::vector<T>& b)
+   {
+      return (a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0)) ? 0 : 1;
+   }
+
+   unsigned int CountMismatches(CharacterAsset& a, CharacterAsset& b)
+   {
+      unsigned int numMismatches = 0;
+
+      numMismatches += (a.skeleton.GetRestPose() != b.skeleton.GetRestPose()) ? 1 : 0;
+      numMismatches += (a.skeleton.GetBindPose() != b.skeleton.GetBindPose()) ? 1 : 0;
+      numMismatches += CountMismatches(a.skeleton.GetInvBindPose(), b.skeleton.GetInvBindPose());
+      numMismatches += (a.skeleton.GetJointNames() != b.skeleton.GetJointNames()) ? 1 : 0;
+
+      if (a.meshes.size() != b.meshes.size() || a.clips->GetNumberOfClips() != b.clips->GetNumberOfClips())
+      {
+         return numMismatches + 1;
+      }
+
+      for (unsigned int meshIndex = 0, numMeshes = static_cast<unsigned int>(a.meshes.size()); meshIndex < numMeshes; ++meshIndex)
+      {
+         AnimatedMesh& meshA = a.meshes[meshIndex];
+         AnimatedMesh& meshB = b.meshes[meshIndex];
+         numMismatches += CountMismatches(meshA.GetPositions(), meshB.GetPositions());
+         numMismatches += CountMismatches(meshA.GetNormals(), meshB.GetNormals());
+         numMismatches += CountMismatches(meshA.GetTexCoords(), meshB.GetTexCoords());
+         numMismatches += CountMismatches(meshA.GetWeights(), meshB.GetWeights());
+         numMismatches += CountMismatches(meshA.GetInfluences(), meshB.GetInfluences());
+         numMismatches += CountMismatches(meshA.GetIndices(), meshB.GetIndices());
+         numMismatches += (meshA.GetLODIndices() != meshB.GetLODIndices()) ? 1 : 0;
+         numMismatches += CountMismatches(meshA.GetLODErrors(), meshB.GetLODErrors());
+         numMismatches += CountMismatches(meshA.GetDefaultMorphWeights(), meshB.GetDefaultMorphWeights());
+         numMismatches += (meshA.GetNumberOfMorphTargets() != meshB.GetNumberOfMorphTargets()) ? 1 : 0;
+         numMismatches += (meshA.GetNodeIndex() != meshB.GetNodeIndex()) ? 1 : 0;
+      }
+
+      // The clips are compared by sampling them, which compares their frames and their maps of samples to frames at the same time
+      Pose poseA = a.skeleton.GetRestPose();
+      Pose poseB = b.skeleton.GetRestPose();
+      for (unsigned int clipIndex = 0, numClips = a.clips->GetNumberOfClips(); clipIndex < numClips; ++clipIndex)
+      {
+         std::shared_ptr<const FastClip> clipHandleA = a.clips->GetClip(clipIndex);
+         std::shared_ptr<const FastClip> clipHandleB = b.clips->GetClip(clipIndex);
+         if (!clipHandleA || !clipHandleB)
+         {
+            ++numMismatches;
+            continue;
+         }
+
+         const FastClip& clipA = *clipHandleA;
+         const FastClip& clipB = *clipHandleB;
+         numMismatches += (clipA.GetName() != clipB.GetName() || clipA.GetLooping() != clipB.GetLooping() || clipA.GetDuration() != clipB.GetDuration()) ? 1 : 0;
+
+         const unsigned int numSamples = 64;
+         for (unsigned int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+         {
+            float time = clipA.GetStartTime() + (clipA.GetDuration() * sampleIndex) / (numSamples - 1);
+            clipA.Sample(poseA, time);
+            clipB.Sample(poseB, time);
+            numMismatches += (poseA != poseB) ? 1 : 0;
+         }
+      }
+
+      return numMismatches;
+   }
+}
+
+bool WriteBakedCharacterAsset(CharacterAsset& asset, const char* path)
+{
+   using namespace BakedAssetHelpers;
+
+   Writer writer;
+
+   // Skeleton
+   {
+      Skeleton& skeleton  = asset.skeleton;
+      Pose&     restPose  = skeleton.GetRestPose();
+      Pose&     bindPose  = skeleton.GetBindPose();
+      unsigned int numJoints = restPose.GetNumberOfJoints();
+
+      std::vector<int32_t>   parentIndices(numJoints);
+      std::vector<Transform> restTransforms(numJoints);
+      std::vector<Transform> bindTransforms(numJoints);
+      for (unsigned int jointIndex = 0; jointIndex < numJoints; ++jointIndex)
+      {
+         parentIndices[jointIndex]  = restPose.GetParent(jointIndex);
+         restTransforms[jointIndex] = restPose.GetLocalTransform(jointIndex);
+         bindTransforms[jointIndex] = bindPose.GetLocalTransform(jointIndex);
+      }
+
+      std::vector<BakedArray> jointNames;
+      for (const std::string& jointName : skeleton.GetJointNames())
+      {
+         jointNames.push_back(writer.WriteString(jointName));
+      }
+
+      BakedSkeleton bakedSkeleton;
+      bakedSkeleton.parentIndices = writer.WriteArray(parentIndices);
+      bakedSkeleton.restPose      = writer.WriteArray(restTransforms);
+      bakedSkeleton.bindPose      = writer.WriteArray(bindTransforms);
+      bakedSkeleton.invBindPose   = writer.WriteArray(skeleton.GetInvBindPose());
+      bakedSkeleton.jointNames    = writer.WriteArray(jointNames);
+      writer.SetSection(skeletonSection, writer.WriteArray(&bakedSkeleton, 1));
+   }
+
+   // Meshes
+   {
+      std::vector<BakedMesh> bakedMeshes;
+      for (AnimatedMesh& mesh : asset.meshes)
+      {
+         std::vector<BakedArray> lodIndices;
+         for (const std::vector<unsigned int>& indicesOfLOD : mesh.GetLODIndices())
+         {
+            lodIndices.push_back(writer.WriteArray(indicesOfLOD));
+         }
+
+         std::vector<BakedMorphTarget> morphTargets;
+         for (const MorphTarget& morphTarget : mesh.GetMorphTargets())
+         {
+            BakedMorphTarget bakedMorphTarget;
+            bakedMorphTarget.name           = writer.WriteString(morphTarget.name);
+            bakedMorphTarget.vertexIndices  = writer.WriteArray(morphTarget.vertexIndices);
+            bakedMorphTarget.positionDeltas = writer.WriteArray(morphTarget.positionDeltas);
+            bakedMorphTarget.normalDeltas   = writer.WriteArray(morphTarget.normalDeltas);
+            morphTargets.push_back(bakedMorphTarget);
+         }
+
+         BakedMesh bakedMesh;
+         bakedMesh.positions           = writer.WriteArray(mesh.GetPositions());
+         bakedMesh.normals             = writer.WriteArray(mesh.GetNormals());
+         bakedMesh.texCoords           = writer.WriteArray(mesh.GetTexCoords());
+         bakedMesh.weights             = writer.WriteArray(mesh.GetWeights());
+         bakedMesh.influences          = writer.WriteArray(mesh.GetInfluences());
+         bakedMesh.indices             = writer.WriteArray(mesh.GetIndices());
+         bakedMesh.lodIndices          = writer.WriteArray(lodIndices);
+         bakedMesh.lodErrors           = writer.WriteArray(mesh.GetLODErrors());
+         bakedMesh.morphTargets        = writer.WriteArray(morphTargets);
+         bakedMesh.defaultMorphWeights = writer.WriteArray(mesh.GetDefaultMorphWeights());
+         bakedMesh.nodeIndex           = mesh.GetNodeIndex();
+         bakedMesh.padding             = 0;
+         bakedMeshes.push_back(bakedMesh);
+      }
+
+      writer.SetSection(meshSection, writer.WriteArray(bakedMeshes));
+   }
+
+   // Clips
+   {
+      std::vector<BakedClip> bakedClips;
+      for (unsigned int clipIndex = 0, numClips = asset.clips->GetNumberOfClips(); clipIndex < numClips; ++clipIndex)
+      {
+         // The tracks of a clip can only be accessed through a non-const clip, so the clip is copied
+         FastClip clip = *asset.clips->GetClip(clipIndex);
+
+         std::vector<BakedTransformTrack> transformTracks;
+         for (unsigned int transfTrackIndex = 0, numTransfTracks = clip.GetNumberOfTransformTracks(); transfTrackIndex < numTransfTracks; ++transfTrackIndex)
+         {
+            unsigned int        jointID        = clip.GetJointIDOfTransformTrack(transfTrackIndex);
+            FastTransformTrack& transformTrack = clip.GetTransformTrackOfJoint(jointID);
+
+            BakedTransformTrack bakedTransformTrack;
+            bakedTransformTrack.jointID  = jointID;
+            bakedTransformTrack.padding  = 0;
+            bakedTransformTrack.position = writer.WriteTrack(transformTrack.GetPositionTrack());
+            bakedTransformTrack.rotation = writer.WriteTrack(transformTrack.GetRotationTrack());
+            bakedTransformTrack.scale    = writer.WriteTrack(transformTrack.GetScaleTrack());
+            transformTracks.push_back(bakedTransformTrack);
+         }
+
+         std::vector<BakedMorphWeightsTrack> morphWeightsTracks;
+         for (unsigned int weightsTrackIndex = 0, numWeightsTracks = clip.GetNumberOfMorphWeightsTracks(); weightsTrackIndex < numWeightsTracks; ++weightsTrackIndex)
+         {
+            unsigned int           nodeID            = clip.GetNodeIDOfMorphWeightsTrack(weightsTrackIndex);
+            FastMorphWeightsTrack& morphWeightsTrack = clip.GetMorphWeightsTrackOfNode(nodeID);
+
+            std::vector<BakedTrack> weightTracks;
+            for (unsigned int targetIndex = 0, numTargets = morphWeightsTrack.GetNumberOfTargets(); targetIndex < numTargets; ++targetIndex)
+            {
+               weightTracks.push_back(writer.WriteTrack(morphWeightsTrack.GetWeightTrack(targetIndex)));
+            }
+
+            BakedMorphWeightsTrack bakedMorphWeightsTrack;
+            bakedMorphWeightsTrack.nodeID       = nodeID;
+            bakedMorphWeightsTrack.padding      = 0;
+            bakedMorphWeightsTrack.weightTracks = writer.WriteArray(weightTracks);
+            morphWeightsTracks.push_back(bakedMorphWeightsTrack);
+         }
+
+         BakedClip bakedClip;
+         bakedClip.name               = writer.WriteString(clip.GetName());
+         bakedClip.transformTracks    = writer.WriteArray(transformTracks);
+         bakedClip.morphWeightsTracks = writer.WriteArray(morphWeightsTracks);
+         bakedClip.looping            = clip.GetLooping() ? 1 : 0;
+         bakedClip.padding            = 0;
+         bakedClips.push_back(bakedClip);
+      }
+
+      writer.SetSection(clipSection, writer.WriteArray(bakedClips));
+   }
+
+   return writer.Save(path);
+}
+
+bool LoadBakedCharacterAsset(const char* path, CharacterAsset& outAsset)
+{
+   using namespace BakedAssetHelpers;
+
+   // A missing baked asset is not an error, since the glTF file can be loaded instead
+   // The file is shared with the functions that load the clips, which keep it mapped for as long as the clips of the asset exist
+   std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+   if (!file->Open(path))
+   {
+      return false;
+   }
+
+   const char* data = file->GetData();
+   size_t      size = file->GetSize();
+
+   const Header* header = reinterpret_cast<const Header*>(data);
+   if (size < sizeof(Header) + (numSections * sizeof(Section)) || header->magic != magic || header->fileSize != size || header->numSections != numSections)
+   {
+      std::cout << "The following baked asset is corrupt: " << path << '\n';
+      return false;
+   }
+
+   if (header->version != version)
+   {
+      std::cout << "The following baked asset has version " << header->version << " instead of version " << version << ", so it must be baked again: " << path << '\n';
+      return false;
+   }
+
+   const Section* sections = reinterpret_cast<const Section*>(data + sizeof(Header));
+   Reader         reader(data, size);
+
+   // Skeleton
+   unsigned int numSkeletons;
+   const BakedSkeleton* bakedSkeleton = reader.Resolve<BakedSkeleton>(sections[skeletonSection], numSkeletons);
+   if (numSkeletons != 1)
+   {
+      std::cout << "The following baked asset is corrupt: " << path << '\n';
+      return false;
+   }
+
+   unsigned int numJoints, numRestTransforms, numBindTransforms, numJointNames;
+   const int32_t*    parentIndices  = reader.Resolve<int32_t>(bakedSkeleton->parentIndices, numJoints);
+   const Transform*  restTransforms = reader.Resolve<Transform>(bakedSkeleton->restPose, numRestTransforms);
+   const Transform*  bindTransforms = reader.Resolve<Transform>(bakedSkeleton->bindPose, numBindTransforms);
+   const BakedArray* jointNames     = reader.Resolve<BakedArray>(bakedSkeleton->jointNames, numJointNames);
+
+   std::vector<glm::mat4> invBindPose;
+   reader.Read(bakedSkeleton->invBindPose, invBindPose);
+
+   if (numRestTransforms != numJoints || numBindTransforms != numJoints || numJointNames != numJoints || invBindPose.size() != numJoints)
+   {
+      reader.Invalidate();
+   }
+
+   Pose restPose(numJoints);
+   Pose bindPose(numJoints);
+   std::vector<std::string> jointNameStrings(numJoints);
+   for (unsigned int jointIndex = 0; jointIndex < numJoints && reader.IsValid(); ++jointIndex)
+   {
+      // The parents must come before their children, otherwise calculating a global transform could loop forever
+      if (parentIndices[jointIndex] < -1 || parentIndices[jointIndex] >= static_cast<int32_t>(jointIndex))
+      {
+         reader.Invalidate();
+         break;
+      }
+
+      restPose.SetParent(jointIndex, parentIndices[jointIndex]);
+      restPose.SetLocalTransform(jointIndex, restTransforms[jointIndex]);
+      bindPose.SetParent(jointIndex, parentIndices[jointIndex]);
+      bindPose.SetLocalTransform(jointIndex, bindTransforms[jointIndex]);
+      jointNameStrings[jointIndex] = reader.ReadString(jointNames[jointIndex]);
+   }
+
+   outAsset.skeleton.Set(restPose, bindPose, invBindPose, jointNameStrings);
+
+   // Meshes
+   unsigned int numMeshes;
+   const BakedMesh* bakedMeshes = reader.Resolve<BakedMesh>(sections[meshSection], numMeshes);
+   outAsset.meshes.clear();
+   outAsset.meshes.resize(numMeshes);
+   for (unsigned int meshIndex = 0; meshIndex < numMeshes; ++meshIndex)
+   {
+      const BakedMesh& bakedMesh = bakedMeshes[meshIndex];
+      AnimatedMesh&                 mesh      = outAsset.meshes[meshIndex];
+
+      reader.Read(bakedMesh.positions, mesh.GetPositions());
+      reader.Read(bakedMesh.normals, mesh.GetNormals());
+      reader.Read(bakedMesh.texCoords, mesh.GetTexCoords());
+      reader.Read(bakedMesh.weights, mesh.GetWeights());
+      reader.Read(bakedMesh.influences, mesh.GetInfluences());
+      reader.Read(bakedMesh.indices, mesh.GetIndices());
+      reader.Read(bakedMesh.lodErrors, mesh.GetLODErrors());
+      reader.Read(bakedMesh.defaultMorphWeights, mesh.GetDefaultMorphWeights());
+      mesh.SetNodeIndex(bakedMesh.nodeIndex);
+
+      unsigned int numLODs;
+      const BakedArray* lodIndices = reader.Resolve<BakedArray>(bakedMesh.lodIndices, numLODs);
+      mesh.GetLODIndices().resize(numLODs);
+      for (unsigned int lodIndex = 0; lodIndex < numLODs; ++lodIndex)
+      {
+         reader.Read(lodIndices[lodIndex], mesh.GetLODIndices()[lodIndex]);
+      }
+
+      unsigned int numMorphTargets;
+      const BakedMorphTarget* bakedMorphTargets = reader.Resolve<BakedMorphTarget>(bakedMesh.morphTargets, numMorphTargets);
+      mesh.GetMorphTargets().resize(numMorphTargets);
+      for (unsigned int targetIndex = 0; targetIndex < numMorphTargets; ++targetIndex)
+      {
+         MorphTarget& morphTarget = mesh.GetMorphTargets()[targetIndex];
+         morphTarget.name = reader.ReadString(bakedMorphTargets[targetIndex].name);
+         reader.Read(bakedMorphTargets[targetIndex].vertexIndices, morphTarget.vertexIndices);
+         reader.Read(bakedMorphTargets[targetIndex].positionDeltas, morphTarget.positionDeltas);
+         reader.Read(bakedMorphTargets[targetIndex].normalDeltas, morphTarget.normalDeltas);
+      }
+
+      // The bounds are indexed by joint, and they are cheap to calculate, so they aren't baked
+      mesh.CalculateBounds();
+   }
+
+   // Clips
+   // Only the names of the clips are read here, and their arrays are validated without copying them
+   // Each clip is copied out of the mapping the first time that it's requested from the ClipLibrary
+   unsigned int numClips;
+   const BakedClip* bakedClips = reader.Resolve<BakedClip>(sections[clipSection], numClips);
+   outAsset.clips = std::make_shared<ClipLibrary>();
+   for (unsigned int clipIndex = 0; clipIndex < numClips && reader.IsValid(); ++clipIndex)
+   {
+      const BakedClip& bakedClip   = bakedClips[clipIndex];
+      size_t           sizeInBytes = ValidateClip(reader, bakedClip, numJoints);
+
+      outAsset.clips->AddStreamedClip(reader.ReadString(bakedClip.name), sizeInBytes, [file, bakedClip, numJoints](FastClip& outClip)
+      {
+         Reader clipReader(file->GetData(), file->GetSize());
+         ReadClip(clipReader, bakedClip, numJoints, outClip);
+         return clipReader.IsValid();
+      });
+   }
+
+   if (!reader.IsValid())
+   {
+      std::cout << "The following baked asset is corrupt: " << path << '\n';
+      return false;
+   }
+
+   return true;
+}
+
+bool BakeCharacterAsset(const char* gltfPath, const char* bakedPath)
+{
+   using namespace BakedAssetHelpers;
+
+   auto start = std::chrono::steady_clock::now();
+   CharacterAsset gltfAsset;
+   if (!LoadCharacterAssetFromGLTF(gltfPath, gltfAsset))
+   {
+      return false;
+   }
+   auto end = std::chrono::steady_clock::now();
+   double gltfMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+   if (!WriteBakedCharacterAsset(gltfAsset, bakedPath))
+   {
+      return false;
+   }
+
+   start = std::chrono::steady_clock::now();
+   CharacterAsset bakedAsset;
+   if (!LoadBakedCharacterAsset(bakedPath, bakedAsset))
+   {
+      std::cout << "Could not load the following baked asset after baking it: " << bakedPath << '\n';
+      return false;
+   }
+   end = std::chrono::steady_clock::now();
+   double bakedMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+   // Both assets should be identical
+   unsigned int numMismatches = CountMismatches(gltfAsset, bakedAsset);
+
+   MappedFile bakedFile;
+   size_t     bakedSize = bakedFile.Open(bakedPath) ? bakedFile.GetSize() : 0;
+
+   std::cout << "Asset baker - Baked " << gltfPath << " into " << bakedPath << " (" << (bakedSize / 1024) << " KB)"
+             << ", Joints: " << bakedAsset.skeleton.GetRestPose().GetNumberOfJoints() << ", Meshes: " << bakedAsset.meshes.size() << ", Clips: " << bakedAsset.clips->GetNumberOfClips()
+             << ", Mismatches: " << numMismatches << '\n'
+             << "   Cold start from the glTF file:    " << gltfMilliseconds << " ms" << '\n'
+             << "   Cold start from the baked asset:  " << bakedMilliseconds << " ms (" << (gltfMilliseconds / glm::max(bakedMilliseconds, 1e-6)) << "x)" << '\n';
+
+   return numMismatches == 0;
+}
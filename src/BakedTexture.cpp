@@ -0,0 +1,677 @@
+#include <stb_image/stb_image.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include "BakedTexture.h"
+#include "MappedFile.h"
+
+namespace BakedTextureHelpers
+{
+   using namespace BakedTextureFormat;
+
+   // The OpenGL enums of the BC1 and BC3 formats, which are not part of the core profile
+   const unsigned int compressedRGBS3TCDXT1  = 0x83F0;
+   const unsigned int compressedRGBAS3TCDXT5 = 0x83F3;
+
+   uint32_t AlignOffset(uint32_t offset)
+   {
+      return (offset + alignment - 1) & ~(alignment - 1);
+   }
+
+   bool IsPowerOfTwo(int value)
+   {
+      return (value > 0) && ((value & (value - 1)) == 0);
+   }
+
+   int GetNumComponents(PixelFormat pixelFormat)
+   {
+      return (pixelFormat == rgb8 || pixelFormat == bc1) ? 3 : 4;
+   }
+
+   uint32_t GetMipLevelSize(PixelFormat pixelFormat, uint32_t width, uint32_t height)
+   {
+      uint32_t numBlocks = ((width + 3) / 4) * ((height + 3) / 4);
+      switch (pixelFormat)
+      {
+      case rgb8:  return width * height * 3;
+      case rgba8: return width * height * 4;
+      case bc1:   return numBlocks * 8;
+      case bc3:   return numBlocks * 16;
+      }
+
+      return 0;
+   }
+
+   // The functions below convert between sRGB values and linear values
+   float SRGBToLinear(float value)
+   {
+      return (value <= 0.04045f) ? (value / 12.92f) : std::pow((value + 0.055f) / 1.055f, 2.4f);
+   }
+
+   float LinearToSRGB(float value)
+   {
+      return (value <= 0.0031308f) ? (value * 12.92f) : ((1.055f * std::pow(value, 1.0f / 2.4f)) - 0.055f);
+   }
+
+   // This function generates the next mip level of an image with a box filter, which averages each block of 2x2 pixels
+   // When a size is odd, the last row or column is averaged with itself
+   // The color channels of sRGB images are averaged in linear space, while the alpha channel is always averaged as is
+   std::vector<unsigned char> GenerateMipLevel(const std::vector<unsigned char>& pixels, int width, int height, int numComponents, bool linear, int& outWidth, int& outHeight)
+   {
+      static const std::vector<float> srgbToLinear = []()
+      {
+         std::vector<float> table(256);
+         for (int value = 0; value < 256; ++value)
+         {
+            table[value] = SRGBToLinear(value / 255.0f);
+         }
+         return table;
+      }();
+
+      outWidth  = std::max(1, width / 2);
+      outHeight = std::max(1, height / 2);
+
+      std::vector<unsigned char> mipLevel(static_cast<size_t>(outWidth) * outHeight * numComponents);
+      for (int y = 0; y < outHeight; ++y)
+      {
+         int y0 = std::min(2 * y, height - 1);
+         int y1 = std::min((2 * y) + 1, height - 1);
+         for (int x = 0; x < outWidth; ++x)
+         {
+            int x0 = std::min(2 * x, width - 1);
+            int x1 = std::min((2 * x) + 1, width - 1);
+
+            const unsigned char* sourcePixels[4] = { &pixels[((static_cast<size_t>(y0) * width) + x0) * numComponents],
+                                                     &pixels[((static_cast<size_t>(y0) * width) + x1) * numComponents],
+                                                     &pixels[((static_cast<size_t>(y1) * width) + x0) * numComponents],
+                                                     &pixels[((static_cast<size_t>(y1) * width) + x1) * numComponents] };
+
+            unsigned char* mipPixel = &mipLevel[((static_cast<size_t>(y) * outWidth) + x) * numComponents];
+            for (int component = 0; component < numComponents; ++component)
+            {
+               bool isColor = !linear && (component < 3);
+
+               float sum = 0.0f;
+               for (const unsigned char* sourcePixel : sourcePixels)
+               {
+                  sum += isColor ? srgbToLinear[sourcePixel[component]] : (sourcePixel[component] / 255.0f);
+               }
+
+               float average = sum * 0.25f;
+               if (isColor)
+               {
+                  average = LinearToSRGB(average);
+               }
+
+               mipPixel[component] = static_cast<unsigned char>(std::min(255.0f, std::max(0.0f, (average * 255.0f) + 0.5f)));
+            }
+         }
+      }
+
+      return mipLevel;
+   }
+
+   uint16_t PackRGB565(const int color[3])
+   {
+      int r = (color[0] * 31 + 127) / 255;
+      int g = (color[1] * 63 + 127) / 255;
+      int b = (color[2] * 31 + 127) / 255;
+      return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+   }
+
+   void UnpackRGB565(uint16_t packedColor, int outColor[3])
+   {
+      int r = (packedColor >> 11) & 31;
+      int g = (packedColor >> 5) & 63;
+      int b = packedColor & 31;
+      outColor[0] = (r << 3) | (r >> 2);
+      outColor[1] = (g << 2) | (g >> 4);
+      outColor[2] = (b << 3) | (b >> 2);
+   }
+
+   // This function calculates the 4 colors of a BC1 block from its endpoints
+   // When the first endpoint is not greater than the second one, the block uses the 3-color mode, whose last color is transparent black
+   void GetPaletteOfColorBlock(uint16_t endpoint0, uint16_t endpoint1, bool forceFourColors, int outPalette[4][4])
+   {
+      UnpackRGB565(endpoint0, outPalette[0]);
+      UnpackRGB565(endpoint1, outPalette[1]);
+      outPalette[0][3] = 255;
+      outPalette[1][3] = 255;
+
+      bool fourColors = forceFourColors || (endpoint0 > endpoint1);
+      for (int channel = 0; channel < 3; ++channel)
+      {
+         if (fourColors)
+         {
+            outPalette[2][channel] = ((2 * outPalette[0][channel]) + outPalette[1][channel]) / 3;
+            outPalette[3][channel] = (outPalette[0][channel] + (2 * outPalette[1][channel])) / 3;
+         }
+         else
+         {
+            outPalette[2][channel] = (outPalette[0][channel] + outPalette[1][channel]) / 2;
+            outPalette[3][channel] = 0;
+         }
+      }
+      outPalette[2][3] = 255;
+      outPalette[3][3] = fourColors ? 255 : 0;
+   }
+
+   // This function compresses the colors of a block of 4x4 RGBA pixels into a BC1 block
+   // The endpoints are the corners of the bounding box of the colors, inset slightly to reduce the error of the pixels in between,
+   // and the diagonal of the box is chosen to follow the correlation between the channels
+   void CompressColorBlock(const unsigned char block[16][4], unsigned char outBlock[8])
+   {
+      int minColor[3] = { 255, 255, 255 };
+      int maxColor[3] = { 0, 0, 0 };
+      float mean[3] = { 0.0f, 0.0f, 0.0f };
+      for (int pixelIndex = 0; pixelIndex < 16; ++pixelIndex)
+      {
+         for (int channel = 0; channel < 3; ++channel)
+         {
+            minColor[channel] = std::min(minColor[channel], static_cast<int>(block[pixelIndex][channel]));
+            maxColor[channel] = std::max(maxColor[channel], static_cast<int>(block[pixelIndex][channel]));
+            mean[channel] += block[pixelIndex][channel] / 16.0f;
+         }
+      }
+
+      // Flip the range of the channels that are anticorrelated with the channel that varies the most
+      int mainChannel = 0;
+      for (int channel = 1; channel < 3; ++channel)
+      {
+         if ((maxColor[channel] - minColor[channel]) > (maxColor[mainChannel] - minColor[mainChannel]))
+         {
+            mainChannel = channel;
+         }
+      }
+
+      int endpoint0[3];
+      int endpoint1[3];
+      for (int channel = 0; channel < 3; ++channel)
+      {
+         float covariance = 0.0f;
+         for (int pixelIndex = 0; pixelIndex < 16; ++pixelIndex)
+         {
+            covariance += (block[pixelIndex][channel] - mean[channel]) * (block[pixelIndex][mainChannel] - mean[mainChannel]);
+         }
+
+         int inset = (maxColor[channel] - minColor[channel]) / 16;
+         int high  = maxColor[channel] - inset;
+         int low   = minColor[channel] + inset;
+         endpoint0[channel] = (covariance >= 0.0f) ? high : low;
+         endpoint1[channel] = (covariance >= 0.0f) ? low : high;
+      }
+
+      uint16_t packedEndpoint0 = PackRGB565(endpoint0);
+      uint16_t packedEndpoint1 = PackRGB565(endpoint1);
+
+      // The 4-color mode requires the first endpoint to be greater than the second one
+      if (packedEndpoint0 < packedEndpoint1)
+      {
+         std::swap(packedEndpoint0, packedEndpoint1);
+      }
+
+      int palette[4][4];
+      GetPaletteOfColorBlock(packedEndpoint0, packedEndpoint1, true, palette);
+
+      uint32_t indices = 0;
+      if (packedEndpoint0 != packedEndpoint1)
+      {
+         for (int pixelIndex = 0; pixelIndex < 16; ++pixelIndex)
+         {
+            int bestIndex    = 0;
+            int bestDistance = INT32_MAX;
+            for (int paletteIndex = 0; paletteIndex < 4; ++paletteIndex)
+            {
+               int distance = 0;
+               for (int channel = 0; channel < 3; ++channel)
+               {
+                  int difference = block[pixelIndex][channel] - palette[paletteIndex][channel];
+                  distance += difference * difference;
+               }
+
+               if (distance < bestDistance)
+               {
+                  bestDistance = distance;
+                  bestIndex    = paletteIndex;
+               }
+            }
+
+            indices |= static_cast<uint32_t>(bestIndex) << (2 * pixelIndex);
+         }
+      }
+
+      memcpy(outBlock + 0, &packedEndpoint0, 2);
+      memcpy(outBlock + 2, &packedEndpoint1, 2);
+      memcpy(outBlock + 4, &indices, 4);
+   }
+
+   // This function calculates the 8 alphas of the alpha block of a BC3 block from its endpoints
+   void GetPaletteOfAlphaBlock(int endpoint0, int endpoint1, int outPalette[8])
+   {
+      outPalette[0] = endpoint0;
+      outPalette[1] = endpoint1;
+      if (endpoint0 > endpoint1)
+      {
+         for (int i = 1; i < 7; ++i)
+         {
+            outPalette[i + 1] = (((7 - i) * endpoint0) + (i * endpoint1)) / 7;
+         }
+      }
+      else
+      {
+         for (int i = 1; i < 5; ++i)
+         {
+            outPalette[i + 1] = (((5 - i) * endpoint0) + (i * endpoint1)) / 5;
+         }
+         outPalette[6] = 0;
+         outPalette[7] = 255;
+      }
+   }
+
+   // This function compresses the alphas of a block of 4x4 RGBA pixels into the alpha block of a BC3 block
+   void CompressAlphaBlock(const unsigned char block[16][4], unsigned char outBlock[8])
+   {
+      int minAlpha = 255;
+      int maxAlpha = 0;
+      for (int pixelIndex = 0; pixelIndex < 16; ++pixelIndex)
+      {
+         minAlpha = std::min(minAlpha, static_cast<int>(block[pixelIndex][3]));
+         maxAlpha = std::max(maxAlpha, static_cast<int>(block[pixelIndex][3]));
+      }
+
+      int palette[8];
+      GetPaletteOfAlphaBlock(maxAlpha, minAlpha, palette);
+
+      uint64_t indices = 0;
+      if (maxAlpha != minAlpha)
+      {
+         for (int pixelIndex = 0; pixelIndex < 16; ++pixelIndex)
+         {
+            int bestIndex    = 0;
+            int bestDistance = INT32_MAX;
+            for (int paletteIndex = 0; paletteIndex < 8; ++paletteIndex)
+            {
+               int distance = std::abs(block[pixelIndex][3] - palette[paletteIndex]);
+               if (distance < bestDistance)
+               {
+                  bestDistance = distance;
+                  bestIndex    = paletteIndex;
+               }
+            }
+
+            indices |= static_cast<uint64_t>(bestIndex) << (3 * pixelIndex);
+         }
+      }
+
+      outBlock[0] = static_cast<unsigned char>(maxAlpha);
+      outBlock[1] = static_cast<unsigned char>(minAlpha);
+      for (int byteIndex = 0; byteIndex < 6; ++byteIndex)
+      {
+         outBlock[2 + byteIndex] = static_cast<unsigned char>((indices >> (8 * byteIndex)) & 0xFF);
+      }
+   }
+
+   // This function compresses a mip level into BC1 blocks (RGB) or BC3 blocks (RGBA)
+   // The pixels of the blocks that extend past the edges of the level are copies of the closest pixels of the level
+   std::vector<unsigned char> CompressMipLevel(const std::vector<unsigned char>& pixels, int width, int height, int numComponents)
+   {
+      PixelFormat pixelFormat = (numComponents == 3) ? bc1 : bc3;
+      uint32_t    blockSize   = (pixelFormat == bc1) ? 8 : 16;
+
+      std::vector<unsigned char> compressedLevel(GetMipLevelSize(pixelFormat, width, height));
+      unsigned char* outBlock = compressedLevel.data();
+      for (int blockY = 0; blockY < height; blockY += 4)
+      {
+         for (int blockX = 0; blockX < width; blockX += 4)
+         {
+            unsigned char block[16][4];
+            for (int pixelIndex = 0; pixelIndex < 16; ++pixelIndex)
+            {
+               int x = std::min(blockX + (pixelIndex % 4), width - 1);
+               int y = std::min(blockY + (pixelIndex / 4), height - 1);
+               const unsigned char* pixel = &pixels[((static_cast<size_t>(y) * width) + x) * numComponents];
+               block[pixelIndex][0] = pixel[0];
+               block[pixelIndex][1] = pixel[1];
+               block[pixelIndex][2] = pixel[2];
+               block[pixelIndex][3] = (numComponents == 4) ? pixel[3] : 255;
+            }
+
+            if (pixelFormat == bc3)
+            {
+               CompressAlphaBlock(block, outBlock);
+               CompressColorBlock(block, outBlock + 8);
+            }
+            else
+            {
+               CompressColorBlock(block, outBlock);
+            }
+
+            outBlock += blockSize;
+         }
+      }
+
+      return compressedLevel;
+   }
+
+   // This function writes a baked texture, whose mip levels must already be in the given pixel format
+   bool WriteBakedTexture(const char* path, PixelFormat pixelFormat, const std::vector<std::vector<unsigned char>>& mipLevels, int width, int height, size_t& outFileSize)
+   {
+      uint32_t numMipLevels = static_cast<uint32_t>(mipLevels.size());
+
+      std::vector<MipLevel> table(numMipLevels);
+      uint32_t offset = AlignOffset(static_cast<uint32_t>(sizeof(Header) + (numMipLevels * sizeof(MipLevel))));
+      uint32_t levelWidth  = static_cast<uint32_t>(width);
+      uint32_t levelHeight = static_cast<uint32_t>(height);
+      for (uint32_t level = 0; level < numMipLevels; ++level)
+      {
+         table[level].offset = offset;
+         table[level].size   = static_cast<uint32_t>(mipLevels[level].size());
+         table[level].width  = levelWidth;
+         table[level].height = levelHeight;
+
+         offset      = AlignOffset(offset + table[level].size);
+         levelWidth  = std::max(1u, levelWidth / 2);
+         levelHeight = std::max(1u, levelHeight / 2);
+      }
+
+      Header header;
+      header.magic        = magic;
+      header.version      = version;
+      header.fileSize     = offset;
+      header.pixelFormat  = pixelFormat;
+      header.width        = static_cast<uint32_t>(width);
+      header.height       = static_cast<uint32_t>(height);
+      header.numMipLevels = numMipLevels;
+      header.padding      = 0;
+
+      std::vector<char> data(offset, 0);
+      memcpy(&data[0], &header, sizeof(Header));
+      memcpy(&data[sizeof(Header)], table.data(), numMipLevels * sizeof(MipLevel));
+      for (uint32_t level = 0; level < numMipLevels; ++level)
+      {
+         memcpy(&data[table[level].offset], mipLevels[level].data(), table[level].size);
+      }
+
+      FILE* file = fopen(path, "wb");
+      if (file == nullptr)
+      {
+         std::cout << "Could not open the following file for writing: " << path << '\n';
+         return false;
+      }
+
+      size_t numBytesWritten = fwrite(data.data(), 1, data.size(), file);
+      fclose(file);
+
+      if (numBytesWritten != data.size())
+      {
+         std::cout << "Could not write the following baked texture: " << path << '\n';
+         return false;
+      }
+
+      outFileSize = data.size();
+      return true;
+   }
+}
+
+std::string GetBakedTexturePath(const std::string& imagePath)
+{
+   size_t lastSeparator = imagePath.find_last_of("/\\");
+   size_t lastDot       = imagePath.find_last_of('.');
+   if (lastDot == std::string::npos || (lastSeparator != std::string::npos && lastDot < lastSeparator))
+   {
+      return imagePath + ".tex";
+   }
+
+   return imagePath.substr(0, lastDot) + ".tex";
+}
+
+std::shared_ptr<DecodedImage> LoadBakedTexture(const std::string& path)
+{
+   using namespace BakedTextureHelpers;
+
+   // A missing baked texture is not an error, since the image can be decoded instead
+   std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+   if (!file->Open(path.c_str()))
+   {
+      return nullptr;
+   }
+
+   const char* data = file->GetData();
+   size_t      size = file->GetSize();
+
+   const Header* header = reinterpret_cast<const Header*>(data);
+   if (size < sizeof(Header) || header->magic != magic || header->fileSize != size)
+   {
+      std::cout << "The following baked texture is corrupt: " << path << '\n';
+      return nullptr;
+   }
+
+   if (header->version != version)
+   {
+      std::cout << "The following baked texture has version " << header->version << " instead of version " << version << ", so it must be baked again: " << path << '\n';
+      return nullptr;
+   }
+
+   if (header->pixelFormat > bc3 || header->numMipLevels == 0 || size < sizeof(Header) + (static_cast<uint64_t>(header->numMipLevels) * sizeof(MipLevel)))
+   {
+      std::cout << "The following baked texture is corrupt: " << path << '\n';
+      return nullptr;
+   }
+
+   PixelFormat     pixelFormat = static_cast<PixelFormat>(header->pixelFormat);
+   const MipLevel* table       = reinterpret_cast<const MipLevel*>(data + sizeof(Header));
+
+   std::vector<DecodedImage::MipLevel> mipLevels(header->numMipLevels);
+   for (uint32_t level = 0; level < header->numMipLevels; ++level)
+   {
+      const MipLevel& mipLevel = table[level];
+      if (static_cast<uint64_t>(mipLevel.offset) + mipLevel.size > size || mipLevel.size != GetMipLevelSize(pixelFormat, mipLevel.width, mipLevel.height))
+      {
+         std::cout << "The following baked texture is corrupt: " << path << '\n';
+         return nullptr;
+      }
+
+      mipLevels[level].width  = static_cast<int>(mipLevel.width);
+      mipLevels[level].height = static_cast<int>(mipLevel.height);
+      mipLevels[level].data   = reinterpret_cast<const unsigned char*>(data + mipLevel.offset);
+      mipLevels[level].size   = mipLevel.size;
+   }
+
+   unsigned int compressedFormat = 0;
+   if (pixelFormat == bc1)
+   {
+      compressedFormat = compressedRGBS3TCDXT1;
+   }
+   else if (pixelFormat == bc3)
+   {
+      compressedFormat = compressedRGBAS3TCDXT5;
+   }
+
+   return std::make_shared<DecodedImage>(file, GetNumComponents(pixelFormat), compressedFormat, std::move(mipLevels));
+}
+
+std::vector<unsigned char> DecompressMipLevel(const DecodedImage::MipLevel& mipLevel, unsigned int compressedFormat)
+{
+   using namespace BakedTextureHelpers;
+
+   bool     hasAlphaBlocks = (compressedFormat == compressedRGBAS3TCDXT5);
+   uint32_t blockSize      = hasAlphaBlocks ? 16 : 8;
+
+   std::vector<unsigned char> pixels(static_cast<size_t>(mipLevel.width) * mipLevel.height * 4);
+   const unsigned char* block = mipLevel.data;
+   for (int blockY = 0; blockY < mipLevel.height; blockY += 4)
+   {
+      for (int blockX = 0; blockX < mipLevel.width; blockX += 4)
+      {
+         int alphaPalette[8];
+         uint64_t alphaIndices = 0;
+         if (hasAlphaBlocks)
+         {
+            GetPaletteOfAlphaBlock(block[0], block[1], alphaPalette);
+            for (int byteIndex = 0; byteIndex < 6; ++byteIndex)
+            {
+               alphaIndices |= static_cast<uint64_t>(block[2 + byteIndex]) << (8 * byteIndex);
+            }
+         }
+
+         const unsigned char* colorBlock = hasAlphaBlocks ? (block + 8) : block;
+         uint16_t endpoint0, endpoint1;
+         uint32_t colorIndices;
+         memcpy(&endpoint0, colorBlock + 0, 2);
+         memcpy(&endpoint1, colorBlock + 2, 2);
+         memcpy(&colorIndices, colorBlock + 4, 4);
+
+         // The color blocks of BC3 always use the 4-color mode
+         int colorPalette[4][4];
+         GetPaletteOfColorBlock(endpoint0, endpoint1, hasAlphaBlocks, colorPalette);
+
+         for (int pixelIndex = 0; pixelIndex < 16; ++pixelIndex)
+         {
+            int x = blockX + (pixelIndex % 4);
+            int y = blockY + (pixelIndex / 4);
+            if (x >= mipLevel.width || y >= mipLevel.height)
+            {
+               continue;
+            }
+
+            const int* color = colorPalette[(colorIndices >> (2 * pixelIndex)) & 3];
+            unsigned char* pixel = &pixels[((static_cast<size_t>(y) * mipLevel.width) + x) * 4];
+            pixel[0] = static_cast<unsigned char>(color[0]);
+            pixel[1] = static_cast<unsigned char>(color[1]);
+            pixel[2] = static_cast<unsigned char>(color[2]);
+            pixel[3] = static_cast<unsigned char>(hasAlphaBlocks ? alphaPalette[(alphaIndices >> (3 * pixelIndex)) & 7] : color[3]);
+         }
+
+         block += blockSize;
+      }
+   }
+
+   return pixels;
+}
+
+bool BakeTexture(const char* imagePath, const char* bakedPath, bool linear, bool compress)
+{
+   using namespace BakedTextureHelpers;
+
+   // Decode the image, expanding grayscale images into RGB images, since we only upload RGB and RGBA textures
+   auto decodeStart = std::chrono::steady_clock::now();
+   int width, height, numComponents;
+   if (!stbi_info(imagePath, &width, &height, &numComponents))
+   {
+      std::cout << "Texture baker - The following image could not be decoded: " << imagePath << '\n';
+      return false;
+   }
+
+   numComponents = (numComponents == 2 || numComponents == 4) ? 4 : 3;
+   unsigned char* decodedPixels = stbi_load(imagePath, &width, &height, nullptr, numComponents);
+   if (decodedPixels == nullptr)
+   {
+      std::cout << "Texture baker - The following image could not be decoded: " << imagePath << '\n';
+      return false;
+   }
+   auto decodeEnd = std::chrono::steady_clock::now();
+
+   std::vector<std::vector<unsigned char>> mipLevels;
+   mipLevels.emplace_back(decodedPixels, decodedPixels + (static_cast<size_t>(width) * height * numComponents));
+   stbi_image_free(decodedPixels);
+
+   // Generate the chain of mip levels all the way down to 1x1
+   int levelWidth  = width;
+   int levelHeight = height;
+   while (levelWidth > 1 || levelHeight > 1)
+   {
+      int nextWidth, nextHeight;
+      mipLevels.push_back(GenerateMipLevel(mipLevels.back(), levelWidth, levelHeight, numComponents, linear, nextWidth, nextHeight));
+      levelWidth  = nextWidth;
+      levelHeight = nextHeight;
+   }
+
+   if (compress && (!IsPowerOfTwo(width) || !IsPowerOfTwo(height)))
+   {
+      std::cout << "Texture baker - Only textures whose sizes are powers of two can be compressed, so the following one is stored uncompressed: " << imagePath << '\n';
+      compress = false;
+   }
+
+   std::vector<unsigned char> uncompressedLevel0;
+   PixelFormat pixelFormat = (numComponents == 3) ? rgb8 : rgba8;
+   if (compress)
+   {
+      uncompressedLevel0 = mipLevels[0];
+      pixelFormat = (numComponents == 3) ? bc1 : bc3;
+      levelWidth  = width;
+      levelHeight = height;
+      for (std::vector<unsigned char>& mipLevel : mipLevels)
+      {
+         mipLevel    = CompressMipLevel(mipLevel, levelWidth, levelHeight, numComponents);
+         levelWidth  = std::max(1, levelWidth / 2);
+         levelHeight = std::max(1, levelHeight / 2);
+      }
+   }
+
+   size_t fileSize = 0;
+   if (!WriteBakedTexture(bakedPath, pixelFormat, mipLevels, width, height, fileSize))
+   {
+      return false;
+   }
+
+   // Load the baked texture back to verify it
+   // Reading every byte of it includes the cost of paging the mapping in, which is otherwise paid while its levels are uploaded
+   auto loadStart = std::chrono::steady_clock::now();
+   std::shared_ptr<DecodedImage> bakedImage = LoadBakedTexture(bakedPath);
+   unsigned int checksum = 0;
+   if (bakedImage)
+   {
+      for (const DecodedImage::MipLevel& mipLevel : bakedImage->mipLevels)
+      {
+         for (size_t byteIndex = 0; byteIndex < mipLevel.size; ++byteIndex)
+         {
+            checksum += mipLevel.data[byteIndex];
+         }
+      }
+   }
+   auto loadEnd = std::chrono::steady_clock::now();
+
+   if (!bakedImage || bakedImage->mipLevels.size() != mipLevels.size() || memcmp(bakedImage->mipLevels[0].data, mipLevels[0].data(), mipLevels[0].size()) != 0)
+   {
+      std::cout << "Texture baker - The following baked texture doesn't match the image it was baked from: " << bakedPath << '\n';
+      return false;
+   }
+
+   const char* pixelFormatNames[] = { "RGB8", "RGBA8", "BC1", "BC3" };
+   double decodeTime = std::chrono::duration<double, std::milli>(decodeEnd - decodeStart).count();
+   double loadTime   = std::chrono::duration<double, std::milli>(loadEnd - loadStart).count();
+
+   std::cout << "Texture baker - Baked " << imagePath << " into " << bakedPath << " (" << fileSize / 1024 << " KB)"
+             << ", Size: " << width << "x" << height << ", Mip levels: " << mipLevels.size()
+             << ", Format: " << pixelFormatNames[pixelFormat] << ", Color space: " << (linear ? "Linear" : "sRGB") << '\n';
+
+   // Measure the error that compression introduces into the first level
+   if (compress)
+   {
+      std::vector<unsigned char> decompressedLevel0 = DecompressMipLevel(bakedImage->mipLevels[0], bakedImage->compressedFormat);
+      double squaredError = 0.0;
+      size_t numPixels = static_cast<size_t>(width) * height;
+      for (size_t pixelIndex = 0; pixelIndex < numPixels; ++pixelIndex)
+      {
+         for (int component = 0; component < numComponents; ++component)
+         {
+            double difference = static_cast<double>(decompressedLevel0[(pixelIndex * 4) + component]) - uncompressedLevel0[(pixelIndex * numComponents) + component];
+            squaredError += difference * difference;
+         }
+      }
+
+      double meanSquaredError = squaredError / (static_cast<double>(numPixels) * numComponents);
+      double psnr = (meanSquaredError > 0.0) ? (10.0 * std::log10((255.0 * 255.0) / meanSquaredError)) : 99.0;
+      std::cout << "   PSNR of the first level:       " << psnr << " dB" << '\n';
+   }
+
+   std::cout << "   Decoding the image:            " << decodeTime << " ms (without generating its mip levels)" << '\n';
+   std::cout << "   Loading the baked texture:     " << loadTime << " ms (" << decodeTime / loadTime << "x)" << " (checksum " << checksum << ")" << '\n';
+
+   return true;
+}
@@ -0,0 +1,160 @@
+#include <iostream>
+
+#include "GLTFLoader.h"
+#include "CharacterAsset.h"
+#include "IKLeg.h"
+#include "FABRIKBatchSolver.h"
+#include "FootPlacementSystem.h"
+#include "HeightQueryGrid.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "SegmentedClip.h"
+#include "StaticCollisionWorld.h"
+#include "TriangleBVH.h"
+#include "TwoBoneIKSolver.h"
+#include "Benchmarks.h"
+
+namespace BenchmarkHelpers
+{
+   // The IK states place the character on this ground, so it's where the ground queries are measured
+   const char* groundPath = "resources/models/ground/water_terrain.glb";
+
+   // The character is loaded from the glTF file instead of the baked asset, so that the benchmarks don't depend on the baker
+   const char* characterPath = "resources/models/woman/woman.glb";
+
+   bool LoadGroundTriangles(IndexedTriangleStore& outTriangles)
+   {
+      cgltf_data* data = LoadGLTFFile(groundPath);
+      if (data == nullptr)
+      {
+         std::cout << "Benchmarks - Could not load the ground: " << groundPath << '\n';
+         return false;
+      }
+
+      LoadTrianglesOfStaticMeshes(data, outTriangles);
+      FreeGLTFFile(data);
+      return true;
+   }
+
+   // These are the settings that IKMovementState starts with
+   FootPlacementSettings GetFootPlacementSettings()
+   {
+      FootPlacementSettings settings;
+      settings.heightOfHip            = 2.0f;
+      settings.heightOfKnees          = 1.0f;
+      settings.distanceFromAnkleToToe = 0.3f;
+      settings.solveAnalytically      = false;
+      settings.solveInBatch           = false;
+      settings.solveWithConstraints   = true;
+      settings.warmStart              = false;
+      settings.numIterations          = 15;
+      return settings;
+   }
+
+   // The leg benchmarks use a pose from a quarter of the way through the walking clip, where the knee of the left leg is bent
+   bool SampleWalkingPose(CharacterAsset& character, Pose& outPose)
+   {
+      std::shared_ptr<const FastClip> walkingClip = character.clips->GetClip("Walking");
+      if (!walkingClip)
+      {
+         std::cout << "Benchmarks - The character doesn't have a walking clip: " << characterPath << '\n';
+         return false;
+      }
+
+      outPose = character.skeleton.GetRestPose();
+      walkingClip->Sample(outPose, walkingClip->GetStartTime() + 0.25f * walkingClip->GetDuration());
+      return true;
+   }
+}
+
+bool RunBenchmarks()
+{
+   using namespace BenchmarkHelpers;
+
+   IndexedTriangleStore groundTriangles;
+   if (!LoadGroundTriangles(groundTriangles))
+   {
+      return false;
+   }
+
+   // Measure how much faster the BVH is than testing every triangle
+   TriangleBVH groundBVH;
+   groundBVH.Build(groundTriangles);
+   BenchmarkTriangleBVH(groundBVH, groundTriangles, 1024);
+
+   // Measure how much faster it is to sweep spheres and overlap capsules against the hashed triangles than against every triangle
+   StaticCollisionWorld collisionWorld;
+   collisionWorld.Build(groundTriangles);
+   BenchmarkStaticCollisionWorld(collisionWorld, 1024);
+
+   CharacterAsset character;
+   if (!LoadCharacterAssetFromGLTF(characterPath, character))
+   {
+      std::cout << "Benchmarks - Could not load the character: " << characterPath << '\n';
+      return false;
+   }
+
+   // Measure how much the vertex cache optimization that runs when the meshes are loaded improves their index buffers
+   // The triangles of the ground are read straight from the glTF file, so they show how well the meshes were ordered by their exporter
+   std::vector<unsigned int> groundIndices;
+   groundIndices.reserve(groundTriangles.GetNumberOfTriangles() * 3);
+   for (unsigned int triangleIndex = 0, numTriangles = groundTriangles.GetNumberOfTriangles(); triangleIndex < numTriangles; ++triangleIndex)
+   {
+      const glm::uvec3& triangle = groundTriangles.GetIndicesOfTriangle(triangleIndex);
+      groundIndices.insert(groundIndices.end(), { triangle.x, triangle.y, triangle.z });
+   }
+   BenchmarkMeshOptimizer(groundIndices, groundTriangles.GetNumberOfVertices());
+
+   for (AnimatedMesh& mesh : character.meshes)
+   {
+      BenchmarkMeshOptimizer(mesh.GetIndices(), static_cast<unsigned int>(mesh.GetPositions().size()));
+   }
+
+   // Measure how long it takes to generate the LODs of the meshes of the character, and how coarse they get
+   for (AnimatedMesh& mesh : character.meshes)
+   {
+      BenchmarkMeshSimplifier(mesh);
+   }
+
+   Pose walkingPose;
+   if (!SampleWalkingPose(character, walkingPose))
+   {
+      return false;
+   }
+
+   IKLeg leftLeg(character.skeleton, "LeftUpLeg", "LeftLeg", "LeftFoot", "LeftToeBase");
+
+   // Measure how much faster the analytic leg solver is than FABRIK, and how closely their results match
+   BenchmarkTwoBoneIKSolver(walkingPose.GetGlobalTransform(leftLeg.GetHipIndex()),
+                            walkingPose.GetLocalTransform(leftLeg.GetKneeIndex()),
+                            walkingPose.GetLocalTransform(leftLeg.GetAnkleIndex()),
+                            glm::vec3(1.0f, 0.0f, 0.0f),
+                            15,
+                            1000);
+
+   // Measure how much faster it is to solve the legs of a crowd of characters in a batch
+   BenchmarkFABRIKBatchSolver(walkingPose.GetGlobalTransform(leftLeg.GetHipIndex()),
+                              walkingPose.GetLocalTransform(leftLeg.GetKneeIndex()),
+                              walkingPose.GetLocalTransform(leftLeg.GetAnkleIndex()),
+                              15,
+                              1000);
+
+   // Measure how much faster it is to place the feet of a crowd of characters all at once than one at a time
+   HeightQueryGrid groundHeightGrid;
+   groundHeightGrid.Build(groundTriangles);
+
+   FootPlacementCharacter footPlacementCharacter;
+   footPlacementCharacter.leftLeg  = leftLeg;
+   footPlacementCharacter.leftLeg.SetAnkleOffset(0.2f);
+   footPlacementCharacter.rightLeg = IKLeg(character.skeleton, "RightUpLeg", "RightLeg", "RightFoot", "RightToeBase");
+   footPlacementCharacter.rightLeg.SetAnkleOffset(0.2f);
+
+   BenchmarkFootPlacementSystem(groundHeightGrid, GetFootPlacementSettings(), footPlacementCharacter, walkingPose, 256);
+
+   // Measure how a long motion capture take compares when it's stored as a FastClip and as a SegmentedClip
+   // The take is built by repeating the walking clip for a minute, and it's split into segments of 2 seconds
+   FastClip walkingClip = *character.clips->GetClip("Walking");
+   BenchmarkSegmentedClip(walkingClip, character.skeleton.GetRestPose(), 60.0f, 2.0f);
+
+   return true;
+}
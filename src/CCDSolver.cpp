@@ -1,6 +1,7 @@
 #include <glm/gtx/norm.hpp>
 
 #include "CCDSolver.h"
+#include "IKSolverHelpers.h"
 
 // Cyclic Coordinate Descent (CCD) is an algorithm that can be used to pose a chain of joints so that the last joint of the chain
 // comes as close as possible to touching a target
@@ -18,6 +19,8 @@
 CCDSolver::CCDSolver()
    : mNumIterations(15)
    , mConvergenceThreshold(0.00001f)
+   , mMinImprovementPerIteration(0.0f)
+   , mNumIterationsPerformed(0)
 {
 
 }
@@ -75,6 +78,21 @@ void CCDSolver::SetThreshold(float threshold)
    mConvergenceThreshold = threshold;
 }
 
+float CCDSolver::GetMinImprovementPerIteration()
+{
+   return mMinImprovementPerIteration;
+}
+
+void CCDSolver::SetMinImprovementPerIteration(float minImprovement)
+{
+   mMinImprovementPerIteration = minImprovement;
+}
+
+unsigned int CCDSolver::GetNumberOfIterationsPerformed()
+{
+   return mNumIterationsPerformed;
+}
+
 bool CCDSolver::Solve(const Transform& goal)
 {
    unsigned int numJoints = GetNumberOfJointsInIKChain();
@@ -90,6 +108,8 @@ bool CCDSolver::Solve(const Transform& goal)
    glm::vec3    goalPos            = goal.position;
    glm::vec3    endEffectorPos     = GetGlobalTransform(indexOfEndEffector).position;
 
+   mNumIterationsPerformed = 0;
+
    // TODO: Possibly unnecessary
    // Check if convergence has already been achieved
    if (glm::length2(goalPos - endEffectorPos) < thresholdSq)
@@ -97,9 +117,13 @@ bool CCDSolver::Solve(const Transform& goal)
       return true;
    }
 
-   // Loop over the allowed number of iterations until we either converge or reach the maximum number of iterations
+   float prevSquaredDistToGoal = glm::length2(goalPos - endEffectorPos);
+
+   // Loop over the allowed number of iterations until we either converge, stop making progress or reach the maximum number of iterations
    for (unsigned int iteration = 0; iteration < mNumIterations; ++iteration)
    {
+      ++mNumIterationsPerformed;
+
       // Loop backwards over the IK chain, starting with the joint that comes before the end effector
       for (int jointIndex = static_cast<int>(numJoints) - 2; jointIndex >= 0; --jointIndex)
       {
@@ -196,6 +220,15 @@ bool CCDSolver::Solve(const Transform& goal)
             return true;
          }
       }
+
+      // Check if this iteration barely moved the end effector towards the goal, which happens when the goal is out of reach
+      float squaredDistToGoal = glm::length2(goalPos - endEffectorPos);
+      if (HasIKSolverStalled(squaredDistToGoal, prevSquaredDistToGoal, mMinImprovementPerIteration))
+      {
+         break;
+      }
+
+      prevSquaredDistToGoal = squaredDistToGoal;
    }
 
    return false;
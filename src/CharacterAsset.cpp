@@ -0,0 +1,85 @@
+#include <chrono>
+#include <iostream>
+
+#include "GLTFLoader.h"
+#include "RearrangeBones.h"
+#include "BakedAsset.h"
+#include "ParallelFor.h"
+#include "CharacterAsset.h"
+
+bool LoadCharacterAssetFromGLTF(const char* path, CharacterAsset& outAsset)
+{
+   cgltf_data* data = LoadGLTFFile(path);
+   if (data == nullptr)
+   {
+      return false;
+   }
+
+   outAsset.skeleton = LoadSkeleton(data);
+
+   // Rearrange the skeleton
+   JointMap jointMap = RearrangeSkeleton(outAsset.skeleton);
+
+   // Loading the meshes and loading each clip are independent of each other, so they run as parallel tasks:
+   // - The first task loads the meshes, which optimizes them and generates their LODs, and rearranges them
+   // - Each of the other tasks loads a clip, optimizes it and rearranges it
+   // Each task uses its own copy of the joint map, since looking up a joint that isn't in the map inserts it
+   unsigned int numClips = static_cast<unsigned int>(data->animations_count);
+   std::vector<FastClip> fastClips(numClips);
+   ParallelFor(numClips + 1, [data, &jointMap, &outAsset, &fastClips](unsigned int taskIndex)
+   {
+      JointMap jointMapOfTask = jointMap;
+
+      if (taskIndex == 0)
+      {
+         outAsset.meshes = LoadAnimatedMeshes(data);
+         for (unsigned int meshIndex = 0,
+              numMeshes = static_cast<unsigned int>(outAsset.meshes.size());
+              meshIndex < numMeshes;
+              ++meshIndex)
+         {
+            RearrangeMesh(outAsset.meshes[meshIndex], jointMapOfTask);
+         }
+      }
+      else
+      {
+         unsigned int clipIndex = taskIndex - 1;
+         Clip clip = LoadClip(data, clipIndex);
+         fastClips[clipIndex] = OptimizeClip(clip);
+         RearrangeFastClip(fastClips[clipIndex], jointMapOfTask);
+      }
+   });
+
+   FreeGLTFFile(data);
+
+   // The clips of a glTF file can't be loaded one at a time, so they are all resident
+   outAsset.clips = std::make_shared<ClipLibrary>();
+   for (unsigned int clipIndex = 0; clipIndex < numClips; ++clipIndex)
+   {
+      outAsset.clips->AddClip(std::move(fastClips[clipIndex]));
+   }
+
+   return true;
+}
+
+bool LoadCharacterAsset(const char* gltfPath, const char* bakedPath, CharacterAsset& outAsset)
+{
+   auto start = std::chrono::steady_clock::now();
+
+   // If the baked asset doesn't exist or was baked with an older version of the format, we fall back to the glTF file
+   const char* loadedPath = bakedPath;
+   if (!LoadBakedCharacterAsset(bakedPath, outAsset))
+   {
+      loadedPath = gltfPath;
+      if (!LoadCharacterAssetFromGLTF(gltfPath, outAsset))
+      {
+         return false;
+      }
+   }
+
+   auto end = std::chrono::steady_clock::now();
+
+   std::cout << "Character asset - Loaded " << loadedPath << " in " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << '\n';
+
+   return true;
+}
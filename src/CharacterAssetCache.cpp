@@ -0,0 +1,38 @@
+#include <iostream>
+
+#include "CharacterAssetCache.h"
+
+std::shared_ptr<const CharacterAsset> CharacterAssetCache::Load(const std::string& gltfPath, const std::string& bakedPath)
+{
+   {
+      std::lock_guard<std::mutex> lock(mAssetsMutex);
+
+      auto it = mAssets.find(gltfPath);
+      std::shared_ptr<const CharacterAsset> asset = (it != mAssets.end()) ? it->second.lock() : nullptr;
+      if (asset)
+      {
+         return asset;
+      }
+   }
+
+   // The cache isn't locked while the asset is loaded, so another thread may load the same asset at the same time
+   std::shared_ptr<CharacterAsset> loadedAsset = std::make_shared<CharacterAsset>();
+   if (!LoadCharacterAsset(gltfPath.c_str(), bakedPath.c_str(), *loadedAsset))
+   {
+      std::cout << "Could not load the following character: " << gltfPath << '\n';
+      return nullptr;
+   }
+
+   std::lock_guard<std::mutex> lock(mAssetsMutex);
+
+   // If another thread stored the same asset while we were loading it, we return that one, so that the asset is only stored once
+   std::weak_ptr<const CharacterAsset>& cachedAsset = mAssets[gltfPath];
+   std::shared_ptr<const CharacterAsset> asset = cachedAsset.lock();
+   if (asset)
+   {
+      return asset;
+   }
+
+   cachedAsset = loadedAsset;
+   return loadedAsset;
+}
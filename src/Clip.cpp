@@ -1,7 +1,46 @@
+#include <map>
+
 #include "Clip.h"
 
-template <typename TRACK>
-TClip<TRACK>::TClip()
+namespace ClipHelpers
+{
+   typedef std::map<std::vector<float>, std::shared_ptr<const Timeline>> TimelinePool;
+
+   template <typename T, unsigned int N>
+   void ShareTimeline(FastTrack<T, N>& track, TimelinePool& pool)
+   {
+      // A track with less than two frames is never interpolated, so it doesn't need a timeline
+      unsigned int numFrames = track.GetNumberOfFrames();
+      if (numFrames <= 1)
+      {
+         return;
+      }
+
+      const Frame<N>* frames = track.GetFrames();
+      std::vector<float> times(numFrames);
+      for (unsigned int frameIndex = 0; frameIndex < numFrames; ++frameIndex)
+      {
+         times[frameIndex] = frames[frameIndex].mTime;
+      }
+
+      auto it = pool.find(times);
+      if (it == pool.end())
+      {
+         // The map only depends on the times, so the map of the first track with these times can be used by all of them
+         if (track.GetSampleToFrameIndexMap().empty())
+         {
+            track.GenerateSampleToFrameIndexMap();
+         }
+
+         it = pool.emplace(times, std::make_shared<const Timeline>(times, track.GetSampleToFrameIndexMap())).first;
+      }
+
+      track.SetTimeline(it->second);
+   }
+}
+
+template <typename TRACK, typename WTRACK>
+TClip<TRACK, WTRACK>::TClip()
    : mName("Unnamed")
    , mStartTime(0.0f)
    , mEndTime(0.0f)
@@ -10,26 +49,26 @@ TClip<TRACK>::TClip()
 
 }
 
-template <typename TRACK>
-unsigned int TClip<TRACK>::GetNumberOfTransformTracks() const
+template <typename TRACK, typename WTRACK>
+unsigned int TClip<TRACK, WTRACK>::GetNumberOfTransformTracks() const
 {
    return static_cast<unsigned int>(mTransformTracks.size());
 }
 
-template <typename TRACK>
-unsigned int TClip<TRACK>::GetJointIDOfTransformTrack(unsigned int transfTrackIndex) const
+template <typename TRACK, typename WTRACK>
+unsigned int TClip<TRACK, WTRACK>::GetJointIDOfTransformTrack(unsigned int transfTrackIndex) const
 {
    return mTransformTracks[transfTrackIndex].GetJointID();
 }
 
-template <typename TRACK>
-void TClip<TRACK>::SetJointIDOfTransformTrack(unsigned int transfTrackIndex, unsigned int jointID)
+template <typename TRACK, typename WTRACK>
+void TClip<TRACK, WTRACK>::SetJointIDOfTransformTrack(unsigned int transfTrackIndex, unsigned int jointID)
 {
    return mTransformTracks[transfTrackIndex].SetJointID(jointID);
 }
 
-template <typename TRACK>
-TRACK& TClip<TRACK>::GetTransformTrackOfJoint(unsigned int jointID)
+template <typename TRACK, typename WTRACK>
+TRACK& TClip<TRACK, WTRACK>::GetTransformTrackOfJoint(unsigned int jointID)
 {
    // Loop over the transform tracks and compare their joint IDs with the desired one
    for (unsigned int transfTrackIndex = 0,
@@ -50,8 +89,8 @@ TRACK& TClip<TRACK>::GetTransformTrackOfJoint(unsigned int jointID)
    return mTransformTracks[mTransformTracks.size() - 1];
 }
 
-template <typename TRACK>
-void TClip<TRACK>::SetTransformTrackOfJoint(unsigned int jointID, const TRACK& transfTrack)
+template <typename TRACK, typename WTRACK>
+void TClip<TRACK, WTRACK>::SetTransformTrackOfJoint(unsigned int jointID, const TRACK& transfTrack)
 {
    // Loop over the transform tracks and compare their joint IDs with the desired one
    for (unsigned int transfTrackIndex = 0,
@@ -72,38 +111,94 @@ void TClip<TRACK>::SetTransformTrackOfJoint(unsigned int jointID, const TRACK& t
    mTransformTracks[mTransformTracks.size() - 1].SetJointID(jointID);
 }
 
-template <typename TRACK>
-std::string TClip<TRACK>::GetName() const
+template <typename TRACK, typename WTRACK>
+unsigned int TClip<TRACK, WTRACK>::GetNumberOfMorphWeightsTracks() const
+{
+   return static_cast<unsigned int>(mMorphWeightsTracks.size());
+}
+
+template <typename TRACK, typename WTRACK>
+unsigned int TClip<TRACK, WTRACK>::GetNodeIDOfMorphWeightsTrack(unsigned int weightsTrackIndex) const
+{
+   return mMorphWeightsTracks[weightsTrackIndex].GetNodeID();
+}
+
+template <typename TRACK, typename WTRACK>
+WTRACK& TClip<TRACK, WTRACK>::GetMorphWeightsTrackOfNode(unsigned int nodeID)
+{
+   // Loop over the morph weights tracks and compare their node IDs with the desired one
+   for (unsigned int weightsTrackIndex = 0,
+        numWeightsTracks = static_cast<unsigned int>(mMorphWeightsTracks.size());
+        weightsTrackIndex < numWeightsTracks;
+        ++weightsTrackIndex)
+   {
+      if (mMorphWeightsTracks[weightsTrackIndex].GetNodeID() == nodeID)
+      {
+         return mMorphWeightsTracks[weightsTrackIndex];
+      }
+   }
+
+   // If a morph weights track that animates the desired node doesn't exist,
+   // we create an empty one and return it
+   mMorphWeightsTracks.push_back(WTRACK());
+   mMorphWeightsTracks[mMorphWeightsTracks.size() - 1].SetNodeID(nodeID);
+   return mMorphWeightsTracks[mMorphWeightsTracks.size() - 1];
+}
+
+template <typename TRACK, typename WTRACK>
+void TClip<TRACK, WTRACK>::SetMorphWeightsTrackOfNode(unsigned int nodeID, const WTRACK& weightsTrack)
+{
+   // Loop over the morph weights tracks and compare their node IDs with the desired one
+   for (unsigned int weightsTrackIndex = 0,
+        numWeightsTracks = static_cast<unsigned int>(mMorphWeightsTracks.size());
+        weightsTrackIndex < numWeightsTracks;
+        ++weightsTrackIndex)
+   {
+      if (mMorphWeightsTracks[weightsTrackIndex].GetNodeID() == nodeID)
+      {
+         mMorphWeightsTracks[weightsTrackIndex] = weightsTrack;
+         return;
+      }
+   }
+
+   // If a morph weights track that animates the desired node doesn't exist,
+   // we create a new one
+   mMorphWeightsTracks.push_back(weightsTrack);
+   mMorphWeightsTracks[mMorphWeightsTracks.size() - 1].SetNodeID(nodeID);
+}
+
+template <typename TRACK, typename WTRACK>
+std::string TClip<TRACK, WTRACK>::GetName() const
 {
    return mName;
 }
 
-template <typename TRACK>
-void TClip<TRACK>::SetName(const std::string& name)
+template <typename TRACK, typename WTRACK>
+void TClip<TRACK, WTRACK>::SetName(const std::string& name)
 {
    mName = name;
 }
 
-template <typename TRACK>
-float TClip<TRACK>::GetStartTime() const
+template <typename TRACK, typename WTRACK>
+float TClip<TRACK, WTRACK>::GetStartTime() const
 {
    return mStartTime;
 }
 
-template <typename TRACK>
-float TClip<TRACK>::GetEndTime() const
+template <typename TRACK, typename WTRACK>
+float TClip<TRACK, WTRACK>::GetEndTime() const
 {
    return mEndTime;
 }
 
-template <typename TRACK>
-float TClip<TRACK>::GetDuration() const
+template <typename TRACK, typename WTRACK>
+float TClip<TRACK, WTRACK>::GetDuration() const
 {
    return mEndTime - mStartTime;
 }
 
-template <typename TRACK>
-void TClip<TRACK>::RecalculateDuration()
+template <typename TRACK, typename WTRACK>
+void TClip<TRACK, WTRACK>::RecalculateDuration()
 {
    // Reset the start time and the end time
    mStartTime = 0.0f;
@@ -135,10 +230,35 @@ void TClip<TRACK>::RecalculateDuration()
          }
       }
    }
+
+   // The morph weights tracks can extend the duration of the clip too
+   for (unsigned int weightsTrackIndex = 0,
+        numWeightsTracks = static_cast<unsigned int>(mMorphWeightsTracks.size());
+        weightsTrackIndex < numWeightsTracks;
+        ++weightsTrackIndex)
+   {
+      if (mMorphWeightsTracks[weightsTrackIndex].IsValid())
+      {
+         float weightsTrackStartTime = mMorphWeightsTracks[weightsTrackIndex].GetStartTime();
+         float weightsTrackEndTime   = mMorphWeightsTracks[weightsTrackIndex].GetEndTime();
+
+         if (weightsTrackStartTime < mStartTime || !initialStartTimeFound)
+         {
+            mStartTime = weightsTrackStartTime;
+            initialStartTimeFound = true;
+         }
+
+         if (weightsTrackEndTime > mEndTime || !initialEndTimeFound)
+         {
+            mEndTime = weightsTrackEndTime;
+            initialEndTimeFound = true;
+         }
+      }
+   }
 }
 
-template <typename TRACK>
-bool TClip<TRACK>::IsTimePastEnd(float time)
+template <typename TRACK, typename WTRACK>
+bool TClip<TRACK, WTRACK>::IsTimePastEnd(float time) const
 {
    if (!mLooping && (time >= mEndTime))
    {
@@ -148,20 +268,20 @@ bool TClip<TRACK>::IsTimePastEnd(float time)
    return false;
 }
 
-template <typename TRACK>
-bool TClip<TRACK>::GetLooping() const
+template <typename TRACK, typename WTRACK>
+bool TClip<TRACK, WTRACK>::GetLooping() const
 {
    return mLooping;
 }
 
-template <typename TRACK>
-void TClip<TRACK>::SetLooping(bool looping)
+template <typename TRACK, typename WTRACK>
+void TClip<TRACK, WTRACK>::SetLooping(bool looping)
 {
    mLooping = looping;
 }
 
-template <typename TRACK>
-float TClip<TRACK>::Sample(Pose& ioPose, float time) const
+template <typename TRACK, typename WTRACK>
+float TClip<TRACK, WTRACK>::Sample(Pose& ioPose, float time) const
 {
    if (GetDuration() <= 0.0f)
    {
@@ -195,8 +315,34 @@ float TClip<TRACK>::Sample(Pose& ioPose, float time) const
    return time;
 }
 
-template <typename TRACK>
-float TClip<TRACK>::AdjustTimeToBeWithinClip(float time) const
+// This function samples the weights of the morph targets of the mesh of a node
+// The weights that the clip doesn't animate are left untouched, so ioWeights should contain the default weights of the mesh
+template <typename TRACK, typename WTRACK>
+void TClip<TRACK, WTRACK>::SampleMorphWeights(unsigned int nodeID, std::vector<float>& ioWeights, float time) const
+{
+   if (GetDuration() <= 0.0f)
+   {
+      // If the duration of the clip is smaller than or equal to zero, it's invalid
+      return;
+   }
+
+   time = AdjustTimeToBeWithinClip(time);
+
+   for (unsigned int weightsTrackIndex = 0,
+        numWeightsTracks = static_cast<unsigned int>(mMorphWeightsTracks.size());
+        weightsTrackIndex < numWeightsTracks;
+        ++weightsTrackIndex)
+   {
+      if (mMorphWeightsTracks[weightsTrackIndex].GetNodeID() == nodeID)
+      {
+         mMorphWeightsTracks[weightsTrackIndex].Sample(ioWeights, time, mLooping);
+         return;
+      }
+   }
+}
+
+template <typename TRACK, typename WTRACK>
+float TClip<TRACK, WTRACK>::AdjustTimeToBeWithinClip(float time) const
 {
    if (mLooping)
    {
@@ -252,11 +398,52 @@ FastClip OptimizeClip(Clip& clip)
       fastClip.SetTransformTrackOfJoint(jointID, OptimizeTransformTrack(clip.GetTransformTrackOfJoint(jointID)));
    }
 
+   // Loop over the morph weights tracks and optimize them one by one
+   for (unsigned int weightsTrackIndex = 0,
+        numWeightsTracks = clip.GetNumberOfMorphWeightsTracks();
+        weightsTrackIndex < numWeightsTracks;
+        ++weightsTrackIndex)
+   {
+      unsigned int nodeID = clip.GetNodeIDOfMorphWeightsTrack(weightsTrackIndex);
+      fastClip.SetMorphWeightsTrackOfNode(nodeID, OptimizeMorphWeightsTrack(clip.GetMorphWeightsTrackOfNode(nodeID)));
+   }
+
    fastClip.RecalculateDuration();
+   ShareTimelines(fastClip);
 
    return fastClip;
 }
 
+unsigned int ShareTimelines(FastClip& clip)
+{
+   ClipHelpers::TimelinePool pool;
+
+   for (unsigned int transfTrackIndex = 0,
+        numTransfTracks = clip.GetNumberOfTransformTracks();
+        transfTrackIndex < numTransfTracks;
+        ++transfTrackIndex)
+   {
+      FastTransformTrack& transfTrack = clip.GetTransformTrackOfJoint(clip.GetJointIDOfTransformTrack(transfTrackIndex));
+      ClipHelpers::ShareTimeline(transfTrack.GetPositionTrack(), pool);
+      ClipHelpers::ShareTimeline(transfTrack.GetRotationTrack(), pool);
+      ClipHelpers::ShareTimeline(transfTrack.GetScaleTrack(), pool);
+   }
+
+   for (unsigned int weightsTrackIndex = 0,
+        numWeightsTracks = clip.GetNumberOfMorphWeightsTracks();
+        weightsTrackIndex < numWeightsTracks;
+        ++weightsTrackIndex)
+   {
+      FastMorphWeightsTrack& weightsTrack = clip.GetMorphWeightsTrackOfNode(clip.GetNodeIDOfMorphWeightsTrack(weightsTrackIndex));
+      for (unsigned int targetIndex = 0, numTargets = weightsTrack.GetNumberOfTargets(); targetIndex < numTargets; ++targetIndex)
+      {
+         ClipHelpers::ShareTimeline(weightsTrack.GetWeightTrack(targetIndex), pool);
+      }
+   }
+
+   return static_cast<unsigned int>(pool.size());
+}
+
 // Instantiate the desired Clip classes from the Clip class template
-template class TClip<TransformTrack>;
-template class TClip<FastTransformTrack>;
+template class TClip<TransformTrack, MorphWeightsTrack>;
+template class TClip<FastTransformTrack, FastMorphWeightsTrack>;
@@ -0,0 +1,220 @@
+#include <iostream>
+
+#include "ClipLibrary.h"
+
+ClipLibrary::ClipLibrary(size_t budgetInBytes)
+   : mEntries()
+   , mClipIndices()
+   , mPrefetchQueue()
+   , mBudgetInBytes(budgetInBytes)
+   , mSizeOfStreamedClips(0)
+   , mNumRequests(0)
+{
+
+}
+
+void ClipLibrary::AddClip(FastClip&& clip)
+{
+   Entry entry;
+   entry.name        = clip.GetName();
+   entry.clip        = std::make_shared<FastClip>(std::move(clip));
+   entry.sizeInBytes = 0;
+   entry.lastRequest = 0;
+
+   mClipIndices[entry.name] = static_cast<unsigned int>(mEntries.size());
+   mEntries.push_back(std::move(entry));
+}
+
+void ClipLibrary::AddStreamedClip(const std::string& name, size_t sizeInBytes, std::function<bool(FastClip&)>&& loadClip)
+{
+   Entry entry;
+   entry.name        = name;
+   entry.clip        = nullptr;
+   entry.loadClip    = std::move(loadClip);
+   entry.sizeInBytes = sizeInBytes;
+   entry.lastRequest = 0;
+
+   mClipIndices[entry.name] = static_cast<unsigned int>(mEntries.size());
+   mEntries.push_back(std::move(entry));
+}
+
+unsigned int ClipLibrary::GetNumberOfClips() const
+{
+   return static_cast<unsigned int>(mEntries.size());
+}
+
+const std::string& ClipLibrary::GetClipName(unsigned int clipIndex) const
+{
+   return mEntries[clipIndex].name;
+}
+
+int ClipLibrary::GetClipIndex(const std::string& name) const
+{
+   auto it = mClipIndices.find(name);
+   return (it != mClipIndices.end()) ? static_cast<int>(it->second) : -1;
+}
+
+std::shared_ptr<const FastClip> ClipLibrary::GetClip(unsigned int clipIndex)
+{
+   if (clipIndex >= mEntries.size())
+   {
+      return nullptr;
+   }
+
+   Entry& entry = mEntries[clipIndex];
+   entry.lastRequest = ++mNumRequests;
+   if (!entry.clip && !LoadClip(entry))
+   {
+      return nullptr;
+   }
+
+   // The handle must be created before evicting the other clips, so that the clip that was just loaded isn't evicted
+   std::shared_ptr<const FastClip> clip = entry.clip;
+   EvictClipsThatExceedBudget();
+   return clip;
+}
+
+std::shared_ptr<const FastClip> ClipLibrary::GetClip(const std::string& name)
+{
+   int clipIndex = GetClipIndex(name);
+   if (clipIndex == -1)
+   {
+      std::cout << "Clip library - There isn't a clip called " << name << '\n';
+      return nullptr;
+   }
+
+   return GetClip(static_cast<unsigned int>(clipIndex));
+}
+
+void ClipLibrary::Prefetch(const std::string& name)
+{
+   int clipIndex = GetClipIndex(name);
+   if (clipIndex == -1 || mEntries[clipIndex].clip)
+   {
+      return;
+   }
+
+   for (unsigned int queuedClipIndex : mPrefetchQueue)
+   {
+      if (queuedClipIndex == static_cast<unsigned int>(clipIndex))
+      {
+         return;
+      }
+   }
+
+   mPrefetchQueue.push_back(static_cast<unsigned int>(clipIndex));
+}
+
+void ClipLibrary::Update()
+{
+   while (!mPrefetchQueue.empty())
+   {
+      Entry& entry = mEntries[mPrefetchQueue.front()];
+      mPrefetchQueue.pop_front();
+
+      // A clip that was requested after it was queued doesn't need to be loaded again
+      if (entry.clip)
+      {
+         continue;
+      }
+
+      // Prefetching is only a hint, so a clip that doesn't fit within the budget along with the clips that are playing isn't prefetched,
+      // since it would be evicted right away
+      if (GetSizeOfPlayingClips() + entry.sizeInBytes > mBudgetInBytes)
+      {
+         continue;
+      }
+
+      // A prefetched clip counts as the most recently requested one, so that it's the last one to be evicted
+      entry.lastRequest = ++mNumRequests;
+      if (LoadClip(entry))
+      {
+         EvictClipsThatExceedBudget();
+      }
+
+      break;
+   }
+}
+
+size_t ClipLibrary::GetBudget() const
+{
+   return mBudgetInBytes;
+}
+
+void ClipLibrary::SetBudget(size_t budgetInBytes)
+{
+   mBudgetInBytes = budgetInBytes;
+   EvictClipsThatExceedBudget();
+}
+
+size_t ClipLibrary::GetSizeOfStreamedClips() const
+{
+   return mSizeOfStreamedClips;
+}
+
+unsigned int ClipLibrary::GetNumberOfLoadedClips() const
+{
+   unsigned int numLoadedClips = 0;
+   for (const Entry& entry : mEntries)
+   {
+      numLoadedClips += entry.clip ? 1 : 0;
+   }
+
+   return numLoadedClips;
+}
+
+size_t ClipLibrary::GetSizeOfPlayingClips() const
+{
+   size_t sizeOfPlayingClips = 0;
+   for (const Entry& entry : mEntries)
+   {
+      if (entry.clip && entry.clip.use_count() > 1)
+      {
+         sizeOfPlayingClips += entry.sizeInBytes;
+      }
+   }
+
+   return sizeOfPlayingClips;
+}
+
+bool ClipLibrary::LoadClip(Entry& entry)
+{
+   std::shared_ptr<FastClip> clip = std::make_shared<FastClip>();
+   if (!entry.loadClip || !entry.loadClip(*clip))
+   {
+      std::cout << "Clip library - Could not load the following clip: " << entry.name << '\n';
+      return false;
+   }
+
+   entry.clip = clip;
+   mSizeOfStreamedClips += entry.sizeInBytes;
+   return true;
+}
+
+void ClipLibrary::EvictClipsThatExceedBudget()
+{
+   while (mSizeOfStreamedClips > mBudgetInBytes)
+   {
+      // Find the least recently requested clip that is streamed and isn't playing
+      Entry* leastRecentlyRequestedEntry = nullptr;
+      for (Entry& entry : mEntries)
+      {
+         if (entry.loadClip && entry.clip && entry.clip.use_count() == 1)
+         {
+            if (leastRecentlyRequestedEntry == nullptr || entry.lastRequest < leastRecentlyRequestedEntry->lastRequest)
+            {
+               leastRecentlyRequestedEntry = &entry;
+            }
+         }
+      }
+
+      // All the clips that are in memory are playing
+      if (leastRecentlyRequestedEntry == nullptr)
+      {
+         return;
+      }
+
+      leastRecentlyRequestedEntry->clip = nullptr;
+      mSizeOfStreamedClips -= leastRecentlyRequestedEntry->sizeInBytes;
+   }
+}
@@ -36,7 +36,7 @@ void TCrossFadeControllerMultiple<CLIP>::SetSkeleton(Skeleton& skeleton)
 }
 
 template <typename CLIP>
-void TCrossFadeControllerMultiple<CLIP>::Play(CLIP* clip, bool lock)
+void TCrossFadeControllerMultiple<CLIP>::Play(const CLIP* clip, bool lock)
 {
    // When asked to play a clip, we clear all the crossfade targets
    mTargets.clear();
@@ -48,7 +48,7 @@ void TCrossFadeControllerMultiple<CLIP>::Play(CLIP* clip, bool lock)
 }
 
 template <typename CLIP>
-void TCrossFadeControllerMultiple<CLIP>::FadeTo(CLIP* targetClip, float fadeDuration, bool lock)
+void TCrossFadeControllerMultiple<CLIP>::FadeTo(const CLIP* targetClip, float fadeDuration, bool lock)
 {
    if (mLock)
    {
@@ -154,11 +154,32 @@ void TCrossFadeControllerMultiple<CLIP>::ClearTargets()
 }
 
 template <typename CLIP>
-CLIP* TCrossFadeControllerMultiple<CLIP>::GetCurrentClip()
+const CLIP* TCrossFadeControllerMultiple<CLIP>::GetCurrentClip()
 {
    return mCurrentClip;
 }
 
+template <typename CLIP>
+bool TCrossFadeControllerMultiple<CLIP>::IsPlaying(const CLIP* clip)
+{
+   // A clip is playing if it's the current clip or if the current clip is fading into it
+   if (mCurrentClip == clip)
+   {
+      return true;
+   }
+
+   unsigned int numTargets = static_cast<unsigned int>(mTargets.size());
+   for (unsigned int targetIndex = 0; targetIndex < numTargets; ++targetIndex)
+   {
+      if (mTargets[targetIndex].mClip == clip)
+      {
+         return true;
+      }
+   }
+
+   return false;
+}
+
 template <typename CLIP>
 Pose& TCrossFadeControllerMultiple<CLIP>::GetCurrentPose()
 {
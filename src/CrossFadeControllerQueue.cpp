@@ -34,7 +34,7 @@ void TCrossFadeControllerQueue<CLIP>::SetSkeleton(Skeleton& skeleton)
 }
 
 template <typename CLIP>
-void TCrossFadeControllerQueue<CLIP>::Play(CLIP* clip)
+void TCrossFadeControllerQueue<CLIP>::Play(const CLIP* clip)
 {
    // When asked to play a clip, we clear all the crossfade targets
    mTargets = {};
@@ -45,7 +45,7 @@ void TCrossFadeControllerQueue<CLIP>::Play(CLIP* clip)
 }
 
 template <typename CLIP>
-void TCrossFadeControllerQueue<CLIP>::FadeTo(CLIP* targetClip, float fadeDuration)
+void TCrossFadeControllerQueue<CLIP>::FadeTo(const CLIP* targetClip, float fadeDuration)
 {
    // If no clip has been set, simply play the target clip since there is no clip to fade from
    if (mCurrentClip == nullptr)
@@ -125,7 +125,7 @@ void TCrossFadeControllerQueue<CLIP>::Update(float dt)
 }
 
 template <typename CLIP>
-CLIP* TCrossFadeControllerQueue<CLIP>::GetCurrentClip()
+const CLIP* TCrossFadeControllerQueue<CLIP>::GetCurrentClip()
 {
    return mCurrentClip;
 }
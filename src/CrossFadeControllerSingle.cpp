@@ -36,7 +36,7 @@ void TCrossFadeControllerSingle<CLIP>::SetSkeleton(Skeleton& skeleton)
 }
 
 template <typename CLIP>
-void TCrossFadeControllerSingle<CLIP>::Play(CLIP* clip)
+void TCrossFadeControllerSingle<CLIP>::Play(const CLIP* clip)
 {
    // When asked to play a clip, clear the crossfade target
    mTarget = {};
@@ -47,7 +47,7 @@ void TCrossFadeControllerSingle<CLIP>::Play(CLIP* clip)
 }
 
 template <typename CLIP>
-void TCrossFadeControllerSingle<CLIP>::FadeTo(CLIP* targetClip, float fadeDuration)
+void TCrossFadeControllerSingle<CLIP>::FadeTo(const CLIP* targetClip, float fadeDuration)
 {
    // If no clip has been set, simply play the target clip since there is no clip to fade from
    if (mCurrentClip == nullptr)
@@ -131,7 +131,7 @@ void TCrossFadeControllerSingle<CLIP>::Update(float dt)
 }
 
 template <typename CLIP>
-CLIP* TCrossFadeControllerSingle<CLIP>::GetCurrentClip()
+const CLIP* TCrossFadeControllerSingle<CLIP>::GetCurrentClip()
 {
    return mCurrentClip;
 }
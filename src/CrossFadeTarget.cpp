@@ -12,7 +12,7 @@ TCrossFadeTarget<CLIP>::TCrossFadeTarget()
 }
 
 template <typename CLIP>
-TCrossFadeTarget<CLIP>::TCrossFadeTarget(CLIP* clip, Pose& pose, float fadeDuration, bool lock)
+TCrossFadeTarget<CLIP>::TCrossFadeTarget(const CLIP* clip, Pose& pose, float fadeDuration, bool lock)
    : mClip(clip)
    , mPose(pose)
    , mPlaybackTime(clip->GetStartTime())
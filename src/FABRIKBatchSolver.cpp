@@ -0,0 +1,468 @@
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define FABRIK_BATCH_SOLVER_USE_SSE
+#endif
+
+#include <chrono>
+#include <iostream>
+
+#include <glm/gtx/norm.hpp>
+
+#include "FABRIKSolver.h"
+#include "FABRIKBatchSolver.h"
+
+namespace FABRIKBatchSolverHelpers
+{
+   /*
+      The functions below wrap the few SIMD operations that the solver needs, so that it can be written once for WebAssembly SIMD and SSE
+      Masks are vectors whose lanes have all their bits set if a condition is true, and all their bits cleared if it's false
+   */
+
+#if defined(__wasm_simd128__)
+   typedef v128_t Float4;
+
+   inline Float4 Load(const float* values)           { return wasm_v128_load(values); }
+   inline Float4 Splat(float value)                  { return wasm_f32x4_splat(value); }
+   inline void   Store(float* values, Float4 a)      { wasm_v128_store(values, a); }
+   inline Float4 Add(Float4 a, Float4 b)             { return wasm_f32x4_add(a, b); }
+   inline Float4 Sub(Float4 a, Float4 b)             { return wasm_f32x4_sub(a, b); }
+   inline Float4 Mul(Float4 a, Float4 b)             { return wasm_f32x4_mul(a, b); }
+   inline Float4 Div(Float4 a, Float4 b)             { return wasm_f32x4_div(a, b); }
+   inline Float4 Sqrt(Float4 a)                      { return wasm_f32x4_sqrt(a); }
+   inline Float4 Less(Float4 a, Float4 b)            { return wasm_f32x4_lt(a, b); }
+   inline Float4 Or(Float4 a, Float4 b)              { return wasm_v128_or(a, b); }
+   // a & ~b
+   inline Float4 AndNot(Float4 a, Float4 b)          { return wasm_v128_andnot(a, b); }
+   // mask ? a : b
+   inline Float4 Select(Float4 mask, Float4 a, Float4 b) { return wasm_v128_bitselect(a, b, mask); }
+   inline int    MoveMask(Float4 a)                  { return static_cast<int>(wasm_i32x4_bitmask(a)); }
+#elif defined(FABRIK_BATCH_SOLVER_USE_SSE)
+   typedef __m128 Float4;
+
+   inline Float4 Load(const float* values)           { return _mm_load_ps(values); }
+   inline Float4 Splat(float value)                  { return _mm_set1_ps(value); }
+   inline void   Store(float* values, Float4 a)      { _mm_store_ps(values, a); }
+   inline Float4 Add(Float4 a, Float4 b)             { return _mm_add_ps(a, b); }
+   inline Float4 Sub(Float4 a, Float4 b)             { return _mm_sub_ps(a, b); }
+   inline Float4 Mul(Float4 a, Float4 b)             { return _mm_mul_ps(a, b); }
+   inline Float4 Div(Float4 a, Float4 b)             { return _mm_div_ps(a, b); }
+   inline Float4 Sqrt(Float4 a)                      { return _mm_sqrt_ps(a); }
+   inline Float4 Less(Float4 a, Float4 b)            { return _mm_cmplt_ps(a, b); }
+   inline Float4 Or(Float4 a, Float4 b)              { return _mm_or_ps(a, b); }
+   // a & ~b
+   inline Float4 AndNot(Float4 a, Float4 b)          { return _mm_andnot_ps(b, a); }
+   // mask ? a : b
+   inline Float4 Select(Float4 mask, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+   inline int    MoveMask(Float4 a)                  { return _mm_movemask_ps(a); }
+#endif
+
+#if defined(__wasm_simd128__) || defined(FABRIK_BATCH_SOLVER_USE_SSE)
+   // This function moves a joint so that it's at the given distance from an anchor, along the line that connects them
+   // It's the SIMD version of the line below, which is used by FABRIKSolver::IterateBackward and FABRIKSolver::IterateForward:
+   //
+   // joint = anchor - (normalizeWithZeroLengthCheck(anchor - joint) * distance)
+   //
+   // Only the lanes that are set in the active mask are moved
+   inline void MoveJointTowardsAnchor(float* jointX, float* jointY, float* jointZ,
+                                      const float* anchorX, const float* anchorY, const float* anchorZ,
+                                      Float4 distance, Float4 active)
+   {
+      Float4 jX = Load(jointX);
+      Float4 jY = Load(jointY);
+      Float4 jZ = Load(jointZ);
+      Float4 aX = Load(anchorX);
+      Float4 aY = Load(anchorY);
+      Float4 aZ = Load(anchorZ);
+
+      Float4 dirX = Sub(aX, jX);
+      Float4 dirY = Sub(aY, jY);
+      Float4 dirZ = Sub(aZ, jZ);
+
+      // Just like normalizeWithZeroLengthCheck, we don't normalize vectors that are almost zero
+      Float4 squaredLen = Add(Add(Mul(dirX, dirX), Mul(dirY, dirY)), Mul(dirZ, dirZ));
+      Float4 one        = Splat(1.0f);
+      Float4 invLen     = Select(Less(squaredLen, Splat(QUAT_EPSILON)), one, Div(one, Sqrt(squaredLen)));
+      Float4 scale      = Mul(invLen, distance);
+
+      Store(jointX, Select(active, Sub(aX, Mul(dirX, scale)), jX));
+      Store(jointY, Select(active, Sub(aY, Mul(dirY, scale)), jY));
+      Store(jointZ, Select(active, Sub(aZ, Mul(dirZ, scale)), jZ));
+   }
+#endif
+}
+
+FABRIKBatchSolver::FABRIKBatchSolver()
+   : mNumJoints(0)
+   , mNumChains(0)
+   , mNumIterations(15)
+   , mConvergenceThreshold(0.00001f)
+{
+
+}
+
+unsigned int FABRIKBatchSolver::GetNumberOfJointsInIKChains() const
+{
+   return mNumJoints;
+}
+
+void FABRIKBatchSolver::SetNumberOfJointsInIKChains(unsigned int numJoints)
+{
+   Clear();
+   mNumJoints = numJoints;
+}
+
+unsigned int FABRIKBatchSolver::GetNumberOfIterations() const
+{
+   return mNumIterations;
+}
+
+void FABRIKBatchSolver::SetNumberOfIterations(unsigned int numIterations)
+{
+   mNumIterations = numIterations;
+}
+
+float FABRIKBatchSolver::GetThreshold() const
+{
+   return mConvergenceThreshold;
+}
+
+void FABRIKBatchSolver::SetThreshold(float threshold)
+{
+   mConvergenceThreshold = threshold;
+}
+
+void FABRIKBatchSolver::Clear()
+{
+   mWorldPositions.clear();
+   mDistancesBetweenJoints.clear();
+   mGoalPositions.clear();
+   mRootPositions.clear();
+   mConvergedMasks.clear();
+   mNumIterationsPerformed.clear();
+   mNumChains = 0;
+}
+
+unsigned int FABRIKBatchSolver::AddIKChain(const glm::vec3* worldPositions, const glm::vec3& goalPos)
+{
+   unsigned int chainIndex = mNumChains;
+   unsigned int groupIndex = chainIndex / 4;
+   unsigned int lane       = chainIndex % 4;
+
+   // Start a new group if the last one is full
+   // The lanes of the new group are filled with zeros, so the lanes that don't get a chain don't produce infinities or NaNs
+   if (lane == 0)
+   {
+      Vec3Lanes  zeroPositions  = {};
+      FloatLanes zeroDistances  = {};
+      mWorldPositions.resize(mWorldPositions.size() + mNumJoints, zeroPositions);
+      mDistancesBetweenJoints.resize(mDistancesBetweenJoints.size() + mNumJoints, zeroDistances);
+      mGoalPositions.push_back(zeroPositions);
+      mRootPositions.push_back(zeroPositions);
+      mConvergedMasks.push_back(0);
+      mNumIterationsPerformed.push_back(0);
+   }
+
+   Vec3Lanes*  positions = &mWorldPositions[groupIndex * mNumJoints];
+   FloatLanes* distances = &mDistancesBetweenJoints[groupIndex * mNumJoints];
+   for (unsigned int jointIndex = 0; jointIndex < mNumJoints; ++jointIndex)
+   {
+      positions[jointIndex].x[lane] = worldPositions[jointIndex].x;
+      positions[jointIndex].y[lane] = worldPositions[jointIndex].y;
+      positions[jointIndex].z[lane] = worldPositions[jointIndex].z;
+
+      // Just like in FABRIKSolver::IKChainToWorld, the distance between the root and its parent is zero
+      distances[jointIndex].v[lane] = (jointIndex == 0) ? 0.0f : glm::length(worldPositions[jointIndex] - worldPositions[jointIndex - 1]);
+   }
+
+   mGoalPositions[groupIndex].x[lane] = goalPos.x;
+   mGoalPositions[groupIndex].y[lane] = goalPos.y;
+   mGoalPositions[groupIndex].z[lane] = goalPos.z;
+
+   if (mNumJoints > 0)
+   {
+      mRootPositions[groupIndex].x[lane] = worldPositions[0].x;
+      mRootPositions[groupIndex].y[lane] = worldPositions[0].y;
+      mRootPositions[groupIndex].z[lane] = worldPositions[0].z;
+   }
+
+   ++mNumChains;
+   return chainIndex;
+}
+
+unsigned int FABRIKBatchSolver::GetNumberOfIKChains() const
+{
+   return mNumChains;
+}
+
+void FABRIKBatchSolver::Solve()
+{
+   // We cannot solve the IK chains if they are empty
+   if (mNumJoints == 0)
+   {
+      return;
+   }
+
+   // The groups are independent, so we solve them one at a time, which keeps the joints of the group that is being solved in the cache
+   for (unsigned int groupIndex = 0, numGroups = static_cast<unsigned int>(mConvergedMasks.size()); groupIndex < numGroups; ++groupIndex)
+   {
+      SolveGroup(groupIndex);
+   }
+}
+
+glm::vec3 FABRIKBatchSolver::GetWorldPosition(unsigned int chainIndex, unsigned int jointIndex) const
+{
+   const Vec3Lanes& joint = mWorldPositions[(chainIndex / 4) * mNumJoints + jointIndex];
+   unsigned int     lane  = chainIndex % 4;
+   return glm::vec3(joint.x[lane], joint.y[lane], joint.z[lane]);
+}
+
+bool FABRIKBatchSolver::HasConverged(unsigned int chainIndex) const
+{
+   return (mConvergedMasks[chainIndex / 4] & (1 << (chainIndex % 4))) != 0;
+}
+
+unsigned int FABRIKBatchSolver::GetNumberOfIterationsPerformed(unsigned int chainIndex) const
+{
+   return mNumIterationsPerformed[chainIndex / 4];
+}
+
+// This function performs the same iterations as FABRIKSolver::Solve on the four chains of a group
+void FABRIKBatchSolver::SolveGroup(unsigned int groupIndex)
+{
+   using namespace FABRIKBatchSolverHelpers;
+
+   Vec3Lanes*        positions          = &mWorldPositions[groupIndex * mNumJoints];
+   const FloatLanes* distances          = &mDistancesBetweenJoints[groupIndex * mNumJoints];
+   const Vec3Lanes&  goal               = mGoalPositions[groupIndex];
+   const Vec3Lanes&  root               = mRootPositions[groupIndex];
+   unsigned int      indexOfEndEffector = mNumJoints - 1;
+   float             thresholdSq        = mConvergenceThreshold * mConvergenceThreshold;
+
+   // The last group might not be full, and the lanes that don't have a chain are treated as if they had converged
+   unsigned int numChainsInGroup = glm::min(mNumChains - groupIndex * 4, 4u);
+   int          validMask        = (1 << numChainsInGroup) - 1;
+
+#if defined(__wasm_simd128__) || defined(FABRIK_BATCH_SOLVER_USE_SSE)
+   alignas(16) const float laneIndices[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+   Float4 valid     = Less(Load(laneIndices), Splat(static_cast<float>(numChainsInGroup)));
+   Float4 converged = Splat(0.0f);
+   unsigned int numIterationsPerformed = 0;
+
+   // Loop over the allowed number of iterations until all the chains converge or we reach the maximum number of iterations
+   // Note that the loop runs one extra time to check if the chains converged in the last iteration
+   for (unsigned int i = 0; i <= mNumIterations; ++i)
+   {
+      // Check which chains converged
+      // Once a chain converges it stops moving, so it stays converged
+      const Vec3Lanes& endEffector = positions[indexOfEndEffector];
+      Float4 toGoalX = Sub(Load(goal.x), Load(endEffector.x));
+      Float4 toGoalY = Sub(Load(goal.y), Load(endEffector.y));
+      Float4 toGoalZ = Sub(Load(goal.z), Load(endEffector.z));
+      Float4 squaredDistToGoal = Add(Add(Mul(toGoalX, toGoalX), Mul(toGoalY, toGoalY)), Mul(toGoalZ, toGoalZ));
+      converged = Or(converged, Less(squaredDistToGoal, Splat(thresholdSq)));
+
+      Float4 active = AndNot(valid, converged);
+      if (MoveMask(active) == 0 || i == mNumIterations)
+      {
+         break;
+      }
+
+      ++numIterationsPerformed;
+
+      // Backward iteration: move the end effector to where the goal is, and then move each joint towards the next one
+      Vec3Lanes& endEffectorToMove = positions[indexOfEndEffector];
+      Store(endEffectorToMove.x, Select(active, Load(goal.x), Load(endEffectorToMove.x)));
+      Store(endEffectorToMove.y, Select(active, Load(goal.y), Load(endEffectorToMove.y)));
+      Store(endEffectorToMove.z, Select(active, Load(goal.z), Load(endEffectorToMove.z)));
+      for (int jointIndex = static_cast<int>(mNumJoints) - 2; jointIndex >= 0; --jointIndex)
+      {
+         MoveJointTowardsAnchor(positions[jointIndex].x, positions[jointIndex].y, positions[jointIndex].z,
+                                positions[jointIndex + 1].x, positions[jointIndex + 1].y, positions[jointIndex + 1].z,
+                                Load(distances[jointIndex + 1].v), active);
+      }
+
+      // Forward iteration: move the root back to its original position, and then move each joint towards the previous one
+      Store(positions[0].x, Select(active, Load(root.x), Load(positions[0].x)));
+      Store(positions[0].y, Select(active, Load(root.y), Load(positions[0].y)));
+      Store(positions[0].z, Select(active, Load(root.z), Load(positions[0].z)));
+      for (unsigned int jointIndex = 1; jointIndex < mNumJoints; ++jointIndex)
+      {
+         MoveJointTowardsAnchor(positions[jointIndex].x, positions[jointIndex].y, positions[jointIndex].z,
+                                positions[jointIndex - 1].x, positions[jointIndex - 1].y, positions[jointIndex - 1].z,
+                                Load(distances[jointIndex].v), active);
+      }
+   }
+
+   mConvergedMasks[groupIndex]         = MoveMask(converged) & validMask;
+   mNumIterationsPerformed[groupIndex] = numIterationsPerformed;
+#else
+   // Without SIMD instructions, we solve the chains of the group one after the other
+   int          convergedMask          = 0;
+   unsigned int numIterationsPerformed = 0;
+   for (unsigned int lane = 0; lane < numChainsInGroup; ++lane)
+   {
+      glm::vec3 goalPos(goal.x[lane], goal.y[lane], goal.z[lane]);
+      glm::vec3 oriPosOfRoot(root.x[lane], root.y[lane], root.z[lane]);
+
+      for (unsigned int i = 0; i <= mNumIterations; ++i)
+      {
+         glm::vec3 endEffectorPos(positions[indexOfEndEffector].x[lane], positions[indexOfEndEffector].y[lane], positions[indexOfEndEffector].z[lane]);
+         if (glm::length2(goalPos - endEffectorPos) < thresholdSq)
+         {
+            convergedMask |= (1 << lane);
+            break;
+         }
+
+         if (i == mNumIterations)
+         {
+            break;
+         }
+
+         // The group performs as many iterations as the chain that needs the most
+         numIterationsPerformed = glm::max(numIterationsPerformed, i + 1);
+
+         // Backward iteration
+         glm::vec3 anchorPos = goalPos;
+         positions[indexOfEndEffector].x[lane] = anchorPos.x;
+         positions[indexOfEndEffector].y[lane] = anchorPos.y;
+         positions[indexOfEndEffector].z[lane] = anchorPos.z;
+         for (int jointIndex = static_cast<int>(mNumJoints) - 2; jointIndex >= 0; --jointIndex)
+         {
+            glm::vec3 jointPos(positions[jointIndex].x[lane], positions[jointIndex].y[lane], positions[jointIndex].z[lane]);
+            jointPos = anchorPos - (normalizeWithZeroLengthCheck(anchorPos - jointPos) * distances[jointIndex + 1].v[lane]);
+            positions[jointIndex].x[lane] = jointPos.x;
+            positions[jointIndex].y[lane] = jointPos.y;
+            positions[jointIndex].z[lane] = jointPos.z;
+            anchorPos = jointPos;
+         }
+
+         // Forward iteration
+         anchorPos = oriPosOfRoot;
+         positions[0].x[lane] = anchorPos.x;
+         positions[0].y[lane] = anchorPos.y;
+         positions[0].z[lane] = anchorPos.z;
+         for (unsigned int jointIndex = 1; jointIndex < mNumJoints; ++jointIndex)
+         {
+            glm::vec3 jointPos(positions[jointIndex].x[lane], positions[jointIndex].y[lane], positions[jointIndex].z[lane]);
+            jointPos = anchorPos - (normalizeWithZeroLengthCheck(anchorPos - jointPos) * distances[jointIndex].v[lane]);
+            positions[jointIndex].x[lane] = jointPos.x;
+            positions[jointIndex].y[lane] = jointPos.y;
+            positions[jointIndex].z[lane] = jointPos.z;
+            anchorPos = jointPos;
+         }
+      }
+   }
+
+   mConvergedMasks[groupIndex]         = convergedMask & validMask;
+   mNumIterationsPerformed[groupIndex] = numIterationsPerformed;
+#endif
+}
+
+void BenchmarkFABRIKBatchSolver(const Transform& hip, const Transform& knee, const Transform& ankle, unsigned int numIterations, unsigned int numChains)
+{
+   if (numChains == 0)
+   {
+      return;
+   }
+
+   glm::vec3 worldPosOfKnee  = combine(hip, knee).position;
+   glm::vec3 worldPosOfAnkle = combine(hip, combine(knee, ankle)).position;
+   float     lengthOfLeg     = glm::length(worldPosOfKnee - hip.position) + glm::length(worldPosOfAnkle - worldPosOfKnee);
+
+   // Place the targets on a grid inside a box around the ankle, which is where the ground ends up when the characters walk on uneven terrain
+   unsigned int targetsPerSide = static_cast<unsigned int>(glm::ceil(glm::pow(static_cast<float>(numChains), 1.0f / 3.0f)));
+   float        halfSizeOfBox  = 0.25f * lengthOfLeg;
+   std::vector<glm::vec3> targets;
+   targets.reserve(targetsPerSide * targetsPerSide * targetsPerSide);
+   for (unsigned int z = 0; z < targetsPerSide; ++z)
+   {
+      for (unsigned int y = 0; y < targetsPerSide; ++y)
+      {
+         for (unsigned int x = 0; x < targetsPerSide; ++x)
+         {
+            glm::vec3 offset(glm::mix(-halfSizeOfBox, halfSizeOfBox, (x + 0.5f) / targetsPerSide),
+                             glm::mix(-halfSizeOfBox, halfSizeOfBox, (y + 0.5f) / targetsPerSide),
+                             glm::mix(-halfSizeOfBox, halfSizeOfBox, (z + 0.5f) / targetsPerSide));
+            targets.push_back(worldPosOfAnkle + offset);
+         }
+      }
+   }
+
+   unsigned int numBenchmarkChains = static_cast<unsigned int>(targets.size());
+
+   // One chain at a time, just like the IK legs solve them
+   std::vector<FABRIKSolver> solvers(numBenchmarkChains);
+   std::vector<glm::vec3>    singleEndEffectorPositions(numBenchmarkChains);
+   for (unsigned int chainIndex = 0; chainIndex < numBenchmarkChains; ++chainIndex)
+   {
+      solvers[chainIndex].SetNumberOfJointsInIKChain(3);
+      solvers[chainIndex].SetNumberOfIterations(numIterations);
+   }
+
+   auto start = std::chrono::steady_clock::now();
+   for (unsigned int chainIndex = 0; chainIndex < numBenchmarkChains; ++chainIndex)
+   {
+      FABRIKSolver& solver = solvers[chainIndex];
+      solver.SetLocalTransform(0, hip);
+      solver.SetLocalTransform(1, knee);
+      solver.SetLocalTransform(2, ankle);
+      solver.Solve(Transform(targets[chainIndex], Q::quat(), glm::vec3(1.0f)));
+      singleEndEffectorPositions[chainIndex] = solver.GetGlobalTransform(2).position;
+   }
+   auto end = std::chrono::steady_clock::now();
+   double singleSeconds = std::chrono::duration<double>(end - start).count();
+
+   // All the chains at once, including the conversions from transforms to world positions and back
+   FABRIKBatchSolver batchSolver;
+   batchSolver.SetNumberOfJointsInIKChains(3);
+   batchSolver.SetNumberOfIterations(numIterations);
+   std::vector<glm::vec3> batchEndEffectorPositions(numBenchmarkChains);
+
+   start = std::chrono::steady_clock::now();
+   batchSolver.Clear();
+   for (unsigned int chainIndex = 0; chainIndex < numBenchmarkChains; ++chainIndex)
+   {
+      FABRIKSolver& solver = solvers[chainIndex];
+      solver.SetLocalTransform(0, hip);
+      solver.SetLocalTransform(1, knee);
+      solver.SetLocalTransform(2, ankle);
+
+      glm::vec3 worldPositions[3] = { solver.GetGlobalTransform(0).position, solver.GetGlobalTransform(1).position, solver.GetGlobalTransform(2).position };
+      batchSolver.AddIKChain(worldPositions, targets[chainIndex]);
+   }
+
+   auto startOfSolve = std::chrono::steady_clock::now();
+   batchSolver.Solve();
+   auto endOfSolve = std::chrono::steady_clock::now();
+
+   for (unsigned int chainIndex = 0; chainIndex < numBenchmarkChains; ++chainIndex)
+   {
+      glm::vec3 worldPositions[3] = { batchSolver.GetWorldPosition(chainIndex, 0), batchSolver.GetWorldPosition(chainIndex, 1), batchSolver.GetWorldPosition(chainIndex, 2) };
+      solvers[chainIndex].SetWorldPositionsOfIKChain(worldPositions);
+      batchEndEffectorPositions[chainIndex] = solvers[chainIndex].GetGlobalTransform(2).position;
+   }
+   end = std::chrono::steady_clock::now();
+   double batchSeconds      = std::chrono::duration<double>(end - start).count();
+   double batchSolveSeconds = std::chrono::duration<double>(endOfSolve - startOfSolve).count();
+
+   // Both solvers perform the same iterations, so their results should only differ by rounding errors
+   unsigned int numConvergedChains = 0;
+   float        maxDifference      = 0.0f;
+   for (unsigned int chainIndex = 0; chainIndex < numBenchmarkChains; ++chainIndex)
+   {
+      numConvergedChains += batchSolver.HasConverged(chainIndex) ? 1 : 0;
+      maxDifference       = glm::max(maxDifference, glm::length(singleEndEffectorPositions[chainIndex] - batchEndEffectorPositions[chainIndex]));
+   }
+
+   double singleChainsPerSecond     = numBenchmarkChains / glm::max(singleSeconds, 1e-9);
+   double batchChainsPerSecond      = numBenchmarkChains / glm::max(batchSeconds, 1e-9);
+   double batchSolveChainsPerSecond = numBenchmarkChains / glm::max(batchSolveSeconds, 1e-9);
+
+   std::cout << "FABRIK batch - Chains: " << numBenchmarkChains << ", Converged: " << numConvergedChains << ", Iterations: " << numIterations
+             << ", Max end effector difference: " << (maxDifference / lengthOfLeg) << " leg lengths" << '\n'
+             << "   One chain at a time:        " << singleChainsPerSecond << " chains/s" << '\n'
+             << "   Batch:                      " << batchChainsPerSecond << " chains/s (" << (batchChainsPerSecond / singleChainsPerSecond) << "x)" << '\n'
+             << "   Batch without conversions:  " << batchSolveChainsPerSecond << " chains/s (" << (batchSolveChainsPerSecond / singleChainsPerSecond) << "x)" << '\n';
+}
@@ -1,7 +1,10 @@
+#include <cfloat>
+
 #include <glm/gtx/norm.hpp>
 #include <glm/gtx/vector_angle.hpp>
 
 #include "FABRIKSolver.h"
+#include "IKSolverHelpers.h"
 
 // Forward and Backward Reaching Inverse Kinematics (FABRIK) is an algorithm that can be used to pose a chain of joints so that the last joint of the chain
 // comes as close as possible to touching a target
@@ -25,6 +28,8 @@
 FABRIKSolver::FABRIKSolver()
    : mNumIterations(15)
    , mConvergenceThreshold(0.00001f)
+   , mMinImprovementPerIteration(0.0f)
+   , mNumIterationsPerformed(0)
 {
 
 }
@@ -84,6 +89,21 @@ void FABRIKSolver::SetThreshold(float threshold)
    mConvergenceThreshold = threshold;
 }
 
+float FABRIKSolver::GetMinImprovementPerIteration()
+{
+   return mMinImprovementPerIteration;
+}
+
+void FABRIKSolver::SetMinImprovementPerIteration(float minImprovement)
+{
+   mMinImprovementPerIteration = minImprovement;
+}
+
+unsigned int FABRIKSolver::GetNumberOfIterationsPerformed()
+{
+   return mNumIterationsPerformed;
+}
+
 bool FABRIKSolver::Solve(const Transform& target)
 {
    unsigned int numJoints = GetNumberOfJointsInIKChain();
@@ -104,20 +124,33 @@ bool FABRIKSolver::Solve(const Transform& target)
 
    glm::vec3 oriPosOfRoot = mWorldPositionsChain[0];
 
-   // Loop over the allowed number of iterations until we either converge or reach the maximum number of iterations
+   float prevSquaredDistToGoal = FLT_MAX;
+   mNumIterationsPerformed = 0;
+
+   // Loop over the allowed number of iterations until we either converge, stop making progress or reach the maximum number of iterations
    for (unsigned int i = 0; i < mNumIterations; ++i)
    {
       // Update the position of the end effector, since it changes with every iteration of this loop
       endEffectorPos = mWorldPositionsChain[indexOfEndEffector];
+      float squaredDistToGoal = glm::length2(goalPos - endEffectorPos);
 
       // Check if we converged
-      if (glm::length2(goalPos - endEffectorPos) < thresholdSq)
+      if (squaredDistToGoal < thresholdSq)
       {
          // If we did, use the positions stored in mWorldPositionsChain to rotate the joints stored in mIKChain to achieve the solved pose
          WorldToIKChain();
          return true;
       }
 
+      // Check if the last iteration barely moved the end effector towards the goal, which happens when the goal is out of reach
+      if (HasIKSolverStalled(squaredDistToGoal, prevSquaredDistToGoal, mMinImprovementPerIteration))
+      {
+         break;
+      }
+
+      prevSquaredDistToGoal = squaredDistToGoal;
+      ++mNumIterationsPerformed;
+
       // Perform a backward and forward iteration
       IterateBackward(goalPos);
       IterateForward(oriPosOfRoot);
@@ -164,14 +197,18 @@ bool FABRIKSolver::SolveThreeJointLegWithConstraints(const Transform& target, in
    glm::vec3 initialWorldXAxisOfKnee = GetGlobalTransform(indexOfKnee).rotation * glm::vec3(1.0f, 0.0f, 0.0f);
    glm::vec3 initialWorldXAxisOfHip  = GetGlobalTransform(indexOfHip).rotation * glm::vec3(1.0f, 0.0f, 0.0f);
 
-   // Loop over the allowed number of iterations until we either converge or reach the maximum number of iterations
+   float prevSquaredDistToGoal = FLT_MAX;
+   mNumIterationsPerformed = 0;
+
+   // Loop over the allowed number of iterations until we either converge, stop making progress or reach the maximum number of iterations
    for (unsigned int i = 0; i < mNumIterations; ++i)
    {
       // Update the position of the end effector, since it changes with every iteration of this loop
       endEffectorPos = mWorldPositionsChain[indexOfEndEffector];
+      float squaredDistToGoal = glm::length2(goalPos - endEffectorPos);
 
       // Check if we converged
-      if (glm::length2(goalPos - endEffectorPos) < thresholdSq)
+      if (squaredDistToGoal < thresholdSq)
       {
          // If we did, use the positions stored in mWorldPositionsChain to rotate the joints stored in mIKChain to achieve the solved pose
          WorldToIKChain();
@@ -179,6 +216,15 @@ bool FABRIKSolver::SolveThreeJointLegWithConstraints(const Transform& target, in
          return true;
       }
 
+      // Check if the last iteration barely moved the end effector towards the goal, which happens when the goal is out of reach
+      if (HasIKSolverStalled(squaredDistToGoal, prevSquaredDistToGoal, mMinImprovementPerIteration))
+      {
+         break;
+      }
+
+      prevSquaredDistToGoal = squaredDistToGoal;
+      ++mNumIterationsPerformed;
+
       // Perform a backward and forward iteration
       IterateBackward(goalPos);
       IterateForward(oriPosOfRoot);
@@ -208,6 +254,16 @@ bool FABRIKSolver::SolveThreeJointLegWithConstraints(const Transform& target, in
    }
 }
 
+void FABRIKSolver::SetWorldPositionsOfIKChain(const glm::vec3* worldPositions)
+{
+   for (unsigned int jointIndex = 0, numJoints = GetNumberOfJointsInIKChain(); jointIndex < numJoints; ++jointIndex)
+   {
+      mWorldPositionsChain[jointIndex] = worldPositions[jointIndex];
+   }
+
+   WorldToIKChain();
+}
+
 // This function fills mWorldPositionsChain with the world positions of the joints that make up the unsolved IK chain
 // It does this by calculating the global transform of each joint using the local transforms stored in mIKChain
 // It also fills mDistancesBetweenJoints, which contains the distance between each joint and its parent
@@ -0,0 +1,386 @@
+#include <chrono>
+#include <iostream>
+
+#include <glm/gtx/norm.hpp>
+#include <glm/gtx/compatibility.hpp>
+
+#include "FootPlacementSystem.h"
+
+namespace FootPlacementHelpers
+{
+   // This function rotates an ankle so that the vector that goes from it to its toe points towards the new position of the toe
+   void RotateAnkleTowardsToe(Pose& pose, unsigned int ankleIndex, const Transform& worldTransfOfAnkle, const glm::vec3& worldPosOfToe, const glm::vec3& newWorldPosOfToe)
+   {
+      glm::vec3 ankleToCurrToe = worldPosOfToe - worldTransfOfAnkle.position;
+      glm::vec3 ankleToNewToe  = newWorldPosOfToe - worldTransfOfAnkle.position;
+      // TODO: Use constant
+      if (glm::dot(ankleToCurrToe, ankleToNewToe) <= 0.00001f)
+      {
+         return;
+      }
+
+      // Construct a world rotation that goes from the current toe to the new one
+      Q::quat worldRotFromCurrToeToNewToe = Q::fromTo(ankleToCurrToe, ankleToNewToe);
+
+      // Apply the toe-to-toe world rotation to the world rotation of the ankle
+      Q::quat newWorldRotOfAnkle = worldTransfOfAnkle.rotation * worldRotFromCurrToeToNewToe;
+
+      // Multiply the new world rotation of the ankle by the inverse of its old world rotation to get:
+      // worldTransfOfAnkle.rotation^-1 * newWorldRotOfAnkle = (D * C * B * A_old)^-1 * (D * C * B * A_new) = (A_old^-1 * B^-1 * C^-1 * D^-1) * (D * C * B * A_new) = A_old^-1 * A_new
+      Q::quat newLocalRotOfAnkle = newWorldRotOfAnkle * inverse(worldTransfOfAnkle.rotation);
+
+      // Multiply newLocalRotOfAnkle by the old local rotation of the ankle to get:
+      // localTransfOfAnkle * newLocalRotOfAnkle = A_old * A_old^-1 * A_new = A_new
+      Transform localTransfOfAnkle = pose.GetLocalTransform(ankleIndex);
+      localTransfOfAnkle.rotation  = newLocalRotOfAnkle * localTransfOfAnkle.rotation;
+      pose.SetLocalTransform(ankleIndex, localTransfOfAnkle);
+   }
+}
+
+FootPlacementSystem::FootPlacementSystem()
+   : mQueryOrigins()
+   , mQueryProbes()
+   , mGroundPoints()
+   , mHits()
+   , mWorldTransfsOfAnkles()
+   , mWorldPosOfToes()
+   , mLegBatchSolver()
+{
+   // The chains of the legs have 3 joints: the hip, the knee and the ankle
+   mLegBatchSolver.SetNumberOfJointsInIKChains(3);
+}
+
+void FootPlacementSystem::Run(const HeightQueryGrid&       grid,
+                              const FootPlacementSettings& settings,
+                              const FootPlacementInput*    inputs,
+                              FootPlacementCharacter*      characters,
+                              Pose*                        poses,
+                              FootPlacementOutput*         outputs,
+                              unsigned int                 numCharacters)
+{
+   using namespace FootPlacementHelpers;
+
+   unsigned int numFeet = numCharacters * 2;
+   mQueryOrigins.resize(numFeet);
+   mQueryProbes.resize(numFeet);
+   mGroundPoints.resize(numFeet);
+   mHits.resize(numFeet);
+   mWorldTransfsOfAnkles.resize(numFeet);
+   mWorldPosOfToes.resize(numFeet);
+
+   // Ankle Correction
+   // **********************************************************************************************************************************************
+
+   GatherAnkleQueries(settings, inputs, characters, poses, numCharacters);
+   ResolveQueries(grid);
+
+   for (unsigned int characterIndex = 0; characterIndex < numCharacters; ++characterIndex)
+   {
+      const float pinTrackValues[2] = { inputs[characterIndex].leftFootPinTrackValue, inputs[characterIndex].rightFootPinTrackValue };
+      glm::vec3*  finalTargets[2]   = { &outputs[characterIndex].leftAnkleTarget, &outputs[characterIndex].rightAnkleTarget };
+
+      for (unsigned int side = 0; side < 2; ++side)
+      {
+         unsigned int footIndex = (characterIndex * 2) + side;
+
+         // If the ray doesn't hit anything, we use the position of the ankle as the default value
+         glm::vec3 worldPosOfAnkle   = mWorldTransfsOfAnkles[footIndex].position;
+         glm::vec3 ankleGroundTarget = worldPosOfAnkle;
+
+         // Here we do the equivalent of the following:
+         // - Shoot a ray downwards from the height of the hip to the ankle
+         // - Shoot a ray downwards from the height of the hip through the ankle to infinity
+         // The first ray tells us if there's ground above the ankle
+         // If there is, that becomes the new position of the ankle, which means that the foot will be on the ground regardless of what the pin track says
+         // The second ray tells us if there's ground above or below the ankle
+         // If there is, that becomes the new target of the IK chain
+         if (mHits[footIndex])
+         {
+            if (glm::length2(mGroundPoints[footIndex] - mQueryOrigins[footIndex]) < settings.heightOfHip * settings.heightOfHip)
+            {
+               worldPosOfAnkle = mGroundPoints[footIndex];
+            }
+
+            ankleGroundTarget = mGroundPoints[footIndex];
+         }
+
+         // Interpolate between the world position of the ankle and its ground target based on the value of the pin track
+         // If the pin track says that the foot should be on the ground, then the ground target will be favored
+         // If the pin track says that the foot should not be on the ground, the the world position of the ankle, which is given by the animation clip, will be favored
+         *finalTargets[side] = glm::lerp(worldPosOfAnkle, ankleGroundTarget, pinTrackValues[side]);
+      }
+   }
+
+   SolveLegs(settings, inputs, characters, poses, outputs, numCharacters);
+
+   // Toe Correction
+   // **********************************************************************************************************************************************
+
+   GatherToeQueries(settings, inputs, characters, poses, numCharacters);
+   ResolveQueries(grid);
+
+   for (unsigned int characterIndex = 0; characterIndex < numCharacters; ++characterIndex)
+   {
+      const float  pinTrackValues[2] = { inputs[characterIndex].leftFootPinTrackValue, inputs[characterIndex].rightFootPinTrackValue };
+      unsigned int ankleIndices[2]   = { characters[characterIndex].leftLeg.GetAnkleIndex(), characters[characterIndex].rightLeg.GetAnkleIndex() };
+
+      for (unsigned int side = 0; side < 2; ++side)
+      {
+         unsigned int footIndex = (characterIndex * 2) + side;
+
+         // If the ray doesn't hit anything, we use the position of the toe as the default value
+         glm::vec3 newWorldPosOfToe = mWorldPosOfToes[footIndex];
+         glm::vec3 toeGroundTarget  = mWorldPosOfToes[footIndex];
+
+         // The rays of the toes work just like the rays of the ankles, except that they shoot down from the height of the knees
+         if (mHits[footIndex])
+         {
+            if (glm::length2(mGroundPoints[footIndex] - mQueryOrigins[footIndex]) < settings.heightOfKnees * settings.heightOfKnees)
+            {
+               newWorldPosOfToe = mGroundPoints[footIndex];
+            }
+
+            toeGroundTarget = mGroundPoints[footIndex];
+         }
+
+         newWorldPosOfToe = glm::lerp(newWorldPosOfToe, toeGroundTarget, pinTrackValues[side]);
+
+         RotateAnkleTowardsToe(poses[characterIndex], ankleIndices[side], mWorldTransfsOfAnkles[footIndex], mWorldPosOfToes[footIndex], newWorldPosOfToe);
+      }
+   }
+}
+
+void FootPlacementSystem::GatherAnkleQueries(const FootPlacementSettings& settings, const FootPlacementInput* inputs, FootPlacementCharacter* characters, const Pose* poses, unsigned int numCharacters)
+{
+   for (unsigned int characterIndex = 0; characterIndex < numCharacters; ++characterIndex)
+   {
+      const Transform&        modelTransform = inputs[characterIndex].modelTransform;
+      const Pose&             pose           = poses[characterIndex];
+      FootPlacementCharacter& character      = characters[characterIndex];
+      unsigned int            footIndex      = characterIndex * 2;
+
+      // Calculate the world positions of the ankles by combining the model transform of the character with the global transforms of the joints
+      mWorldTransfsOfAnkles[footIndex]     = combine(modelTransform, pose.GetGlobalTransform(character.leftLeg.GetAnkleIndex()));
+      mWorldTransfsOfAnkles[footIndex + 1] = combine(modelTransform, pose.GetGlobalTransform(character.rightLeg.GetAnkleIndex()));
+
+      // The rays of the ankles shoot down from the height of the hip
+      mQueryOrigins[footIndex]     = mWorldTransfsOfAnkles[footIndex].position + glm::vec3(0.0f, settings.heightOfHip, 0.0f);
+      mQueryOrigins[footIndex + 1] = mWorldTransfsOfAnkles[footIndex + 1].position + glm::vec3(0.0f, settings.heightOfHip, 0.0f);
+
+      mQueryProbes[footIndex]     = &character.leftAnkleGroundProbe;
+      mQueryProbes[footIndex + 1] = &character.rightAnkleGroundProbe;
+   }
+}
+
+void FootPlacementSystem::GatherToeQueries(const FootPlacementSettings& settings, const FootPlacementInput* inputs, FootPlacementCharacter* characters, const Pose* poses, unsigned int numCharacters)
+{
+   for (unsigned int characterIndex = 0; characterIndex < numCharacters; ++characterIndex)
+   {
+      const Transform&        modelTransform = inputs[characterIndex].modelTransform;
+      const Pose&             pose           = poses[characterIndex];
+      FootPlacementCharacter& character      = characters[characterIndex];
+      unsigned int            footIndex      = characterIndex * 2;
+
+      // The ankles were moved by the IK solver, so their world transforms must be calculated again
+      mWorldTransfsOfAnkles[footIndex]     = combine(modelTransform, pose.GetGlobalTransform(character.leftLeg.GetAnkleIndex()));
+      mWorldTransfsOfAnkles[footIndex + 1] = combine(modelTransform, pose.GetGlobalTransform(character.rightLeg.GetAnkleIndex()));
+      mWorldPosOfToes[footIndex]           = combine(modelTransform, pose.GetGlobalTransform(character.leftLeg.GetToeIndex())).position;
+      mWorldPosOfToes[footIndex + 1]       = combine(modelTransform, pose.GetGlobalTransform(character.rightLeg.GetToeIndex())).position;
+
+      // World forward direction of character
+      glm::vec3 worldFwdDirOfCharacter = modelTransform.rotation * glm::vec3(0.0f, 0.0f, 1.0f);
+
+      // The rays of the toes are composed as follows:
+      // - Start at position of the ankle
+      // - Move the origin to the height of the toe
+      // - Move the origin up by the distance between the toe and the knee
+      // - Move the origin forward by the distance between the ankle and the toe
+      // By doing this we create a ray that shoots down from the knee in front of the ankle
+      for (unsigned int side = 0; side < 2; ++side)
+      {
+         glm::vec3& origin = mQueryOrigins[footIndex + side];
+         origin    = mWorldTransfsOfAnkles[footIndex + side].position;
+         origin.y  = mWorldPosOfToes[footIndex + side].y + settings.heightOfKnees;
+         origin   += worldFwdDirOfCharacter * settings.distanceFromAnkleToToe;
+      }
+
+      mQueryProbes[footIndex]     = &character.leftToeGroundProbe;
+      mQueryProbes[footIndex + 1] = &character.rightToeGroundProbe;
+   }
+}
+
+void FootPlacementSystem::ResolveQueries(const HeightQueryGrid& grid)
+{
+   GetGroundPointsBelow(grid, mQueryProbes.data(), mQueryOrigins.data(), static_cast<unsigned int>(mQueryOrigins.size()), mGroundPoints.data(), mHits.data());
+}
+
+void FootPlacementSystem::SolveLegs(const FootPlacementSettings& settings, const FootPlacementInput* inputs, FootPlacementCharacter* characters, Pose* poses, FootPlacementOutput* outputs, unsigned int numCharacters)
+{
+   // Solve the IK chains of the legs so that their end effectors (ankles) are at the targets we calculated
+   if (settings.solveAnalytically)
+   {
+      for (unsigned int characterIndex = 0; characterIndex < numCharacters; ++characterIndex)
+      {
+         const Transform&        modelTransform = inputs[characterIndex].modelTransform;
+         FootPlacementCharacter& character      = characters[characterIndex];
+         character.leftLeg.SolveAnalytically(modelTransform, poses[characterIndex], outputs[characterIndex].leftAnkleTarget);
+         character.rightLeg.SolveAnalytically(modelTransform, poses[characterIndex], outputs[characterIndex].rightAnkleTarget);
+      }
+   }
+   else if (settings.solveInBatch)
+   {
+      // The legs of all the characters are solved together, which is where batching the characters pays off the most
+      mLegBatchSolver.Clear();
+      mLegBatchSolver.SetNumberOfIterations(settings.numIterations);
+      for (unsigned int characterIndex = 0; characterIndex < numCharacters; ++characterIndex)
+      {
+         const Transform&        modelTransform = inputs[characterIndex].modelTransform;
+         FootPlacementCharacter& character      = characters[characterIndex];
+         character.leftLeg.SubmitToBatch(mLegBatchSolver, modelTransform, poses[characterIndex], outputs[characterIndex].leftAnkleTarget);
+         character.rightLeg.SubmitToBatch(mLegBatchSolver, modelTransform, poses[characterIndex], outputs[characterIndex].rightAnkleTarget);
+      }
+
+      mLegBatchSolver.Solve();
+
+      for (unsigned int characterIndex = 0; characterIndex < numCharacters; ++characterIndex)
+      {
+         const Transform&        modelTransform = inputs[characterIndex].modelTransform;
+         FootPlacementCharacter& character      = characters[characterIndex];
+         character.leftLeg.RetrieveFromBatch(mLegBatchSolver, modelTransform, poses[characterIndex], settings.solveWithConstraints);
+         character.rightLeg.RetrieveFromBatch(mLegBatchSolver, modelTransform, poses[characterIndex], settings.solveWithConstraints);
+      }
+   }
+   else
+   {
+      for (unsigned int characterIndex = 0; characterIndex < numCharacters; ++characterIndex)
+      {
+         const Transform&        modelTransform = inputs[characterIndex].modelTransform;
+         FootPlacementCharacter& character      = characters[characterIndex];
+         character.leftLeg.Solve(modelTransform, poses[characterIndex], outputs[characterIndex].leftAnkleTarget, settings.solveWithConstraints, settings.numIterations, settings.warmStart);
+         character.rightLeg.Solve(modelTransform, poses[characterIndex], outputs[characterIndex].rightAnkleTarget, settings.solveWithConstraints, settings.numIterations, settings.warmStart);
+      }
+   }
+
+   // Write the resulting IK chains into the poses
+   // Only the hips, knees and ankles change when the legs are solved, so those are the only joints that we need to write
+   for (unsigned int characterIndex = 0; characterIndex < numCharacters; ++characterIndex)
+   {
+      FootPlacementCharacter& character = characters[characterIndex];
+      character.leftLeg.ApplySolvedChainToPose(poses[characterIndex]);
+      character.rightLeg.ApplySolvedChainToPose(poses[characterIndex]);
+
+      outputs[characterIndex].numIKIterations = character.leftLeg.GetNumberOfIterationsOfLastSolve() + character.rightLeg.GetNumberOfIterationsOfLastSolve();
+   }
+}
+
+void BenchmarkFootPlacementSystem(const HeightQueryGrid&        grid,
+                                  const FootPlacementSettings&  settings,
+                                  const FootPlacementCharacter& character,
+                                  const Pose&                   pose,
+                                  unsigned int                  numCharacters)
+{
+   AABB bounds = grid.GetBounds();
+   if (bounds.IsEmpty() || numCharacters == 0)
+   {
+      return;
+   }
+
+   // Place the characters on a grid that covers the ground, facing different directions, with their feet at different points of their pin tracks
+   unsigned int charactersPerSide = static_cast<unsigned int>(glm::ceil(glm::sqrt(static_cast<float>(numCharacters))));
+   std::vector<FootPlacementInput> inputs;
+   inputs.reserve(charactersPerSide * charactersPerSide);
+   for (unsigned int z = 0; z < charactersPerSide; ++z)
+   {
+      for (unsigned int x = 0; x < charactersPerSide; ++x)
+      {
+         unsigned int characterIndex = (z * charactersPerSide) + x;
+         float posX = glm::mix(bounds.min.x, bounds.max.x, (x + 0.5f) / charactersPerSide);
+         float posZ = glm::mix(bounds.min.z, bounds.max.z, (z + 0.5f) / charactersPerSide);
+         float posY;
+         if (!grid.GetGroundHeight(posX, posZ, posY))
+         {
+            continue;
+         }
+
+         FootPlacementInput input;
+         input.modelTransform         = Transform(glm::vec3(posX, posY, posZ), Q::angleAxis(characterIndex * 2.39996f, glm::vec3(0.0f, 1.0f, 0.0f)), glm::vec3(1.0f));
+         input.leftFootPinTrackValue  = ((characterIndex * 7) % 8) / 7.0f;
+         input.rightFootPinTrackValue = 1.0f - input.leftFootPinTrackValue;
+         inputs.push_back(input);
+      }
+   }
+
+   unsigned int numBenchmarkCharacters = static_cast<unsigned int>(inputs.size());
+   if (numBenchmarkCharacters == 0)
+   {
+      return;
+   }
+
+   // Both methods start from the same characters and poses on every repetition, so that warm starts don't make the later repetitions cheaper
+   // The time it takes to restore them isn't measured
+   const unsigned int numRepetitions = 16;
+
+   FootPlacementSystem                 system;
+   std::vector<FootPlacementCharacter> characters;
+   std::vector<Pose>                   poses;
+   std::vector<FootPlacementOutput>    singleOutputs(numBenchmarkCharacters);
+   std::vector<FootPlacementOutput>    batchOutputs(numBenchmarkCharacters);
+
+   // One character at a time, just like the IK states place the feet of their only character
+   double singleSeconds = 0.0;
+   for (unsigned int repetition = 0; repetition < numRepetitions; ++repetition)
+   {
+      characters.assign(numBenchmarkCharacters, character);
+      poses.assign(numBenchmarkCharacters, pose);
+
+      auto start = std::chrono::steady_clock::now();
+      for (unsigned int characterIndex = 0; characterIndex < numBenchmarkCharacters; ++characterIndex)
+      {
+         system.Run(grid, settings, &inputs[characterIndex], &characters[characterIndex], &poses[characterIndex], &singleOutputs[characterIndex], 1);
+      }
+      auto end = std::chrono::steady_clock::now();
+      singleSeconds += std::chrono::duration<double>(end - start).count();
+   }
+
+   std::vector<glm::vec3> singleAnklePositions(numBenchmarkCharacters);
+   for (unsigned int characterIndex = 0; characterIndex < numBenchmarkCharacters; ++characterIndex)
+   {
+      singleAnklePositions[characterIndex] = poses[characterIndex].GetGlobalTransform(characters[characterIndex].leftLeg.GetAnkleIndex()).position;
+   }
+
+   // All the characters at once
+   double batchSeconds = 0.0;
+   for (unsigned int repetition = 0; repetition < numRepetitions; ++repetition)
+   {
+      characters.assign(numBenchmarkCharacters, character);
+      poses.assign(numBenchmarkCharacters, pose);
+
+      auto start = std::chrono::steady_clock::now();
+      system.Run(grid, settings, inputs.data(), characters.data(), poses.data(), batchOutputs.data(), numBenchmarkCharacters);
+      auto end = std::chrono::steady_clock::now();
+      batchSeconds += std::chrono::duration<double>(end - start).count();
+   }
+
+   // Both methods should place the feet in exactly the same way
+   float        maxDifference   = 0.0f;
+   unsigned int numIKIterations = 0;
+   for (unsigned int characterIndex = 0; characterIndex < numBenchmarkCharacters; ++characterIndex)
+   {
+      glm::vec3 batchAnklePosition = poses[characterIndex].GetGlobalTransform(characters[characterIndex].leftLeg.GetAnkleIndex()).position;
+      maxDifference = glm::max(maxDifference, glm::length(singleAnklePositions[characterIndex] - batchAnklePosition));
+      maxDifference = glm::max(maxDifference, glm::length(singleOutputs[characterIndex].leftAnkleTarget - batchOutputs[characterIndex].leftAnkleTarget));
+      maxDifference = glm::max(maxDifference, glm::length(singleOutputs[characterIndex].rightAnkleTarget - batchOutputs[characterIndex].rightAnkleTarget));
+      numIKIterations += batchOutputs[characterIndex].numIKIterations;
+   }
+
+   double singleCharactersPerSecond = (numBenchmarkCharacters * numRepetitions) / glm::max(singleSeconds, 1e-9);
+   double batchCharactersPerSecond  = (numBenchmarkCharacters * numRepetitions) / glm::max(batchSeconds, 1e-9);
+
+   std::cout << "Height query grid - Triangles: " << grid.GetNumberOfTriangles() << ", Cells: " << grid.GetNumberOfCellsAlongX() << "x" << grid.GetNumberOfCellsAlongZ()
+             << ", Average triangles per cell: " << grid.GetAverageNumberOfTrianglesPerCell() << '\n';
+
+   std::cout << "Foot placement - Characters: " << numBenchmarkCharacters << ", IK iterations per character: " << (static_cast<float>(numIKIterations) / numBenchmarkCharacters)
+             << ", Max difference: " << maxDifference << '\n'
+             << "   One character at a time: " << singleCharactersPerSecond << " characters/s" << '\n'
+             << "   All characters at once:  " << batchCharactersPerSecond << " characters/s (" << (batchCharactersPerSecond / singleCharactersPerSecond) << "x)" << '\n';
+}
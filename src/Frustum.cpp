@@ -0,0 +1,91 @@
+#include "Frustum.h"
+
+Frustum::Frustum()
+   : mPlanes()
+   , mNumPlanes(0)
+{
+
+}
+
+Frustum::Frustum(const glm::mat4& projectionViewMatrix)
+   : mPlanes()
+   , mNumPlanes(0)
+{
+   ExtractPlanes(projectionViewMatrix);
+}
+
+Frustum::Frustum(const glm::mat4& projectionViewMatrix, const glm::vec2& horizontalClippingPlaneYNormalAndHeight)
+   : mPlanes()
+   , mNumPlanes(0)
+{
+   ExtractPlanes(projectionViewMatrix);
+
+   // The clipping shaders discard fragments for which (fragPos.y - height) * normal.y < 0
+   // That's the plane (0, normal.y, 0, -height * normal.y)
+   mPlanes[mNumPlanes++] = glm::vec4(0.0f,
+                                     horizontalClippingPlaneYNormalAndHeight.x,
+                                     0.0f,
+                                     -horizontalClippingPlaneYNormalAndHeight.y * horizontalClippingPlaneYNormalAndHeight.x);
+}
+
+/*
+   A world space point p is inside of the clip volume when:
+
+   -w <= x <= w
+   -w <= y <= w
+   -w <= z <= w
+
+   Where (x, y, z, w) = M * p and M is the projection * view matrix
+   If we call the rows of M r0, r1, r2 and r3, then each of those inequalities can be rewritten as a plane equation:
+
+   (r3 + r0) . p >= 0 -> Left
+   (r3 - r0) . p >= 0 -> Right
+   (r3 + r1) . p >= 0 -> Bottom
+   (r3 - r1) . p >= 0 -> Top
+   (r3 + r2) . p >= 0 -> Near
+   (r3 - r2) . p >= 0 -> Far
+
+   Note that glm matrices are column-major, so row i is (M[0][i], M[1][i], M[2][i], M[3][i])
+*/
+void Frustum::ExtractPlanes(const glm::mat4& projectionViewMatrix)
+{
+   glm::vec4 row0 = glm::vec4(projectionViewMatrix[0][0], projectionViewMatrix[1][0], projectionViewMatrix[2][0], projectionViewMatrix[3][0]);
+   glm::vec4 row1 = glm::vec4(projectionViewMatrix[0][1], projectionViewMatrix[1][1], projectionViewMatrix[2][1], projectionViewMatrix[3][1]);
+   glm::vec4 row2 = glm::vec4(projectionViewMatrix[0][2], projectionViewMatrix[1][2], projectionViewMatrix[2][2], projectionViewMatrix[3][2]);
+   glm::vec4 row3 = glm::vec4(projectionViewMatrix[0][3], projectionViewMatrix[1][3], projectionViewMatrix[2][3], projectionViewMatrix[3][3]);
+
+   mPlanes[0] = row3 + row0;
+   mPlanes[1] = row3 - row0;
+   mPlanes[2] = row3 + row1;
+   mPlanes[3] = row3 - row1;
+   mPlanes[4] = row3 + row2;
+   mPlanes[5] = row3 - row2;
+   mNumPlanes = 6;
+}
+
+// For each plane, we only need to test the corner of the AABB that is furthest along the normal of the plane (the "positive vertex")
+// If that corner is behind any of the planes, then the entire AABB is outside of the frustum
+// Note that this test is conservative: some AABBs that are outside of the frustum near its corners are reported as visible
+bool Frustum::IsAABBVisible(const AABB& aabb) const
+{
+   if (aabb.IsEmpty())
+   {
+      return false;
+   }
+
+   for (unsigned int planeIndex = 0; planeIndex < mNumPlanes; ++planeIndex)
+   {
+      const glm::vec4& plane = mPlanes[planeIndex];
+
+      glm::vec3 positiveVertex = glm::vec3((plane.x >= 0.0f) ? aabb.max.x : aabb.min.x,
+                                           (plane.y >= 0.0f) ? aabb.max.y : aabb.min.y,
+                                           (plane.z >= 0.0f) ? aabb.max.z : aabb.min.z);
+
+      if (glm::dot(glm::vec3(plane), positiveVertex) + plane.w < 0.0f)
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
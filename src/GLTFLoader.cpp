@@ -4,32 +4,80 @@
 #include <glm/gtx/norm.hpp>
 
 #include "GLTFLoader.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MappedFile.h"
 #include <iostream>
 #include "Transform.h"
 #include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace GLTFHelpers
 {
+   // By default, cgltf reads a file by allocating a buffer and copying the contents of the file into it
+   // The functions below are called by cgltf instead, and they map the file into memory
+   // This applies to the .gltf or .glb file itself and to the external .bin files that it refers to, so the binary chunk of a .glb file
+   // and the external buffers of a .gltf file are read straight from the mapping, both by cgltf and by our accessor functions
+   // Since cgltf only gives us the address of the data when it releases it, we keep track of the mappings in the map below
+   // Note that the mutex is necessary because the AssetLoader loads glTF files on worker threads
+   std::mutex                                                   mappedFilesMutex;
+   std::unordered_map<const void*, std::unique_ptr<MappedFile>> mappedFiles;
+
+   cgltf_result MapFile(const cgltf_memory_options* /*memoryOptions*/, const cgltf_file_options* /*fileOptions*/, const char* path, cgltf_size* size, void** data)
+   {
+      std::unique_ptr<MappedFile> mappedFile = std::make_unique<MappedFile>();
+      if (!mappedFile->Open(path))
+      {
+         return cgltf_result_file_not_found;
+      }
+
+      *size = mappedFile->GetSize();
+      *data = const_cast<char*>(mappedFile->GetData());
+
+      std::lock_guard<std::mutex> lock(mappedFilesMutex);
+      mappedFiles[*data] = std::move(mappedFile);
+      return cgltf_result_success;
+   }
+
+   void UnmapFile(const cgltf_memory_options* /*memoryOptions*/, const cgltf_file_options* /*fileOptions*/, void* data)
+   {
+      std::lock_guard<std::mutex> lock(mappedFilesMutex);
+      mappedFiles.erase(data);
+   }
+
    // A glTF file may contain an array of scenes and an array of nodes
    // Each scene may contain an array of indices of nodes
    // Each node may contain an array of indices of its children
-   // The function below linearly searches for a specific node in the array of nodes and returns its index
-   int GetNodeIndex(cgltf_node* target, cgltf_node* nodes, unsigned int numNodes)
+   // cgltf resolves those indices into pointers into its array of nodes, which is contiguous,
+   // so the function below can calculate the index of a node from its address instead of searching for it
+   int GetNodeIndex(const cgltf_node* target, const cgltf_node* nodes, unsigned int numNodes)
    {
-      if (target == nullptr)
+      if (target == nullptr || target < nodes || target >= nodes + numNodes)
       {
          return -1;
       }
 
-      for (unsigned int nodeIndex = 0; nodeIndex < numNodes; ++nodeIndex)
+      return static_cast<int>(target - nodes);
+   }
+
+   // The joints of a skin are referred to by their index in the array of joints of the skin, not in the array of nodes of the glTF file
+   // The function below calculates the node index of each joint of a skin once, so that the joint indices of the vertices of a mesh
+   // can be converted from being skin-relative to being file-relative with a single lookup per index
+   std::vector<int> GetNodeIndicesOfSkinJoints(const cgltf_skin& skin, const cgltf_node* nodes, unsigned int numNodes)
+   {
+      std::vector<int> nodeIndicesOfSkinJoints(skin.joints_count);
+
+      for (cgltf_size skinJointIndex = 0; skinJointIndex < skin.joints_count; ++skinJointIndex)
       {
-         if (target == &nodes[nodeIndex])
-         {
-            return static_cast<int>(nodeIndex);
-         }
+         nodeIndicesOfSkinJoints[skinJointIndex] = GetNodeIndex(skin.joints[skinJointIndex], nodes, numNodes);
       }
 
-      return -1;
+      return nodeIndicesOfSkinJoints;
    }
 
    // A node may contain a local transform, which can be stored as:
@@ -70,12 +118,47 @@ namespace GLTFHelpers
    //   Properties: buffer, byteOffset, byteLength, byteStride, target (optional OpenGL buffer target)
    // - An accessor defines how the data of a bufferView is interpreted
    //   Properties: bufferView, byteOffset, type (e.g. "VEC2"), componentType (e.g. GL_FLOAT), count (e.g. number of "VEC2"s in the bufferView), min, max
-   // The function below reads the values of an accessor whose componentType must be GL_FLOAT
+   // Most accessors store their values tightly packed in their bufferView, in which case they can be read in bulk
+   // The function below returns a pointer to the first value of an accessor if it's tightly packed and its values have the given
+   // component type and component count, and a nullptr otherwise
+   // Note that sparse accessors are never read in bulk, since their values must be patched
+   const unsigned char* GetTightlyPackedValuesOfAccessor(const cgltf_accessor& accessor, cgltf_component_type componentType, cgltf_size componentSize, unsigned int componentCount)
+   {
+      if (accessor.is_sparse || accessor.normalized || accessor.buffer_view == nullptr ||
+          accessor.component_type != componentType ||
+          cgltf_num_components(accessor.type) != componentCount ||
+          accessor.stride != componentSize * componentCount)
+      {
+         return nullptr;
+      }
+
+      const cgltf_buffer_view& bufferView = *accessor.buffer_view;
+      const unsigned char* bufferViewData = nullptr;
+      if (bufferView.data != nullptr)
+      {
+         bufferViewData = static_cast<const unsigned char*>(bufferView.data);
+      }
+      else if (bufferView.buffer->data != nullptr)
+      {
+         bufferViewData = static_cast<const unsigned char*>(bufferView.buffer->data) + bufferView.offset;
+      }
+
+      return (bufferViewData != nullptr) ? (bufferViewData + accessor.offset) : nullptr;
+   }
+
+   // The function below reads the values of an accessor as floats
    // E.g. For an accessor with a type of "VEC2", a componentType of GL_FLOAT and a count of 32, componentCount should be equal to 2,
    //      which would result in 64 floats being read
-   void GetFloatsFromAccessor(const cgltf_accessor& accessor, unsigned int componentCount, std::vector<float>& outValues)
+   // When the values are tightly packed floats, they are copied with a single memcpy
+   // Otherwise they are converted one by one by cgltf, which also handles normalized integers and sparse accessors
+   void GetFloatsFromAccessor(const cgltf_accessor& accessor, unsigned int componentCount, float* outValues)
    {
-      outValues.resize(accessor.count * componentCount);
+      const unsigned char* values = GetTightlyPackedValuesOfAccessor(accessor, cgltf_component_type_r_32f, sizeof(float), componentCount);
+      if (values != nullptr)
+      {
+         memcpy(outValues, values, accessor.count * componentCount * sizeof(float));
+         return;
+      }
 
       for (cgltf_size i = 0; i < accessor.count; ++i)
       {
@@ -83,6 +166,64 @@ namespace GLTFHelpers
       }
    }
 
+   void GetFloatsFromAccessor(const cgltf_accessor& accessor, unsigned int componentCount, std::vector<float>& outValues)
+   {
+      outValues.resize(accessor.count * componentCount);
+      if (!outValues.empty())
+      {
+         GetFloatsFromAccessor(accessor, componentCount, &outValues[0]);
+      }
+   }
+
+   // The function below converts tightly packed unsigned integers of type T into unsigned ints
+   template<typename T>
+   void ConvertUnsignedInts(const unsigned char* values, cgltf_size numValues, unsigned int* outValues)
+   {
+      for (cgltf_size i = 0; i < numValues; ++i)
+      {
+         // The values of an accessor are not guaranteed to be aligned in memory, so we copy them instead of dereferencing a T*
+         T value;
+         memcpy(&value, values + (i * sizeof(T)), sizeof(T));
+         outValues[i] = static_cast<unsigned int>(value);
+      }
+   }
+
+   // The function below reads the values of an accessor whose componentType is an unsigned integer type (e.g. indices or joints)
+   // Tightly packed values are converted directly from the buffer, while the rest are read one by one by cgltf as floats
+   void GetUnsignedIntsFromAccessor(const cgltf_accessor& accessor, unsigned int componentCount, unsigned int* outValues)
+   {
+      cgltf_size numValues = accessor.count * componentCount;
+
+      if (const unsigned char* values = GetTightlyPackedValuesOfAccessor(accessor, cgltf_component_type_r_32u, sizeof(uint32_t), componentCount))
+      {
+         memcpy(outValues, values, numValues * sizeof(uint32_t));
+      }
+      else if (const unsigned char* values = GetTightlyPackedValuesOfAccessor(accessor, cgltf_component_type_r_16u, sizeof(uint16_t), componentCount))
+      {
+         ConvertUnsignedInts<uint16_t>(values, numValues, outValues);
+      }
+      else if (const unsigned char* values = GetTightlyPackedValuesOfAccessor(accessor, cgltf_component_type_r_8u, sizeof(uint8_t), componentCount))
+      {
+         ConvertUnsignedInts<uint8_t>(values, numValues, outValues);
+      }
+      else
+      {
+         // cgltf_accessor_read_uint doesn't support sparse accessors, so we read the values as floats and convert them into ints
+         // Why do we add 0.5 before casting? Because if an index is stored as 1.999999999999943157,
+         // it will be truncated into being equal to 1 instead of 2 by the cast
+         std::vector<float> floats(numValues);
+         for (cgltf_size i = 0; i < accessor.count; ++i)
+         {
+            cgltf_accessor_read_float(&accessor, i, &floats[i * componentCount], componentCount);
+         }
+
+         for (cgltf_size i = 0; i < numValues; ++i)
+         {
+            outValues[i] = static_cast<unsigned int>(floats[i] + 0.5f);
+         }
+      }
+   }
+
    // A glTF file may contain an array of animations
    // Each animation consists of two elements:
    // - An array of channels
@@ -189,6 +330,146 @@ namespace GLTFHelpers
       }
    } 
 
+   // A channel whose path is "weights" animates all the morph targets of a mesh at once,
+   // so each of its key frames contains one weight per morph target
+   // The function below splits such a channel into one scalar track per morph target
+   void GetMorphWeightsTrackFromChannel(const cgltf_animation_channel& channel, MorphWeightsTrack& outTrack)
+   {
+      cgltf_animation_sampler& sampler = *channel.sampler;
+
+      bool interpolationModeIsCubic = false;
+      Interpolation interpolation = Interpolation::Constant;
+      if (sampler.interpolation == cgltf_interpolation_type_linear)
+      {
+         interpolation = Interpolation::Linear;
+      }
+      else if (sampler.interpolation == cgltf_interpolation_type_cubic_spline)
+      {
+         interpolationModeIsCubic = true;
+         interpolation = Interpolation::Cubic;
+      }
+
+      std::vector<float> keyFrameTimes;
+      GetFloatsFromAccessor(*sampler.input, 1, keyFrameTimes);
+
+      std::vector<float> keyFrameValues;
+      GetFloatsFromAccessor(*sampler.output, 1, keyFrameValues);
+
+      unsigned int numFrames = static_cast<unsigned int>(keyFrameTimes.size());
+      if (numFrames == 0)
+      {
+         return;
+      }
+
+      // For a constant or linearly interpolated track, each key frame looks like this:
+      // | weight0 | weight1 | ... | weightN |
+      // For a cubically interpolated track, each key frame looks like this:
+      // | inSlope0 | ... | inSlopeN | weight0 | ... | weightN | outSlope0 | ... | outSlopeN |
+      unsigned int numFloatsPerFrame = static_cast<unsigned int>(keyFrameValues.size() / numFrames);
+      unsigned int numTargets = interpolationModeIsCubic ? (numFloatsPerFrame / 3) : numFloatsPerFrame;
+
+      outTrack.SetNumberOfTargets(numTargets);
+      for (unsigned int targetIndex = 0; targetIndex < numTargets; ++targetIndex)
+      {
+         ScalarTrack& weightTrack = outTrack.GetWeightTrack(targetIndex);
+         weightTrack.SetInterpolation(interpolation);
+         weightTrack.SetNumberOfFrames(numFrames);
+
+         for (unsigned int frameIndex = 0; frameIndex < numFrames; ++frameIndex)
+         {
+            unsigned int firstIndexOfCurrKeyFrameFloats = frameIndex * numFloatsPerFrame;
+
+            Frame<1>& frame = weightTrack.GetFrame(frameIndex);
+            frame.mTime = keyFrameTimes[frameIndex];
+
+            if (interpolationModeIsCubic)
+            {
+               frame.mInSlope[0]  = keyFrameValues[firstIndexOfCurrKeyFrameFloats + targetIndex];
+               frame.mValue[0]    = keyFrameValues[firstIndexOfCurrKeyFrameFloats + numTargets + targetIndex];
+               frame.mOutSlope[0] = keyFrameValues[firstIndexOfCurrKeyFrameFloats + (2 * numTargets) + targetIndex];
+            }
+            else
+            {
+               frame.mInSlope[0]  = 0.0f;
+               frame.mValue[0]    = keyFrameValues[firstIndexOfCurrKeyFrameFloats + targetIndex];
+               frame.mOutSlope[0] = 0.0f;
+            }
+         }
+      }
+   }
+
+   // A mesh primitive may contain an array of morph targets
+   // Each morph target contains the same attributes as the primitive (e.g. POSITION and NORMAL), except that they are deltas,
+   // which are added to the attributes of the primitive after being scaled by the weights of the morph targets
+   // Most morph targets only displace a small region of a mesh (e.g. a blink only moves the eyelids), so instead of storing a delta for every vertex,
+   // the function below only stores the deltas of the vertices that are actually displaced
+   void StoreMorphTargetsInAnimatedMesh(const cgltf_primitive& primitive, const cgltf_mesh& mesh, const cgltf_node& node, AnimatedMesh& outMesh)
+   {
+      // Deltas whose squared length is smaller than this don't displace a vertex enough to be visible
+      const float minSquaredDeltaLength = 1e-12f;
+
+      std::vector<MorphTarget>& morphTargets = outMesh.GetMorphTargets();
+      morphTargets.resize(primitive.targets_count);
+
+      for (cgltf_size targetIndex = 0; targetIndex < primitive.targets_count; ++targetIndex)
+      {
+         const cgltf_morph_target& target = primitive.targets[targetIndex];
+         MorphTarget&              morphTarget = morphTargets[targetIndex];
+
+         if (targetIndex < mesh.target_names_count && mesh.target_names[targetIndex] != nullptr)
+         {
+            morphTarget.name = mesh.target_names[targetIndex];
+         }
+
+         std::vector<float> positionDeltas;
+         std::vector<float> normalDeltas;
+         for (cgltf_size attributeIndex = 0; attributeIndex < target.attributes_count; ++attributeIndex)
+         {
+            const cgltf_attribute& attribute = target.attributes[attributeIndex];
+            if (attribute.type == cgltf_attribute_type_position)
+            {
+               GetFloatsFromAccessor(*attribute.data, 3, positionDeltas);
+            }
+            else if (attribute.type == cgltf_attribute_type_normal)
+            {
+               GetFloatsFromAccessor(*attribute.data, 3, normalDeltas);
+            }
+         }
+
+         unsigned int numVertices = static_cast<unsigned int>(std::max(positionDeltas.size(), normalDeltas.size()) / 3);
+         for (unsigned int vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+         {
+            glm::vec3 positionDelta = (positionDeltas.size() > 0) ? glm::vec3(positionDeltas[(vertexIndex * 3) + 0], positionDeltas[(vertexIndex * 3) + 1], positionDeltas[(vertexIndex * 3) + 2]) : glm::vec3(0.0f);
+            glm::vec3 normalDelta   = (normalDeltas.size() > 0)   ? glm::vec3(normalDeltas[(vertexIndex * 3) + 0],   normalDeltas[(vertexIndex * 3) + 1],   normalDeltas[(vertexIndex * 3) + 2])   : glm::vec3(0.0f);
+
+            // Skip the vertices that this morph target doesn't displace
+            if (glm::length2(positionDelta) < minSquaredDeltaLength && glm::length2(normalDelta) < minSquaredDeltaLength)
+            {
+               continue;
+            }
+
+            morphTarget.vertexIndices.push_back(vertexIndex);
+            morphTarget.positionDeltas.push_back(glm::vec4(positionDelta, 0.0f));
+            if (normalDeltas.size() > 0)
+            {
+               morphTarget.normalDeltas.push_back(glm::vec4(normalDelta, 0.0f));
+            }
+         }
+      }
+
+      // The default weights of the morph targets are stored in the node or in the mesh, with the former taking precedence
+      std::vector<float>& defaultWeights = outMesh.GetDefaultMorphWeights();
+      defaultWeights.assign(primitive.targets_count, 0.0f);
+      if (node.weights_count == primitive.targets_count)
+      {
+         defaultWeights.assign(node.weights, node.weights + node.weights_count);
+      }
+      else if (mesh.weights_count == primitive.targets_count)
+      {
+         defaultWeights.assign(mesh.weights, mesh.weights + mesh.weights_count);
+      }
+   }
+
    // A glTF file may contain an array of meshes
    // Each mesh may contain multiple mesh primitives, which refer to the geometry data that is required to render a mesh
    // Each mesh primitive consists of:
@@ -198,198 +479,259 @@ namespace GLTFHelpers
    // - The material that should be used for rendering
    // Each attribute is defined by mapping the attribute name (e.g. "POSITION", "NORMAL", etc.)
    // to the index of the accessor that contains the attribute data
-   void StoreValuesOfAttributeInAnimatedMesh(cgltf_attribute& attribute, cgltf_skin* skin, cgltf_node* nodes, unsigned int nodeCount, AnimatedMesh& outMesh)
+   // The values of each attribute are read in bulk directly into the vector of the mesh that stores them
+   void StoreValuesOfAttributeInAnimatedMesh(const cgltf_attribute& attribute, const std::vector<int>& nodeIndicesOfSkinJoints, AnimatedMesh& outMesh)
    {
-      // Get the accessor of the attribute and its component count
-      cgltf_accessor& accessor = *attribute.data;
-      unsigned int componentCount = 0;
-      if (accessor.type == cgltf_type_vec2)
+      // Get the accessor of the attribute
+      // Note that accessor.count is not equal to the number of floats in the accessor
+      // It's equal to the number of attribute values (e.g, vec2s, vec3s, vec4s, etc.) in the accessor
+      const cgltf_accessor& accessor = *attribute.data;
+      unsigned int numAttributeValues = static_cast<unsigned int>(accessor.count);
+      if (numAttributeValues == 0)
       {
-         componentCount = 2;
+         return;
       }
-      else if (accessor.type == cgltf_type_vec3)
+
+      // Store the values in the correct vector of the mesh
+      // In each call to this function we only fill one of the vectors, since a cgltf_attribute only describes one attribute
+      switch (attribute.type)
+      {
+      case cgltf_attribute_type_position:
       {
-         componentCount = 3;
+         std::vector<glm::vec3>& positions = outMesh.GetPositions();
+         positions.resize(numAttributeValues);
+         GetFloatsFromAccessor(accessor, 3, glm::value_ptr(positions[0]));
       }
-      else if (accessor.type == cgltf_type_vec4)
+      break;
+      case cgltf_attribute_type_texcoord:
       {
-         componentCount = 4;
+         std::vector<glm::vec2>& texCoords = outMesh.GetTexCoords();
+         texCoords.resize(numAttributeValues);
+         GetFloatsFromAccessor(accessor, 2, glm::value_ptr(texCoords[0]));
       }
+      break;
+      case cgltf_attribute_type_weights:
+      {
+         std::vector<glm::vec4>& weights = outMesh.GetWeights();
+         weights.resize(numAttributeValues);
+         GetFloatsFromAccessor(accessor, 4, glm::value_ptr(weights[0]));
+      }
+      break;
+      case cgltf_attribute_type_normal:
+      {
+         std::vector<glm::vec3>& normals = outMesh.GetNormals();
+         normals.resize(numAttributeValues);
+         GetFloatsFromAccessor(accessor, 3, glm::value_ptr(normals[0]));
 
-      // Read the floats from the accessor
-      std::vector<float> attributeFloats;
-      GetFloatsFromAccessor(accessor, componentCount, attributeFloats);
-
-      // Get the vectors that will store the attributes of the mesh that we are loading
-      // In each call to this function we only fill one of these, since a cgltf_attribute only describes one attribute
-      std::vector<glm::vec3>&  positions  = outMesh.GetPositions();
-      std::vector<glm::vec3>&  normals    = outMesh.GetNormals();
-      std::vector<glm::vec2>&  texCoords  = outMesh.GetTexCoords();
-      std::vector<glm::ivec4>& influences = outMesh.GetInfluences();
-      std::vector<glm::vec4>&  weights    = outMesh.GetWeights();
-
-      // Loop over all the values of the accessor
-      // Note that accessor.count is not equal to the number of floats in the accessor
-      // It's equal to the number of attribute values (e.g, vec2s, vec3s, vec4s, etc.) in the accessor
-      cgltf_attribute_type attributeType = attribute.type;
-      unsigned int numAttributeValues = static_cast<unsigned int>(accessor.count);
-      for (unsigned int attributeValueIndex = 0; attributeValueIndex < numAttributeValues; ++attributeValueIndex)
-      {
-         // Store the current attribute value in the correct vector of the mesh
-         // TODO: This looks inefficient. I think it would be better to have separate for loops inside if-statements
-         //       Since this function only loads one attribute type when it's called, it doesn't make sense to check
-         //       the attribute type in each iteration of this loop
-         int indexOfFirstFloatOfCurrAttribValue = attributeValueIndex * componentCount;
-         switch (attributeType)
-         {
-         case cgltf_attribute_type_position:
-            // Store a position vec3
-            positions.push_back(glm::vec3(attributeFloats[indexOfFirstFloatOfCurrAttribValue + 0],
-                                          attributeFloats[indexOfFirstFloatOfCurrAttribValue + 1],
-                                          attributeFloats[indexOfFirstFloatOfCurrAttribValue + 2]));
-            break;
-         case cgltf_attribute_type_texcoord:
-            // Store a texture coordinates vec2
-            texCoords.push_back(glm::vec2(attributeFloats[indexOfFirstFloatOfCurrAttribValue + 0],
-                                          attributeFloats[indexOfFirstFloatOfCurrAttribValue + 1]));
-            break;
-         case cgltf_attribute_type_weights:
-            // Store a weights vec4
-            weights.push_back(glm::vec4(attributeFloats[indexOfFirstFloatOfCurrAttribValue + 0],
-                                        attributeFloats[indexOfFirstFloatOfCurrAttribValue + 1],
-                                        attributeFloats[indexOfFirstFloatOfCurrAttribValue + 2],
-                                        attributeFloats[indexOfFirstFloatOfCurrAttribValue + 3]));
-            break;
-         case cgltf_attribute_type_normal:
+         for (glm::vec3& normal : normals)
          {
-            // Store a normal vec3
-            glm::vec3 normal = glm::vec3(attributeFloats[indexOfFirstFloatOfCurrAttribValue + 0],
-                                         attributeFloats[indexOfFirstFloatOfCurrAttribValue + 1],
-                                         attributeFloats[indexOfFirstFloatOfCurrAttribValue + 2]);
-
             // TODO: Use a constant here and add an error message
             if (glm::length2(normal) < 0.000001f)
             {
                normal = glm::vec3(0, 1, 0);
             }
 
-            normals.push_back(glm::normalize(normal));
+            normal = glm::normalize(normal);
          }
-         break;
-         case cgltf_attribute_type_joints:
+      }
+      break;
+      case cgltf_attribute_type_joints:
+      {
+         // Remember that in this function we are processing a node that has a mesh and a skin,
+         // so the indices we are storing below are indices into the array of nodes of the skin,
+         // not indices into the array of nodes of the glTF file, so we need to convert them from being
+         // skin-relative to being file-relative
+         std::vector<glm::ivec4>& influences = outMesh.GetInfluences();
+         influences.resize(numAttributeValues);
+         unsigned int* jointsIndices = reinterpret_cast<unsigned int*>(glm::value_ptr(influences[0]));
+         GetUnsignedIntsFromAccessor(accessor, 4, jointsIndices);
+
+         // TODO: Display error for invalid indices
+         // Convert the indices from being skin-relative to being file-relative
+         // and store invalid indices as zeroes
+         unsigned int numSkinJoints = static_cast<unsigned int>(nodeIndicesOfSkinJoints.size());
+         for (unsigned int i = 0; i < numAttributeValues * 4; ++i)
          {
-            // Store an influences ivec4
-            // Remember that in this function we are processing a node that has a mesh and a skin,
-            // so the indices we are storing below are indices into the array of nodes of the skin,
-            // not indices into the array of nodes of the glTF file, so we need to convert them from being
-            // skin-relative to being file-relative
-
-            // Note that we read the ints below as floats using the GetFloatsFromAccessor function,
-            // so we need to convert them into ints
-            // Why do we add 0.5 before casting? Because if an index is stored as 1.999999999999943157,
-            // it will be truncated into being equal to 1 instead of 2 by the cast
-            glm::ivec4 jointsIndices(static_cast<int>(attributeFloats[indexOfFirstFloatOfCurrAttribValue + 0] + 0.5f),
-                                     static_cast<int>(attributeFloats[indexOfFirstFloatOfCurrAttribValue + 1] + 0.5f),
-                                     static_cast<int>(attributeFloats[indexOfFirstFloatOfCurrAttribValue + 2] + 0.5f),
-                                     static_cast<int>(attributeFloats[indexOfFirstFloatOfCurrAttribValue + 3] + 0.5f));
-
-            // TODO: Display error for negative indices
-            // Convert the indices from being skin-relative to being file-relative
-            // and store negative indices as zeroes
-            jointsIndices.x = std::max(0, GetNodeIndex(skin->joints[jointsIndices.x], nodes, nodeCount));
-            jointsIndices.y = std::max(0, GetNodeIndex(skin->joints[jointsIndices.y], nodes, nodeCount));
-            jointsIndices.z = std::max(0, GetNodeIndex(skin->joints[jointsIndices.z], nodes, nodeCount));
-            jointsIndices.w = std::max(0, GetNodeIndex(skin->joints[jointsIndices.w], nodes, nodeCount));
-
-            influences.push_back(jointsIndices);
+            int nodeIndex = (jointsIndices[i] < numSkinJoints) ? nodeIndicesOfSkinJoints[jointsIndices[i]] : -1;
+            jointsIndices[i] = static_cast<unsigned int>(std::max(0, nodeIndex));
          }
+      }
+      break;
+      case cgltf_attribute_type_invalid:
+      case cgltf_attribute_type_tangent:
+      case cgltf_attribute_type_color:
          break;
-         case cgltf_attribute_type_invalid:
-         case cgltf_attribute_type_tangent:
-         case cgltf_attribute_type_color:
-            break;
-         }
       }
    }
 
    // This function is identical to the one above, except that it's tailored for static meshes (i.e. meshes that are not animated)
-   void StoreValuesOfAttributeInStaticMesh(cgltf_attribute& attribute, AnimatedMesh& outMesh)
+   void StoreValuesOfAttributeInStaticMesh(const cgltf_attribute& attribute, StaticMesh& outMesh)
    {
-      // Get the accessor of the attribute and its component count
-      cgltf_accessor& accessor = *attribute.data;
-      unsigned int componentCount = 0;
-      if (accessor.type == cgltf_type_vec2)
+      const cgltf_accessor& accessor = *attribute.data;
+      unsigned int numAttributeValues = static_cast<unsigned int>(accessor.count);
+      if (numAttributeValues == 0)
       {
-         componentCount = 2;
+         return;
       }
-      else if (accessor.type == cgltf_type_vec3)
+
+      switch (attribute.type)
+      {
+      case cgltf_attribute_type_position:
       {
-         componentCount = 3;
+         std::vector<glm::vec3>& positions = outMesh.GetPositions();
+         positions.resize(numAttributeValues);
+         GetFloatsFromAccessor(accessor, 3, glm::value_ptr(positions[0]));
       }
-      else if (accessor.type == cgltf_type_vec4)
+      break;
+      case cgltf_attribute_type_texcoord:
       {
-         componentCount = 4;
+         std::vector<glm::vec2>& texCoords = outMesh.GetTexCoords();
+         texCoords.resize(numAttributeValues);
+         GetFloatsFromAccessor(accessor, 2, glm::value_ptr(texCoords[0]));
       }
+      break;
+      case cgltf_attribute_type_normal:
+      {
+         std::vector<glm::vec3>& normals = outMesh.GetNormals();
+         normals.resize(numAttributeValues);
+         GetFloatsFromAccessor(accessor, 3, glm::value_ptr(normals[0]));
 
-      // Read the floats from the accessor
-      std::vector<float> attributeFloats;
-      GetFloatsFromAccessor(accessor, componentCount, attributeFloats);
-
-      // Get the vectors that will store the attributes of the mesh that we are loading
-      // In each call to this function we only fill one of these, since a cgltf_attribute only describes one attribute
-      std::vector<glm::vec3>&  positions  = outMesh.GetPositions();
-      std::vector<glm::vec3>&  normals    = outMesh.GetNormals();
-      std::vector<glm::vec2>&  texCoords  = outMesh.GetTexCoords();
-
-      // Loop over all the values of the accessor
-      // Note that accessor.count is not equal to the number of floats in the accessor
-      // It's equal to the number of attribute values (e.g, vec2s, vec3s, vec4s, etc.) in the accessor
-      cgltf_attribute_type attributeType = attribute.type;
-      unsigned int numAttributeValues = static_cast<unsigned int>(accessor.count);
-      for (unsigned int attributeValueIndex = 0; attributeValueIndex < numAttributeValues; ++attributeValueIndex)
-      {
-         // Store the current attribute value in the correct vector of the mesh
-         // TODO: This looks inefficient. I think it would be better to have separate for loops inside if-statements
-         //       Since this function only loads one attribute type when it's called, it doesn't make sense to check
-         //       the attribute type in each iteration of this loop
-         int indexOfFirstFloatOfCurrAttribValue = attributeValueIndex * componentCount;
-         switch (attributeType)
+         for (glm::vec3& normal : normals)
          {
-         case cgltf_attribute_type_position:
-            // Store a position vec3
-            positions.push_back(glm::vec3(attributeFloats[indexOfFirstFloatOfCurrAttribValue + 0],
-                                          attributeFloats[indexOfFirstFloatOfCurrAttribValue + 1],
-                                          attributeFloats[indexOfFirstFloatOfCurrAttribValue + 2]));
-            break;
-         case cgltf_attribute_type_texcoord:
-            // Store a texture coordinates vec2
-            texCoords.push_back(glm::vec2(attributeFloats[indexOfFirstFloatOfCurrAttribValue + 0],
-                                          attributeFloats[indexOfFirstFloatOfCurrAttribValue + 1]));
-            break;
-         case cgltf_attribute_type_normal:
-         {
-            // Store a normal vec3
-            glm::vec3 normal = glm::vec3(attributeFloats[indexOfFirstFloatOfCurrAttribValue + 0],
-                                         attributeFloats[indexOfFirstFloatOfCurrAttribValue + 1],
-                                         attributeFloats[indexOfFirstFloatOfCurrAttribValue + 2]);
-
             // TODO: Use a constant here and add an error message
             if (glm::length2(normal) < 0.000001f)
             {
                normal = glm::vec3(0, 1, 0);
             }
 
-            normals.push_back(glm::normalize(normal));
+            normal = glm::normalize(normal);
          }
+      }
+      break;
+      case cgltf_attribute_type_invalid:
+      case cgltf_attribute_type_tangent:
+      case cgltf_attribute_type_color:
+      case cgltf_attribute_type_joints:
+      case cgltf_attribute_type_weights:
          break;
-         case cgltf_attribute_type_invalid:
-         case cgltf_attribute_type_tangent:
-         case cgltf_attribute_type_color:
-         case cgltf_attribute_type_joints:
-         case cgltf_attribute_type_weights:
-            break;
+      }
+   }
+
+   // The function below reads the indices of a mesh primitive
+   void GetIndicesOfPrimitive(const cgltf_primitive& primitive, std::vector<unsigned int>& outIndices)
+   {
+      outIndices.resize(primitive.indices->count);
+      if (!outIndices.empty())
+      {
+         GetUnsignedIntsFromAccessor(*primitive.indices, 1, &outIndices[0]);
+      }
+   }
+
+   // The function below skips over a JSON string that starts at the given offset and returns the offset of the character that follows it
+   size_t SkipJSONString(const std::string& json, size_t stringBegin)
+   {
+      size_t i = stringBegin + 1;
+      while (i < json.size() && json[i] != '"')
+      {
+         // Skip the character that follows a backslash, since it may be an escaped quote
+         i += (json[i] == '\\') ? 2 : 1;
+      }
+
+      return std::min(i + 1, json.size());
+   }
+
+   // The function below finds the value of a member of the root object of a JSON document (e.g. the "buffers" array of a glTF file)
+   // It returns false if the member doesn't exist, and otherwise it stores the offsets of the first character of the value
+   // and of the character that follows its last one
+   // Note that it assumes that the document is valid, which cgltf has already verified by the time we call it
+   bool FindValueOfRootMember(const std::string& json, const std::string& memberName, size_t& outValueBegin, size_t& outValueEnd)
+   {
+      int  depth = 0;
+      char previousCharacter = 0;
+      for (size_t i = 0; i < json.size(); ++i)
+      {
+         char character = json[i];
+         if (isspace(static_cast<unsigned char>(character)))
+         {
+            continue;
+         }
+
+         if (character == '"')
+         {
+            size_t stringEnd = SkipJSONString(json, i);
+
+            // A string that follows the opening brace of the root object or a comma at a depth of 1 is the name of a member of the root object
+            bool isNameOfRootMember = (depth == 1) && (previousCharacter == '{' || previousCharacter == ',');
+            if (isNameOfRootMember && json.compare(i + 1, stringEnd - i - 2, memberName) == 0)
+            {
+               // Skip the colon and the whitespace that surround it
+               size_t valueBegin = json.find(':', stringEnd) + 1;
+               while (valueBegin < json.size() && isspace(static_cast<unsigned char>(json[valueBegin])))
+               {
+                  ++valueBegin;
+               }
+
+               // The value ends at the comma or the closing brace that follows it at the same depth
+               int    valueDepth = 0;
+               size_t valueEnd = valueBegin;
+               while (valueEnd < json.size())
+               {
+                  char valueCharacter = json[valueEnd];
+                  if (valueCharacter == '"')
+                  {
+                     valueEnd = SkipJSONString(json, valueEnd);
+                     continue;
+                  }
+                  else if (valueCharacter == '{' || valueCharacter == '[')
+                  {
+                     ++valueDepth;
+                  }
+                  else if (valueCharacter == '}' || valueCharacter == ']')
+                  {
+                     if (valueDepth == 0)
+                     {
+                        break;
+                     }
+
+                     --valueDepth;
+                  }
+                  else if (valueCharacter == ',' && valueDepth == 0)
+                  {
+                     break;
+                  }
+
+                  ++valueEnd;
+               }
+
+               // Exclude the whitespace that precedes the comma or the closing brace
+               while (valueEnd > valueBegin && isspace(static_cast<unsigned char>(json[valueEnd - 1])))
+               {
+                  --valueEnd;
+               }
+
+               outValueBegin = valueBegin;
+               outValueEnd = valueEnd;
+               return true;
+            }
+
+            i = stringEnd - 1;
+            previousCharacter = '"';
+            continue;
+         }
+
+         if (character == '{' || character == '[')
+         {
+            ++depth;
+         }
+         else if (character == '}' || character == ']')
+         {
+            --depth;
          }
+
+         previousCharacter = character;
       }
+
+      return false;
    }
 }
 
@@ -400,9 +742,12 @@ cgltf_data* LoadGLTFFile(const char* path)
    cgltf_data* data = nullptr;
 
    // The cgltf_options struct can be used to control parts of the parsing process
-   // Initializing it to zero tells cgltf that we want to use the default behavior
+   // Initializing it to zero tells cgltf that we want to use the default behavior,
+   // except for reading files, which we replace with memory mapping
    cgltf_options options;
    memset(&options, 0, sizeof(cgltf_options));
+   options.file.read    = GLTFHelpers::MapFile;
+   options.file.release = GLTFHelpers::UnmapFile;
 
    // Open the glTF file and parse the glTF data
    cgltf_result result = cgltf_parse_file(&options, path, &data);
@@ -414,6 +759,10 @@ cgltf_data* LoadGLTFFile(const char* path)
 
    // Open and read the buffer files referenced by the glTF file
    // Buffer files are binary files that contain geometry or animation data
+   // They can be stored in three ways:
+   // - As base64 data URIs inside of a .gltf file, which cgltf must decode into memory that it allocates
+   // - As external .bin files next to a .gltf file, which are mapped into memory
+   // - As the binary chunk of a .glb file, which is part of the mapping of the file itself
    result = cgltf_load_buffers(&options, data, path);
    if (result != cgltf_result_success)
    {
@@ -446,6 +795,99 @@ void FreeGLTFFile(cgltf_data* data)
    }
 }
 
+// A .glb file stores the same JSON as a .gltf file, followed by the contents of its buffer in binary form:
+// +--------+------------------------------+-------------------------------+
+// | Header | JSON chunk (padded with ' ') | BIN chunk (padded with zeros) |
+// +--------+------------------------------+-------------------------------+
+// The header consists of the magic number "glTF", the version (2) and the size of the file,
+// and each chunk starts with its size and its type ("JSON" or "BIN")
+// The only change that the JSON needs is that the buffer that becomes the BIN chunk mustn't have a URI,
+// so this function replaces the "buffers" array with one that only contains the length of that buffer
+// Note that a .glb file can only contain one BIN chunk, so this function only supports files with a single buffer,
+// which is what Blender exports
+bool ConvertGLTFFileToGLB(const char* gltfPath, const char* glbPath)
+{
+   cgltf_data* data = LoadGLTFFile(gltfPath);
+   if (data == nullptr)
+   {
+      return false;
+   }
+
+   if (data->file_type == cgltf_file_type_glb || data->buffers_count > 1)
+   {
+      std::cout << "Only .gltf files with a single buffer can be converted into .glb files: " << gltfPath << '\n';
+      FreeGLTFFile(data);
+      return false;
+   }
+
+   std::string json(data->json, data->json_size);
+   const char* bin     = (data->buffers_count == 1) ? static_cast<const char*>(data->buffers[0].data) : nullptr;
+   size_t      binSize = (data->buffers_count == 1) ? data->buffers[0].size : 0;
+
+   size_t buffersBegin = 0;
+   size_t buffersEnd   = 0;
+   if (GLTFHelpers::FindValueOfRootMember(json, "buffers", buffersBegin, buffersEnd))
+   {
+      json.replace(buffersBegin, buffersEnd - buffersBegin, "[{\"byteLength\":" + std::to_string(binSize) + "}]");
+   }
+
+   // Both chunks must be padded to a multiple of 4 bytes, which keeps the data of the BIN chunk aligned for the accessors
+   json.append((4 - (json.size() % 4)) % 4, ' ');
+   std::vector<char> binChunk(bin, bin + binSize);
+   binChunk.resize(binChunk.size() + ((4 - (binChunk.size() % 4)) % 4), 0);
+
+   FreeGLTFFile(data);
+
+   // The bytes "glTF", "JSON" and "BIN\0" in little-endian order
+   const uint32_t glbMagic       = 0x46546C67;
+   const uint32_t glbVersion     = 2;
+   const uint32_t jsonChunkType  = 0x4E4F534A;
+   const uint32_t binChunkType   = 0x004E4942;
+
+   uint32_t jsonChunkSize = static_cast<uint32_t>(json.size());
+   uint32_t binChunkSize  = static_cast<uint32_t>(binChunk.size());
+   uint32_t fileSize      = 12 + 8 + jsonChunkSize + (binChunk.empty() ? 0 : (8 + binChunkSize));
+
+   std::vector<char> glb;
+   glb.reserve(fileSize);
+   auto append = [&glb](const void* bytes, size_t numBytes)
+   {
+      glb.insert(glb.end(), static_cast<const char*>(bytes), static_cast<const char*>(bytes) + numBytes);
+   };
+
+   append(&glbMagic, 4);
+   append(&glbVersion, 4);
+   append(&fileSize, 4);
+   append(&jsonChunkSize, 4);
+   append(&jsonChunkType, 4);
+   append(json.data(), json.size());
+   if (!binChunk.empty())
+   {
+      append(&binChunkSize, 4);
+      append(&binChunkType, 4);
+      append(binChunk.data(), binChunk.size());
+   }
+
+   FILE* file = fopen(glbPath, "wb");
+   if (file == nullptr)
+   {
+      std::cout << "Could not open the following file for writing: " << glbPath << '\n';
+      return false;
+   }
+
+   size_t numBytesWritten = fwrite(glb.data(), 1, glb.size(), file);
+   fclose(file);
+
+   if (numBytesWritten != glb.size())
+   {
+      std::cout << "Could not write the following .glb file: " << glbPath << '\n';
+      return false;
+   }
+
+   std::cout << "Converted " << gltfPath << " into " << glbPath << " - Size: " << glb.size() << " bytes" << '\n';
+   return true;
+}
+
 Pose LoadRestPose(cgltf_data* data)
 {
    unsigned int numNodes = static_cast<unsigned int>(data->nodes_count);
@@ -505,7 +947,6 @@ std::vector<std::string> LoadJointNames(cgltf_data* data)
 // - A sampler, which summarizes the animation data
 std::vector<Clip> LoadClips(cgltf_data* data)
 {
-   unsigned int numNodes = static_cast<unsigned int>(data->nodes_count);
    unsigned int numClips = static_cast<unsigned int>(data->animations_count);
 
    std::vector<Clip> clips(numClips);
@@ -513,44 +954,61 @@ std::vector<Clip> LoadClips(cgltf_data* data)
    // Loop over the array of animations of the glTF file
    for (unsigned int clipIndex = 0; clipIndex < numClips; ++clipIndex)
    {
-      // Store the name of the current animation
-      clips[clipIndex].SetName(data->animations[clipIndex].name);
+      clips[clipIndex] = LoadClip(data, clipIndex);
+   }
 
-      // Loop over the array of channels of the current animation
-      unsigned int numChannels = static_cast<unsigned int>(data->animations[clipIndex].channels_count);
-      for (unsigned int channelIndex = 0; channelIndex < numChannels; ++channelIndex)
-      {
-         // Get the current channel
-         cgltf_animation_channel& channel = data->animations[clipIndex].channels[channelIndex];
+   return clips;
+}
 
-         // Get the index of the node that the current channel targets
-         int indexOfTargetNode = GLTFHelpers::GetNodeIndex(channel.target_node, data->nodes, numNodes);
+// This function only reads the glTF file, so the clips of a file can be loaded by multiple threads at the same time
+Clip LoadClip(cgltf_data* data, unsigned int clipIndex)
+{
+   unsigned int numNodes = static_cast<unsigned int>(data->nodes_count);
 
-         // Get a position, scale or rotation track from the channel depending on which of those values it animates
-         // Note how we pass the index of the target node as a joint ID to the Clip class to get a TransformTrack
-         // That's possible because all of our animation classes mirror the order of the nodes of the glTF file
-         if (channel.target_path == cgltf_animation_path_type_translation)
-         {
-            VectorTrack& positionTrack = clips[clipIndex].GetTransformTrackOfJoint(indexOfTargetNode).GetPositionTrack();
-            GLTFHelpers::GetTrackFromChannel<glm::vec3, 3>(channel, positionTrack);
-         }
-         else if (channel.target_path == cgltf_animation_path_type_scale)
-         {
-            VectorTrack& scaleTrack = clips[clipIndex].GetTransformTrackOfJoint(indexOfTargetNode).GetScaleTrack();
-            GLTFHelpers::GetTrackFromChannel<glm::vec3, 3>(channel, scaleTrack);
-         }
-         else if (channel.target_path == cgltf_animation_path_type_rotation)
-         {
-            QuaternionTrack& rotationTrack = clips[clipIndex].GetTransformTrackOfJoint(indexOfTargetNode).GetRotationTrack();
-            GLTFHelpers::GetTrackFromChannel<Q::quat, 4>(channel, rotationTrack);
-         }
-      }
+   Clip clip;
 
-      // Recalculate the duration of the current clip once all of its tracks have been loaded
-      clips[clipIndex].RecalculateDuration();
+   // Store the name of the animation
+   clip.SetName(data->animations[clipIndex].name);
+
+   // Loop over the array of channels of the animation
+   unsigned int numChannels = static_cast<unsigned int>(data->animations[clipIndex].channels_count);
+   for (unsigned int channelIndex = 0; channelIndex < numChannels; ++channelIndex)
+   {
+      // Get the current channel
+      cgltf_animation_channel& channel = data->animations[clipIndex].channels[channelIndex];
+
+      // Get the index of the node that the current channel targets
+      int indexOfTargetNode = GLTFHelpers::GetNodeIndex(channel.target_node, data->nodes, numNodes);
+
+      // Get a position, scale or rotation track from the channel depending on which of those values it animates
+      // Note how we pass the index of the target node as a joint ID to the Clip class to get a TransformTrack
+      // That's possible because all of our animation classes mirror the order of the nodes of the glTF file
+      if (channel.target_path == cgltf_animation_path_type_translation)
+      {
+         VectorTrack& positionTrack = clip.GetTransformTrackOfJoint(indexOfTargetNode).GetPositionTrack();
+         GLTFHelpers::GetTrackFromChannel<glm::vec3, 3>(channel, positionTrack);
+      }
+      else if (channel.target_path == cgltf_animation_path_type_scale)
+      {
+         VectorTrack& scaleTrack = clip.GetTransformTrackOfJoint(indexOfTargetNode).GetScaleTrack();
+         GLTFHelpers::GetTrackFromChannel<glm::vec3, 3>(channel, scaleTrack);
+      }
+      else if (channel.target_path == cgltf_animation_path_type_rotation)
+      {
+         QuaternionTrack& rotationTrack = clip.GetTransformTrackOfJoint(indexOfTargetNode).GetRotationTrack();
+         GLTFHelpers::GetTrackFromChannel<Q::quat, 4>(channel, rotationTrack);
+      }
+      else if (channel.target_path == cgltf_animation_path_type_weights)
+      {
+         MorphWeightsTrack& weightsTrack = clip.GetMorphWeightsTrackOfNode(indexOfTargetNode);
+         GLTFHelpers::GetMorphWeightsTrackFromChannel(channel, weightsTrack);
+      }
    }
 
-   return clips;
+   // Recalculate the duration of the clip once all of its tracks have been loaded
+   clip.RecalculateDuration();
+
+   return clip;
 }
 
 // A glTF file may contain an array of skins
@@ -679,6 +1137,9 @@ std::vector<AnimatedMesh> LoadAnimatedMeshes(cgltf_data* data)
          continue;
       }
 
+      // Calculate the node indices of the joints of the skin of the current node once for all of its mesh primitives
+      std::vector<int> nodeIndicesOfSkinJoints = GLTFHelpers::GetNodeIndicesOfSkinJoints(*currNode->skin, data->nodes, numNodes);
+
       // Loop over the array of mesh primitives of the current node
       unsigned int numPrimitives = static_cast<unsigned int>(currNode->mesh->primitives_count);
       for (unsigned int primitiveIndex = 0; primitiveIndex < numPrimitives; ++primitiveIndex)
@@ -697,28 +1158,34 @@ std::vector<AnimatedMesh> LoadAnimatedMeshes(cgltf_data* data)
             // Get the current attribute
             cgltf_attribute* attribute = &currPrimitive->attributes[attributeIndex];
             // Read the values of the current attribute and store them in the current mesh
-            GLTFHelpers::StoreValuesOfAttributeInAnimatedMesh(*attribute, currNode->skin, data->nodes, numNodes, currMesh);
+            GLTFHelpers::StoreValuesOfAttributeInAnimatedMesh(*attribute, nodeIndicesOfSkinJoints, currMesh);
          }
 
          // If the current mesh primitive has a set of indices, store them too
          if (currPrimitive->indices != nullptr)
          {
-            unsigned int indexCount = static_cast<unsigned int>(currPrimitive->indices->count);
-
-            // Get the vector that will store the indices of the current mesh
-            std::vector<unsigned int>& indices = currMesh.GetIndices();
-            indices.resize(indexCount);
+            GLTFHelpers::GetIndicesOfPrimitive(*currPrimitive, currMesh.GetIndices());
+         }
 
-            // Loop over the indices of the current mesh primitive
-            for (unsigned int i = 0; i < indexCount; ++i)
-            {
-               indices[i] = static_cast<unsigned int>(cgltf_accessor_read_index(currPrimitive->indices, i));
-            }
+         // If the current mesh primitive has morph targets, store them too
+         // We also store the index of the current node, since the channels that animate the weights of the morph targets refer to it
+         if (currPrimitive->targets_count > 0)
+         {
+            GLTFHelpers::StoreMorphTargetsInAnimatedMesh(*currPrimitive, *currNode->mesh, *currNode, currMesh);
          }
+         currMesh.SetNodeIndex(nodeIndex);
 
-         // TODO: Perhaps we shouldn't do this here. The user should choose when this is done
-         // Once we are done loading the current mesh, we load its VBOs with the data that we read
-         currMesh.LoadBuffers();
+         // Reorder the triangles and the vertices of the current mesh to make better use of the vertex cache of the GPU
+         OptimizeMesh(currMesh);
+
+         // Generate coarser versions of the current mesh that can be rendered when it's far away from the camera
+         GenerateLODs(currMesh);
+
+         // Calculate the bounds of the current mesh, which are used for frustum culling
+         currMesh.CalculateBounds();
+
+         // Note that the VBOs of the current mesh are not loaded here, since the joints of its influences are usually rearranged first
+         // The user must call AnimatedMesh::LoadBuffers once the mesh is ready to be rendered
       }
    }
 
@@ -727,9 +1194,9 @@ std::vector<AnimatedMesh> LoadAnimatedMeshes(cgltf_data* data)
 
 // This function is identical to the one above, except that it loads the meshes of nodes that don't refer to skins
 // In other words, it loads static meshes
-std::vector<AnimatedMesh> LoadStaticMeshes(cgltf_data* data)
+std::vector<StaticMesh> LoadStaticMeshes(cgltf_data* data)
 {
-   std::vector<AnimatedMesh> staticMeshes;
+   std::vector<StaticMesh> staticMeshes;
 
    // Loop over the array of nodes of the glTF file
    unsigned int numNodes = static_cast<unsigned int>(data->nodes_count);
@@ -749,9 +1216,9 @@ std::vector<AnimatedMesh> LoadStaticMeshes(cgltf_data* data)
          // Get the current mesh primitive
          cgltf_primitive* currPrimitive = &currNode->mesh->primitives[primitiveIndex];
 
-         // Create an AnimatedMesh for the current mesh primitive
-         staticMeshes.push_back(AnimatedMesh());
-         AnimatedMesh& currMesh = staticMeshes[staticMeshes.size() - 1];
+         // Create a StaticMesh for the current mesh primitive
+         staticMeshes.push_back(StaticMesh());
+         StaticMesh& currMesh = staticMeshes[staticMeshes.size() - 1];
 
          // Loop over the attributes of the current mesh primitive
          unsigned int numAttributes = static_cast<unsigned int>(currPrimitive->attributes_count);
@@ -766,18 +1233,17 @@ std::vector<AnimatedMesh> LoadStaticMeshes(cgltf_data* data)
          // If the current mesh primitive has a set of indices, store them too
          if (currPrimitive->indices != nullptr)
          {
-            unsigned int indexCount = static_cast<unsigned int>(currPrimitive->indices->count);
+            GLTFHelpers::GetIndicesOfPrimitive(*currPrimitive, currMesh.GetIndices());
+         }
 
-            // Get the vector that will store the indices of the current mesh
-            std::vector<unsigned int>& indices = currMesh.GetIndices();
-            indices.resize(indexCount);
+         // Reorder the triangles and the vertices of the current mesh to make better use of the vertex cache of the GPU
+         OptimizeMesh(currMesh);
 
-            // Loop over the indices of the current mesh primitive
-            for (unsigned int i = 0; i < indexCount; ++i)
-            {
-               indices[i] = static_cast<unsigned int>(cgltf_accessor_read_index(currPrimitive->indices, i));
-            }
-         }
+         // Generate coarser versions of the current mesh that can be rendered when it's far away from the camera
+         GenerateLODs(currMesh);
+
+         // Calculate the bounds of the current mesh, which are used for frustum culling
+         currMesh.CalculateBounds();
 
          // TODO: Perhaps we shouldn't do this here. The user should choose when this is done
          // Once we are done loading the current mesh, we load its VBOs with the data that we read
@@ -787,3 +1253,49 @@ std::vector<AnimatedMesh> LoadStaticMeshes(cgltf_data* data)
 
    return staticMeshes;
 }
+
+void LoadTrianglesOfStaticMeshes(cgltf_data* data, IndexedTriangleStore& outTriangles)
+{
+   outTriangles.Clear();
+
+   // Loop over the array of nodes of the glTF file
+   unsigned int numNodes = static_cast<unsigned int>(data->nodes_count);
+   for (unsigned int nodeIndex = 0; nodeIndex < numNodes; ++nodeIndex)
+   {
+      cgltf_node* currNode = &data->nodes[nodeIndex];
+      if (currNode->mesh == nullptr)
+      {
+         continue;
+      }
+
+      // Loop over the array of mesh primitives of the current node
+      unsigned int numPrimitives = static_cast<unsigned int>(currNode->mesh->primitives_count);
+      for (unsigned int primitiveIndex = 0; primitiveIndex < numPrimitives; ++primitiveIndex)
+      {
+         cgltf_primitive* currPrimitive = &currNode->mesh->primitives[primitiveIndex];
+
+         // Only the positions and the indices are needed to build the triangles
+         std::vector<glm::vec3>    positions;
+         std::vector<unsigned int> indices;
+         for (unsigned int attributeIndex = 0,
+              numAttributes = static_cast<unsigned int>(currPrimitive->attributes_count);
+              attributeIndex < numAttributes;
+              ++attributeIndex)
+         {
+            const cgltf_attribute& attribute = currPrimitive->attributes[attributeIndex];
+            if (attribute.type == cgltf_attribute_type_position && attribute.data->count > 0)
+            {
+               positions.resize(attribute.data->count);
+               GLTFHelpers::GetFloatsFromAccessor(*attribute.data, 3, glm::value_ptr(positions[0]));
+            }
+         }
+
+         if (currPrimitive->indices != nullptr)
+         {
+            GLTFHelpers::GetIndicesOfPrimitive(*currPrimitive, indices);
+         }
+
+         outTriangles.AddTriangles(TriangleView(positions, indices));
+      }
+   }
+}
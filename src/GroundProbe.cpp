@@ -0,0 +1,93 @@
+#include "GroundProbe.h"
+
+GroundProbe::GroundProbe()
+   : mLastTriangleIndex(-1)
+   , mNumQueries(0)
+   , mNumCacheHits(0)
+   , mNumNeighborHits(0)
+{
+
+}
+
+bool GroundProbe::GetGroundPointBelow(const HeightQueryGrid& grid, const glm::vec3& origin, glm::vec3& outGroundPoint)
+{
+   ++mNumQueries;
+
+   if (mLastTriangleIndex >= 0 && static_cast<unsigned int>(mLastTriangleIndex) < grid.GetNumberOfTriangles())
+   {
+      // Test the last triangle that was hit
+      if (grid.GetGroundPointBelowOnTriangle(mLastTriangleIndex, origin, outGroundPoint))
+      {
+         ++mNumCacheHits;
+         return true;
+      }
+
+      // Test its neighbors
+      const glm::ivec3& neighbors = grid.GetNeighborsOfTriangle(mLastTriangleIndex);
+      for (int edge = 0; edge < 3; ++edge)
+      {
+         if (neighbors[edge] >= 0 && grid.GetGroundPointBelowOnTriangle(neighbors[edge], origin, outGroundPoint))
+         {
+            mLastTriangleIndex = neighbors[edge];
+            ++mNumNeighborHits;
+            return true;
+         }
+      }
+   }
+
+   // Fall back to the grid
+   unsigned int triangleIndex;
+   if (grid.GetGroundPointBelow(origin, outGroundPoint, triangleIndex))
+   {
+      mLastTriangleIndex = static_cast<int>(triangleIndex);
+      return true;
+   }
+
+   mLastTriangleIndex = -1;
+   return false;
+}
+
+void GroundProbe::Reset()
+{
+   mLastTriangleIndex = -1;
+}
+
+unsigned int GroundProbe::GetNumberOfQueries() const
+{
+   return mNumQueries;
+}
+
+unsigned int GroundProbe::GetNumberOfCacheHits() const
+{
+   return mNumCacheHits;
+}
+
+unsigned int GroundProbe::GetNumberOfNeighborHits() const
+{
+   return mNumNeighborHits;
+}
+
+void GroundProbe::ResetStatistics()
+{
+   mNumQueries      = 0;
+   mNumCacheHits    = 0;
+   mNumNeighborHits = 0;
+}
+
+unsigned int GetGroundPointsBelow(const HeightQueryGrid& grid,
+                                  GroundProbe* const*    probes,
+                                  const glm::vec3*       origins,
+                                  unsigned int           numPoints,
+                                  glm::vec3*             outGroundPoints,
+                                  unsigned char*         outHits)
+{
+   unsigned int numHits = 0;
+   for (unsigned int pointIndex = 0; pointIndex < numPoints; ++pointIndex)
+   {
+      bool hit = probes[pointIndex]->GetGroundPointBelow(grid, origins[pointIndex], outGroundPoints[pointIndex]);
+      outHits[pointIndex] = hit ? 1 : 0;
+      numHits += outHits[pointIndex];
+   }
+
+   return numHits;
+}
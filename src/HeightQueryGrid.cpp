@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <map>
+#include <utility>
+
+#include "HeightQueryGrid.h"
+
+namespace HeightQueryGridHelpers
+{
+   // The size of the cells is chosen so that there's roughly one cell per triangle, which keeps the number of triangles per cell low
+   // without wasting too much memory on empty cells
+   const float cellsPerTriangle = 1.0f;
+
+   // This limit prevents very large or very thin grounds from generating an absurd number of cells
+   const unsigned int maxCellsAlongAxis = 1024;
+
+   // Downward rays ignore triangles that face down or that are vertical, just like DoesRayIntersectTriangle does
+   const float minNormalY = 0.0000001f;
+
+   // The Y component of the cross product of two vectors projected onto the XZ plane
+   // Its sign tells us on which side of an edge a point lies when we look at the ground from above
+   inline float CrossXZ(const glm::vec3& edge, float dx, float dz)
+   {
+      return (edge.z * dx) - (edge.x * dz);
+   }
+
+   // This function calculates the height of a triangle at the given X and Z position
+   // It returns false if the position isn't inside the projection of the triangle onto the XZ plane or if the triangle faces down
+   bool CalculateHeightOfTriangleAt(const Triangle& triangle, float x, float z, float& outHeight)
+   {
+      if (triangle.normal.y < minNormalY)
+      {
+         return false;
+      }
+
+      // Since the normal of the triangle points up, its vertices are in a counterclockwise order when we look at them from above,
+      // so the point lies inside the triangle if it's to the left of the three edges
+      // This is the same test that DoesRayIntersectTriangle performs, except that the cross products are calculated on the XZ plane
+      if (CrossXZ(triangle.vertexB - triangle.vertexA, x - triangle.vertexA.x, z - triangle.vertexA.z) < 0.0f ||
+          CrossXZ(triangle.vertexC - triangle.vertexB, x - triangle.vertexB.x, z - triangle.vertexB.z) < 0.0f ||
+          CrossXZ(triangle.vertexA - triangle.vertexC, x - triangle.vertexC.x, z - triangle.vertexC.z) < 0.0f)
+      {
+         return false;
+      }
+
+      // Evaluate the equation of the plane of the triangle to get the height at the given X and Z position:
+      // (P - A) dot N = 0
+      outHeight = triangle.vertexA.y - (((x - triangle.vertexA.x) * triangle.normal.x) + ((z - triangle.vertexA.z) * triangle.normal.z)) / triangle.normal.y;
+      return true;
+   }
+
+   // This function finds the triangles that share each edge of each triangle
+   // The neighbor across edge AB is stored in X, the one across edge BC in Y and the one across edge CA in Z, and -1 means that there's no neighbor
+   // The meshes duplicate the vertices that have different normals or texture coordinates, so the edges are matched by the positions of their vertices instead of their indices
+   std::vector<glm::ivec3> CalculateTriangleNeighbors(const IndexedTriangleStore& triangles)
+   {
+      typedef std::array<float, 6> EdgeKey;
+
+      unsigned int numTriangles = triangles.GetNumberOfTriangles();
+      std::vector<glm::ivec3> neighbors(numTriangles, glm::ivec3(-1));
+
+      // Map each edge to the first triangle and edge that referenced it
+      std::map<EdgeKey, std::pair<int, int>> edgeToTriangle;
+      for (unsigned int triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+      {
+         const glm::uvec3& indices = triangles.GetIndicesOfTriangle(triangleIndex);
+         const glm::vec3* vertices[3] = { &triangles.GetPosition(indices.x), &triangles.GetPosition(indices.y), &triangles.GetPosition(indices.z) };
+         for (int edge = 0; edge < 3; ++edge)
+         {
+            const glm::vec3& v0 = *vertices[edge];
+            const glm::vec3& v1 = *vertices[(edge + 1) % 3];
+
+            // Sort the vertices of the edge so that both triangles that share it generate the same key
+            bool v0First = (v0.x < v1.x) || (v0.x == v1.x && ((v0.y < v1.y) || (v0.y == v1.y && v0.z < v1.z)));
+            const glm::vec3& first  = v0First ? v0 : v1;
+            const glm::vec3& second = v0First ? v1 : v0;
+            EdgeKey key = { first.x, first.y, first.z, second.x, second.y, second.z };
+
+            std::map<EdgeKey, std::pair<int, int>>::iterator it = edgeToTriangle.find(key);
+            if (it == edgeToTriangle.end())
+            {
+               edgeToTriangle.insert(std::make_pair(key, std::make_pair(static_cast<int>(triangleIndex), edge)));
+            }
+            else
+            {
+               neighbors[triangleIndex][edge]                 = it->second.first;
+               neighbors[it->second.first][it->second.second] = static_cast<int>(triangleIndex);
+            }
+         }
+      }
+
+      return neighbors;
+   }
+}
+
+HeightQueryGrid::HeightQueryGrid()
+   : mTriangles()
+   , mTriangleNeighbors()
+   , mCellOffsets()
+   , mCellTriangleIndices()
+   , mBounds()
+   , mCellSize(1.0f)
+   , mInverseCellSize(1.0f)
+   , mNumCellsAlongX(0)
+   , mNumCellsAlongZ(0)
+{
+
+}
+
+void HeightQueryGrid::Build(const IndexedTriangleStore& triangles)
+{
+   Build(IndexedTriangleStore(triangles));
+}
+
+void HeightQueryGrid::Build(IndexedTriangleStore&& triangles)
+{
+   using namespace HeightQueryGridHelpers;
+
+   mTriangles = std::move(triangles);
+   mTriangleNeighbors.clear();
+   mCellOffsets.clear();
+   mCellTriangleIndices.clear();
+   mBounds = AABB();
+   mNumCellsAlongX = 0;
+   mNumCellsAlongZ = 0;
+
+   unsigned int numTriangles = mTriangles.GetNumberOfTriangles();
+   if (numTriangles == 0)
+   {
+      return;
+   }
+
+   for (unsigned int vertexIndex = 0, numVertices = mTriangles.GetNumberOfVertices(); vertexIndex < numVertices; ++vertexIndex)
+   {
+      mBounds.Expand(mTriangles.GetPosition(vertexIndex));
+   }
+
+   // Calculate the size of the cells
+   float extentX = glm::max(mBounds.max.x - mBounds.min.x, 0.0001f);
+   float extentZ = glm::max(mBounds.max.z - mBounds.min.z, 0.0001f);
+   mCellSize = glm::sqrt((extentX * extentZ) / (numTriangles * cellsPerTriangle));
+   mCellSize = glm::max(mCellSize, glm::max(extentX, extentZ) / maxCellsAlongAxis);
+   mInverseCellSize = 1.0f / mCellSize;
+
+   mNumCellsAlongX = glm::clamp(static_cast<unsigned int>(glm::ceil(extentX * mInverseCellSize)), 1u, maxCellsAlongAxis);
+   mNumCellsAlongZ = glm::clamp(static_cast<unsigned int>(glm::ceil(extentZ * mInverseCellSize)), 1u, maxCellsAlongAxis);
+   unsigned int numCells = mNumCellsAlongX * mNumCellsAlongZ;
+
+   // Calculate the range of cells that is overlapped by the projection of each triangle onto the XZ plane
+   // We use the bounds of the projection, which is conservative, but it's cheap and it never misses a triangle
+   std::vector<glm::uvec4> cellRangeOfTriangle(numTriangles);
+   for (unsigned int triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+   {
+      Triangle triangle = mTriangles.GetTriangle(triangleIndex);
+      float minX = glm::min(triangle.vertexA.x, glm::min(triangle.vertexB.x, triangle.vertexC.x));
+      float maxX = glm::max(triangle.vertexA.x, glm::max(triangle.vertexB.x, triangle.vertexC.x));
+      float minZ = glm::min(triangle.vertexA.z, glm::min(triangle.vertexB.z, triangle.vertexC.z));
+      float maxZ = glm::max(triangle.vertexA.z, glm::max(triangle.vertexB.z, triangle.vertexC.z));
+
+      cellRangeOfTriangle[triangleIndex] = glm::uvec4(glm::min(static_cast<unsigned int>((minX - mBounds.min.x) * mInverseCellSize), mNumCellsAlongX - 1),
+                                                      glm::min(static_cast<unsigned int>((maxX - mBounds.min.x) * mInverseCellSize), mNumCellsAlongX - 1),
+                                                      glm::min(static_cast<unsigned int>((minZ - mBounds.min.z) * mInverseCellSize), mNumCellsAlongZ - 1),
+                                                      glm::min(static_cast<unsigned int>((maxZ - mBounds.min.z) * mInverseCellSize), mNumCellsAlongZ - 1));
+   }
+
+   // Count the triangles of each cell, and then turn the counts into offsets
+   mCellOffsets.assign(numCells + 1, 0);
+   for (unsigned int triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+   {
+      const glm::uvec4& range = cellRangeOfTriangle[triangleIndex];
+      for (unsigned int z = range.z; z <= range.w; ++z)
+      {
+         for (unsigned int x = range.x; x <= range.y; ++x)
+         {
+            mCellOffsets[(z * mNumCellsAlongX) + x + 1]++;
+         }
+      }
+   }
+
+   for (unsigned int cellIndex = 0; cellIndex < numCells; ++cellIndex)
+   {
+      mCellOffsets[cellIndex + 1] += mCellOffsets[cellIndex];
+   }
+
+   // Store the indices of the triangles of each cell
+   mCellTriangleIndices.resize(mCellOffsets[numCells]);
+   std::vector<unsigned int> numTrianglesWrittenForCell(numCells, 0);
+   for (unsigned int triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+   {
+      const glm::uvec4& range = cellRangeOfTriangle[triangleIndex];
+      for (unsigned int z = range.z; z <= range.w; ++z)
+      {
+         for (unsigned int x = range.x; x <= range.y; ++x)
+         {
+            unsigned int cellIndex = (z * mNumCellsAlongX) + x;
+            mCellTriangleIndices[mCellOffsets[cellIndex] + numTrianglesWrittenForCell[cellIndex]++] = triangleIndex;
+         }
+      }
+   }
+
+   mTriangleNeighbors = CalculateTriangleNeighbors(mTriangles);
+}
+
+bool HeightQueryGrid::GetGroundHeight(float x, float z, float& outHeight) const
+{
+   unsigned int triangleIndex;
+   return FindHighestTriangleBelow(x, z, FLT_MAX, outHeight, triangleIndex);
+}
+
+bool HeightQueryGrid::GetGroundPointBelow(const glm::vec3& origin, glm::vec3& outGroundPoint) const
+{
+   unsigned int triangleIndex;
+   return GetGroundPointBelow(origin, outGroundPoint, triangleIndex);
+}
+
+bool HeightQueryGrid::GetGroundPointBelow(const glm::vec3& origin, glm::vec3& outGroundPoint, unsigned int& outTriangleIndex) const
+{
+   float height;
+   if (FindHighestTriangleBelow(origin.x, origin.z, origin.y, height, outTriangleIndex))
+   {
+      outGroundPoint = glm::vec3(origin.x, height, origin.z);
+      return true;
+   }
+
+   return false;
+}
+
+bool HeightQueryGrid::GetGroundPointBelowOnTriangle(unsigned int triangleIndex, const glm::vec3& origin, glm::vec3& outGroundPoint) const
+{
+   using namespace HeightQueryGridHelpers;
+
+   float height;
+   if (CalculateHeightOfTriangleAt(mTriangles.GetTriangle(triangleIndex), origin.x, origin.z, height) && height <= origin.y)
+   {
+      outGroundPoint = glm::vec3(origin.x, height, origin.z);
+      return true;
+   }
+
+   return false;
+}
+
+const glm::ivec3& HeightQueryGrid::GetNeighborsOfTriangle(unsigned int triangleIndex) const
+{
+   return mTriangleNeighbors[triangleIndex];
+}
+
+unsigned int HeightQueryGrid::GetNumberOfTriangles() const
+{
+   return mTriangles.GetNumberOfTriangles();
+}
+
+float HeightQueryGrid::GetAverageNumberOfTrianglesPerCell() const
+{
+   unsigned int numCells = mNumCellsAlongX * mNumCellsAlongZ;
+   return (numCells > 0) ? (static_cast<float>(mCellTriangleIndices.size()) / numCells) : 0.0f;
+}
+
+unsigned int HeightQueryGrid::GetNumberOfCellsAlongX() const
+{
+   return mNumCellsAlongX;
+}
+
+unsigned int HeightQueryGrid::GetNumberOfCellsAlongZ() const
+{
+   return mNumCellsAlongZ;
+}
+
+AABB HeightQueryGrid::GetBounds() const
+{
+   return mBounds;
+}
+
+bool HeightQueryGrid::FindHighestTriangleBelow(float x, float z, float maxHeight, float& outHeight, unsigned int& outTriangleIndex) const
+{
+   using namespace HeightQueryGridHelpers;
+
+   if (mNumCellsAlongX == 0 || x < mBounds.min.x || x > mBounds.max.x || z < mBounds.min.z || z > mBounds.max.z)
+   {
+      return false;
+   }
+
+   unsigned int cellX = glm::min(static_cast<unsigned int>((x - mBounds.min.x) * mInverseCellSize), mNumCellsAlongX - 1);
+   unsigned int cellZ = glm::min(static_cast<unsigned int>((z - mBounds.min.z) * mInverseCellSize), mNumCellsAlongZ - 1);
+   unsigned int cellIndex = (cellZ * mNumCellsAlongX) + cellX;
+
+   bool  hit           = false;
+   float highestHeight = -FLT_MAX;
+   float height;
+   for (unsigned int i = mCellOffsets[cellIndex], end = mCellOffsets[cellIndex + 1]; i < end; ++i)
+   {
+      if (CalculateHeightOfTriangleAt(mTriangles.GetTriangle(mCellTriangleIndices[i]), x, z, height) && height <= maxHeight && height > highestHeight)
+      {
+         highestHeight    = height;
+         outTriangleIndex = mCellTriangleIndices[i];
+         hit              = true;
+      }
+   }
+
+   if (hit)
+   {
+      outHeight = highestHeight;
+   }
+
+   return hit;
+}
@@ -46,7 +46,7 @@ void TIKCrossFadeController<CLIP>::SetSkeleton(Skeleton& skeleton)
 }
 
 template <typename CLIP>
-void TIKCrossFadeController<CLIP>::Play(CLIP* clip, ScalarTrack* leftFootPinTrack, ScalarTrack* rightFootPinTrack, bool lock)
+void TIKCrossFadeController<CLIP>::Play(const CLIP* clip, ScalarTrack* leftFootPinTrack, ScalarTrack* rightFootPinTrack, bool lock)
 {
    // When asked to play a clip, we clear all the crossfade targets
    mTargets.clear();
@@ -60,7 +60,7 @@ void TIKCrossFadeController<CLIP>::Play(CLIP* clip, ScalarTrack* leftFootPinTrac
 }
 
 template <typename CLIP>
-void TIKCrossFadeController<CLIP>::FadeTo(CLIP* targetClip, ScalarTrack* leftFootPinTrack, ScalarTrack* rightFootPinTrack, float fadeDuration, bool lock)
+void TIKCrossFadeController<CLIP>::FadeTo(const CLIP* targetClip, ScalarTrack* leftFootPinTrack, ScalarTrack* rightFootPinTrack, float fadeDuration, bool lock)
 {
    if (mLock)
    {
@@ -191,11 +191,32 @@ void TIKCrossFadeController<CLIP>::ClearTargets()
 }
 
 template <typename CLIP>
-CLIP* TIKCrossFadeController<CLIP>::GetCurrentClip()
+const CLIP* TIKCrossFadeController<CLIP>::GetCurrentClip()
 {
    return mCurrentClip;
 }
 
+template <typename CLIP>
+bool TIKCrossFadeController<CLIP>::IsPlaying(const CLIP* clip)
+{
+   // A clip is playing if it's the current clip or if the current clip is fading into it
+   if (mCurrentClip == clip)
+   {
+      return true;
+   }
+
+   unsigned int numTargets = static_cast<unsigned int>(mTargets.size());
+   for (unsigned int targetIndex = 0; targetIndex < numTargets; ++targetIndex)
+   {
+      if (mTargets[targetIndex].mClip == clip)
+      {
+         return true;
+      }
+   }
+
+   return false;
+}
+
 template <typename CLIP>
 Pose& TIKCrossFadeController<CLIP>::GetCurrentPose()
 {
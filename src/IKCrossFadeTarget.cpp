@@ -16,7 +16,7 @@ TIKCrossFadeTarget<CLIP>::TIKCrossFadeTarget()
 }
 
 template <typename CLIP>
-TIKCrossFadeTarget<CLIP>::TIKCrossFadeTarget(CLIP*        clip,
+TIKCrossFadeTarget<CLIP>::TIKCrossFadeTarget(const CLIP*  clip,
                                              ScalarTrack* leftFootPinTrack,
                                              ScalarTrack* rightFootPinTrack,
                                              Pose&        pose,
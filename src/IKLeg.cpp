@@ -1,3 +1,5 @@
+#include <glm/gtx/norm.hpp>
+
 #include "IKLeg.h"
 
 // TODO: This isn't very nice. It's just here to avoid creating legs on the heap.
@@ -7,6 +9,11 @@ IKLeg::IKLeg()
    , mAnkleIndex(0)
    , mToeIndex(0)
    , mAnkleToGroundOffset(0)
+   , mIndexInBatch(0)
+   , mNumIterationsOfLastSolve(0)
+   , mPrevTargetInSpaceOfParentOfHip(0.0f)
+   , mHasPrevSolution(false)
+   , mWarmStartThreshold(0.05f)
 {
 
 }
@@ -17,10 +24,20 @@ IKLeg::IKLeg(Skeleton& skeleton, const std::string& hipName, const std::string&
    , mAnkleIndex(0)
    , mToeIndex(0)
    , mAnkleToGroundOffset(0)
+   , mIndexInBatch(0)
+   , mNumIterationsOfLastSolve(0)
+   , mPrevTargetInSpaceOfParentOfHip(0.0f)
+   , mHasPrevSolution(false)
+   , mWarmStartThreshold(0.05f)
 {
    // There are 3 joints in the IK chain of a leg: the hip, the knee and the ankle
    mSolver.SetNumberOfJointsInIKChain(3);
 
+   // Stop iterating once the ankle is within a tenth of a millimeter of its target, or once an iteration barely brings it closer,
+   // which is what happens when the target is out of reach
+   mSolver.SetThreshold(0.0001f);
+   mSolver.SetMinImprovementPerIteration(0.001f);
+
    for (unsigned int jointIndex = 0, numJoints = skeleton.GetRestPose().GetNumberOfJoints(); jointIndex < numJoints; ++jointIndex)
    {
       std::string& nameOfCurrJoint = skeleton.GetJointName(jointIndex);
@@ -44,16 +61,32 @@ IKLeg::IKLeg(Skeleton& skeleton, const std::string& hipName, const std::string&
    }
 }
 
-void IKLeg::Solve(const Transform& modelTransform, Pose& pose, const glm::vec3& ankleTargetPosition, bool constrained, int numIterations)
+void IKLeg::Solve(const Transform& modelTransform, Pose& pose, const glm::vec3& ankleTargetPosition, bool constrained, int numIterations, bool warmStart)
 {
-   mSolver.SetNumberOfIterations(numIterations);
-   mSolver.SetLocalTransform(0, combine(modelTransform, pose.GetGlobalTransform(mHipIndex)));
-   mSolver.SetLocalTransform(1, pose.GetLocalTransform(mKneeIndex));
-   mSolver.SetLocalTransform(2, pose.GetLocalTransform(mAnkleIndex));
-   mIKPose = pose;
-
+   Transform rootWorld = combine(modelTransform, pose.GetGlobalTransform(pose.GetParent(mHipIndex)));
    Transform target(ankleTargetPosition + glm::vec3(0, 1, 0) * mAnkleToGroundOffset, Q::quat(), glm::vec3(1, 1, 1));
 
+   // If the target barely moved relative to the parent of the hip, the chain that we solved in the last frame is a better starting point than the animated pose
+   // We only reuse the rotations of the joints, since their positions come from the animated pose
+   glm::vec3 targetInSpaceOfParentOfHip = transformPoint(inverse(rootWorld), target.position);
+   bool      canWarmStart               = warmStart && mHasPrevSolution &&
+                                          glm::length2(targetInSpaceOfParentOfHip - mPrevTargetInSpaceOfParentOfHip) < (mWarmStartThreshold * mWarmStartThreshold);
+
+   Transform localTransfOfHip   = pose.GetLocalTransform(mHipIndex);
+   Transform localTransfOfKnee  = pose.GetLocalTransform(mKneeIndex);
+   Transform localTransfOfAnkle = pose.GetLocalTransform(mAnkleIndex);
+   if (canWarmStart)
+   {
+      localTransfOfHip.rotation   = mSolvedLocalTransfOfHip.rotation;
+      localTransfOfKnee.rotation  = mSolvedLocalTransfOfKnee.rotation;
+      localTransfOfAnkle.rotation = mSolvedLocalTransfOfAnkle.rotation;
+   }
+
+   mSolver.SetNumberOfIterations(numIterations);
+   mSolver.SetLocalTransform(0, combine(rootWorld, localTransfOfHip));
+   mSolver.SetLocalTransform(1, localTransfOfKnee);
+   mSolver.SetLocalTransform(2, localTransfOfAnkle);
+
    if (constrained)
    {
       glm::vec3 characterRight = modelTransform.rotation * glm::vec3(1.0f, 0.0f, 0.0f);
@@ -64,10 +97,69 @@ void IKLeg::Solve(const Transform& modelTransform, Pose& pose, const glm::vec3&
       mSolver.Solve(target);
    }
 
+   mNumIterationsOfLastSolve = mSolver.GetNumberOfIterationsPerformed();
+
+   mSolvedLocalTransfOfHip         = combine(inverse(rootWorld), mSolver.GetLocalTransform(0));
+   mSolvedLocalTransfOfKnee        = mSolver.GetLocalTransform(1);
+   mSolvedLocalTransfOfAnkle       = mSolver.GetLocalTransform(2);
+   mPrevTargetInSpaceOfParentOfHip = targetInSpaceOfParentOfHip;
+   mHasPrevSolution                = true;
+}
+
+void IKLeg::SolveAnalytically(const Transform& modelTransform, Pose& pose, const glm::vec3& ankleTargetPosition)
+{
+   Transform rootWorld = combine(modelTransform, pose.GetGlobalTransform(pose.GetParent(mHipIndex)));
+   Transform target(ankleTargetPosition + glm::vec3(0, 1, 0) * mAnkleToGroundOffset, Q::quat(), glm::vec3(1, 1, 1));
+
+   mTwoBoneSolver.SetLocalTransform(0, combine(rootWorld, pose.GetLocalTransform(mHipIndex)));
+   mTwoBoneSolver.SetLocalTransform(1, pose.GetLocalTransform(mKneeIndex));
+   mTwoBoneSolver.SetLocalTransform(2, pose.GetLocalTransform(mAnkleIndex));
+
+   glm::vec3 characterRight = modelTransform.rotation * glm::vec3(1.0f, 0.0f, 0.0f);
+   mTwoBoneSolver.Solve(target, characterRight);
+
+   mNumIterationsOfLastSolve = 0;
+
+   mSolvedLocalTransfOfHip         = combine(inverse(rootWorld), mTwoBoneSolver.GetLocalTransform(0));
+   mSolvedLocalTransfOfKnee        = mTwoBoneSolver.GetLocalTransform(1);
+   mSolvedLocalTransfOfAnkle       = mTwoBoneSolver.GetLocalTransform(2);
+   mPrevTargetInSpaceOfParentOfHip = transformPoint(inverse(rootWorld), target.position);
+   mHasPrevSolution                = true;
+}
+
+void IKLeg::SubmitToBatch(FABRIKBatchSolver& batchSolver, const Transform& modelTransform, Pose& pose, const glm::vec3& ankleTargetPosition)
+{
+   Transform rootWorld = combine(modelTransform, pose.GetGlobalTransform(pose.GetParent(mHipIndex)));
+
+   mSolver.SetLocalTransform(0, combine(rootWorld, pose.GetLocalTransform(mHipIndex)));
+   mSolver.SetLocalTransform(1, pose.GetLocalTransform(mKneeIndex));
+   mSolver.SetLocalTransform(2, pose.GetLocalTransform(mAnkleIndex));
+
+   glm::vec3 worldPositions[3] = { mSolver.GetGlobalTransform(0).position, mSolver.GetGlobalTransform(1).position, mSolver.GetGlobalTransform(2).position };
+   glm::vec3 targetPosition    = ankleTargetPosition + glm::vec3(0, 1, 0) * mAnkleToGroundOffset;
+   mIndexInBatch = batchSolver.AddIKChain(worldPositions, targetPosition);
+
+   mPrevTargetInSpaceOfParentOfHip = transformPoint(inverse(rootWorld), targetPosition);
+}
+
+void IKLeg::RetrieveFromBatch(const FABRIKBatchSolver& batchSolver, const Transform& modelTransform, Pose& pose, bool constrained)
+{
+   glm::vec3 worldPositions[3] = { batchSolver.GetWorldPosition(mIndexInBatch, 0), batchSolver.GetWorldPosition(mIndexInBatch, 1), batchSolver.GetWorldPosition(mIndexInBatch, 2) };
+   mSolver.SetWorldPositionsOfIKChain(worldPositions);
+
+   if (constrained)
+   {
+      glm::vec3 characterRight = modelTransform.rotation * glm::vec3(1.0f, 0.0f, 0.0f);
+      mSolver.ApplyBackwardsKneeCorrection(1, characterRight);
+   }
+
+   mNumIterationsOfLastSolve = batchSolver.GetNumberOfIterationsPerformed(mIndexInBatch);
+
    Transform rootWorld = combine(modelTransform, pose.GetGlobalTransform(pose.GetParent(mHipIndex)));
-   mIKPose.SetLocalTransform(mHipIndex, combine(inverse(rootWorld), mSolver.GetLocalTransform(0)));
-   mIKPose.SetLocalTransform(mKneeIndex, mSolver.GetLocalTransform(1));
-   mIKPose.SetLocalTransform(mAnkleIndex, mSolver.GetLocalTransform(2));
+   mSolvedLocalTransfOfHip   = combine(inverse(rootWorld), mSolver.GetLocalTransform(0));
+   mSolvedLocalTransfOfKnee  = mSolver.GetLocalTransform(1);
+   mSolvedLocalTransfOfAnkle = mSolver.GetLocalTransform(2);
+   mHasPrevSolution          = true;
 }
 
 unsigned int IKLeg::GetHipIndex()
@@ -95,7 +187,19 @@ void IKLeg::SetAnkleOffset(float ankleOffset)
    mAnkleToGroundOffset = ankleOffset;
 }
 
-const Pose& IKLeg::GetAdjustedPose()
+void IKLeg::SetWarmStartThreshold(float warmStartThreshold)
+{
+   mWarmStartThreshold = warmStartThreshold;
+}
+
+void IKLeg::ApplySolvedChainToPose(Pose& pose) const
+{
+   pose.SetLocalTransform(mHipIndex, mSolvedLocalTransfOfHip);
+   pose.SetLocalTransform(mKneeIndex, mSolvedLocalTransfOfKnee);
+   pose.SetLocalTransform(mAnkleIndex, mSolvedLocalTransfOfAnkle);
+}
+
+unsigned int IKLeg::GetNumberOfIterationsOfLastSolve() const
 {
-   return mIKPose;
+   return mNumIterationsOfLastSolve;
 }
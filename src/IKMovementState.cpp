@@ -5,12 +5,14 @@
 #include <glm/gtx/norm.hpp>
 #include <glm/gtx/compatibility.hpp>
 
+#include <utility>
+
 #include "resource_manager.h"
 #include "shader_loader.h"
 #include "texture_loader.h"
 #include "GLTFLoader.h"
-#include "RearrangeBones.h"
 #include "Intersection.h"
+#include "MeshSimplifier.h"
 #include "Blending.h"
 #include "IKMovementState.h"
 
@@ -20,12 +22,13 @@ extern std::string runInstruction;
 #endif
 
 IKMovementState::IKMovementState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
-                                 const std::shared_ptr<Window>&             window)
+                                 const std::shared_ptr<Window>&             window,
+                                 const std::shared_ptr<AssetLoader>&        assetLoader)
    : mFSM(finiteStateMachine)
    , mWindow(window)
    , mCamera3(8.0f, 15.0f, glm::vec3(0.0f), Q::quat(), glm::vec3(0.0f, 3.0f, 0.0f), 0.0f, 90.0f, 0.0f, 90.0f, 45.0f, 1280.0f / 720.0f, 0.1f, 500.0f, 0.25f)
-   , mWater(Transform(glm::vec3(0.0f, 10.0f, 0.0f), Q::angleAxis(glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f)), glm::vec3(205.0f)))
-   , mSky()
+   , mWater(Transform(glm::vec3(0.0f, 10.0f, 0.0f), Q::angleAxis(glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f)), glm::vec3(205.0f)), *assetLoader)
+   , mSky(*assetLoader)
 {
    // Initialize the animated mesh shader
    mAnimatedCharacterMeshShader = ResourceManager<Shader>().loadUnmanagedResource<ShaderLoader>("resources/shaders/animated_mesh_with_pregenerated_skin_matrices_clipped.vert",
@@ -46,40 +49,29 @@ IKMovementState::IKMovementState(const std::shared_ptr<FiniteStateMachine>& fini
    configureLights(mStaticMeshShader, glm::vec3(0.5f, 0.5f, 0.5f));
 
    // Load the diffuse texture of the animated character
-   mDiffuseTexture = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>("resources/models/woman/woman.png");
+   mDiffuseTexture = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>(assetLoader->GetImage("resources/models/woman/woman.png"));
 
    // Load the animated character
-   cgltf_data* data        = LoadGLTFFile("resources/models/woman/woman.gltf");
-   mSkeleton               = LoadSkeleton(data);
-   mAnimatedMeshes         = LoadAnimatedMeshes(data);
-   std::vector<Clip> clips = LoadClips(data);
-   FreeGLTFFile(data);
-
-   // Rearrange the skeleton
-   JointMap jointMap = RearrangeSkeleton(mSkeleton);
+   mCharacter = assetLoader->GetCharacter("resources/models/woman/woman.glb", "resources/models/woman/woman.bake");
+   mSkeleton  = mCharacter->skeleton;
 
-   // Rearrange the meshes
+   // The meshes of the state share the vertices and the static buffers of the meshes of the character,
+   // and they only store what changes when the character is animated, since each state morphs and skins its own vertices
+   mAnimatedMeshes.resize(mCharacter->meshes.size());
    for (unsigned int meshIndex = 0,
         numMeshes = static_cast<unsigned int>(mAnimatedMeshes.size());
         meshIndex < numMeshes;
         ++meshIndex)
    {
-      RearrangeMesh(mAnimatedMeshes[meshIndex], jointMap);
+      mAnimatedMeshes[meshIndex].ShareMeshData(mCharacter->meshes[meshIndex]);
    }
 
-   // Optimize the clips, rearrange them and get their names
-   for (unsigned int clipIndex = 0,
-        numClips = static_cast<unsigned int>(clips.size());
-        clipIndex < numClips;
-        ++clipIndex)
-   {
-      FastClip currClip = OptimizeClip(clips[clipIndex]);
-      RearrangeFastClip(currClip, jointMap);
-      mClips.insert(std::make_pair(currClip.GetName(), currClip));
-   }
+   // Copy the jumps, which are released right away so that the clip library can evict them
+   mJumpClip = *mCharacter->clips->GetClip("Jump");
+   mJumpClip.SetLooping(false);
 
-   mClips["Jump"].SetLooping(false);
-   mClips["Jump2"].SetLooping(false);
+   mJump2Clip = *mCharacter->clips->GetClip("Jump2");
+   mJump2Clip.SetLooping(false);
 
    // Configure the pin tracks for all the clips
    configurePinTracks();
@@ -95,6 +87,7 @@ IKMovementState::IKMovementState(const std::shared_ptr<FiniteStateMachine>& fini
         i < size;
         ++i)
    {
+      mAnimatedMeshes[i].LoadBuffers();
       mAnimatedMeshes[i].ConfigureVAO(positionsAttribLocOfAnimatedShader,
                                       normalsAttribLocOfAnimatedShader,
                                       texCoordsAttribLocOfAnimatedShader,
@@ -103,7 +96,7 @@ IKMovementState::IKMovementState(const std::shared_ptr<FiniteStateMachine>& fini
    }
 
    // Load the ground
-   data = LoadGLTFFile("resources/models/ground/water_terrain.gltf");
+   cgltf_data* data = LoadGLTFFile("resources/models/ground/water_terrain.glb");
    mGroundMeshes = LoadStaticMeshes(data);
    FreeGLTFFile(data);
 
@@ -117,17 +110,22 @@ IKMovementState::IKMovementState(const std::shared_ptr<FiniteStateMachine>& fini
    {
       mGroundMeshes[i].ConfigureVAO(positionsAttribLocOfStaticShader,
                                     normalsAttribLocOfStaticShader,
-                                    texCoordsAttribLocOfStaticShader,
-                                    -1,
-                                    -1);
+                                    texCoordsAttribLocOfStaticShader);
    }
 
    // Load the texture of the ground
-   mGroundDiffuseTexture  = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>("resources/models/ground/grass.png");
-   mGroundEmissiveTexture = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>("resources/models/ground/lights.png");
+   mGroundDiffuseTexture  = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>(assetLoader->GetImage("resources/models/ground/grass.png"));
+   mGroundEmissiveTexture = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>(assetLoader->GetImage("resources/models/ground/lights.png"));
 
    // Get the triangles that make up the ground
-   mGroundTriangles = GetTrianglesFromMeshes(mGroundMeshes);
+   // They are read straight from the positions and indices of the meshes and stored as indices into a shared array of positions
+   IndexedTriangleStore groundTriangles;
+   groundTriangles.Build(mGroundMeshes);
+
+   // All the rays that we shoot at the ground point straight down, so we build a grid that lets us find the height of the ground
+   // at any X and Z position by only testing the triangles of a single cell
+   // The grid is the only thing that queries the triangles, so they are moved into it instead of being copied
+   mGroundHeightGrid.Build(std::move(groundTriangles));
 
    // Initialize the values we use to describe the position of the character
    mHeightOfOriginOfYPositionRay = 100.0f;
@@ -138,10 +136,12 @@ IKMovementState::IKMovementState(const std::shared_ptr<FiniteStateMachine>& fini
    mAnkleVerticalOffset          = 0.2f;
 
    // Create the IK legs
-   mLeftLeg = IKLeg(mSkeleton, "LeftUpLeg", "LeftLeg", "LeftFoot", "LeftToeBase");
-   mLeftLeg.SetAnkleOffset(mAnkleVerticalOffset);  // The left ankle is 0.2 units above the ground
-   mRightLeg = IKLeg(mSkeleton, "RightUpLeg", "RightLeg", "RightFoot", "RightToeBase");
-   mRightLeg.SetAnkleOffset(mAnkleVerticalOffset); // The right ankle is 0.2 units above the ground
+   IKLeg& leftLeg  = mFootPlacementCharacter.leftLeg;
+   IKLeg& rightLeg = mFootPlacementCharacter.rightLeg;
+   leftLeg = IKLeg(mSkeleton, "LeftUpLeg", "LeftLeg", "LeftFoot", "LeftToeBase");
+   leftLeg.SetAnkleOffset(mAnkleVerticalOffset);  // The left ankle is 0.2 units above the ground
+   rightLeg = IKLeg(mSkeleton, "RightUpLeg", "RightLeg", "RightFoot", "RightToeBase");
+   rightLeg.SetAnkleOffset(mAnkleVerticalOffset); // The right ankle is 0.2 units above the ground
 
    initializeState();
 
@@ -161,7 +161,7 @@ void IKMovementState::initializeState()
 
    // Set the initial clip and initialize the crossfade controller
    mIKCrossFadeController.SetSkeleton(mSkeleton);
-   mIKCrossFadeController.Play(&mClips["Idle"], &mLeftFootPinTracks["Idle"], &mRightFootPinTracks["Idle"], false);
+   mIKCrossFadeController.Play(getClip("Idle"), &mLeftFootPinTracks["Idle"], &mRightFootPinTracks["Idle"], false);
    mIKCrossFadeController.Update(0.0f);
    mIKCrossFadeController.GetCurrentPose().GetMatrixPalette(mPosePalette);
 
@@ -179,7 +179,18 @@ void IKMovementState::initializeState()
    mWireframeModeForTerrain = false;
    mPerformDepthTesting = true;
 #endif
+   mPerformFrustumCulling = true;
+   mNumMeshesSubmitted = 0;
+   mNumMeshesCulled = 0;
+   mPerformLODSelection = true;
+   mMaxScreenSpaceErrorInPix = 1.0f;
+   mWaterPassLODBias = 1;
+   mCharacterLODIndex = 0;
    // Set the initial IK options
+   mSolveAnalytically = false;
+   mSolveInBatch = false;
+   mWarmStartIK = false;
+   mAverageIKIterationsPerFrame = 0.0f;
    mSolveWithConstraints = true;
    mSelectedNumberOfIterations = 15;
    // Set the initial beauty pass options
@@ -339,17 +350,17 @@ void IKMovementState::processInput(float deltaTime)
 
       if (mIsWalking)
       {
-         mIKCrossFadeController.FadeTo(&mClips["Jump2"], &mLeftFootPinTracks["Jump2"], &mRightFootPinTracks["Jump2"], 0.1f, true);
+         mIKCrossFadeController.FadeTo(getClip("Jump2"), &mLeftFootPinTracks["Jump2"], &mRightFootPinTracks["Jump2"], 0.1f, true);
          mJumpingWhileWalking = true;
       }
       else if (mIsRunning)
       {
-         mIKCrossFadeController.FadeTo(&mClips["Jump2"], &mLeftFootPinTracks["Jump2"], &mRightFootPinTracks["Jump2"], 0.1f, true);
+         mIKCrossFadeController.FadeTo(getClip("Jump2"), &mLeftFootPinTracks["Jump2"], &mRightFootPinTracks["Jump2"], 0.1f, true);
          mJumpingWhileRunning = true;
       }
       else
       {
-         mIKCrossFadeController.FadeTo(&mClips["Jump"], &mLeftFootPinTracks["Jump"], &mRightFootPinTracks["Jump"], 0.1f, true);
+         mIKCrossFadeController.FadeTo(getClip("Jump"), &mLeftFootPinTracks["Jump"], &mRightFootPinTracks["Jump"], 0.1f, true);
          mJumpingWhileIdle = true;
       }
 
@@ -364,17 +375,17 @@ void IKMovementState::processInput(float deltaTime)
 
          if (mIsWalking)
          {
-            mIKCrossFadeController.FadeTo(&mClips["Walking"], &mLeftFootPinTracks["Walking"], &mRightFootPinTracks["Walking"], 0.15f, false);
+            mIKCrossFadeController.FadeTo(getClip("Walking"), &mLeftFootPinTracks["Walking"], &mRightFootPinTracks["Walking"], 0.15f, false);
             mJumpingWhileWalking = false;
          }
          else if (mIsRunning)
          {
-            mIKCrossFadeController.FadeTo(&mClips["Running"], &mLeftFootPinTracks["Running"], &mRightFootPinTracks["Running"], 0.15f, false);
+            mIKCrossFadeController.FadeTo(getClip("Running"), &mLeftFootPinTracks["Running"], &mRightFootPinTracks["Running"], 0.15f, false);
             mJumpingWhileRunning = false;
          }
          else
          {
-            mIKCrossFadeController.FadeTo(&mClips["Idle"], &mLeftFootPinTracks["Idle"], &mRightFootPinTracks["Idle"], 0.1f, false);
+            mIKCrossFadeController.FadeTo(getClip("Idle"), &mLeftFootPinTracks["Idle"], &mRightFootPinTracks["Idle"], 0.1f, false);
             mJumpingWhileIdle = false;
          }
 
@@ -389,12 +400,12 @@ void IKMovementState::processInput(float deltaTime)
          if (runKeyPressed)
          {
             mIsRunning = true;
-            mIKCrossFadeController.FadeTo(&mClips["Running"], &mLeftFootPinTracks["Running"], &mRightFootPinTracks["Running"], 0.25f, false);
+            mIKCrossFadeController.FadeTo(getClip("Running"), &mLeftFootPinTracks["Running"], &mRightFootPinTracks["Running"], 0.25f, false);
          }
          else
          {
             mIsWalking = true;
-            mIKCrossFadeController.FadeTo(&mClips["Walking"], &mLeftFootPinTracks["Walking"], &mRightFootPinTracks["Walking"], 0.25f, false);
+            mIKCrossFadeController.FadeTo(getClip("Walking"), &mLeftFootPinTracks["Walking"], &mRightFootPinTracks["Walking"], 0.25f, false);
          }
       }
       else if (mIsWalking)
@@ -403,7 +414,7 @@ void IKMovementState::processInput(float deltaTime)
          {
             mIsWalking = false;
             mIsRunning = true;
-            mIKCrossFadeController.FadeTo(&mClips["Running"], &mLeftFootPinTracks["Running"], &mRightFootPinTracks["Running"], 0.25f, false);
+            mIKCrossFadeController.FadeTo(getClip("Running"), &mLeftFootPinTracks["Running"], &mRightFootPinTracks["Running"], 0.25f, false);
          }
       }
       else if (mIsRunning)
@@ -412,7 +423,7 @@ void IKMovementState::processInput(float deltaTime)
          {
             mIsRunning = false;
             mIsWalking = true;
-            mIKCrossFadeController.FadeTo(&mClips["Walking"], &mLeftFootPinTracks["Walking"], &mRightFootPinTracks["Walking"], 0.25f, false);
+            mIKCrossFadeController.FadeTo(getClip("Walking"), &mLeftFootPinTracks["Walking"], &mRightFootPinTracks["Walking"], 0.25f, false);
          }
       }
    }
@@ -422,7 +433,7 @@ void IKMovementState::processInput(float deltaTime)
       {
          mIsRunning = false;
          mIsWalking = false;
-         mIKCrossFadeController.FadeTo(&mClips["Idle"], &mLeftFootPinTracks["Idle"], &mRightFootPinTracks["Idle"], 0.25f, false);
+         mIKCrossFadeController.FadeTo(getClip("Idle"), &mLeftFootPinTracks["Idle"], &mRightFootPinTracks["Idle"], 0.25f, false);
       }
    }
 }
@@ -459,78 +470,17 @@ void IKMovementState::update(float deltaTime)
    // Ask the crossfade controller to sample the current clip and fade with the next one if necessary
    mIKCrossFadeController.Update(deltaTime);
 
+   // Release the clips that stopped playing and load the ones that the character is likely to play next
+   releaseClipsThatAreNotPlaying();
+   prefetchNextClips();
+   mCharacter->clips->Update();
+
    // --- --- ---
 
-   // Ankle Correction
+   // Foot Placement
    // **********************************************************************************************************************************************
 
-   FastClip* currClip = mIKCrossFadeController.GetCurrentClip();
-   Pose&     currPose = mIKCrossFadeController.GetCurrentPose();
-
-   // The keyframes of the pin tracks are set in normalized time, so they must be sampled with the normalized time
-   float leftFootPinTrackValue   = mIKCrossFadeController.GetCurrentLeftFootPinTrackValue();
-   float rightFootPinTrackValue  = mIKCrossFadeController.GetCurrentRightFootPinTrackValue();
-
-   // Calculate the world positions of the left and right ankles
-   // We do this by combining the model transform of the character (mModelTransform) with the global transforms of the joints
-   // Note the parent-child order here, which makes sense
-   glm::vec3 worldPosOfLeftAnkle  = combine(mModelTransform, currPose.GetGlobalTransform(mLeftLeg.GetAnkleIndex())).position;
-   glm::vec3 worldPosOfRightAnkle = combine(mModelTransform, currPose.GetGlobalTransform(mRightLeg.GetAnkleIndex())).position;
-
-   // Construct rays for the left and right ankles
-   // These shoot down from the height of the hip
-   Ray leftAnkleRay(worldPosOfLeftAnkle + glm::vec3(0.0f, mHeightOfHip, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
-   Ray rightAnkleRay(worldPosOfRightAnkle + glm::vec3(0.0f, mHeightOfHip, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f));
-
-   // If the rays don't hit anything, we use the positions of the ankles as default values
-   glm::vec3 leftAnkleGroundIKTarget  = worldPosOfLeftAnkle;
-   glm::vec3 rightAnkleGroundIKTarget = worldPosOfRightAnkle;
-
-   // Here we do the equivalent of the following:
-   // - Shoot a ray downwards from the height of the hip to the ankle
-   // - Shoot a ray downwards from the height of the hip through the ankle to infinity
-   // The first ray tells us if there's ground above the ankle
-   // If there is, that becomes the new position of the ankle
-   // The second ray tells us if there's ground above or below the ankle
-   // If there is, that becomes the new target of the IK chain
-   glm::vec3 hitPoint;
-   for (unsigned int i = 0,
-        numTriangles = static_cast<unsigned int>(mGroundTriangles.size());
-        i < numTriangles;
-        ++i)
-   {
-      if (DoesRayIntersectTriangle(leftAnkleRay, mGroundTriangles[i], hitPoint))
-      {
-         // Is the hit point between the ankle and the hip?
-         // In other words, is it above the ankle?
-         // TODO: Is there a better way to check if the hit point is above the ankle?
-         if (glm::length2(hitPoint - leftAnkleRay.origin) < mHeightOfHip * mHeightOfHip)
-         {
-            // If it is, we update the position of the ankle to be on the ground
-            // We do this because if there's ground above the ankle, the foot should be on the ground regardless of what the pin track says
-            // In other words, here we override the animation to avoid having the foot be below ground
-            worldPosOfLeftAnkle = hitPoint;
-         }
-
-         leftAnkleGroundIKTarget = hitPoint;
-      }
-
-      if (DoesRayIntersectTriangle(rightAnkleRay, mGroundTriangles[i], hitPoint))
-      {
-         // Is the hit point between the ankle and the hip?
-         // In other words, is it above the ankle?
-         // TODO: Is there a better way to check if the hit point is above the ankle?
-         if (glm::length2(hitPoint - rightAnkleRay.origin) < mHeightOfHip * mHeightOfHip)
-         {
-            // If it is, we update the position of the ankle to be on the ground
-            // We do this because if there's ground above the ankle, the foot should be on the ground regardless of what the pin track says
-            // In other words, here we override the animation to avoid having the foot be below ground
-            worldPosOfRightAnkle = hitPoint;
-         }
-
-         rightAnkleGroundIKTarget = hitPoint;
-      }
-   }
+   Pose& currPose = mIKCrossFadeController.GetCurrentPose();
 
    // Create a vector with the current X and Z position values of the character and the old Y value
    glm::vec3 currPosOfCharacterWithPreviousHeight = mModelTransform.position;
@@ -542,170 +492,18 @@ void IKMovementState::update(float deltaTime)
 
    mCamera3.processPlayerMovement(mModelTransform.position, mModelTransform.rotation);
 
-   // Interpolate between the current world position of the left ankle and its ground IK target based on the value of the pin track
-   // If the pin track says that the foot should be on the ground, then the ground IK target will be favored
-   // If the pin track says that the foot should not be on the ground, the the world position of the ankle, which is given by the animation clip, will be favored
-   // Note that if we detected that there's ground above the ankle, worldPosOfLeftAnkle and leftAnkleGroundIKTarget will be the same, which means that the foot
-   // will be on the ground regardless of what the pin track says
-   mLeftAnkleFinalTarget = glm::lerp(worldPosOfLeftAnkle, leftAnkleGroundIKTarget, leftFootPinTrackValue);
-   // Do the same for the right ankle
-   mRightAnkleFinalTarget = glm::lerp(worldPosOfRightAnkle, rightAnkleGroundIKTarget, rightFootPinTrackValue);
-
-   // Solve the IK chains of the left and right legs so that their end effectors (ankles) are at the positions we interpolated above
-   mLeftLeg.Solve(mModelTransform, currPose, mLeftAnkleFinalTarget, mSolveWithConstraints, mSelectedNumberOfIterations);
-   mRightLeg.Solve(mModelTransform, currPose, mRightAnkleFinalTarget, mSolveWithConstraints, mSelectedNumberOfIterations);
-
-   // Blend the resulting IK chains into the animated pose
-   // Note how the blend factor is equal to 1.0f
-   // We want the legs of the animated pose to be equal to the IK chains
-   Blend(currPose, mLeftLeg.GetAdjustedPose(), 1.0f, mLeftLeg.GetHipIndex(), currPose);
-   Blend(currPose, mRightLeg.GetAdjustedPose(), 1.0f, mRightLeg.GetHipIndex(), currPose);
-
-   // Toe Correction
-   // **********************************************************************************************************************************************
-
-   // Calculate the world transforms of the final ankles
-   // We do this by combining the model transform of the character (mModelTransform) with the global transforms of the joints
-   // Note the parent-child order here, which makes sense
-   Transform worldTransfOfLeftAnkle  = combine(mModelTransform, currPose.GetGlobalTransform(mLeftLeg.GetAnkleIndex()));
-   Transform worldTransfOfRightAnkle = combine(mModelTransform, currPose.GetGlobalTransform(mRightLeg.GetAnkleIndex()));
-
-   // Calculate the world positions of the toes
-   // We do this by combining the model transform of the character (mModelTransform) with the global transforms of the joints
-   // Note the parent-child order here, which makes sense
-   glm::vec3 worldPosOfLeftToe = combine(mModelTransform, currPose.GetGlobalTransform(mLeftLeg.GetToeIndex())).position;
-   glm::vec3 worldPosOfRightToe = combine(mModelTransform, currPose.GetGlobalTransform(mRightLeg.GetToeIndex())).position;
-
-   // World forward direction of character
-   glm::vec3 worldFwdDirOfCharacter = mModelTransform.rotation * glm::vec3(0.0f, 0.0f, 1.0f);
-
-   // Construct rays for the left and right toes
-   // These are composed a follows:
-   // - Start at position of the ankle
-   // - Move the origin to the height of the toe
-   // - Move the origin up by the distance between the toe and the knee
-   // - Move the origin forward by the distance between the ankle and the toe
-   // By doing this we create a ray that shoots down from the knee in front of the ankle
-   glm::vec3 originOfLeftToeRay = worldTransfOfLeftAnkle.position;
-   originOfLeftToeRay.y         = worldPosOfLeftToe.y + mHeightOfKnees;
-   originOfLeftToeRay          += worldFwdDirOfCharacter * mDistanceFromAnkleToToe;
-   Ray leftToeRay(originOfLeftToeRay, glm::vec3(0.0f, -1.0f, 0.0f));
-
-   glm::vec3 originOfRightToeRay = worldTransfOfRightAnkle.position;
-   originOfRightToeRay.y         = worldPosOfRightToe.y + mHeightOfKnees;
-   originOfRightToeRay          += worldFwdDirOfCharacter * mDistanceFromAnkleToToe;
-   Ray rightToeRay(originOfRightToeRay, glm::vec3(0.0f, -1.0f, 0.0f));
-
-   // If the rays don't hit anything, we use the positions of the toes as default values
-   glm::vec3 leftToeGroundIKTarget  = worldPosOfLeftToe;
-   glm::vec3 rightToeGroundIKTarget = worldPosOfRightToe;
-   // We use these if we hit anything above the toes
-   glm::vec3 newWorldPosOfLeftToe  = worldPosOfLeftToe;
-   glm::vec3 newWorldPosOfRightToe = worldPosOfRightToe;
-
-   // Here we do the equivalent of the following:
-   // - Shoot a ray downwards from the height of the knees to the toe
-   // - Shoot a ray downwards from the height of the knees through the toe to infinity
-   // The first ray tells us if there's ground above the toe
-   // If there is, that becomes the new position of the toe
-   // The second ray tells us if there's ground above or below the toe
-   // If there is, that becomes the new target of the IK chain
-   for (unsigned int i = 0,
-        numTriangles = static_cast<unsigned int>(mGroundTriangles.size());
-        i < numTriangles;
-        ++i)
-   {
-      if (DoesRayIntersectTriangle(leftToeRay, mGroundTriangles[i], hitPoint))
-      {
-         // Is the hit point between the toe and the knees?
-         // In other words, is it above the toe?
-         // TODO: Is there a better way to check if the hit point is above the toe?
-         if (glm::length2(hitPoint - leftToeRay.origin) < mHeightOfKnees * mHeightOfKnees)
-         {
-            // If it is, we update the position of the toe to be on the ground
-            // We do this because if there's ground above the toe, the toe should be on the ground regardless of what the pin track says
-            // In other words, here we override the animation to avoid having the toe be below ground
-            newWorldPosOfLeftToe = hitPoint;
-         }
-
-         leftToeGroundIKTarget = hitPoint;
-      }
-
-      if (DoesRayIntersectTriangle(rightToeRay, mGroundTriangles[i], hitPoint))
-      {
-         // Is the hit point between the toe and the knees?
-         // In other words, is it above the toe?
-         // TODO: Is there a better way to check if the hit point is above the toe?
-         if (glm::length2(hitPoint - rightToeRay.origin) < mHeightOfKnees * mHeightOfKnees)
-         {
-            // If it is, we update the position of the toe to be on the ground
-            // We do this because if there's ground above the toe, the toe should be on the ground regardless of what the pin track says
-            // In other words, here we override the animation to avoid having the toe be below ground
-            newWorldPosOfRightToe = hitPoint;
-         }
-
-         rightToeGroundIKTarget = hitPoint;
-      }
-   }
+   // The keyframes of the pin tracks are set in normalized time, so they must be sampled with the normalized time
+   FootPlacementInput footPlacementInput;
+   footPlacementInput.modelTransform         = mModelTransform;
+   footPlacementInput.leftFootPinTrackValue  = mIKCrossFadeController.GetCurrentLeftFootPinTrackValue();
+   footPlacementInput.rightFootPinTrackValue = mIKCrossFadeController.GetCurrentRightFootPinTrackValue();
 
-   // Interpolate between the new world position of the left toe and its ground IK target based on the value of the pin track
-   // If the pin track says that the toe should be on the ground, then the ground IK target will be favored
-   // If the pin track says that the toe should not be on the ground, the the world position of the toe, which is given by the animation clip, will be favored
-   // Note that if we detected that there's ground above the toe, newWorldPosOfLeftToe and leftToeGroundIKTarget will be the same, which means that the toe
-   // will be on the ground regardless of what the pin track says
-   newWorldPosOfLeftToe = glm::lerp(newWorldPosOfLeftToe, leftToeGroundIKTarget, leftFootPinTrackValue);
-   // Do the same for the right toes
-   newWorldPosOfRightToe = glm::lerp(newWorldPosOfRightToe, rightToeGroundIKTarget, rightFootPinTrackValue);
-
-   // Rotate the left ankle if necessary
-   glm::vec3 leftAnkleToCurrToe = worldPosOfLeftToe - worldTransfOfLeftAnkle.position;
-   glm::vec3 leftAnkleToNewToe  = newWorldPosOfLeftToe - worldTransfOfLeftAnkle.position;
-   // TODO: Use constant
-   if (glm::dot(leftAnkleToCurrToe, leftAnkleToNewToe) > 0.00001f)
-   {
-      // Construct a world rotation that goes from the current toe to the new one
-      Q::quat worldRotFromCurrToeToNewToe = Q::fromTo(leftAnkleToCurrToe, leftAnkleToNewToe);
-
-      // Apply the toe-to-toe world rotation to the world rotation of the ankle
-      Q::quat newWorldRotOfLeftAnkle = worldTransfOfLeftAnkle.rotation * worldRotFromCurrToeToNewToe;
-
-      // Multiply the new world rotation of the ankle by the inverse of its old world rotation to get:
-      // worldTransfOfLeftAnkle.rotation^-1 * newWorldRotOfAnkle = (D * C * B * A_old)^-1 * (D * C * B * A_new) = (A_old^-1 * B^-1 * C^-1 * D^-1) * (D * C * B * A_new) = A_old^-1 * A_new
-      Q::quat newLocalRotOfLeftAnkle = newWorldRotOfLeftAnkle * inverse(worldTransfOfLeftAnkle.rotation);
-
-      // Get the local transform of the left ankle
-      Transform localTransfOfLeftAnkle = currPose.GetLocalTransform(mLeftLeg.GetAnkleIndex());
-      // Multiply newLocalRotOfLeftAnkle by the old local rotation of the left ankle to get:
-      // localTransfOfLeftAnkle * newLocalRotOfLeftAnkle = A_old * A_old^-1 * A_new = A_new
-      localTransfOfLeftAnkle.rotation = newLocalRotOfLeftAnkle * localTransfOfLeftAnkle.rotation;
-      // Update the local transform of the left ankle in the pose
-      currPose.SetLocalTransform(mLeftLeg.GetAnkleIndex(), localTransfOfLeftAnkle);
-   }
+   // Find the ground below the ankles and the toes, and solve the legs so that the feet are on it
+   FootPlacementOutput footPlacementOutput;
+   mFootPlacementSystem.Run(mGroundHeightGrid, getFootPlacementSettings(), &footPlacementInput, &mFootPlacementCharacter, &currPose, &footPlacementOutput, 1);
 
-   // Rotate the right ankle if necessary
-   glm::vec3 rightAnkleToCurrToe = worldPosOfRightToe - worldTransfOfRightAnkle.position;
-   glm::vec3 rightAnkleToNewToe  = newWorldPosOfRightToe - worldTransfOfRightAnkle.position;
-   // TODO: Use constant
-   if (glm::dot(rightAnkleToCurrToe, rightAnkleToNewToe) > 0.00001f)
-   {
-      // Construct a world rotation that goes from the current toe to the new one
-      Q::quat worldRotFromCurrToeToNewToe = Q::fromTo(rightAnkleToCurrToe, rightAnkleToNewToe);
-
-      // Apply the toe-to-toe world rotation to the world rotation of the ankle
-      Q::quat newWorldRotOfRightAnkle = worldTransfOfRightAnkle.rotation * worldRotFromCurrToeToNewToe;
-
-      // Multiply the new world rotation of the ankle by the inverse of its old world rotation to get:
-      // worldTransfOfRightAnkle.rotation^-1 * newWorldRotOfAnkle = (D * C * B * A_old)^-1 * (D * C * B * A_new) = (A_old^-1 * B^-1 * C^-1 * D^-1) * (D * C * B * A_new) = A_old^-1 * A_new
-      Q::quat newLocalRotOfRightAnkle = newWorldRotOfRightAnkle * inverse(worldTransfOfRightAnkle.rotation);
-
-      // Get the local transform of the right ankle
-      Transform localTransfOfRightAnkle = currPose.GetLocalTransform(mRightLeg.GetAnkleIndex());
-      // Multiply newLocalRotOfRightAnkle by the old local rotation of the right ankle to get:
-      // localTransfOfRightAnkle * newLocalRotOfRightAnkle = A_old * A_old^-1 * A_new = A_new
-      localTransfOfRightAnkle.rotation = newLocalRotOfRightAnkle * localTransfOfRightAnkle.rotation;
-      // Update the local transform of the right ankle in the pose
-      currPose.SetLocalTransform(mRightLeg.GetAnkleIndex(), localTransfOfRightAnkle);
-   }
+   // Keep track of how many iterations the IK chains needed, averaged over the last frames so that the number is readable
+   mAverageIKIterationsPerFrame = glm::mix(mAverageIKIterationsPerFrame, static_cast<float>(footPlacementOutput.numIKIterations), 0.05f);
 
    // --- --- ---
 
@@ -724,6 +522,17 @@ void IKMovementState::update(float deltaTime)
       mSkinMatrices[i] = mPosePalette[i] * inverseBindPose[i];
    }
 
+   // Apply the morph targets of the meshes that have them, which must happen before skinning
+   // The weights are sampled from the current clip of the crossfade controller, since morph weights aren't blended during a fade
+   const FastClip* currClip = mIKCrossFadeController.GetCurrentClip();
+   if (currClip != nullptr)
+   {
+      for (unsigned int i = 0, size = (unsigned int)mAnimatedMeshes.size(); i < size; ++i)
+      {
+         mAnimatedMeshes[i].ApplyMorphTargetsOfClip(*currClip, mIKCrossFadeController.GetPlaybackTime(), mCurrentSkinningMode == SkinningMode::GPU);
+      }
+   }
+
    // Skin the meshes on the CPU if that's the current skinning mode
    if (mCurrentSkinningMode == SkinningMode::CPU)
    {
@@ -733,6 +542,18 @@ void IKMovementState::update(float deltaTime)
       }
    }
 
+   // Calculate the world space bounds of the animated meshes, which are used for frustum culling
+   // Instead of bounding the skinned vertices, we transform the bind pose bounds of each joint by its skin matrix
+   glm::mat4 modelMatrix = transformToMat4(mModelTransform);
+   mAnimatedMeshWorldBounds.resize(mAnimatedMeshes.size());
+   for (unsigned int i = 0,
+        size = static_cast<unsigned int>(mAnimatedMeshes.size());
+        i < size;
+        ++i)
+   {
+      mAnimatedMeshWorldBounds[i] = TransformAABB(modelMatrix, CalculateSkinnedAABB(mAnimatedMeshes[i].GetJointBounds(), mSkinMatrices));
+   }
+
    // Update the skeleton viewer
    mSkeletonViewer.UpdateBones(currPose, mPosePalette);
 
@@ -747,14 +568,22 @@ void IKMovementState::render()
 
    userInterface();
 
+   // Reset the culling statistics, which are accumulated over the reflection, refraction and main passes
+   mNumMeshesSubmitted = 0;
+   mNumMeshesCulled = 0;
+
+   // The reflection and refraction textures are distorted by the waves of the water, so their details are hard to see
+   // That's why we allow them to be rendered with coarser LODs than the main pass
+   unsigned int waterPassMinLODIndex = static_cast<unsigned int>(mWaterPassLODBias);
+
    mWater.BindReflectionFBO();
    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-   renderScene(glm::vec2(1.0f, mWater.GetWaterHeight() + 1.0f), calculateReflectionViewMatrix(), mCamera3.getPerspectiveProjectionMatrix(), false);
+   renderScene(glm::vec2(1.0f, mWater.GetWaterHeight() + 1.0f), calculateReflectionViewMatrix(), mCamera3.getPerspectiveProjectionMatrix(), false, waterPassMinLODIndex);
    mWater.UnbindCurrentFBO();
 
    mWater.BindRefractionFBO();
    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-   renderScene(glm::vec2(-1.0f, mWater.GetWaterHeight() + 1.0f), mCamera3.getViewMatrix(), mCamera3.getPerspectiveProjectionMatrix(), false);
+   renderScene(glm::vec2(-1.0f, mWater.GetWaterHeight() + 1.0f), mCamera3.getViewMatrix(), mCamera3.getPerspectiveProjectionMatrix(), false, waterPassMinLODIndex);
    mWater.UnbindCurrentFBO();
 
    mWindow->setViewport();
@@ -763,7 +592,7 @@ void IKMovementState::render()
    mWindow->bindMultisampleFramebuffer();
 #endif
    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-   renderScene(glm::vec2(-1.0f, 1000.0f), mCamera3.getViewMatrix(), mCamera3.getPerspectiveProjectionMatrix(), true); // TODO: Replace hacky way of disabling clipping plane
+   renderScene(glm::vec2(-1.0f, 1000.0f), mCamera3.getViewMatrix(), mCamera3.getPerspectiveProjectionMatrix(), true, 0); // TODO: Replace hacky way of disabling clipping plane
 
    ImGui::Render();
    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -788,7 +617,9 @@ void IKMovementState::render()
 
 void IKMovementState::exit()
 {
-
+   // The state doesn't play anything while it's inactive, so it lets the clip library evict its clips
+   // Entering the state again plays the idle clip from the start, which requests it again
+   mClipsInUse.clear();
 }
 
 void IKMovementState::configureLights(const std::shared_ptr<Shader>& shader, const glm::vec3& lightColor)
@@ -879,20 +710,27 @@ void IKMovementState::switchFromCPUToGPU()
                                       influencesAttribLocOfAnimatedShader);
    }
 
-   // TODO: This is inefficient. We just need to load the positions and normals.
    // Load the original positions and normals because the CPU skinning algorithm
    // has been modifying them every frame
+   // They live in the dynamic buffer, so that's the only buffer we need to reload
    for (unsigned int i = 0,
         size = static_cast<unsigned int>(mAnimatedMeshes.size());
         i < size;
         ++i)
    {
-      mAnimatedMeshes[i].LoadBuffers();
+      mAnimatedMeshes[i].LoadDynamicBuffer();
    }
 }
 
-void IKMovementState::renderScene(const glm::vec2& horizontalClippingPlaneYNormalAndHeight, const glm::mat4& viewMat, const glm::mat4 perspMat, bool renderWater)
+void IKMovementState::renderScene(const glm::vec2& horizontalClippingPlaneYNormalAndHeight, const glm::mat4& viewMat, const glm::mat4 perspMat, bool renderWater, unsigned int minLODIndex)
 {
+   // The frustum includes the horizontal clipping plane, so meshes that are entirely above or below the water are culled
+   // when rendering the refraction and reflection textures
+   Frustum frustum(perspMat * viewMat, horizontalClippingPlaneYNormalAndHeight);
+
+   // The LODs are selected based on the distance to the camera of the current pass, which is mirrored when rendering the reflection texture
+   glm::vec3 cameraPosition = glm::vec3(glm::inverse(viewMat)[3]);
+
    // Enable depth testing for 3D objects
    glEnable(GL_DEPTH_TEST);
 
@@ -919,7 +757,11 @@ void IKMovementState::renderScene(const glm::vec2& horizontalClippingPlaneYNorma
       i < size;
       ++i)
    {
-      mGroundMeshes[i].Render();
+      // The ground meshes are static and their model matrix is the identity, so their bounds are already in world space
+      if (isVisible(frustum, mGroundMeshes[i].GetBounds()))
+      {
+         mGroundMeshes[i].RenderLOD(selectLOD(mGroundMeshes[i].GetLODErrors(), mGroundMeshes[i].GetBounds(), cameraPosition, perspMat, minLODIndex));
+      }
    }
 
    mGroundDiffuseTexture->unbind(0);
@@ -951,7 +793,11 @@ void IKMovementState::renderScene(const glm::vec2& horizontalClippingPlaneYNorma
            i < size;
            ++i)
       {
-         mAnimatedMeshes[i].Render();
+         if (isVisible(frustum, mAnimatedMeshWorldBounds[i]))
+         {
+            mCharacterLODIndex = selectLOD(mCharacter->meshes[i].GetLODErrors(), mAnimatedMeshWorldBounds[i], cameraPosition, perspMat, minLODIndex);
+            mAnimatedMeshes[i].RenderLOD(mCharacterLODIndex);
+         }
       }
 
       mDiffuseTexture->unbind(0);
@@ -973,7 +819,11 @@ void IKMovementState::renderScene(const glm::vec2& horizontalClippingPlaneYNorma
            i < size;
            ++i)
       {
-         mAnimatedMeshes[i].Render();
+         if (isVisible(frustum, mAnimatedMeshWorldBounds[i]))
+         {
+            mCharacterLODIndex = selectLOD(mCharacter->meshes[i].GetLODErrors(), mAnimatedMeshWorldBounds[i], cameraPosition, perspMat, minLODIndex);
+            mAnimatedMeshes[i].RenderLOD(mCharacterLODIndex);
+         }
       }
 
       mDiffuseTexture->unbind(0);
@@ -1032,6 +882,31 @@ void IKMovementState::renderScene(const glm::vec2& horizontalClippingPlaneYNorma
    glEnable(GL_DEPTH_TEST);
 }
 
+bool IKMovementState::isVisible(const Frustum& frustum, const AABB& worldBounds)
+{
+   if (mPerformFrustumCulling && !frustum.IsAABBVisible(worldBounds))
+   {
+      ++mNumMeshesCulled;
+      return false;
+   }
+
+   ++mNumMeshesSubmitted;
+   return true;
+}
+
+unsigned int IKMovementState::selectLOD(const std::vector<float>& lodErrors, const AABB& worldBounds, const glm::vec3& cameraPosition, const glm::mat4& perspMat, unsigned int minLODIndex)
+{
+   if (!mPerformLODSelection)
+   {
+      return minLODIndex;
+   }
+
+   // The number of pixels that a world unit covers at a distance of one unit from the camera
+   float pixelsPerUnitAtUnitDistance = 0.5f * static_cast<float>(mWindow->getHeightOfViewportInPix()) * perspMat[1][1];
+
+   return SelectLOD(lodErrors, CalculateDistanceToAABB(cameraPosition, worldBounds), pixelsPerUnitAtUnitDistance, mMaxScreenSpaceErrorInPix, minLODIndex);
+}
+
 void IKMovementState::userInterface()
 {
    ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f), ImGuiCond_Appearing);
@@ -1091,10 +966,48 @@ void IKMovementState::userInterface()
       ImGui::Checkbox("Perform Depth Testing", &mPerformDepthTesting);
 #endif
 
+      ImGui::Checkbox("Frustum Culling", &mPerformFrustumCulling);
+
+      ImGui::Text("Meshes Submitted: %u, Meshes Culled: %u", mNumMeshesSubmitted, mNumMeshesCulled);
+
+      ImGui::Checkbox("Level of Detail", &mPerformLODSelection);
+
+      ImGui::SliderFloat("Max LOD Error", &mMaxScreenSpaceErrorInPix, 0.1f, 20.0f, "%.1f px");
+
+      ImGui::SliderInt("Water Pass LOD Bias", &mWaterPassLODBias, 0, 4);
+
+      ImGui::Text("Character LOD: %u", mCharacterLODIndex);
+
+      {
+         const GroundProbe* groundProbes[] = { &mRootGroundProbe,
+                                               &mFootPlacementCharacter.leftAnkleGroundProbe,
+                                               &mFootPlacementCharacter.rightAnkleGroundProbe,
+                                               &mFootPlacementCharacter.leftToeGroundProbe,
+                                               &mFootPlacementCharacter.rightToeGroundProbe };
+         unsigned int numQueries = 0, numCacheHits = 0, numNeighborHits = 0;
+         for (const GroundProbe* groundProbe : groundProbes)
+         {
+            numQueries      += groundProbe->GetNumberOfQueries();
+            numCacheHits    += groundProbe->GetNumberOfCacheHits();
+            numNeighborHits += groundProbe->GetNumberOfNeighborHits();
+         }
+
+         float invNumQueries = (numQueries > 0) ? (100.0f / static_cast<float>(numQueries)) : 0.0f;
+         ImGui::Text("Ground Probe Hits: Last %.1f%%, Neighbors %.1f%%", numCacheHits * invNumQueries, numNeighborHits * invNumQueries);
+      }
+
+      ImGui::Checkbox("Solve Analytically", &mSolveAnalytically);
+
+      ImGui::Checkbox("Solve in a Batch", &mSolveInBatch);
+
       ImGui::Checkbox("Solve with Constraints", &mSolveWithConstraints);
 
       ImGui::SliderInt("IK Iterations", &mSelectedNumberOfIterations, 0, 100);
 
+      ImGui::Checkbox("Warm Start IK", &mWarmStartIK);
+
+      ImGui::Text("IK Iterations per Frame: %.2f", mAverageIKIterationsPerFrame);
+
       ImGui::SliderFloat("Emissivity", &mSelectedEmissiveTextureBrightnessScaleFactor, 0.0f, 1.0f, "%.3f");
 
       ImGui::SliderFloat("UV Scale", &mSelectedEmissiveTextureUVScaleFactor, 0.0f, 100.0f, "%.3f");
@@ -1113,6 +1026,63 @@ void IKMovementState::resetCamera()
    mCamera3.reposition(8.0f, 15.0f, mModelTransform.position, mModelTransform.rotation, glm::vec3(0.0f, 3.0f, 0.0f), 0.0f, 90.0f, 0.0f, 90.0f);
 }
 
+const FastClip* IKMovementState::getClip(const std::string& name)
+{
+   if (name == "Jump")
+   {
+      return &mJumpClip;
+   }
+
+   if (name == "Jump2")
+   {
+      return &mJump2Clip;
+   }
+
+   std::shared_ptr<const FastClip>& clip = mClipsInUse[name];
+   if (!clip)
+   {
+      clip = mCharacter->clips->GetClip(name);
+   }
+
+   return clip.get();
+}
+
+void IKMovementState::releaseClipsThatAreNotPlaying()
+{
+   for (auto it = mClipsInUse.begin(); it != mClipsInUse.end();)
+   {
+      if (mIKCrossFadeController.IsPlaying(it->second.get()))
+      {
+         ++it;
+      }
+      else
+      {
+         it = mClipsInUse.erase(it);
+      }
+   }
+}
+
+void IKMovementState::prefetchNextClips()
+{
+   // The character can only go from idling to walking or running, from walking to running or idling and from running to walking or idling
+   ClipLibrary& clips = *mCharacter->clips;
+   if (mIsWalking)
+   {
+      clips.Prefetch("Running");
+      clips.Prefetch("Idle");
+   }
+   else if (mIsRunning)
+   {
+      clips.Prefetch("Walking");
+      clips.Prefetch("Idle");
+   }
+   else
+   {
+      clips.Prefetch("Walking");
+      clips.Prefetch("Running");
+   }
+}
+
 void IKMovementState::configurePinTracks()
 {
    // Walking pin tracks
@@ -1322,20 +1292,27 @@ void IKMovementState::determineYPosition()
    // and sink it into the ground a little so that the IK solver has room to work
    Ray groundRay(glm::vec3(mModelTransform.position.x, mHeightOfOriginOfYPositionRay, mModelTransform.position.z), glm::vec3(0.0f, -1.0f, 0.0f));
    glm::vec3 hitPoint;
-   for (unsigned int i = 0,
-        numTriangles = static_cast<unsigned int>(mGroundTriangles.size());
-        i < numTriangles;
-        ++i)
+   if (mRootGroundProbe.GetGroundPointBelow(mGroundHeightGrid, groundRay.origin, hitPoint))
    {
-      if (DoesRayIntersectTriangle(groundRay, mGroundTriangles[i], hitPoint))
-      {
-         mModelTransform.position      = hitPoint;
-         mModelTransform.position.y   -= mSinkIntoGround;
-         break;
-      }
+      mModelTransform.position      = hitPoint;
+      mModelTransform.position.y   -= mSinkIntoGround;
    }
 }
 
+FootPlacementSettings IKMovementState::getFootPlacementSettings() const
+{
+   FootPlacementSettings settings;
+   settings.heightOfHip            = mHeightOfHip;
+   settings.heightOfKnees          = mHeightOfKnees;
+   settings.distanceFromAnkleToToe = mDistanceFromAnkleToToe;
+   settings.solveAnalytically      = mSolveAnalytically;
+   settings.solveInBatch           = mSolveInBatch;
+   settings.solveWithConstraints   = mSolveWithConstraints;
+   settings.warmStart              = mWarmStartIK;
+   settings.numIterations          = mSelectedNumberOfIterations;
+   return settings;
+}
+
 glm::mat4 IKMovementState::calculateReflectionViewMatrix()
 {
    glm::vec3 cameraPos = mCamera3.getPosition();
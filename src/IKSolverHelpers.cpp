@@ -0,0 +1,13 @@
+#include "IKSolverHelpers.h"
+
+bool HasIKSolverStalled(float squaredDistToGoal, float prevSquaredDistToGoal, float minImprovementPerIteration)
+{
+   if (minImprovementPerIteration <= 0.0f)
+   {
+      return false;
+   }
+
+   // The distances are squared, so the fraction must be squared too
+   float maxRatio = 1.0f - minImprovementPerIteration;
+   return squaredDistToGoal <= prevSquaredDistToGoal && squaredDistToGoal > prevSquaredDistToGoal * maxRatio * maxRatio;
+}
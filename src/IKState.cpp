@@ -5,21 +5,24 @@
 #include <glm/gtx/norm.hpp>
 #include <glm/gtx/compatibility.hpp>
 
+#include <utility>
+
 #include "resource_manager.h"
 #include "shader_loader.h"
 #include "texture_loader.h"
 #include "GLTFLoader.h"
-#include "RearrangeBones.h"
 #include "Intersection.h"
 #include "Blending.h"
 #include "IKState.h"
 
 #ifdef USE_THIRD_PERSON_CAMERA
 IKState::IKState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
-                 const std::shared_ptr<Window>&             window)
+                 const std::shared_ptr<Window>&             window,
+                 const std::shared_ptr<AssetLoader>&        assetLoader)
 #else
 IKState::IKState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
                  const std::shared_ptr<Window>&             window,
+                 const std::shared_ptr<AssetLoader>&        assetLoader,
                  const std::shared_ptr<Camera>&             camera)
 #endif
    : mFSM(finiteStateMachine)
@@ -41,37 +44,30 @@ IKState::IKState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
    configureLights(mStaticMeshShader);
 
    // Load the diffuse texture of the animated character
-   mDiffuseTexture = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>("resources/models/woman/woman.png");
+   mDiffuseTexture = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>(assetLoader->GetImage("resources/models/woman/woman.png"));
 
    // Load the animated character
-   cgltf_data* data        = LoadGLTFFile("resources/models/woman/woman.gltf");
-   mSkeleton               = LoadSkeleton(data);
-   mAnimatedMeshes         = LoadAnimatedMeshes(data);
-   std::vector<Clip> clips = LoadClips(data);
-   FreeGLTFFile(data);
+   mCharacter = assetLoader->GetCharacter("resources/models/woman/woman.glb", "resources/models/woman/woman.bake");
+   mSkeleton  = mCharacter->skeleton;
 
-   // Rearrange the skeleton
-   JointMap jointMap = RearrangeSkeleton(mSkeleton);
-
-   // Rearrange the meshes
+   // The meshes of the state share the vertices and the static buffers of the meshes of the character,
+   // and they only store what changes when the character is animated, since each state morphs and skins its own vertices
+   mAnimatedMeshes.resize(mCharacter->meshes.size());
    for (unsigned int meshIndex = 0,
         numMeshes = static_cast<unsigned int>(mAnimatedMeshes.size());
         meshIndex < numMeshes;
         ++meshIndex)
    {
-      RearrangeMesh(mAnimatedMeshes[meshIndex], jointMap);
+      mAnimatedMeshes[meshIndex].ShareMeshData(mCharacter->meshes[meshIndex]);
    }
 
-   // Optimize the clips, rearrange them and get their names
-   mClips.resize(clips.size());
+   // Get the names of the clips
    for (unsigned int clipIndex = 0,
-        numClips = static_cast<unsigned int>(clips.size());
+        numClips = mCharacter->clips->GetNumberOfClips();
         clipIndex < numClips;
         ++clipIndex)
    {
-      mClips[clipIndex] = OptimizeClip(clips[clipIndex]);
-      RearrangeFastClip(mClips[clipIndex], jointMap);
-      mClipNames += (mClips[clipIndex].GetName() + '\0');
+      mClipNames += (mCharacter->clips->GetClipName(clipIndex) + '\0');
    }
 
    // Configure the VAOs of the animated meshes
@@ -85,6 +81,7 @@ IKState::IKState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
         i < size;
         ++i)
    {
+      mAnimatedMeshes[i].LoadBuffers();
       mAnimatedMeshes[i].ConfigureVAO(positionsAttribLocOfAnimatedShader,
                                       normalsAttribLocOfAnimatedShader,
                                       texCoordsAttribLocOfAnimatedShader,
@@ -93,7 +90,7 @@ IKState::IKState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
    }
 
    // Load the ground
-   data = LoadGLTFFile("resources/models/ground/catwalk.gltf");
+   cgltf_data* data = LoadGLTFFile("resources/models/ground/catwalk.glb");
    mGroundMeshes = LoadStaticMeshes(data);
    FreeGLTFFile(data);
 
@@ -107,16 +104,21 @@ IKState::IKState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
    {
       mGroundMeshes[i].ConfigureVAO(positionsAttribLocOfStaticShader,
                                     normalsAttribLocOfStaticShader,
-                                    texCoordsAttribLocOfStaticShader,
-                                    -1,
-                                    -1);
+                                    texCoordsAttribLocOfStaticShader);
    }
 
    // Load the texture of the ground
-   mGroundTexture = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>("resources/models/ground/catwalk_uv.png");
+   mGroundTexture = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>(assetLoader->GetImage("resources/models/ground/catwalk_uv.png"));
 
    // Get the triangles that make up the ground
-   mGroundTriangles = GetTrianglesFromMeshes(mGroundMeshes);
+   // They are read straight from the positions and indices of the meshes and stored as indices into a shared array of positions
+   IndexedTriangleStore groundTriangles;
+   groundTriangles.Build(mGroundMeshes);
+
+   // All the rays that we shoot at the ground point straight down, so we build a grid that lets us find the height of the ground
+   // at any X and Z position by only testing the triangles of a single cell
+   // The grid is the only thing that queries the triangles, so they are moved into it instead of being copied
+   mGroundHeightGrid.Build(std::move(groundTriangles));
 
    // Compose the motion track, which tells the character where to walk by supplying X and Z coordinates
    mMotionTrack.SetInterpolation(Interpolation::Linear);
@@ -153,6 +155,9 @@ IKState::IKState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
    mRightLeg = IKLeg(mSkeleton, "RightUpLeg", "RightLeg", "RightFoot", "RightToeBase");
    mRightLeg.SetAnkleOffset(0.2f); // The right ankle is 0.2 units above the ground
 
+   // The chains of the legs have 3 joints: the hip, the knee and the ankle
+   mLegBatchSolver.SetNumberOfJointsInIKChains(3);
+
    // Compose the pin track of the left foot, which tells us when the left foot is on and off the ground
    // Note that the times of the keyframes that make up this pin track are normalized, which means that
    // it must be sampled with the current time of an animation divided by its duration
@@ -208,16 +213,13 @@ IKState::IKState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
 void IKState::initializeState()
 {
    // Set the initial clip
-   unsigned int numClips = static_cast<unsigned int>(mClips.size());
-   for (unsigned int clipIndex = 0; clipIndex < numClips; ++clipIndex)
+   int walkingClipIndex = mCharacter->clips->GetClipIndex("Walking");
+   if (walkingClipIndex != -1)
    {
-      if (mClips[clipIndex].GetName() == "Walking")
-      {
-         mSelectedClip = clipIndex;
-         mAnimationData.currentClipIndex = clipIndex;
-         break;
-      }
+      mSelectedClip = walkingClipIndex;
+      mAnimationData.currentClipIndex = walkingClipIndex;
    }
+   mAnimationData.currentClip = mCharacter->clips->GetClip(mAnimationData.currentClipIndex);
 
    // Set the initial skinning mode
    mSelectedSkinningMode = SkinningMode::GPU;
@@ -233,7 +235,14 @@ void IKState::initializeState()
    mWireframeModeForTerrain = false;
    mPerformDepthTesting = true;
 #endif
+   mPerformFrustumCulling = true;
+   mNumMeshesSubmitted = 0;
+   mNumMeshesCulled = 0;
    // Set the initial IK options
+   mSolveAnalytically = false;
+   mSolveInBatch = false;
+   mWarmStartIK = false;
+   mAverageIKIterationsPerFrame = 0.0f;
    mSolveWithConstraints = true;
    mSelectedNumberOfIterations = 15;
 
@@ -248,18 +257,11 @@ void IKState::initializeState()
    // and sink it into the ground a little so that the IK solver has room to work
    Ray groundRay(glm::vec3(mModelTransform.position.x, mHeightOfOriginOfYPositionRay, mModelTransform.position.z), glm::vec3(0.0f, -1.0f, 0.0f));
    glm::vec3 hitPoint;
-   for (unsigned int i = 0,
-        numTriangles = static_cast<unsigned int>(mGroundTriangles.size());
-        i < numTriangles;
-        ++i)
+   if (mGroundHeightGrid.GetGroundPointBelow(groundRay.origin, hitPoint))
    {
-      if (DoesRayIntersectTriangle(groundRay, mGroundTriangles[i], hitPoint))
-      {
-         mModelTransform.position      = hitPoint;
-         mModelTransform.position.y   -= mSinkIntoGround;
-         mPreviousYPositionOfCharacter = mModelTransform.position.y;
-         break;
-      }
+      mModelTransform.position      = hitPoint;
+      mModelTransform.position.y   -= mSinkIntoGround;
+      mPreviousYPositionOfCharacter = mModelTransform.position.y;
    }
 }
 
@@ -460,17 +462,10 @@ void IKState::update(float deltaTime)
    // and sink it into the ground a little so that the IK solver has room to work
    Ray groundRay(glm::vec3(mModelTransform.position.x, mHeightOfOriginOfYPositionRay, mModelTransform.position.z), glm::vec3(0.0f, -1.0f, 0.0f));
    glm::vec3 hitPoint;
-   for (unsigned int i = 0,
-        numTriangles = static_cast<unsigned int>(mGroundTriangles.size());
-        i < numTriangles;
-        ++i)
+   if (mGroundHeightGrid.GetGroundPointBelow(groundRay.origin, hitPoint))
    {
-      if (DoesRayIntersectTriangle(groundRay, mGroundTriangles[i], hitPoint))
-      {
-         mModelTransform.position = hitPoint;
-         mModelTransform.position.y -= mSinkIntoGround;
-         break;
-      }
+      mModelTransform.position = hitPoint;
+      mModelTransform.position.y -= mSinkIntoGround;
    }
 
    // Calculate the new forward direction of the character in world space
@@ -492,6 +487,7 @@ void IKState::update(float deltaTime)
    if (mAnimationData.currentClipIndex != mSelectedClip)
    {
       mAnimationData.currentClipIndex = mSelectedClip;
+      mAnimationData.currentClip      = mCharacter->clips->GetClip(mAnimationData.currentClipIndex);
       mAnimationData.animatedPose     = mSkeleton.GetRestPose();
       mAnimationData.playbackTime     = 0.0f;
    }
@@ -511,7 +507,7 @@ void IKState::update(float deltaTime)
    }
 
    // Sample the clip to get the animated pose
-   FastClip& currClip = mClips[mAnimationData.currentClipIndex];
+   const FastClip& currClip = *mAnimationData.currentClip;
    mAnimationData.playbackTime = currClip.Sample(mAnimationData.animatedPose, mAnimationData.playbackTime + deltaTime);
 
    // --- --- ---
@@ -546,42 +542,36 @@ void IKState::update(float deltaTime)
    // If there is, that becomes the new position of the ankle
    // The second ray tells us if there's ground above or below the ankle
    // If there is, that becomes the new target of the IK chain
-   for (unsigned int i = 0,
-        numTriangles = static_cast<unsigned int>(mGroundTriangles.size());
-        i < numTriangles;
-        ++i)
+   if (mGroundHeightGrid.GetGroundPointBelow(leftAnkleRay.origin, hitPoint))
    {
-      if (DoesRayIntersectTriangle(leftAnkleRay, mGroundTriangles[i], hitPoint))
+      // Is the hit point between the ankle and the hip?
+      // In other words, is it above the ankle?
+      // TODO: Is there a better way to check if the hit point is above the ankle?
+      if (glm::length2(hitPoint - leftAnkleRay.origin) < mHeightOfHip * mHeightOfHip)
       {
-         // Is the hit point between the ankle and the hip?
-         // In other words, is it above the ankle?
-         // TODO: Is there a better way to check if the hit point is above the ankle?
-         if (glm::length2(hitPoint - leftAnkleRay.origin) < mHeightOfHip * mHeightOfHip)
-         {
-            // If it is, we update the position of the ankle to be on the ground
-            // We do this because if there's ground above the ankle, the foot should be on the ground regardless of what the pin track says
-            // In other words, here we override the animation to avoid having the foot be below ground
-            worldPosOfLeftAnkle = hitPoint;
-         }
-
-         leftAnkleGroundIKTarget = hitPoint;
+         // If it is, we update the position of the ankle to be on the ground
+         // We do this because if there's ground above the ankle, the foot should be on the ground regardless of what the pin track says
+         // In other words, here we override the animation to avoid having the foot be below ground
+         worldPosOfLeftAnkle = hitPoint;
       }
 
-      if (DoesRayIntersectTriangle(rightAnkleRay, mGroundTriangles[i], hitPoint))
-      {
-         // Is the hit point between the ankle and the hip?
-         // In other words, is it above the ankle?
-         // TODO: Is there a better way to check if the hit point is above the ankle?
-         if (glm::length2(hitPoint - rightAnkleRay.origin) < mHeightOfHip * mHeightOfHip)
-         {
-            // If it is, we update the position of the ankle to be on the ground
-            // We do this because if there's ground above the ankle, the foot should be on the ground regardless of what the pin track says
-            // In other words, here we override the animation to avoid having the foot be below ground
-            worldPosOfRightAnkle = hitPoint;
-         }
+      leftAnkleGroundIKTarget = hitPoint;
+   }
 
-         rightAnkleGroundIKTarget = hitPoint;
+   if (mGroundHeightGrid.GetGroundPointBelow(rightAnkleRay.origin, hitPoint))
+   {
+      // Is the hit point between the ankle and the hip?
+      // In other words, is it above the ankle?
+      // TODO: Is there a better way to check if the hit point is above the ankle?
+      if (glm::length2(hitPoint - rightAnkleRay.origin) < mHeightOfHip * mHeightOfHip)
+      {
+         // If it is, we update the position of the ankle to be on the ground
+         // We do this because if there's ground above the ankle, the foot should be on the ground regardless of what the pin track says
+         // In other words, here we override the animation to avoid having the foot be below ground
+         worldPosOfRightAnkle = hitPoint;
       }
+
+      rightAnkleGroundIKTarget = hitPoint;
    }
 
    // Create a vector with the current X and Z position values of the character and the old Y value
@@ -606,14 +596,35 @@ void IKState::update(float deltaTime)
    worldPosOfRightAnkle = glm::lerp(worldPosOfRightAnkle, rightAnkleGroundIKTarget, rightLegPinTrackValue);
 
    // Solve the IK chains of the left and right legs so that their end effectors (ankles) are at the positions we interpolated above
-   mLeftLeg.Solve(mModelTransform, mAnimationData.animatedPose, worldPosOfLeftAnkle, mSolveWithConstraints, mSelectedNumberOfIterations);
-   mRightLeg.Solve(mModelTransform, mAnimationData.animatedPose, worldPosOfRightAnkle, mSolveWithConstraints, mSelectedNumberOfIterations);
+   if (mSolveAnalytically)
+   {
+      mLeftLeg.SolveAnalytically(mModelTransform, mAnimationData.animatedPose, worldPosOfLeftAnkle);
+      mRightLeg.SolveAnalytically(mModelTransform, mAnimationData.animatedPose, worldPosOfRightAnkle);
+   }
+   else if (mSolveInBatch)
+   {
+      mLegBatchSolver.Clear();
+      mLegBatchSolver.SetNumberOfIterations(mSelectedNumberOfIterations);
+      mLeftLeg.SubmitToBatch(mLegBatchSolver, mModelTransform, mAnimationData.animatedPose, worldPosOfLeftAnkle);
+      mRightLeg.SubmitToBatch(mLegBatchSolver, mModelTransform, mAnimationData.animatedPose, worldPosOfRightAnkle);
+      mLegBatchSolver.Solve();
+      mLeftLeg.RetrieveFromBatch(mLegBatchSolver, mModelTransform, mAnimationData.animatedPose, mSolveWithConstraints);
+      mRightLeg.RetrieveFromBatch(mLegBatchSolver, mModelTransform, mAnimationData.animatedPose, mSolveWithConstraints);
+   }
+   else
+   {
+      mLeftLeg.Solve(mModelTransform, mAnimationData.animatedPose, worldPosOfLeftAnkle, mSolveWithConstraints, mSelectedNumberOfIterations, mWarmStartIK);
+      mRightLeg.Solve(mModelTransform, mAnimationData.animatedPose, worldPosOfRightAnkle, mSolveWithConstraints, mSelectedNumberOfIterations, mWarmStartIK);
+   }
 
-   // Blend the resulting IK chains into the animated pose
-   // Note how the blend factor is equal to 1.0f
-   // We want the legs of the animated pose to be equal to the IK chains
-   Blend(mAnimationData.animatedPose, mLeftLeg.GetAdjustedPose(), 1.0f, mLeftLeg.GetHipIndex(), mAnimationData.animatedPose);
-   Blend(mAnimationData.animatedPose, mRightLeg.GetAdjustedPose(), 1.0f, mRightLeg.GetHipIndex(), mAnimationData.animatedPose);
+   // Keep track of how many iterations the IK chains needed, averaged over the last frames so that the number is readable
+   unsigned int numIKIterations = mLeftLeg.GetNumberOfIterationsOfLastSolve() + mRightLeg.GetNumberOfIterationsOfLastSolve();
+   mAverageIKIterationsPerFrame = glm::mix(mAverageIKIterationsPerFrame, static_cast<float>(numIKIterations), 0.05f);
+
+   // Write the resulting IK chains into the animated pose
+   // Only the hips, knees and ankles change when the legs are solved, so those are the only joints that we need to write
+   mLeftLeg.ApplySolvedChainToPose(mAnimationData.animatedPose);
+   mRightLeg.ApplySolvedChainToPose(mAnimationData.animatedPose);
 
    // Toe Correction
    // **********************************************************************************************************************************************
@@ -664,42 +675,36 @@ void IKState::update(float deltaTime)
    // If there is, that becomes the new position of the toe
    // The second ray tells us if there's ground above or below the toe
    // If there is, that becomes the new target of the IK chain
-   for (unsigned int i = 0,
-        numTriangles = static_cast<unsigned int>(mGroundTriangles.size());
-        i < numTriangles;
-        ++i)
+   if (mGroundHeightGrid.GetGroundPointBelow(leftToeRay.origin, hitPoint))
    {
-      if (DoesRayIntersectTriangle(leftToeRay, mGroundTriangles[i], hitPoint))
+      // Is the hit point between the toe and the knees?
+      // In other words, is it above the toe?
+      // TODO: Is there a better way to check if the hit point is above the toe?
+      if (glm::length2(hitPoint - leftToeRay.origin) < mHeightOfKnees * mHeightOfKnees)
       {
-         // Is the hit point between the toe and the knees?
-         // In other words, is it above the toe?
-         // TODO: Is there a better way to check if the hit point is above the toe?
-         if (glm::length2(hitPoint - leftToeRay.origin) < mHeightOfKnees * mHeightOfKnees)
-         {
-            // If it is, we update the position of the toe to be on the ground
-            // We do this because if there's ground above the toe, the toe should be on the ground regardless of what the pin track says
-            // In other words, here we override the animation to avoid having the toe be below ground
-            newWorldPosOfLeftToe = hitPoint;
-         }
-
-         leftToeGroundIKTarget = hitPoint;
+         // If it is, we update the position of the toe to be on the ground
+         // We do this because if there's ground above the toe, the toe should be on the ground regardless of what the pin track says
+         // In other words, here we override the animation to avoid having the toe be below ground
+         newWorldPosOfLeftToe = hitPoint;
       }
 
-      if (DoesRayIntersectTriangle(rightToeRay, mGroundTriangles[i], hitPoint))
-      {
-         // Is the hit point between the toe and the knees?
-         // In other words, is it above the toe?
-         // TODO: Is there a better way to check if the hit point is above the toe?
-         if (glm::length2(hitPoint - rightToeRay.origin) < mHeightOfKnees * mHeightOfKnees)
-         {
-            // If it is, we update the position of the toe to be on the ground
-            // We do this because if there's ground above the toe, the toe should be on the ground regardless of what the pin track says
-            // In other words, here we override the animation to avoid having the toe be below ground
-            newWorldPosOfRightToe = hitPoint;
-         }
+      leftToeGroundIKTarget = hitPoint;
+   }
 
-         rightToeGroundIKTarget = hitPoint;
+   if (mGroundHeightGrid.GetGroundPointBelow(rightToeRay.origin, hitPoint))
+   {
+      // Is the hit point between the toe and the knees?
+      // In other words, is it above the toe?
+      // TODO: Is there a better way to check if the hit point is above the toe?
+      if (glm::length2(hitPoint - rightToeRay.origin) < mHeightOfKnees * mHeightOfKnees)
+      {
+         // If it is, we update the position of the toe to be on the ground
+         // We do this because if there's ground above the toe, the toe should be on the ground regardless of what the pin track says
+         // In other words, here we override the animation to avoid having the toe be below ground
+         newWorldPosOfRightToe = hitPoint;
       }
+
+      rightToeGroundIKTarget = hitPoint;
    }
 
    // Interpolate between the new world position of the left toe and its ground IK target based on the value of the pin track
@@ -778,6 +783,12 @@ void IKState::update(float deltaTime)
       mAnimationData.skinMatrices[i] = mAnimationData.animatedPosePalette[i] * inverseBindPose[i];
    }
 
+   // Apply the morph targets of the meshes that have them, which must happen before skinning
+   for (unsigned int i = 0, size = (unsigned int)mAnimatedMeshes.size(); i < size; ++i)
+   {
+      mAnimatedMeshes[i].ApplyMorphTargetsOfClip(currClip, mAnimationData.playbackTime, mAnimationData.currentSkinningMode == SkinningMode::GPU);
+   }
+
    // Skin the meshes on the CPU if that's the current skinning mode
    if (mAnimationData.currentSkinningMode == SkinningMode::CPU)
    {
@@ -787,6 +798,18 @@ void IKState::update(float deltaTime)
       }
    }
 
+   // Calculate the world space bounds of the animated meshes, which are used for frustum culling
+   // Instead of bounding the skinned vertices, we transform the bind pose bounds of each joint by its skin matrix
+   glm::mat4 modelMatrix = transformToMat4(mModelTransform);
+   mAnimatedMeshWorldBounds.resize(mAnimatedMeshes.size());
+   for (unsigned int i = 0,
+        size = static_cast<unsigned int>(mAnimatedMeshes.size());
+        i < size;
+        ++i)
+   {
+      mAnimatedMeshWorldBounds[i] = TransformAABB(modelMatrix, CalculateSkinnedAABB(mAnimatedMeshes[i].GetJointBounds(), mAnimationData.skinMatrices));
+   }
+
    // Update the skeleton viewer
    mSkeletonViewer.UpdateBones(mAnimationData.animatedPose, mAnimationData.animatedPosePalette);
 }
@@ -807,6 +830,15 @@ void IKState::render()
    // Enable depth testing for 3D objects
    glEnable(GL_DEPTH_TEST);
 
+   // Reset the culling statistics and extract the planes of the frustum of the camera
+   mNumMeshesSubmitted = 0;
+   mNumMeshesCulled = 0;
+#ifdef USE_THIRD_PERSON_CAMERA
+   Frustum frustum(mCamera3.getPerspectiveProjectionViewMatrix());
+#else
+   Frustum frustum(mCamera->getPerspectiveProjectionViewMatrix());
+#endif
+
 #ifndef __EMSCRIPTEN__
    if (mWireframeModeForTerrain)
    {
@@ -831,7 +863,11 @@ void IKState::render()
       i < size;
       ++i)
    {
-      mGroundMeshes[i].Render();
+      // The ground meshes are static and their model matrix is the identity, so their bounds are already in world space
+      if (isVisible(frustum, mGroundMeshes[i].GetBounds()))
+      {
+         mGroundMeshes[i].Render();
+      }
    }
 
    mGroundTexture->unbind(0);
@@ -866,7 +902,10 @@ void IKState::render()
            i < size;
            ++i)
       {
-         mAnimatedMeshes[i].Render();
+         if (isVisible(frustum, mAnimatedMeshWorldBounds[i]))
+         {
+            mAnimatedMeshes[i].Render();
+         }
       }
 
       mDiffuseTexture->unbind(0);
@@ -892,7 +931,10 @@ void IKState::render()
            i < size;
            ++i)
       {
-         mAnimatedMeshes[i].Render();
+         if (isVisible(frustum, mAnimatedMeshWorldBounds[i]))
+         {
+            mAnimatedMeshes[i].Render();
+         }
       }
 
       mDiffuseTexture->unbind(0);
@@ -959,7 +1001,9 @@ void IKState::render()
 
 void IKState::exit()
 {
-
+   // The state doesn't play anything while it's inactive, so it lets the clip library evict its clip
+   // Entering the state again requests the clip again
+   mAnimationData.currentClip = nullptr;
 }
 
 void IKState::configureLights(const std::shared_ptr<Shader>& shader)
@@ -1074,18 +1118,30 @@ void IKState::switchFromCPUToGPU()
                                       influencesAttribLocOfAnimatedShader);
    }
 
-   // TODO: This is inefficient. We just need to load the positions and normals.
    // Load the original positions and normals because the CPU skinning algorithm
    // has been modifying them every frame
+   // They live in the dynamic buffer, so that's the only buffer we need to reload
    for (unsigned int i = 0,
         size = static_cast<unsigned int>(mAnimatedMeshes.size());
         i < size;
         ++i)
    {
-      mAnimatedMeshes[i].LoadBuffers();
+      mAnimatedMeshes[i].LoadDynamicBuffer();
    }
 }
 
+bool IKState::isVisible(const Frustum& frustum, const AABB& worldBounds)
+{
+   if (mPerformFrustumCulling && !frustum.IsAABBVisible(worldBounds))
+   {
+      ++mNumMeshesCulled;
+      return false;
+   }
+
+   ++mNumMeshesSubmitted;
+   return true;
+}
+
 void IKState::userInterface()
 {
    ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f), ImGuiCond_Appearing);
@@ -1124,7 +1180,7 @@ void IKState::userInterface()
 
       ImGui::SliderFloat("Playback Speed", &mSelectedPlaybackSpeed, 0.0f, 2.0f, "%.3f");
 
-      float durationOfCurrClip = mClips[mAnimationData.currentClipIndex].GetDuration();
+      float durationOfCurrClip = mAnimationData.currentClip->GetDuration();
       char progress[32];
       snprintf(progress, 32, "%.3f / %.3f", mAnimationData.playbackTime, durationOfCurrClip);
       ImGui::ProgressBar(mAnimationData.playbackTime / durationOfCurrClip, ImVec2(0.0f, 0.0f), progress);
@@ -1148,9 +1204,21 @@ void IKState::userInterface()
       ImGui::Checkbox("Perform Depth Testing", &mPerformDepthTesting);
 #endif
 
+      ImGui::Checkbox("Frustum Culling", &mPerformFrustumCulling);
+
+      ImGui::Text("Meshes Submitted: %u, Meshes Culled: %u", mNumMeshesSubmitted, mNumMeshesCulled);
+
+      ImGui::Checkbox("Solve Analytically", &mSolveAnalytically);
+
+      ImGui::Checkbox("Solve in a Batch", &mSolveInBatch);
+
       ImGui::Checkbox("Solve with Constraints", &mSolveWithConstraints);
 
       ImGui::SliderInt("IK Iterations", &mSelectedNumberOfIterations, 0, 100);
+
+      ImGui::Checkbox("Warm Start IK", &mWarmStartIK);
+
+      ImGui::Text("IK Iterations per Frame: %.2f", mAverageIKIterationsPerFrame);
    }
 
    ImGui::End();
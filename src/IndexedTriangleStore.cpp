@@ -0,0 +1,145 @@
+#include "IndexedTriangleStore.h"
+
+TriangleView::TriangleView()
+   : mPositions(nullptr)
+   , mIndices(nullptr)
+   , mNumVertices(0)
+   , mNumTriangles(0)
+{
+
+}
+
+TriangleView::TriangleView(const StaticMesh& mesh)
+   : TriangleView(mesh.GetPositions(), mesh.GetIndices())
+{
+
+}
+
+TriangleView::TriangleView(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices)
+   : mPositions(positions.data())
+   , mIndices(indices.empty() ? nullptr : indices.data())
+   , mNumVertices(static_cast<unsigned int>(positions.size()))
+   , mNumTriangles(static_cast<unsigned int>(indices.empty() ? positions.size() : indices.size()) / 3)
+{
+
+}
+
+unsigned int TriangleView::GetNumberOfTriangles() const
+{
+   return mNumTriangles;
+}
+
+unsigned int TriangleView::GetNumberOfVertices() const
+{
+   return mNumVertices;
+}
+
+const glm::vec3& TriangleView::GetPosition(unsigned int vertexIndex) const
+{
+   return mPositions[vertexIndex];
+}
+
+glm::uvec3 TriangleView::GetIndicesOfTriangle(unsigned int triangleIndex) const
+{
+   unsigned int firstIndex = triangleIndex * 3;
+   if (mIndices == nullptr)
+   {
+      return glm::uvec3(firstIndex, firstIndex + 1, firstIndex + 2);
+   }
+
+   return glm::uvec3(mIndices[firstIndex], mIndices[firstIndex + 1], mIndices[firstIndex + 2]);
+}
+
+Triangle TriangleView::GetTriangle(unsigned int triangleIndex) const
+{
+   glm::uvec3 indices = GetIndicesOfTriangle(triangleIndex);
+   return Triangle(mPositions[indices.x], mPositions[indices.y], mPositions[indices.z]);
+}
+
+IndexedTriangleStore::IndexedTriangleStore()
+   : mPositions()
+   , mTriangles()
+{
+
+}
+
+void IndexedTriangleStore::Build(const std::vector<StaticMesh>& meshes)
+{
+   Clear();
+
+   // Count the vertices and the triangles of all the meshes first, so that the arrays are allocated once
+   unsigned int numVertices  = 0;
+   unsigned int numTriangles = 0;
+   for (const StaticMesh& mesh : meshes)
+   {
+      TriangleView view(mesh);
+      numVertices  += view.GetNumberOfVertices();
+      numTriangles += view.GetNumberOfTriangles();
+   }
+
+   Reserve(numVertices, numTriangles);
+
+   for (const StaticMesh& mesh : meshes)
+   {
+      AddTriangles(TriangleView(mesh));
+   }
+}
+
+void IndexedTriangleStore::Clear()
+{
+   mPositions.clear();
+   mTriangles.clear();
+}
+
+void IndexedTriangleStore::Reserve(unsigned int numVertices, unsigned int numTriangles)
+{
+   mPositions.reserve(numVertices);
+   mTriangles.reserve(numTriangles);
+}
+
+void IndexedTriangleStore::AddTriangles(const TriangleView& view)
+{
+   // The indices of the view refer to its own vertices, so they must be offset by the number of vertices that were added before them
+   unsigned int firstVertex = static_cast<unsigned int>(mPositions.size());
+
+   for (unsigned int vertexIndex = 0, numVertices = view.GetNumberOfVertices(); vertexIndex < numVertices; ++vertexIndex)
+   {
+      mPositions.push_back(view.GetPosition(vertexIndex));
+   }
+
+   for (unsigned int triangleIndex = 0, numTriangles = view.GetNumberOfTriangles(); triangleIndex < numTriangles; ++triangleIndex)
+   {
+      mTriangles.push_back(view.GetIndicesOfTriangle(triangleIndex) + glm::uvec3(firstVertex));
+   }
+}
+
+unsigned int IndexedTriangleStore::GetNumberOfTriangles() const
+{
+   return static_cast<unsigned int>(mTriangles.size());
+}
+
+unsigned int IndexedTriangleStore::GetNumberOfVertices() const
+{
+   return static_cast<unsigned int>(mPositions.size());
+}
+
+const glm::vec3& IndexedTriangleStore::GetPosition(unsigned int vertexIndex) const
+{
+   return mPositions[vertexIndex];
+}
+
+const glm::uvec3& IndexedTriangleStore::GetIndicesOfTriangle(unsigned int triangleIndex) const
+{
+   return mTriangles[triangleIndex];
+}
+
+Triangle IndexedTriangleStore::GetTriangle(unsigned int triangleIndex) const
+{
+   const glm::uvec3& indices = mTriangles[triangleIndex];
+   return Triangle(mPositions[indices.x], mPositions[indices.y], mPositions[indices.z]);
+}
+
+size_t IndexedTriangleStore::GetSizeInBytes() const
+{
+   return (mPositions.size() * sizeof(glm::vec3)) + (mTriangles.size() * sizeof(glm::uvec3));
+}
@@ -1,4 +1,22 @@
+#include <glm/gtx/norm.hpp>
+
 #include "Intersection.h"
+#include "IndexedTriangleStore.h"
+
+namespace IntersectionHelpers
+{
+   // Rays whose directions are this close to being perpendicular to the normal of a triangle are treated as parallel to it
+   const float minRayDirDotNormal = 0.0000001f;
+
+   // Segments whose squared lengths are smaller than this are treated as points
+   const float minSegmentLengthSq = 0.0000001f;
+
+   // A sphere whose displacement is this close to being parallel to an edge can only hit the ends of the edge
+   const float minNonParallelSweepCoefficient = 0.0000001f;
+
+   // Closest points that are closer than this are considered to be touching, so the direction between them is undefined
+   const float minSeparationDistance = 0.000001f;
+}
 
 /*
    To determine if a ray intersects a triangle, we first check if the ray intersects the plane in which the triangle lies
@@ -77,23 +95,32 @@
 
 bool DoesRayIntersectTriangle(const Ray& ray, const Triangle& triangle, glm::vec3& hitPoint)
 {
+   float distAlongRayToHit;
+   return DoesRayIntersectTriangle(ray, triangle, hitPoint, distAlongRayToHit);
+}
+
+// This function is identical to the one above, except that it also returns the distance along the ray to the hit point,
+// which is needed to find the closest hit when a ray intersects multiple triangles
+bool DoesRayIntersectTriangle(const Ray& ray, const Triangle& triangle, glm::vec3& hitPoint, float& distAlongRayToHit)
+{
+   using namespace IntersectionHelpers;
+
    // Calculate the denominator of the solved plane equation:
    // t = ((A dot N) - (origin dot N)) / (direction dot N)
    float rayDirDotNormal = glm::dot(ray.direction, triangle.normal);
 
    // If the ray is perpendicular to the normal of the triangle, the ray and the plane in which the triangle lies are parallel
-   // TODO: Use constant here
    // NOTE: This check has been updated to also exclude triangles whose normal points in the same direction as the ray by adding this:
    //       rayDirDotNormal > 0
    //       When that is the case, the ray is hitting the backface of the triangle, which is why we want to ignore it
-   if (rayDirDotNormal > 0 || glm::abs(rayDirDotNormal) < 0.0000001f)
+   if (rayDirDotNormal > 0 || glm::abs(rayDirDotNormal) < minRayDirDotNormal)
    {
       return false;
    }
 
    // Evaluate the solved plane equation:
    // t = ((A dot N) - (origin dot N)) / (direction dot N)
-   float distAlongRayToHit = (glm::dot(triangle.vertexA, triangle.normal) - glm::dot(ray.origin, triangle.normal)) / rayDirDotNormal;
+   distAlongRayToHit = (glm::dot(triangle.vertexA, triangle.normal) - glm::dot(ray.origin, triangle.normal)) / rayDirDotNormal;
 
    // If the distance along to the ray to the hit point is negative, the plane in which the triangle lies is behind the origin of the ray
    if (distAlongRayToHit < 0)
@@ -145,74 +172,492 @@ bool DoesRayIntersectTriangle(const Ray& ray, const Triangle& triangle, glm::vec
    return true;
 }
 
-// TODO: Resize array of triangles using indices.size() / 3 and emplace_back every Triangle
-std::vector<Triangle> GetTrianglesFromMesh(AnimatedMesh& mesh)
+/*
+   The function below implements the Moller-Trumbore test, which skips the plane equation and calculates the barycentric coordinates of the hit point directly
+
+   The hit point must satisfy both the equation of the ray and the parametric equation of the triangle:
+
+   origin + (direction * t) = A + (u * (B - A)) + (v * (C - A))
+
+   If we rearrange it, we obtain a linear system with three unknowns (t, u and v):
+
+   | -direction  (B - A)  (C - A) | * | t u v | = origin - A
+
+   Which can be solved with Cramer's rule, where each determinant is calculated with a scalar triple product:
+
+   det = (B - A) dot (direction x (C - A))
+   u   = ((origin - A) dot (direction x (C - A))) / det
+   v   = (direction dot ((origin - A) x (B - A))) / det
+   t   = ((C - A) dot ((origin - A) x (B - A))) / det
+
+   The determinant is equal to -(direction dot N), where N is the unnormalized normal of the triangle,
+   so rejecting negative determinants also rejects the backfaces, just like the function above does
+   The hit point lies inside the triangle if u >= 0, v >= 0 and u + v <= 1
+*/
+bool DoesRayIntersectTriangle(const Ray& ray, const PrecomputedTriangle& triangle, glm::vec3& hitPoint, float& distAlongRayToHit)
 {
-   std::vector<Triangle> triangles;
+   glm::vec3 p = glm::cross(ray.direction, triangle.edgeAC);
+   float det = glm::dot(triangle.edgeAB, p);
+
+   // If the determinant is close to zero, the ray is parallel to the triangle
+   // If it's negative, the ray is hitting the backface of the triangle
+   if (det < minMollerTrumboreDeterminant)
+   {
+      return false;
+   }
+
+   float invDet = 1.0f / det;
+
+   glm::vec3 originToA = ray.origin - triangle.vertexA;
+   float u = glm::dot(originToA, p) * invDet;
+   if (u < 0.0f || u > 1.0f)
+   {
+      return false;
+   }
+
+   glm::vec3 q = glm::cross(originToA, triangle.edgeAB);
+   float v = glm::dot(ray.direction, q) * invDet;
+   if (v < 0.0f || (u + v) > 1.0f)
+   {
+      return false;
+   }
+
+   distAlongRayToHit = glm::dot(triangle.edgeAC, q) * invDet;
+   if (distAlongRayToHit < 0.0f)
+   {
+      return false;
+   }
+
+   hitPoint = (ray.direction * distAlongRayToHit) + ray.origin;
+   return true;
+}
+
+/*
+   The functions below are used by StaticCollisionWorld to collide spheres and capsules with triangles
+
+   Every test is built on top of the closest point on a triangle to a given point, which is found by figuring out which feature of the triangle
+   (one of its vertices, one of its edges or its face) is closest to the point
+
+   This is done by calculating the barycentric coordinates of the projection of the point onto the plane of the triangle
+   and checking their signs one feature at a time (see Real-Time Collision Detection by Christer Ericson, section 5.1.5)
+*/
+glm::vec3 CalculateClosestPointOnTriangle(const glm::vec3& point, const Triangle& triangle)
+{
+   const glm::vec3& a = triangle.vertexA;
+   const glm::vec3& b = triangle.vertexB;
+   const glm::vec3& c = triangle.vertexC;
+
+   glm::vec3 ab = b - a;
+   glm::vec3 ac = c - a;
+
+   // Check if the point is in the region of vertex A
+   glm::vec3 ap = point - a;
+   float d1 = glm::dot(ab, ap);
+   float d2 = glm::dot(ac, ap);
+   if (d1 <= 0.0f && d2 <= 0.0f)
+   {
+      return a;
+   }
 
-   std::vector<glm::vec3>    positions = mesh.GetPositions();
-   std::vector<unsigned int> indices   = mesh.GetIndices();
+   // Check if the point is in the region of vertex B
+   glm::vec3 bp = point - b;
+   float d3 = glm::dot(ab, bp);
+   float d4 = glm::dot(ac, bp);
+   if (d3 >= 0.0f && d4 <= d3)
+   {
+      return b;
+   }
 
-   if (indices.size() == 0)
+   // Check if the point is in the region of edge AB
+   float vc = (d1 * d4) - (d3 * d2);
+   if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
    {
-      // If the mesh doesn't have indices, each sequential set of 3 positions makes up a triangle
-      unsigned int numPositions = static_cast<unsigned int>(positions.size());
-      for (unsigned int i = 0; i < numPositions; i += 3)
+      return a + ab * (d1 / (d1 - d3));
+   }
+
+   // Check if the point is in the region of vertex C
+   glm::vec3 cp = point - c;
+   float d5 = glm::dot(ab, cp);
+   float d6 = glm::dot(ac, cp);
+   if (d6 >= 0.0f && d5 <= d6)
+   {
+      return c;
+   }
+
+   // Check if the point is in the region of edge CA
+   float vb = (d5 * d2) - (d1 * d6);
+   if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+   {
+      return a + ac * (d2 / (d2 - d6));
+   }
+
+   // Check if the point is in the region of edge BC
+   float va = (d3 * d6) - (d5 * d4);
+   if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+   {
+      return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+   }
+
+   // The point is in the region of the face, so we return its projection onto the plane of the triangle
+   float denom = 1.0f / (va + vb + vc);
+   return a + (ab * (vb * denom)) + (ac * (vc * denom));
+}
+
+/*
+   The closest points between two segments are found by writing both segments in parametric form:
+
+   P1(s) = start1 + (s * (end1 - start1))
+   P2(t) = start2 + (t * (end2 - start2))
+
+   Minimizing the squared distance between P1(s) and P2(t) results in a 2x2 linear system that is solved for s,
+   after which t is calculated from s, and both are clamped to the [0, 1] range (see Real-Time Collision Detection by Christer Ericson, section 5.1.9)
+*/
+float CalculateClosestPointsBetweenSegments(const glm::vec3& start1, const glm::vec3& end1, const glm::vec3& start2, const glm::vec3& end2,
+                                            glm::vec3& outClosestPoint1, glm::vec3& outClosestPoint2)
+{
+   const float epsilon = IntersectionHelpers::minSegmentLengthSq;
+
+   glm::vec3 d1 = end1 - start1;
+   glm::vec3 d2 = end2 - start2;
+   glm::vec3 r  = start1 - start2;
+   float a = glm::dot(d1, d1);
+   float e = glm::dot(d2, d2);
+   float f = glm::dot(d2, r);
+
+   float s, t;
+   if (a <= epsilon && e <= epsilon)
+   {
+      // Both segments are points
+      s = 0.0f;
+      t = 0.0f;
+   }
+   else if (a <= epsilon)
+   {
+      // The first segment is a point
+      s = 0.0f;
+      t = glm::clamp(f / e, 0.0f, 1.0f);
+   }
+   else
+   {
+      float c = glm::dot(d1, r);
+      if (e <= epsilon)
+      {
+         // The second segment is a point
+         t = 0.0f;
+         s = glm::clamp(-c / a, 0.0f, 1.0f);
+      }
+      else
       {
-         triangles.push_back(Triangle(positions[i + 0],
-                                      positions[i + 1],
-                                      positions[i + 2]));
+         // If the segments are parallel, any s is valid, so we pick zero
+         float b     = glm::dot(d1, d2);
+         float denom = (a * e) - (b * b);
+         s = (denom != 0.0f) ? glm::clamp(((b * f) - (c * e)) / denom, 0.0f, 1.0f) : 0.0f;
+
+         // Calculate the t that corresponds to s, and if it's outside of the [0, 1] range, clamp it and recalculate s
+         t = ((b * s) + f) / e;
+         if (t < 0.0f)
+         {
+            t = 0.0f;
+            s = glm::clamp(-c / a, 0.0f, 1.0f);
+         }
+         else if (t > 1.0f)
+         {
+            t = 1.0f;
+            s = glm::clamp((b - c) / a, 0.0f, 1.0f);
+         }
       }
    }
-   else
+
+   outClosestPoint1 = start1 + (d1 * s);
+   outClosestPoint2 = start2 + (d2 * t);
+   return glm::length2(outClosestPoint1 - outClosestPoint2);
+}
+
+namespace IntersectionHelpers
+{
+   // This function returns the first t in the [0, 1] range for which start + (displacement * t) is at the given distance from a point
+   // It's the same as intersecting a ray with a sphere of that radius that is centered at the point
+   bool CalculateTimeOfImpactWithPoint(const glm::vec3& start, const glm::vec3& displacement, float radius, const glm::vec3& point, float& outTime)
+   {
+      glm::vec3 m = start - point;
+      float a = glm::dot(displacement, displacement);
+      float b = glm::dot(m, displacement);
+      float c = glm::dot(m, m) - (radius * radius);
+
+      // If the start is outside of the sphere and we are moving away from it, there can't be an impact
+      if (a == 0.0f || (c > 0.0f && b > 0.0f))
+      {
+         return false;
+      }
+
+      float discriminant = (b * b) - (a * c);
+      if (discriminant < 0.0f)
+      {
+         return false;
+      }
+
+      float t = (-b - glm::sqrt(discriminant)) / a;
+      if (t < 0.0f || t > 1.0f)
+      {
+         return false;
+      }
+
+      outTime = t;
+      return true;
+   }
+
+   // This function returns the first t in the [0, 1] range for which start + (displacement * t) is at the given distance from the edge that goes from edgeStart to edgeEnd
+   // It's the same as intersecting a ray with a cylinder of that radius whose axis is the edge, and the ends of the cylinder are handled by the function above
+   bool CalculateTimeOfImpactWithEdge(const glm::vec3& start, const glm::vec3& displacement, float radius, const glm::vec3& edgeStart, const glm::vec3& edgeEnd, float& outTime)
    {
-      // If the mesh has indices, each sequential set of 3 indices makes up a triangle
-      unsigned int numIndices = static_cast<unsigned int>(indices.size());
-      for (unsigned int i = 0; i < numIndices; i += 3)
+      glm::vec3 edge = edgeEnd - edgeStart;
+      glm::vec3 m    = start - edgeStart;
+
+      float edgeDotEdge         = glm::dot(edge, edge);
+      float edgeDotDisplacement = glm::dot(edge, displacement);
+      float edgeDotM            = glm::dot(edge, m);
+
+      // These are the coefficients of the quadratic equation that we get when we remove the components that are parallel to the edge
+      // from the displacement and from m, and ask for the distance between them to be equal to the radius
+      float a = (edgeDotEdge * glm::dot(displacement, displacement)) - (edgeDotDisplacement * edgeDotDisplacement);
+      float b = (edgeDotEdge * glm::dot(m, displacement)) - (edgeDotM * edgeDotDisplacement);
+      float c = (edgeDotEdge * (glm::dot(m, m) - (radius * radius))) - (edgeDotM * edgeDotM);
+
+      // If we are moving parallel to the edge, we can only hit its ends
+      if (glm::abs(a) < IntersectionHelpers::minNonParallelSweepCoefficient || (c > 0.0f && b > 0.0f))
+      {
+         return false;
+      }
+
+      float discriminant = (b * b) - (a * c);
+      if (discriminant < 0.0f)
       {
-         triangles.push_back(Triangle(positions[indices[i + 0]],
-                                      positions[indices[i + 1]],
-                                      positions[indices[i + 2]]));
+         return false;
       }
+
+      float t = (-b - glm::sqrt(discriminant)) / a;
+      if (t < 0.0f || t > 1.0f)
+      {
+         return false;
+      }
+
+      // The impact must be between the ends of the edge
+      float s = edgeDotM + (t * edgeDotDisplacement);
+      if (s < 0.0f || s > edgeDotEdge)
+      {
+         return false;
+      }
+
+      outTime = t;
+      return true;
    }
 
-   return triangles;
+   // This function checks if a point that lies on the plane of a triangle is inside of it
+   bool IsPointOnPlaneInsideTriangle(const glm::vec3& point, const Triangle& triangle)
+   {
+      return glm::dot(glm::cross(triangle.vertexB - triangle.vertexA, point - triangle.vertexA), triangle.normal) >= 0.0f &&
+             glm::dot(glm::cross(triangle.vertexC - triangle.vertexB, point - triangle.vertexB), triangle.normal) >= 0.0f &&
+             glm::dot(glm::cross(triangle.vertexA - triangle.vertexC, point - triangle.vertexC), triangle.normal) >= 0.0f;
+   }
 }
 
-// TODO: Resize array of triangles and emplace_back every Triangle
-std::vector<Triangle> GetTrianglesFromMeshes(std::vector<AnimatedMesh>& meshes)
+/*
+   A sphere that moves from start to start + displacement can touch a triangle for the first time in three ways:
+
+   - Its surface touches the face of the triangle. The center of the sphere is at a distance equal to the radius from the plane of the triangle at that moment
+   - Its surface touches one of the edges. The center of the sphere is on a cylinder whose axis is the edge at that moment
+   - Its surface touches one of the vertices. The center of the sphere is on a sphere that is centered at the vertex at that moment
+
+   This function tests all three and keeps the earliest impact
+   Unlike the ray tests above, it doesn't ignore the backfaces, since a character must not be able to walk through a wall from behind
+   If the sphere already overlaps the triangle at the start, the time of impact is zero
+*/
+bool SweepSphereAgainstTriangle(const glm::vec3& start, const glm::vec3& displacement, float radius, const Triangle& triangle,
+                                float& outTimeOfImpact, glm::vec3& outContactPoint)
 {
-   std::vector<Triangle> triangles;
+   using namespace IntersectionHelpers;
 
-   // Loop over the meshes
-   unsigned int numMeshes = static_cast<unsigned int>(meshes.size());
-   for (unsigned int meshIndex = 0; meshIndex < numMeshes; ++meshIndex)
+   // Check if the sphere already overlaps the triangle
+   glm::vec3 closestPoint = CalculateClosestPointOnTriangle(start, triangle);
+   if (glm::length2(closestPoint - start) <= (radius * radius))
    {
-      AnimatedMesh&             mesh      = meshes[meshIndex];
-      std::vector<glm::vec3>    positions = mesh.GetPositions();
-      std::vector<unsigned int> indices   = mesh.GetIndices();
+      outTimeOfImpact = 0.0f;
+      outContactPoint = closestPoint;
+      return true;
+   }
 
-      if (indices.size() == 0)
+   bool  hit      = false;
+   float earliest = 2.0f;
+   float t;
+
+   // Test the face
+   // We flip the normal so that it points towards the side of the triangle where the sphere starts
+   float signedDistToPlane = glm::dot(start - triangle.vertexA, triangle.normal);
+   glm::vec3 normalTowardsSphere = (signedDistToPlane >= 0.0f) ? triangle.normal : -triangle.normal;
+   float distToPlane             = glm::abs(signedDistToPlane);
+   float approachSpeed           = -glm::dot(displacement, normalTowardsSphere);
+   if (approachSpeed > 0.0f && distToPlane > radius)
+   {
+      t = (distToPlane - radius) / approachSpeed;
+      if (t <= 1.0f)
       {
-         // If the current mesh doesn't have indices, each sequential set of 3 positions makes up a triangle
-         unsigned int numPositions = static_cast<unsigned int>(positions.size());
-         for (unsigned int i = 0; i < numPositions; i += 3)
+         glm::vec3 contactPoint = start + (displacement * t) - (normalTowardsSphere * radius);
+         if (IsPointOnPlaneInsideTriangle(contactPoint, triangle))
          {
-            triangles.push_back(Triangle(positions[i + 0],
-                                         positions[i + 1],
-                                         positions[i + 2]));
+            // If the sphere touches the face, it can't touch an edge or a vertex earlier
+            outTimeOfImpact = t;
+            outContactPoint = contactPoint;
+            return true;
          }
       }
-      else
+   }
+
+   // Test the edges and the vertices
+   const glm::vec3* vertices[3] = { &triangle.vertexA, &triangle.vertexB, &triangle.vertexC };
+   for (int i = 0; i < 3; ++i)
+   {
+      const glm::vec3& v0 = *vertices[i];
+      const glm::vec3& v1 = *vertices[(i + 1) % 3];
+
+      if (CalculateTimeOfImpactWithEdge(start, displacement, radius, v0, v1, t) && t < earliest)
       {
-         // If the current mesh has indices, each sequential set of 3 indices makes up a triangle
-         unsigned int numIndices = static_cast<unsigned int>(indices.size());
-         for (unsigned int i = 0; i < numIndices; i += 3)
-         {
-            triangles.push_back(Triangle(positions[indices[i + 0]],
-                                         positions[indices[i + 1]],
-                                         positions[indices[i + 2]]));
-         }
+         glm::vec3 centerAtImpact = start + (displacement * t);
+         glm::vec3 edge           = v1 - v0;
+         earliest        = t;
+         outContactPoint = v0 + edge * (glm::dot(centerAtImpact - v0, edge) / glm::dot(edge, edge));
+         hit             = true;
+      }
+
+      if (CalculateTimeOfImpactWithPoint(start, displacement, radius, v0, t) && t < earliest)
+      {
+         earliest        = t;
+         outContactPoint = v0;
+         hit             = true;
+      }
+   }
+
+   if (hit)
+   {
+      outTimeOfImpact = earliest;
+   }
+
+   return hit;
+}
+
+/*
+   A capsule is the set of points that are within a radius of a segment, so a capsule overlaps a triangle if the distance between the segment and the triangle
+   is smaller than or equal to the radius
+
+   If the segment doesn't pass through the triangle, the closest points between them are either an end of the segment and a point on the triangle,
+   or a point on the segment and a point on one of the edges of the triangle, so we test those five pairs and keep the closest one
+
+   The normal that is returned points from the triangle towards the capsule, and pushing the capsule along it by the penetration depth separates them
+*/
+bool OverlapCapsuleWithTriangle(const glm::vec3& segmentStart, const glm::vec3& segmentEnd, float radius, const Triangle& triangle,
+                                glm::vec3& outContactPoint, glm::vec3& outNormal, float& outPenetrationDepth)
+{
+   using namespace IntersectionHelpers;
+
+   // Check if the segment passes through the triangle
+   float signedDistOfStart = glm::dot(segmentStart - triangle.vertexA, triangle.normal);
+   float signedDistOfEnd   = glm::dot(segmentEnd - triangle.vertexA, triangle.normal);
+   if ((signedDistOfStart <= 0.0f) != (signedDistOfEnd <= 0.0f))
+   {
+      float t = signedDistOfStart / (signedDistOfStart - signedDistOfEnd);
+      glm::vec3 pointOnPlane = segmentStart + ((segmentEnd - segmentStart) * t);
+      if (IsPointOnPlaneInsideTriangle(pointOnPlane, triangle))
+      {
+         // The capsule is pushed out towards the side of the triangle where most of the segment is,
+         // and it must move far enough for the end on the other side to clear the triangle by the radius
+         bool startIsFurther = glm::abs(signedDistOfStart) >= glm::abs(signedDistOfEnd);
+         outNormal           = ((startIsFurther ? signedDistOfStart : signedDistOfEnd) >= 0.0f) ? triangle.normal : -triangle.normal;
+         outContactPoint     = pointOnPlane;
+         outPenetrationDepth = radius + glm::abs(startIsFurther ? signedDistOfEnd : signedDistOfStart);
+         return true;
+      }
+   }
+
+   // Find the closest points between the segment and the triangle
+   glm::vec3 closestPointOnSegment  = segmentStart;
+   glm::vec3 closestPointOnTriangle = CalculateClosestPointOnTriangle(segmentStart, triangle);
+   float     closestDistSq          = glm::length2(closestPointOnSegment - closestPointOnTriangle);
+
+   glm::vec3 pointOnTriangle = CalculateClosestPointOnTriangle(segmentEnd, triangle);
+   float     distSq          = glm::length2(segmentEnd - pointOnTriangle);
+   if (distSq < closestDistSq)
+   {
+      closestPointOnSegment  = segmentEnd;
+      closestPointOnTriangle = pointOnTriangle;
+      closestDistSq          = distSq;
+   }
+
+   const glm::vec3* vertices[3] = { &triangle.vertexA, &triangle.vertexB, &triangle.vertexC };
+   for (int i = 0; i < 3; ++i)
+   {
+      glm::vec3 pointOnSegment, pointOnEdge;
+      distSq = CalculateClosestPointsBetweenSegments(segmentStart, segmentEnd, *vertices[i], *vertices[(i + 1) % 3], pointOnSegment, pointOnEdge);
+      if (distSq < closestDistSq)
+      {
+         closestPointOnSegment  = pointOnSegment;
+         closestPointOnTriangle = pointOnEdge;
+         closestDistSq          = distSq;
+      }
+   }
+
+   if (closestDistSq > (radius * radius))
+   {
+      return false;
+   }
+
+   // If the segment touches the triangle, the direction between the closest points is undefined, so we use the normal of the triangle instead
+   float closestDist = glm::sqrt(closestDistSq);
+   if (closestDist > IntersectionHelpers::minSeparationDistance)
+   {
+      outNormal = (closestPointOnSegment - closestPointOnTriangle) / closestDist;
+   }
+   else
+   {
+      outNormal = (glm::dot(segmentStart + segmentEnd - (triangle.vertexA * 2.0f), triangle.normal) >= 0.0f) ? triangle.normal : -triangle.normal;
+   }
+
+   outContactPoint     = closestPointOnTriangle;
+   outPenetrationDepth = radius - closestDist;
+   return true;
+}
+
+// The triangles are read through a TriangleView, so the positions and the indices of the mesh aren't copied before the triangles are created
+std::vector<Triangle> GetTrianglesFromMesh(StaticMesh& mesh)
+{
+   TriangleView view(mesh);
+
+   std::vector<Triangle> triangles;
+   triangles.reserve(view.GetNumberOfTriangles());
+   for (unsigned int triangleIndex = 0, numTriangles = view.GetNumberOfTriangles(); triangleIndex < numTriangles; ++triangleIndex)
+   {
+      triangles.push_back(view.GetTriangle(triangleIndex));
+   }
+
+   return triangles;
+}
+
+std::vector<Triangle> GetTrianglesFromMeshes(std::vector<StaticMesh>& meshes)
+{
+   unsigned int numTriangles = 0;
+   for (const StaticMesh& mesh : meshes)
+   {
+      numTriangles += TriangleView(mesh).GetNumberOfTriangles();
+   }
+
+   std::vector<Triangle> triangles;
+   triangles.reserve(numTriangles);
+
+   // Loop over the meshes
+   for (const StaticMesh& mesh : meshes)
+   {
+      TriangleView view(mesh);
+      for (unsigned int triangleIndex = 0, numTrianglesInMesh = view.GetNumberOfTriangles(); triangleIndex < numTrianglesInMesh; ++triangleIndex)
+      {
+         triangles.push_back(view.GetTriangle(triangleIndex));
       }
    }
 
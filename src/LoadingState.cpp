@@ -0,0 +1,127 @@
+#include "imgui/imgui.h"
+#include "imgui/imgui_impl_glfw.h"
+#include "imgui/imgui_impl_opengl3.h"
+
+#include <iostream>
+
+#include "LoadingState.h"
+
+LoadingState::LoadingState(const std::shared_ptr<FiniteStateMachine>&          finiteStateMachine,
+                           const std::shared_ptr<Window>&                      window,
+                           const std::shared_ptr<AssetLoader>&                 assetLoader,
+                           std::vector<std::pair<std::string, StateFactory>>&& stateFactories,
+                           const std::string&                                  initialStateID)
+   : mFSM(finiteStateMachine)
+   , mWindow(window)
+   , mAssetLoader(assetLoader)
+   , mStateFactories(std::move(stateFactories))
+   , mNumCreatedStates(0)
+   , mInitialStateID(initialStateID)
+   , mBudgetPerFrameInMs(12.0)
+   , mStartTime()
+   , mTimeToLoadAssetsInMs(0.0)
+{
+
+}
+
+void LoadingState::enter()
+{
+   mStartTime = std::chrono::steady_clock::now();
+}
+
+void LoadingState::processInput(float deltaTime)
+{
+   // Close the game
+   if (mWindow->keyIsPressed(GLFW_KEY_ESCAPE)) { mWindow->setShouldClose(true); }
+}
+
+void LoadingState::update(float deltaTime)
+{
+   auto frameStart = std::chrono::steady_clock::now();
+
+   // Wait until the AssetLoader has loaded all the assets before creating the states, so that they don't have to wait for them
+   // When there are no worker threads, the assets are loaded here
+   if (!mAssetLoader->IsIdle())
+   {
+      mAssetLoader->RunJobs(mBudgetPerFrameInMs);
+      return;
+   }
+
+   if (mNumCreatedStates == 0)
+   {
+      mTimeToLoadAssetsInMs = std::chrono::duration<double, std::milli>(frameStart - mStartTime).count();
+   }
+
+   // Create as many states as the budget allows, but always at least one
+   unsigned int numStates = static_cast<unsigned int>(mStateFactories.size());
+   while (mNumCreatedStates < numStates)
+   {
+      std::pair<std::string, StateFactory>& stateFactory = mStateFactories[mNumCreatedStates];
+      mFSM->addState(stateFactory.first, stateFactory.second());
+      ++mNumCreatedStates;
+
+      if (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count() > mBudgetPerFrameInMs)
+      {
+         break;
+      }
+   }
+
+   if (mNumCreatedStates == numStates)
+   {
+      // The states have uploaded their assets, so the AssetLoader doesn't need to keep them in memory anymore
+      mAssetLoader->ReleaseLoadedAssets();
+
+      double totalTimeInMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mStartTime).count();
+      std::cout << "Loading - Loaded the assets in " << mTimeToLoadAssetsInMs << " ms and created " << numStates << " states in " << totalTimeInMs - mTimeToLoadAssetsInMs << " ms" << '\n';
+
+      mFSM->changeState(mInitialStateID);
+   }
+}
+
+void LoadingState::render()
+{
+   ImGui_ImplOpenGL3_NewFrame();
+   ImGui_ImplGlfw_NewFrame();
+   ImGui::NewFrame();
+
+   userInterface();
+
+#ifndef __EMSCRIPTEN__
+   mWindow->bindMultisampleFramebuffer();
+#endif
+   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+   ImGui::Render();
+   ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+#ifndef __EMSCRIPTEN__
+   mWindow->generateAntiAliasedImage();
+#endif
+
+   mWindow->swapBuffers();
+   mWindow->pollEvents();
+}
+
+void LoadingState::exit()
+{
+   // The factories hold references to the objects that are needed to create the states, which we don't need anymore
+   mStateFactories.clear();
+}
+
+void LoadingState::userInterface()
+{
+   ImGui::SetNextWindowPos(ImVec2(mWindow->getWidthOfWindowInPix() * 0.5f, mWindow->getHeightOfWindowInPix() * 0.5f), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+
+   ImGui::Begin("Loading", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoCollapse);
+
+   // Loading the assets and creating the states are each counted as half of the progress
+   float progress = 0.5f * mAssetLoader->GetProgress();
+   if (!mStateFactories.empty())
+   {
+      progress += 0.5f * static_cast<float>(mNumCreatedStates) / static_cast<float>(mStateFactories.size());
+   }
+
+   ImGui::ProgressBar(progress, ImVec2(300.0f, 0.0f));
+
+   ImGui::End();
+}
@@ -0,0 +1,130 @@
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+MappedFile::MappedFile()
+   : mData(nullptr)
+   , mSize(0)
+#ifdef _WIN32
+   , mFile(INVALID_HANDLE_VALUE)
+   , mMapping(nullptr)
+#endif
+{
+
+}
+
+MappedFile::~MappedFile()
+{
+   Close();
+}
+
+bool MappedFile::Open(const char* path)
+{
+   Close();
+
+#ifdef _WIN32
+   mFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (mFile == INVALID_HANDLE_VALUE)
+   {
+      return false;
+   }
+
+   LARGE_INTEGER size;
+   if (!GetFileSizeEx(mFile, &size) || size.QuadPart == 0)
+   {
+      Close();
+      return false;
+   }
+
+   mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+   if (mMapping == nullptr)
+   {
+      Close();
+      return false;
+   }
+
+   mData = static_cast<const char*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+   mSize = static_cast<size_t>(size.QuadPart);
+#else
+   int fileDescriptor = open(path, O_RDONLY);
+   if (fileDescriptor < 0)
+   {
+      return false;
+   }
+
+   struct stat fileStatus;
+   if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size == 0)
+   {
+      close(fileDescriptor);
+      return false;
+   }
+
+   void* mapping = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+   // The mapping keeps the file alive, so we don't need the file descriptor anymore
+   close(fileDescriptor);
+   if (mapping == MAP_FAILED)
+   {
+      return false;
+   }
+
+   mData = static_cast<const char*>(mapping);
+   mSize = static_cast<size_t>(fileStatus.st_size);
+#endif
+
+   if (mData == nullptr)
+   {
+      Close();
+      return false;
+   }
+
+   return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+   if (mData != nullptr)
+   {
+      UnmapViewOfFile(mData);
+   }
+
+   if (mMapping != nullptr)
+   {
+      CloseHandle(mMapping);
+      mMapping = nullptr;
+   }
+
+   if (mFile != INVALID_HANDLE_VALUE)
+   {
+      CloseHandle(mFile);
+      mFile = INVALID_HANDLE_VALUE;
+   }
+#else
+   if (mData != nullptr)
+   {
+      munmap(const_cast<char*>(mData), mSize);
+   }
+#endif
+
+   mData = nullptr;
+   mSize = 0;
+}
+
+const char* MappedFile::GetData() const
+{
+   return mData;
+}
+
+size_t MappedFile::GetSize() const
+{
+   return mSize;
+}
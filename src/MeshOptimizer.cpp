@@ -0,0 +1,500 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+#include "MeshOptimizer.h"
+
+namespace MeshOptimizerHelpers
+{
+   // The size of the FIFO cache that we simulate to calculate the ACMR and ATVR
+   // Most GPUs have a post-transform cache that behaves like a FIFO cache with 16 to 32 entries
+   const unsigned int simulatedFIFOCacheSize = 16;
+
+   // The size of the LRU cache that the Forsyth algorithm optimizes for
+   // Forsyth recommends 32 entries, since optimizing for a larger cache still works well with smaller caches
+   const unsigned int forsythCacheSize = 32;
+
+   // The constants that are used by the Forsyth algorithm to score the vertices
+   // They come from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+   const float cacheDecayPower   = 1.5f;
+   const float lastTriangleScore = 0.75f;
+   const float valenceBoostScale = 2.0f;
+   const float valenceBoostPower = 0.5f;
+
+   /*
+      The score of a vertex depends on two things:
+
+      - Its position in the LRU cache: vertices that are in the cache are cheap, so triangles that use them should be emitted soon
+        The 3 vertices of the last triangle get a fixed score because we don't want to favour any of them
+      - The number of triangles that still use it: vertices with few remaining triangles get a boost, because emitting those triangles
+        allows us to get rid of the vertex entirely instead of leaving lonely triangles behind that will be expensive to render later
+   */
+   float CalculateVertexScore(int cachePosition, unsigned int numRemainingTriangles)
+   {
+      // If a vertex isn't used by any remaining triangles, it doesn't matter
+      if (numRemainingTriangles == 0)
+      {
+         return -1.0f;
+      }
+
+      float score = 0.0f;
+      if (cachePosition >= 0)
+      {
+         if (cachePosition < 3)
+         {
+            score = lastTriangleScore;
+         }
+         else
+         {
+            float scaler = 1.0f / static_cast<float>(forsythCacheSize - 3);
+            score = 1.0f - static_cast<float>(cachePosition - 3) * scaler;
+            score = std::pow(score, cacheDecayPower);
+         }
+      }
+
+      float valenceBoost = std::pow(static_cast<float>(numRemainingTriangles), -valenceBoostPower);
+      score += valenceBoostScale * valenceBoost;
+
+      return score;
+   }
+
+   // This function reorders the vertex attributes of a mesh using a remap table that maps old vertex indices to new ones
+   template <typename T>
+   void RemapVertexAttribute(std::vector<T>& attribute, const std::vector<unsigned int>& remap)
+   {
+      // Meshes are not required to contain every attribute
+      if (attribute.size() != remap.size())
+      {
+         return;
+      }
+
+      std::vector<T> remappedAttribute(attribute.size());
+      for (unsigned int vertexIndex = 0,
+           numVertices = static_cast<unsigned int>(attribute.size());
+           vertexIndex < numVertices;
+           ++vertexIndex)
+      {
+         remappedAttribute[remap[vertexIndex]] = attribute[vertexIndex];
+      }
+
+      attribute.swap(remappedAttribute);
+   }
+
+   void RemapIndices(std::vector<unsigned int>& indices, const std::vector<unsigned int>& remap)
+   {
+      for (unsigned int i = 0,
+           numIndices = static_cast<unsigned int>(indices.size());
+           i < numIndices;
+           ++i)
+      {
+         indices[i] = remap[indices[i]];
+      }
+   }
+
+   // This function remaps the vertex indices of the morph targets of a mesh
+   // The indices of a morph target must stay sorted, so its deltas are reordered along with them
+   void RemapMorphTargets(std::vector<MorphTarget>& morphTargets, const std::vector<unsigned int>& remap)
+   {
+      for (unsigned int targetIndex = 0,
+           numTargets = static_cast<unsigned int>(morphTargets.size());
+           targetIndex < numTargets;
+           ++targetIndex)
+      {
+         MorphTarget& target = morphTargets[targetIndex];
+         unsigned int numDisplacedVertices = static_cast<unsigned int>(target.vertexIndices.size());
+
+         std::vector<std::pair<unsigned int, unsigned int>> newIndexAndOldPosition(numDisplacedVertices);
+         for (unsigned int i = 0; i < numDisplacedVertices; ++i)
+         {
+            newIndexAndOldPosition[i] = std::make_pair(remap[target.vertexIndices[i]], i);
+         }
+
+         std::sort(newIndexAndOldPosition.begin(), newIndexAndOldPosition.end());
+
+         std::vector<glm::vec4> positionDeltas(target.positionDeltas.size());
+         std::vector<glm::vec4> normalDeltas(target.normalDeltas.size());
+         for (unsigned int i = 0; i < numDisplacedVertices; ++i)
+         {
+            unsigned int oldPosition = newIndexAndOldPosition[i].second;
+            target.vertexIndices[i] = newIndexAndOldPosition[i].first;
+
+            if (positionDeltas.size() > 0)
+            {
+               positionDeltas[i] = target.positionDeltas[oldPosition];
+            }
+
+            if (normalDeltas.size() > 0)
+            {
+               normalDeltas[i] = target.normalDeltas[oldPosition];
+            }
+         }
+
+         target.positionDeltas.swap(positionDeltas);
+         target.normalDeltas.swap(normalDeltas);
+      }
+   }
+}
+
+// This function simulates a FIFO post-transform vertex cache to count how many times the vertex shader would run for an index buffer
+VertexCacheStatistics AnalyzeVertexCache(const std::vector<unsigned int>& indices, unsigned int numVertices, unsigned int cacheSize)
+{
+   VertexCacheStatistics statistics;
+
+   unsigned int numIndices = static_cast<unsigned int>(indices.size());
+   if (numIndices < 3 || numVertices == 0)
+   {
+      return statistics;
+   }
+
+   // A FIFO cache doesn't update the position of an entry when it's hit, so we only need to remember when each vertex entered it
+   // A vertex is in the cache if fewer than cacheSize vertices have entered the cache since it did
+   std::vector<unsigned int> timeWhenVertexEnteredCache(numVertices, 0);
+   unsigned int numCacheMisses = 0;
+
+   for (unsigned int i = 0; i < numIndices; ++i)
+   {
+      unsigned int vertexIndex = indices[i];
+
+      // Note that numCacheMisses doubles as the current time of the cache, since it only advances when a vertex enters the cache
+      // We add cacheSize to the stored times so that a time of 0 means "never entered the cache"
+      if (timeWhenVertexEnteredCache[vertexIndex] == 0 || (numCacheMisses + cacheSize) - timeWhenVertexEnteredCache[vertexIndex] >= cacheSize)
+      {
+         timeWhenVertexEnteredCache[vertexIndex] = numCacheMisses + cacheSize;
+         ++numCacheMisses;
+      }
+   }
+
+   statistics.ACMR = static_cast<float>(numCacheMisses) / static_cast<float>(numIndices / 3);
+   statistics.ATVR = static_cast<float>(numCacheMisses) / static_cast<float>(numVertices);
+
+   return statistics;
+}
+
+/*
+   This function implements Tom Forsyth's "Linear-Speed Vertex Cache Optimisation" algorithm
+
+   The algorithm greedily emits triangles one at a time:
+
+   1) Each vertex gets a score based on its position in a simulated LRU cache and on the number of triangles that still use it
+   2) Each triangle gets a score equal to the sum of the scores of its vertices
+   3) The triangle with the highest score is emitted, its vertices are moved to the front of the cache, and the scores of the vertices
+      in the cache and of the triangles that use them are updated
+
+   Since only the triangles that use vertices in the cache can have their scores changed, the best triangle is usually found among them,
+   which is why the algorithm runs in linear time
+*/
+std::vector<unsigned int> OptimizeVertexCache(const std::vector<unsigned int>& indices, unsigned int numVertices)
+{
+   using namespace MeshOptimizerHelpers;
+
+   unsigned int numIndices   = static_cast<unsigned int>(indices.size());
+   unsigned int numTriangles = numIndices / 3;
+   if (numTriangles == 0 || numVertices == 0)
+   {
+      return indices;
+   }
+
+   // Count the triangles that use each vertex
+   std::vector<unsigned int> numRemainingTrianglesOfVertex(numVertices, 0);
+   for (unsigned int i = 0; i < numTriangles * 3; ++i)
+   {
+      ++numRemainingTrianglesOfVertex[indices[i]];
+   }
+
+   // Build the adjacency lists that store the triangles that use each vertex
+   // They are stored in a single array, where the list of vertex v starts at offsetOfTrianglesOfVertex[v]
+   std::vector<unsigned int> offsetOfTrianglesOfVertex(numVertices + 1, 0);
+   for (unsigned int vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+   {
+      offsetOfTrianglesOfVertex[vertexIndex + 1] = offsetOfTrianglesOfVertex[vertexIndex] + numRemainingTrianglesOfVertex[vertexIndex];
+   }
+
+   std::vector<unsigned int> trianglesOfVertex(numTriangles * 3);
+   std::vector<unsigned int> numTrianglesWrittenForVertex(numVertices, 0);
+   for (unsigned int triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+   {
+      for (unsigned int corner = 0; corner < 3; ++corner)
+      {
+         unsigned int vertexIndex = indices[(triangleIndex * 3) + corner];
+         trianglesOfVertex[offsetOfTrianglesOfVertex[vertexIndex] + numTrianglesWrittenForVertex[vertexIndex]++] = triangleIndex;
+      }
+   }
+
+   // Calculate the initial scores of the vertices and the triangles
+   std::vector<int>   cachePositionOfVertex(numVertices, -1);
+   std::vector<float> scoreOfVertex(numVertices);
+   for (unsigned int vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+   {
+      scoreOfVertex[vertexIndex] = CalculateVertexScore(-1, numRemainingTrianglesOfVertex[vertexIndex]);
+   }
+
+   std::vector<float> scoreOfTriangle(numTriangles);
+   std::vector<bool>  triangleWasEmitted(numTriangles, false);
+   for (unsigned int triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+   {
+      scoreOfTriangle[triangleIndex] = scoreOfVertex[indices[(triangleIndex * 3) + 0]] +
+                                       scoreOfVertex[indices[(triangleIndex * 3) + 1]] +
+                                       scoreOfVertex[indices[(triangleIndex * 3) + 2]];
+   }
+
+   std::vector<unsigned int> optimizedIndices;
+   optimizedIndices.reserve(numTriangles * 3);
+
+   // The LRU cache is stored with the most recently used vertex at the front
+   // It can temporarily hold 3 more entries than its size while the vertices of the last triangle are added to it
+   std::vector<unsigned int> cache;
+   std::vector<unsigned int> newCache;
+   cache.reserve(forsythCacheSize + 3);
+   newCache.reserve(forsythCacheSize + 3);
+
+   unsigned int bestTriangle = 0;
+   unsigned int numEmittedTriangles = 0;
+   unsigned int nextTriangleToScan = 0;
+
+   // Find the initial best triangle
+   for (unsigned int triangleIndex = 1; triangleIndex < numTriangles; ++triangleIndex)
+   {
+      if (scoreOfTriangle[triangleIndex] > scoreOfTriangle[bestTriangle])
+      {
+         bestTriangle = triangleIndex;
+      }
+   }
+
+   while (numEmittedTriangles < numTriangles)
+   {
+      // Emit the best triangle
+      triangleWasEmitted[bestTriangle] = true;
+      ++numEmittedTriangles;
+
+      unsigned int triangleVertices[3] = { indices[(bestTriangle * 3) + 0],
+                                           indices[(bestTriangle * 3) + 1],
+                                           indices[(bestTriangle * 3) + 2] };
+
+      newCache.clear();
+      for (unsigned int corner = 0; corner < 3; ++corner)
+      {
+         unsigned int vertexIndex = triangleVertices[corner];
+         optimizedIndices.push_back(vertexIndex);
+
+         // Degenerate triangles may use the same vertex more than once, but it should only appear once in the cache
+         if (std::find(newCache.begin(), newCache.end(), vertexIndex) == newCache.end())
+         {
+            newCache.push_back(vertexIndex);
+         }
+
+         // Remove the emitted triangle from the adjacency list of the vertex
+         // We do that by swapping it with the last triangle of the list and shrinking the list
+         unsigned int  begin              = offsetOfTrianglesOfVertex[vertexIndex];
+         unsigned int& numTrianglesOfVert = numRemainingTrianglesOfVertex[vertexIndex];
+         for (unsigned int i = 0; i < numTrianglesOfVert; ++i)
+         {
+            if (trianglesOfVertex[begin + i] == bestTriangle)
+            {
+               std::swap(trianglesOfVertex[begin + i], trianglesOfVertex[begin + numTrianglesOfVert - 1]);
+               --numTrianglesOfVert;
+               break;
+            }
+         }
+      }
+
+      // Move the vertices of the emitted triangle to the front of the cache, keeping the order of the other vertices
+      for (unsigned int i = 0, cacheSize = static_cast<unsigned int>(cache.size()); i < cacheSize; ++i)
+      {
+         unsigned int vertexIndex = cache[i];
+         if (vertexIndex != triangleVertices[0] && vertexIndex != triangleVertices[1] && vertexIndex != triangleVertices[2])
+         {
+            newCache.push_back(vertexIndex);
+         }
+      }
+      cache.swap(newCache);
+
+      // Update the scores of the vertices in the cache, including the ones that just fell out of it
+      for (unsigned int i = 0, cacheSize = static_cast<unsigned int>(cache.size()); i < cacheSize; ++i)
+      {
+         unsigned int vertexIndex = cache[i];
+         int cachePosition = (i < forsythCacheSize) ? static_cast<int>(i) : -1;
+         cachePositionOfVertex[vertexIndex] = cachePosition;
+         scoreOfVertex[vertexIndex] = CalculateVertexScore(cachePosition, numRemainingTrianglesOfVertex[vertexIndex]);
+      }
+
+      // Update the scores of the triangles that use the vertices in the cache and find the new best triangle among them
+      float bestScore = -1.0f;
+      bool  foundBestTriangle = false;
+      for (unsigned int i = 0, cacheSize = static_cast<unsigned int>(cache.size()); i < cacheSize; ++i)
+      {
+         unsigned int vertexIndex = cache[i];
+         unsigned int begin       = offsetOfTrianglesOfVertex[vertexIndex];
+         for (unsigned int j = 0; j < numRemainingTrianglesOfVertex[vertexIndex]; ++j)
+         {
+            unsigned int triangleIndex = trianglesOfVertex[begin + j];
+            float score = scoreOfVertex[indices[(triangleIndex * 3) + 0]] +
+                          scoreOfVertex[indices[(triangleIndex * 3) + 1]] +
+                          scoreOfVertex[indices[(triangleIndex * 3) + 2]];
+            scoreOfTriangle[triangleIndex] = score;
+
+            if (score > bestScore)
+            {
+               bestScore = score;
+               bestTriangle = triangleIndex;
+               foundBestTriangle = true;
+            }
+         }
+      }
+
+      // Shrink the cache back to its size
+      if (cache.size() > forsythCacheSize)
+      {
+         cache.resize(forsythCacheSize);
+      }
+
+      // If none of the vertices in the cache are used by the remaining triangles, we need to scan all the triangles
+      // Since triangles are never un-emitted, we can resume the scan where we left it the last time
+      if (!foundBestTriangle && numEmittedTriangles < numTriangles)
+      {
+         while (triangleWasEmitted[nextTriangleToScan])
+         {
+            ++nextTriangleToScan;
+         }
+
+         bestTriangle = nextTriangleToScan;
+         for (unsigned int triangleIndex = nextTriangleToScan + 1; triangleIndex < numTriangles; ++triangleIndex)
+         {
+            if (!triangleWasEmitted[triangleIndex] && scoreOfTriangle[triangleIndex] > scoreOfTriangle[bestTriangle])
+            {
+               bestTriangle = triangleIndex;
+            }
+         }
+      }
+   }
+
+   // If the number of indices wasn't a multiple of 3, keep the leftover indices as they were
+   for (unsigned int i = numTriangles * 3; i < numIndices; ++i)
+   {
+      optimizedIndices.push_back(indices[i]);
+   }
+
+   return optimizedIndices;
+}
+
+// This function generates a table that maps each old vertex index to a new one, so that the vertices end up in memory
+// in the same order in which they are first referenced by the index buffer
+// Vertices that are never referenced are placed at the end
+std::vector<unsigned int> GenerateVertexFetchRemap(const std::vector<unsigned int>& indices, unsigned int numVertices)
+{
+   const unsigned int unassigned = static_cast<unsigned int>(-1);
+   std::vector<unsigned int> remap(numVertices, unassigned);
+
+   unsigned int nextVertexIndex = 0;
+   for (unsigned int i = 0,
+        numIndices = static_cast<unsigned int>(indices.size());
+        i < numIndices;
+        ++i)
+   {
+      if (remap[indices[i]] == unassigned)
+      {
+         remap[indices[i]] = nextVertexIndex++;
+      }
+   }
+
+   for (unsigned int vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+   {
+      if (remap[vertexIndex] == unassigned)
+      {
+         remap[vertexIndex] = nextVertexIndex++;
+      }
+   }
+
+   return remap;
+}
+
+void OptimizeMesh(AnimatedMesh& mesh)
+{
+   using namespace MeshOptimizerHelpers;
+
+   std::vector<unsigned int>& indices = mesh.GetIndices();
+   unsigned int numVertices = static_cast<unsigned int>(mesh.GetPositions().size());
+
+   // Meshes without indices can't be optimized this way
+   if (indices.size() == 0 || numVertices == 0)
+   {
+      return;
+   }
+
+   indices = OptimizeVertexCache(indices, numVertices);
+
+   std::vector<unsigned int> remap = GenerateVertexFetchRemap(indices, numVertices);
+   RemapIndices(indices, remap);
+   RemapVertexAttribute(mesh.GetPositions(), remap);
+   RemapVertexAttribute(mesh.GetNormals(), remap);
+   RemapVertexAttribute(mesh.GetTexCoords(), remap);
+   RemapVertexAttribute(mesh.GetWeights(), remap);
+   RemapVertexAttribute(mesh.GetInfluences(), remap);
+   RemapMorphTargets(mesh.GetMorphTargets(), remap);
+}
+
+// This function is identical to the one above, except that static meshes don't have weights or influences
+void OptimizeMesh(StaticMesh& mesh)
+{
+   using namespace MeshOptimizerHelpers;
+
+   std::vector<unsigned int>& indices = mesh.GetIndices();
+   unsigned int numVertices = static_cast<unsigned int>(mesh.GetPositions().size());
+
+   // Meshes without indices can't be optimized this way
+   if (indices.size() == 0 || numVertices == 0)
+   {
+      return;
+   }
+
+   indices = OptimizeVertexCache(indices, numVertices);
+
+   std::vector<unsigned int> remap = GenerateVertexFetchRemap(indices, numVertices);
+   RemapIndices(indices, remap);
+   RemapVertexAttribute(mesh.GetPositions(), remap);
+   RemapVertexAttribute(mesh.GetNormals(), remap);
+   RemapVertexAttribute(mesh.GetTexCoords(), remap);
+}
+
+void BenchmarkMeshOptimizer(const std::vector<unsigned int>& indices, unsigned int numVertices)
+{
+   using namespace MeshOptimizerHelpers;
+
+   unsigned int numTriangles = static_cast<unsigned int>(indices.size() / 3);
+   if (numTriangles == 0 || numVertices == 0)
+   {
+      return;
+   }
+
+   // The index buffers of the loaded meshes may already be optimized, so their triangles are shuffled to get the order of an unoptimized mesh
+   // The shuffle uses a fixed seed so that the results can be compared between runs
+   std::vector<unsigned int> triangleOrder(numTriangles);
+   std::iota(triangleOrder.begin(), triangleOrder.end(), 0);
+   std::shuffle(triangleOrder.begin(), triangleOrder.end(), std::minstd_rand(12345));
+
+   std::vector<unsigned int> shuffledIndices;
+   shuffledIndices.reserve(numTriangles * 3);
+   for (unsigned int triangleIndex : triangleOrder)
+   {
+      shuffledIndices.push_back(indices[(triangleIndex * 3) + 0]);
+      shuffledIndices.push_back(indices[(triangleIndex * 3) + 1]);
+      shuffledIndices.push_back(indices[(triangleIndex * 3) + 2]);
+   }
+
+   auto start = std::chrono::steady_clock::now();
+   std::vector<unsigned int> optimizedIndices = OptimizeVertexCache(shuffledIndices, numVertices);
+   auto end = std::chrono::steady_clock::now();
+
+   VertexCacheStatistics shuffled  = AnalyzeVertexCache(shuffledIndices, numVertices, simulatedFIFOCacheSize);
+   VertexCacheStatistics optimized = AnalyzeVertexCache(optimizedIndices, numVertices, simulatedFIFOCacheSize);
+   VertexCacheStatistics original  = AnalyzeVertexCache(indices, numVertices, simulatedFIFOCacheSize);
+
+   std::cout << "Mesh optimizer - Vertices: " << numVertices << ", Triangles: " << numTriangles
+             << ", Index size: " << ((numVertices < 65535) ? 16 : 32) << " bits"
+             << ", Optimized in " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << '\n'
+             << "   Shuffled:  ACMR " << shuffled.ACMR  << ", ATVR " << shuffled.ATVR  << '\n'
+             << "   Optimized: ACMR " << optimized.ACMR << ", ATVR " << optimized.ATVR << '\n'
+             << "   Original:  ACMR " << original.ACMR  << ", ATVR " << original.ATVR  << '\n';
+}
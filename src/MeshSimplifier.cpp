@@ -0,0 +1,774 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+
+namespace MeshSimplifierHelpers
+{
+   // The maximum number of LODs that are generated for each mesh, not counting the original mesh
+   const unsigned int maxNumLODs = 4;
+
+   // Each LOD aims to have this fraction of the triangles of the previous one
+   const float lodTriangleRatio = 0.5f;
+
+   // A LOD is discarded if it doesn't get rid of at least this fraction of the triangles of the previous one
+   const float minLODTriangleReduction = 0.1f;
+
+   // Meshes with fewer triangles than this aren't worth simplifying
+   const unsigned int minNumTriangles = 32;
+
+   // The error that the first LOD is allowed to introduce, as a fraction of the radius of the mesh
+   // Each subsequent LOD is allowed to introduce twice as much error as the previous one
+   const float firstLODRelativeError = 0.0125f;
+
+   // Collapsing a vertex onto a neighbour with different skin weights changes how the mesh deforms, so those collapses are penalized
+   // The penalty is proportional to the fraction of the weights that differ, and a difference of 1 / skinWeightPenalty uses up the entire error budget
+   const float skinWeightPenalty = 4.0f;
+
+   /*
+      The plane of a triangle can be described by a unit normal (a, b, c) and a distance d, and the squared distance from a point p to it is:
+
+      distance^2 = (a * x + b * y + c * z + d)^2 = p^T * Q * p
+
+      Where p = (x, y, z, 1) and Q is the symmetric 4x4 matrix below, so we only need to store 10 of its elements:
+
+          | a*a  a*b  a*c  a*d |
+      Q = | a*b  b*b  b*c  b*d |
+          | a*c  b*c  c*c  c*d |
+          | a*d  b*d  c*d  d*d |
+
+      Adding quadrics together results in a quadric that measures the sum of the squared distances to all their planes
+      We use doubles because the terms of the sum cancel each other out, which loses a lot of precision with floats
+   */
+   struct Quadric
+   {
+      Quadric()
+         : a2(0.0), ab(0.0), ac(0.0), ad(0.0)
+         , b2(0.0), bc(0.0), bd(0.0)
+         , c2(0.0), cd(0.0)
+         , d2(0.0)
+      {
+
+      }
+
+      Quadric(double a, double b, double c, double d)
+         : a2(a * a), ab(a * b), ac(a * c), ad(a * d)
+         , b2(b * b), bc(b * c), bd(b * d)
+         , c2(c * c), cd(c * d)
+         , d2(d * d)
+      {
+
+      }
+
+      void Add(const Quadric& rhs)
+      {
+         a2 += rhs.a2; ab += rhs.ab; ac += rhs.ac; ad += rhs.ad;
+         b2 += rhs.b2; bc += rhs.bc; bd += rhs.bd;
+         c2 += rhs.c2; cd += rhs.cd;
+         d2 += rhs.d2;
+      }
+
+      double Evaluate(const glm::vec3& point) const
+      {
+         double x = point.x;
+         double y = point.y;
+         double z = point.z;
+
+         double result = (a2 * x * x) + (2.0 * ab * x * y) + (2.0 * ac * x * z) + (2.0 * ad * x) +
+                         (b2 * y * y) + (2.0 * bc * y * z) + (2.0 * bd * y) +
+                         (c2 * z * z) + (2.0 * cd * z) +
+                         d2;
+
+         // The result can be slightly negative due to rounding errors
+         return std::max(result, 0.0);
+      }
+
+      double a2, ab, ac, ad;
+      double b2, bc, bd;
+      double c2, cd;
+      double d2;
+   };
+
+   // A collapse moves the "from" vertex onto the "to" vertex
+   // The cost is what we sort the collapses by, while the error is the geometric error that the collapse introduces
+   struct Collapse
+   {
+      unsigned int from;
+      unsigned int to;
+      double       cost;
+      double       error;
+   };
+
+   // This struct stores a one-to-many relationship (like the triangles that use each vertex) in two flat arrays:
+   // The items of key k are stored in items[offsets[k]] to items[offsets[k + 1] - 1]
+   struct Adjacency
+   {
+      std::vector<unsigned int> offsets;
+      std::vector<unsigned int> items;
+   };
+
+   // This function maps each vertex to the first vertex that has exactly the same position
+   std::vector<unsigned int> WeldVertices(const std::vector<glm::vec3>& positions)
+   {
+      unsigned int numVertices = static_cast<unsigned int>(positions.size());
+
+      std::vector<unsigned int> sortedVertices(numVertices);
+      for (unsigned int vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+      {
+         sortedVertices[vertexIndex] = vertexIndex;
+      }
+
+      // Sort the vertices by their positions so that the ones with the same position end up next to each other
+      // Ties are broken using the indices of the vertices, which guarantees that the first vertex of each group is the one with the lowest index
+      std::sort(sortedVertices.begin(), sortedVertices.end(), [&positions](unsigned int lhs, unsigned int rhs)
+      {
+         const glm::vec3& lhsPos = positions[lhs];
+         const glm::vec3& rhsPos = positions[rhs];
+         if (lhsPos.x != rhsPos.x) return lhsPos.x < rhsPos.x;
+         if (lhsPos.y != rhsPos.y) return lhsPos.y < rhsPos.y;
+         if (lhsPos.z != rhsPos.z) return lhsPos.z < rhsPos.z;
+         return lhs < rhs;
+      });
+
+      std::vector<unsigned int> weldedVertices(numVertices);
+      for (unsigned int i = 0; i < numVertices; ++i)
+      {
+         unsigned int vertexIndex = sortedVertices[i];
+         if (i > 0 && positions[vertexIndex] == positions[sortedVertices[i - 1]])
+         {
+            weldedVertices[vertexIndex] = weldedVertices[sortedVertices[i - 1]];
+         }
+         else
+         {
+            weldedVertices[vertexIndex] = vertexIndex;
+         }
+      }
+
+      return weldedVertices;
+   }
+
+   // This function groups the items by their keys
+   // It's used to find the duplicates of each welded vertex and the triangles that use each welded vertex
+   Adjacency BuildAdjacency(const std::vector<unsigned int>& keys, unsigned int numKeys, unsigned int itemsPerKeyDivisor)
+   {
+      Adjacency adjacency;
+      adjacency.offsets.assign(numKeys + 1, 0);
+      adjacency.items.resize(keys.size());
+
+      for (unsigned int i = 0,
+           size = static_cast<unsigned int>(keys.size());
+           i < size;
+           ++i)
+      {
+         ++adjacency.offsets[keys[i] + 1];
+      }
+
+      for (unsigned int key = 0; key < numKeys; ++key)
+      {
+         adjacency.offsets[key + 1] += adjacency.offsets[key];
+      }
+
+      std::vector<unsigned int> nextItem(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+      for (unsigned int i = 0,
+           size = static_cast<unsigned int>(keys.size());
+           i < size;
+           ++i)
+      {
+         adjacency.items[nextItem[keys[i]]++] = i / itemsPerKeyDivisor;
+      }
+
+      return adjacency;
+   }
+
+   // The vertices that lie on the border of a mesh or on a non-manifold edge are locked, since collapsing them would shrink the border
+   // An edge is on the border if it's used by a single triangle, and it's non-manifold if it's used by more than two
+   std::vector<bool> FindLockedVertices(const std::vector<unsigned int>& weldedTriangles, unsigned int numVertices)
+   {
+      std::vector<std::pair<unsigned int, unsigned int>> edges;
+      edges.reserve(weldedTriangles.size());
+
+      for (unsigned int i = 0,
+           size = static_cast<unsigned int>(weldedTriangles.size());
+           i < size;
+           i += 3)
+      {
+         for (unsigned int corner = 0; corner < 3; ++corner)
+         {
+            unsigned int v0 = weldedTriangles[i + corner];
+            unsigned int v1 = weldedTriangles[i + ((corner + 1) % 3)];
+            edges.push_back(std::make_pair(std::min(v0, v1), std::max(v0, v1)));
+         }
+      }
+
+      std::sort(edges.begin(), edges.end());
+
+      std::vector<bool> lockedVertices(numVertices, false);
+      for (unsigned int i = 0,
+           size = static_cast<unsigned int>(edges.size());
+           i < size;)
+      {
+         unsigned int numUses = 1;
+         while (i + numUses < size && edges[i + numUses] == edges[i])
+         {
+            ++numUses;
+         }
+
+         if (numUses != 2)
+         {
+            lockedVertices[edges[i].first]  = true;
+            lockedVertices[edges[i].second] = true;
+         }
+
+         i += numUses;
+      }
+
+      return lockedVertices;
+   }
+
+   // This function returns the fraction of the skin weights of two vertices that differ, which is 0 if they are identical and 1 if they have no joints in common
+   float CalculateSkinWeightDifference(const std::vector<glm::vec4>&  weights,
+                                       const std::vector<glm::ivec4>& influences,
+                                       unsigned int                   lhs,
+                                       unsigned int                   rhs)
+   {
+      if (weights.size() == 0 || influences.size() == 0)
+      {
+         return 0.0f;
+      }
+
+      float difference = 0.0f;
+      for (unsigned int lhsComponent = 0; lhsComponent < 4; ++lhsComponent)
+      {
+         float weightOfJointInRHS = 0.0f;
+         for (unsigned int rhsComponent = 0; rhsComponent < 4; ++rhsComponent)
+         {
+            if (influences[rhs][rhsComponent] == influences[lhs][lhsComponent])
+            {
+               weightOfJointInRHS += weights[rhs][rhsComponent];
+            }
+         }
+
+         difference += glm::abs(weights[lhs][lhsComponent] - weightOfJointInRHS);
+      }
+
+      // Add the weights of the joints that only influence the RHS vertex
+      for (unsigned int rhsComponent = 0; rhsComponent < 4; ++rhsComponent)
+      {
+         bool jointInfluencesLHS = false;
+         for (unsigned int lhsComponent = 0; lhsComponent < 4; ++lhsComponent)
+         {
+            if (influences[lhs][lhsComponent] == influences[rhs][rhsComponent])
+            {
+               jointInfluencesLHS = true;
+            }
+         }
+
+         if (!jointInfluencesLHS)
+         {
+            difference += weights[rhs][rhsComponent];
+         }
+      }
+
+      return difference * 0.5f;
+   }
+
+   // A collapse is rejected if it flips any of the triangles that remain around the "from" vertex
+   // The triangles that contain both vertices are not checked, since they become degenerate and are removed
+   bool DoesCollapseFlipTriangles(const Collapse&                  collapse,
+                                  const std::vector<unsigned int>& weldedTriangles,
+                                  const Adjacency&                 vertexTriangles,
+                                  const std::vector<glm::vec3>&    positions)
+   {
+      for (unsigned int i = vertexTriangles.offsets[collapse.from],
+           end = vertexTriangles.offsets[collapse.from + 1];
+           i < end;
+           ++i)
+      {
+         unsigned int triangleIndex = vertexTriangles.items[i];
+         unsigned int v0 = weldedTriangles[(triangleIndex * 3) + 0];
+         unsigned int v1 = weldedTriangles[(triangleIndex * 3) + 1];
+         unsigned int v2 = weldedTriangles[(triangleIndex * 3) + 2];
+
+         if (v0 == collapse.to || v1 == collapse.to || v2 == collapse.to)
+         {
+            continue;
+         }
+
+         glm::vec3 p0 = positions[v0];
+         glm::vec3 p1 = positions[v1];
+         glm::vec3 p2 = positions[v2];
+         glm::vec3 normalBeforeCollapse = glm::cross(p1 - p0, p2 - p0);
+
+         const glm::vec3& destination = positions[collapse.to];
+         if (v0 == collapse.from) p0 = destination;
+         if (v1 == collapse.from) p1 = destination;
+         if (v2 == collapse.from) p2 = destination;
+         glm::vec3 normalAfterCollapse = glm::cross(p1 - p0, p2 - p0);
+
+         if (glm::dot(normalBeforeCollapse, normalAfterCollapse) <= 0.0f)
+         {
+            return true;
+         }
+      }
+
+      return false;
+   }
+
+   // When a corner of a triangle is moved onto a welded vertex, we pick the duplicate of that vertex whose attributes are the closest to the ones of the corner
+   unsigned int FindMostSimilarDuplicate(unsigned int                  vertexIndex,
+                                         unsigned int                  weldedVertexIndex,
+                                         const Adjacency&              duplicates,
+                                         const std::vector<glm::vec3>& normals,
+                                         const std::vector<glm::vec2>& texCoords)
+   {
+      unsigned int mostSimilarDuplicate = weldedVertexIndex;
+      float smallestDifference = -1.0f;
+
+      for (unsigned int i = duplicates.offsets[weldedVertexIndex],
+           end = duplicates.offsets[weldedVertexIndex + 1];
+           i < end;
+           ++i)
+      {
+         unsigned int duplicateIndex = duplicates.items[i];
+
+         float difference = 0.0f;
+         if (vertexIndex < normals.size())
+         {
+            glm::vec3 normalDifference = normals[vertexIndex] - normals[duplicateIndex];
+            difference += glm::dot(normalDifference, normalDifference);
+         }
+
+         if (vertexIndex < texCoords.size())
+         {
+            glm::vec2 texCoordDifference = texCoords[vertexIndex] - texCoords[duplicateIndex];
+            difference += glm::dot(texCoordDifference, texCoordDifference);
+         }
+
+         if (smallestDifference < 0.0f || difference < smallestDifference)
+         {
+            smallestDifference = difference;
+            mostSimilarDuplicate = duplicateIndex;
+         }
+      }
+
+      return mostSimilarDuplicate;
+   }
+
+   float CalculateRadius(const std::vector<glm::vec3>& positions)
+   {
+      AABB bounds;
+      for (unsigned int vertexIndex = 0,
+           numVertices = static_cast<unsigned int>(positions.size());
+           vertexIndex < numVertices;
+           ++vertexIndex)
+      {
+         bounds.Expand(positions[vertexIndex]);
+      }
+
+      return bounds.IsEmpty() ? 0.0f : glm::length(bounds.GetExtents());
+   }
+
+   // The animated and static versions of GenerateLODs only differ in the attributes that they pass to SimplifyMesh
+   template <typename MeshType>
+   void GenerateLODs(MeshType&                      mesh,
+                     const std::vector<glm::vec4>&  weights,
+                     const std::vector<glm::ivec4>& influences)
+   {
+      std::vector<std::vector<unsigned int>>& lodIndices = mesh.GetLODIndices();
+      std::vector<float>&                     lodErrors  = mesh.GetLODErrors();
+      lodIndices.clear();
+      lodErrors.clear();
+
+      const std::vector<unsigned int>& indices = mesh.GetIndices();
+      unsigned int numVertices = static_cast<unsigned int>(mesh.GetPositions().size());
+      if ((indices.size() / 3) < minNumTriangles || numVertices == 0)
+      {
+         return;
+      }
+
+      float maxError = CalculateRadius(mesh.GetPositions()) * firstLODRelativeError;
+      unsigned int numIndicesOfPreviousLOD = static_cast<unsigned int>(indices.size());
+
+      for (unsigned int lodIndex = 0; lodIndex < maxNumLODs; ++lodIndex)
+      {
+         unsigned int targetIndexCount = static_cast<unsigned int>((numIndicesOfPreviousLOD / 3) * lodTriangleRatio) * 3;
+
+         // Each LOD is simplified from the original mesh instead of the previous LOD so that the errors don't compound
+         float lodError = 0.0f;
+         std::vector<unsigned int> simplifiedIndices = SimplifyMesh(indices,
+                                                                    mesh.GetPositions(),
+                                                                    mesh.GetNormals(),
+                                                                    mesh.GetTexCoords(),
+                                                                    weights,
+                                                                    influences,
+                                                                    targetIndexCount,
+                                                                    maxError,
+                                                                    lodError);
+
+         if (simplifiedIndices.size() > numIndicesOfPreviousLOD * (1.0f - minLODTriangleReduction))
+         {
+            break;
+         }
+
+         // The errors must increase with the LODs for SelectLOD to work
+         if (lodErrors.size() > 0)
+         {
+            lodError = std::max(lodError, lodErrors.back());
+         }
+
+         numIndicesOfPreviousLOD = static_cast<unsigned int>(simplifiedIndices.size());
+         lodIndices.push_back(OptimizeVertexCache(simplifiedIndices, numVertices));
+         lodErrors.push_back(lodError);
+
+         maxError *= 2.0f;
+      }
+   }
+}
+
+std::vector<unsigned int> SimplifyMesh(const std::vector<unsigned int>& indices,
+                                       const std::vector<glm::vec3>&    positions,
+                                       const std::vector<glm::vec3>&    normals,
+                                       const std::vector<glm::vec2>&    texCoords,
+                                       const std::vector<glm::vec4>&    weights,
+                                       const std::vector<glm::ivec4>&   influences,
+                                       unsigned int                     targetIndexCount,
+                                       float                            maxError,
+                                       float&                           resultError)
+{
+   using namespace MeshSimplifierHelpers;
+
+   resultError = 0.0f;
+
+   unsigned int numVertices = static_cast<unsigned int>(positions.size());
+   unsigned int targetNumTriangles = targetIndexCount / 3;
+
+   if ((indices.size() / 3) <= targetNumTriangles || numVertices == 0)
+   {
+      return indices;
+   }
+
+   std::vector<unsigned int> weldedVertices = WeldVertices(positions);
+   Adjacency duplicates = BuildAdjacency(weldedVertices, numVertices, 1);
+
+   // We keep two versions of the triangles:
+   // - The corners, which are the indices of the original vertices
+   // - The welded triangles, which are the indices of the welded vertices that the corners currently collapse to
+   // Triangles that are degenerate once welded don't cover any area, so we get rid of them right away
+   std::vector<unsigned int> corners;
+   std::vector<unsigned int> weldedTriangles;
+   corners.reserve(indices.size());
+   weldedTriangles.reserve(indices.size());
+
+   for (unsigned int i = 0,
+        size = static_cast<unsigned int>(indices.size()) - (static_cast<unsigned int>(indices.size()) % 3);
+        i < size;
+        i += 3)
+   {
+      unsigned int w0 = weldedVertices[indices[i + 0]];
+      unsigned int w1 = weldedVertices[indices[i + 1]];
+      unsigned int w2 = weldedVertices[indices[i + 2]];
+
+      if (w0 != w1 && w1 != w2 && w2 != w0)
+      {
+         corners.insert(corners.end(), { indices[i + 0], indices[i + 1], indices[i + 2] });
+         weldedTriangles.insert(weldedTriangles.end(), { w0, w1, w2 });
+      }
+   }
+
+   // Initialize the quadric of each welded vertex with the planes of the triangles that touch it
+   std::vector<Quadric> quadrics(numVertices);
+   for (unsigned int i = 0,
+        size = static_cast<unsigned int>(weldedTriangles.size());
+        i < size;
+        i += 3)
+   {
+      const glm::vec3& p0 = positions[weldedTriangles[i + 0]];
+      const glm::vec3& p1 = positions[weldedTriangles[i + 1]];
+      const glm::vec3& p2 = positions[weldedTriangles[i + 2]];
+
+      glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+      float length = glm::length(normal);
+      if (length == 0.0f)
+      {
+         continue;
+      }
+
+      normal /= length;
+      Quadric planeQuadric(normal.x, normal.y, normal.z, -glm::dot(normal, p0));
+
+      quadrics[weldedTriangles[i + 0]].Add(planeQuadric);
+      quadrics[weldedTriangles[i + 1]].Add(planeQuadric);
+      quadrics[weldedTriangles[i + 2]].Add(planeQuadric);
+   }
+
+   std::vector<bool> lockedVertices = FindLockedVertices(weldedTriangles, numVertices);
+
+   std::vector<unsigned int> collapseTargets(numVertices);
+   for (unsigned int vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+   {
+      collapseTargets[vertexIndex] = vertexIndex;
+   }
+
+   double maxCost = static_cast<double>(maxError) * static_cast<double>(maxError);
+   double maxCollapseError = 0.0;
+
+   /*
+      The collapses are performed in passes:
+
+      1) We calculate the cost of collapsing each edge in both directions and keep the cheapest direction
+      2) We sort the collapses by their costs
+      3) We perform as many collapses as we can in order, skipping the ones that touch a vertex whose neighbourhood
+         has already been modified in this pass, since their costs and flip tests are out of date
+      4) We remove the triangles that became degenerate and start a new pass
+
+      This is simpler and faster than keeping a priority queue of collapses up to date, and it produces similar results
+   */
+   while ((weldedTriangles.size() / 3) > targetNumTriangles)
+   {
+      unsigned int numTriangles = static_cast<unsigned int>(weldedTriangles.size() / 3);
+      Adjacency vertexTriangles = BuildAdjacency(weldedTriangles, numVertices, 3);
+
+      // Find the unique edges
+      std::vector<std::pair<unsigned int, unsigned int>> edges;
+      edges.reserve(weldedTriangles.size());
+      for (unsigned int i = 0,
+           size = static_cast<unsigned int>(weldedTriangles.size());
+           i < size;
+           i += 3)
+      {
+         for (unsigned int corner = 0; corner < 3; ++corner)
+         {
+            unsigned int v0 = weldedTriangles[i + corner];
+            unsigned int v1 = weldedTriangles[i + ((corner + 1) % 3)];
+            edges.push_back(std::make_pair(std::min(v0, v1), std::max(v0, v1)));
+         }
+      }
+
+      std::sort(edges.begin(), edges.end());
+      edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+      // Calculate the cost of each collapse
+      std::vector<Collapse> collapses;
+      collapses.reserve(edges.size());
+      for (unsigned int i = 0,
+           size = static_cast<unsigned int>(edges.size());
+           i < size;
+           ++i)
+      {
+         unsigned int v0 = edges[i].first;
+         unsigned int v1 = edges[i].second;
+         if (lockedVertices[v0] && lockedVertices[v1])
+         {
+            continue;
+         }
+
+         Quadric combinedQuadric = quadrics[v0];
+         combinedQuadric.Add(quadrics[v1]);
+
+         double skinPenalty = static_cast<double>(CalculateSkinWeightDifference(weights, influences, v0, v1) * skinWeightPenalty) * maxCost;
+
+         Collapse collapse;
+         collapse.cost = -1.0;
+
+         if (!lockedVertices[v0])
+         {
+            collapse.from  = v0;
+            collapse.to    = v1;
+            collapse.error = combinedQuadric.Evaluate(positions[v1]);
+            collapse.cost  = collapse.error + skinPenalty;
+         }
+
+         if (!lockedVertices[v1])
+         {
+            double error = combinedQuadric.Evaluate(positions[v0]);
+            if (collapse.cost < 0.0 || (error + skinPenalty) < collapse.cost)
+            {
+               collapse.from  = v1;
+               collapse.to    = v0;
+               collapse.error = error;
+               collapse.cost  = error + skinPenalty;
+            }
+         }
+
+         if (collapse.cost <= maxCost)
+         {
+            collapses.push_back(collapse);
+         }
+      }
+
+      std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs)
+      {
+         return lhs.cost < rhs.cost;
+      });
+
+      // Perform the collapses
+      std::vector<bool> modifiedVertices(numVertices, false);
+      unsigned int numTrianglesToRemove = numTriangles - targetNumTriangles;
+      unsigned int numTrianglesRemoved = 0;
+      unsigned int numCollapsesPerformed = 0;
+
+      for (unsigned int i = 0,
+           size = static_cast<unsigned int>(collapses.size());
+           i < size && numTrianglesRemoved < numTrianglesToRemove;
+           ++i)
+      {
+         const Collapse& collapse = collapses[i];
+         if (modifiedVertices[collapse.from] || modifiedVertices[collapse.to])
+         {
+            continue;
+         }
+
+         if (DoesCollapseFlipTriangles(collapse, weldedTriangles, vertexTriangles, positions))
+         {
+            continue;
+         }
+
+         quadrics[collapse.to].Add(quadrics[collapse.from]);
+         collapseTargets[collapse.from] = collapse.to;
+         maxCollapseError = std::max(maxCollapseError, collapse.error);
+         ++numCollapsesPerformed;
+
+         // Mark every vertex around the "from" vertex as modified, and count the triangles that will become degenerate
+         for (unsigned int j = vertexTriangles.offsets[collapse.from],
+              end = vertexTriangles.offsets[collapse.from + 1];
+              j < end;
+              ++j)
+         {
+            unsigned int triangleIndex = vertexTriangles.items[j];
+            bool triangleContainsTo = false;
+
+            for (unsigned int corner = 0; corner < 3; ++corner)
+            {
+               unsigned int vertexIndex = weldedTriangles[(triangleIndex * 3) + corner];
+               modifiedVertices[vertexIndex] = true;
+               triangleContainsTo = triangleContainsTo || (vertexIndex == collapse.to);
+            }
+
+            if (triangleContainsTo)
+            {
+               ++numTrianglesRemoved;
+            }
+         }
+      }
+
+      if (numCollapsesPerformed == 0)
+      {
+         break;
+      }
+
+      // Apply the collapses and remove the degenerate triangles
+      // A vertex can't be collapsed onto a vertex that was collapsed in the same pass, so a single lookup is enough
+      unsigned int numRemainingIndices = 0;
+      for (unsigned int i = 0,
+           size = static_cast<unsigned int>(weldedTriangles.size());
+           i < size;
+           i += 3)
+      {
+         unsigned int w0 = collapseTargets[weldedTriangles[i + 0]];
+         unsigned int w1 = collapseTargets[weldedTriangles[i + 1]];
+         unsigned int w2 = collapseTargets[weldedTriangles[i + 2]];
+
+         if (w0 == w1 || w1 == w2 || w2 == w0)
+         {
+            continue;
+         }
+
+         weldedTriangles[numRemainingIndices + 0] = w0;
+         weldedTriangles[numRemainingIndices + 1] = w1;
+         weldedTriangles[numRemainingIndices + 2] = w2;
+         corners[numRemainingIndices + 0] = corners[i + 0];
+         corners[numRemainingIndices + 1] = corners[i + 1];
+         corners[numRemainingIndices + 2] = corners[i + 2];
+         numRemainingIndices += 3;
+      }
+
+      weldedTriangles.resize(numRemainingIndices);
+      corners.resize(numRemainingIndices);
+   }
+
+   // Convert the corners back into indices of original vertices
+   // Corners whose welded vertex was collapsed are moved to the most similar duplicate of the welded vertex that they collapsed onto
+   std::vector<unsigned int> simplifiedIndices(corners.size());
+   for (unsigned int i = 0,
+        size = static_cast<unsigned int>(corners.size());
+        i < size;
+        ++i)
+   {
+      unsigned int vertexIndex = corners[i];
+      if (weldedVertices[vertexIndex] == weldedTriangles[i])
+      {
+         simplifiedIndices[i] = vertexIndex;
+      }
+      else
+      {
+         simplifiedIndices[i] = FindMostSimilarDuplicate(vertexIndex, weldedTriangles[i], duplicates, normals, texCoords);
+      }
+   }
+
+   resultError = static_cast<float>(std::sqrt(maxCollapseError));
+
+   return simplifiedIndices;
+}
+
+void GenerateLODs(AnimatedMesh& mesh)
+{
+   MeshSimplifierHelpers::GenerateLODs(mesh, mesh.GetWeights(), mesh.GetInfluences());
+}
+
+void GenerateLODs(StaticMesh& mesh)
+{
+   MeshSimplifierHelpers::GenerateLODs(mesh, std::vector<glm::vec4>(), std::vector<glm::ivec4>());
+}
+
+/*
+   A LOD whose error is E world units looks like this on the screen when it's D units away from a camera with a perspective projection:
+
+   errorInPix = E * pixelsPerUnitAtUnitDistance / D
+
+   Where pixelsPerUnitAtUnitDistance = (viewportHeightInPix / 2) / tan(fovY / 2), which is the same as (viewportHeightInPix / 2) * projection[1][1]
+*/
+unsigned int SelectLOD(const std::vector<float>& lodErrors,
+                       float                     distanceToCamera,
+                       float                     pixelsPerUnitAtUnitDistance,
+                       float                     maxScreenSpaceErrorInPix,
+                       unsigned int              minLODIndex)
+{
+   unsigned int numLODs = static_cast<unsigned int>(lodErrors.size()) + 1;
+
+   // Avoid dividing by zero when the camera is inside the bounds of the mesh
+   float distance = std::max(distanceToCamera, 0.0001f);
+
+   unsigned int lodIndex = 0;
+   while (lodIndex < (numLODs - 1) &&
+          (lodErrors[lodIndex] * pixelsPerUnitAtUnitDistance / distance) <= maxScreenSpaceErrorInPix)
+   {
+      ++lodIndex;
+   }
+
+   return std::min(std::max(lodIndex, minLODIndex), numLODs - 1);
+}
+
+void BenchmarkMeshSimplifier(AnimatedMesh& mesh)
+{
+   // Generating the LODs again produces the same chain that the mesh got when it was loaded, since the LODs are always simplified from the original mesh
+   auto start = std::chrono::steady_clock::now();
+   GenerateLODs(mesh);
+   auto end = std::chrono::steady_clock::now();
+
+   std::vector<std::vector<unsigned int>>& lodIndices = mesh.GetLODIndices();
+   std::vector<float>&                     lodErrors  = mesh.GetLODErrors();
+
+   std::cout << "LOD generation - Triangles: " << (mesh.GetIndices().size() / 3) << ", LODs: " << lodIndices.size()
+             << ", Generated in " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << '\n';
+
+   for (unsigned int lodIndex = 0,
+        numLODs = static_cast<unsigned int>(lodIndices.size());
+        lodIndex < numLODs;
+        ++lodIndex)
+   {
+      std::cout << "   LOD " << (lodIndex + 1) << ": " << (lodIndices[lodIndex].size() / 3) << " triangles, Error: " << lodErrors[lodIndex] << '\n';
+   }
+}
@@ -6,15 +6,16 @@
 #include "shader_loader.h"
 #include "texture_loader.h"
 #include "GLTFLoader.h"
-#include "RearrangeBones.h"
 #include "ModelViewerState.h"
 
 #ifdef USE_THIRD_PERSON_CAMERA
 ModelViewerState::ModelViewerState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
-                                   const std::shared_ptr<Window>&             window)
+                                   const std::shared_ptr<Window>&             window,
+                                   const std::shared_ptr<AssetLoader>&        assetLoader)
 #else
 ModelViewerState::ModelViewerState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
                                    const std::shared_ptr<Window>&             window,
+                                   const std::shared_ptr<AssetLoader>&        assetLoader,
                                    const std::shared_ptr<Camera>&             camera)
 #endif
    : mFSM(finiteStateMachine)
@@ -41,37 +42,30 @@ ModelViewerState::ModelViewerState(const std::shared_ptr<FiniteStateMachine>& fi
    configureLights(mGroundShader);
 
    // Load the diffuse texture of the animated character
-   mDiffuseTexture = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>("resources/models/woman/woman.png");
+   mDiffuseTexture = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>(assetLoader->GetImage("resources/models/woman/woman.png"));
 
    // Load the animated character
-   cgltf_data* data        = LoadGLTFFile("resources/models/woman/woman.gltf");
-   mSkeleton               = LoadSkeleton(data);
-   mAnimatedMeshes         = LoadAnimatedMeshes(data);
-   std::vector<Clip> clips = LoadClips(data);
-   FreeGLTFFile(data);
-
-   // Rearrange the skeleton
-   JointMap jointMap = RearrangeSkeleton(mSkeleton);
+   mCharacter = assetLoader->GetCharacter("resources/models/woman/woman.glb", "resources/models/woman/woman.bake");
+   mSkeleton  = mCharacter->skeleton;
 
-   // Rearrange the meshes
+   // The meshes of the state share the vertices and the static buffers of the meshes of the character,
+   // and they only store what changes when the character is animated, since each state morphs and skins its own vertices
+   mAnimatedMeshes.resize(mCharacter->meshes.size());
    for (unsigned int meshIndex = 0,
         numMeshes = static_cast<unsigned int>(mAnimatedMeshes.size());
         meshIndex < numMeshes;
         ++meshIndex)
    {
-      RearrangeMesh(mAnimatedMeshes[meshIndex], jointMap);
+      mAnimatedMeshes[meshIndex].ShareMeshData(mCharacter->meshes[meshIndex]);
    }
 
-   // Optimize the clips, rearrange them and get their names
-   mClips.resize(clips.size());
+   // Get the names of the clips
    for (unsigned int clipIndex = 0,
-        numClips = static_cast<unsigned int>(clips.size());
+        numClips = mCharacter->clips->GetNumberOfClips();
         clipIndex < numClips;
         ++clipIndex)
    {
-      mClips[clipIndex] = OptimizeClip(clips[clipIndex]);
-      RearrangeFastClip(mClips[clipIndex], jointMap);
-      mClipNames += (mClips[clipIndex].GetName() + '\0');
+      mClipNames += (mCharacter->clips->GetClipName(clipIndex) + '\0');
    }
 
    // Configure the VAOs of the animated meshes
@@ -85,6 +79,7 @@ ModelViewerState::ModelViewerState(const std::shared_ptr<FiniteStateMachine>& fi
         i < size;
         ++i)
    {
+      mAnimatedMeshes[i].LoadBuffers();
       mAnimatedMeshes[i].ConfigureVAO(positionsAttribLocOfAnimatedShader,
                                       normalsAttribLocOfAnimatedShader,
                                       texCoordsAttribLocOfAnimatedShader,
@@ -93,7 +88,7 @@ ModelViewerState::ModelViewerState(const std::shared_ptr<FiniteStateMachine>& fi
    }
 
    // Load the ground
-   data = LoadGLTFFile("resources/models/table/wooden_floor.gltf");
+   cgltf_data* data = LoadGLTFFile("resources/models/table/wooden_floor.glb");
    mGroundMeshes = LoadStaticMeshes(data);
    FreeGLTFFile(data);
 
@@ -107,13 +102,11 @@ ModelViewerState::ModelViewerState(const std::shared_ptr<FiniteStateMachine>& fi
    {
       mGroundMeshes[i].ConfigureVAO(positionsAttribLocOfStaticShader,
                                     normalsAttribLocOfStaticShader,
-                                    texCoordsAttribLocOfStaticShader,
-                                    -1,
-                                    -1);
+                                    texCoordsAttribLocOfStaticShader);
    }
 
    // Load the texture of the ground
-   mGroundTexture = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>("resources/models/table/wooden_floor.jpg");
+   mGroundTexture = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>(assetLoader->GetImage("resources/models/table/wooden_floor.jpg"));
 
    initializeState();
 
@@ -126,16 +119,13 @@ void ModelViewerState::initializeState()
    mPause = false;
 
    // Set the initial clip
-   unsigned int numClips = static_cast<unsigned int>(mClips.size());
-   for (unsigned int clipIndex = 0; clipIndex < numClips; ++clipIndex)
+   int walkingClipIndex = mCharacter->clips->GetClipIndex("Walking");
+   if (walkingClipIndex != -1)
    {
-      if (mClips[clipIndex].GetName() == "Walking")
-      {
-         mSelectedClip = clipIndex;
-         mAnimationData.currentClipIndex = clipIndex;
-         break;
-      }
+      mSelectedClip = walkingClipIndex;
+      mAnimationData.currentClipIndex = walkingClipIndex;
    }
+   mAnimationData.currentClip = mCharacter->clips->GetClip(mAnimationData.currentClipIndex);
 
    // Set the initial skinning mode
    mSelectedSkinningMode = SkinningMode::GPU;
@@ -340,6 +330,7 @@ void ModelViewerState::update(float deltaTime)
    if (mAnimationData.currentClipIndex != mSelectedClip)
    {
       mAnimationData.currentClipIndex = mSelectedClip;
+      mAnimationData.currentClip      = mCharacter->clips->GetClip(mAnimationData.currentClipIndex);
       mAnimationData.animatedPose     = mSkeleton.GetRestPose();
       mAnimationData.playbackTime     = 0.0f;
    }
@@ -359,7 +350,7 @@ void ModelViewerState::update(float deltaTime)
    }
 
    // Sample the clip to get the animated pose
-   FastClip& currClip = mClips[mAnimationData.currentClipIndex];
+   const FastClip& currClip = *mAnimationData.currentClip;
    mAnimationData.playbackTime = currClip.Sample(mAnimationData.animatedPose, mAnimationData.playbackTime + (deltaTime * mSelectedPlaybackSpeed));
 
    // Get the palette of the animated pose
@@ -377,6 +368,13 @@ void ModelViewerState::update(float deltaTime)
       mAnimationData.skinMatrices[i] = mAnimationData.animatedPosePalette[i] * inverseBindPose[i];
    }
 
+   // Apply the morph targets of the meshes that have them
+   // This must happen before skinning, since the deltas of the morph targets are defined in the space of the bind pose
+   for (unsigned int i = 0, size = (unsigned int)mAnimatedMeshes.size(); i < size; ++i)
+   {
+      mAnimatedMeshes[i].ApplyMorphTargetsOfClip(currClip, mAnimationData.playbackTime, mAnimationData.currentSkinningMode == SkinningMode::GPU);
+   }
+
    // Skin the meshes on the CPU if that's the current skinning mode
    if (mAnimationData.currentSkinningMode == SkinningMode::CPU)
    {
@@ -557,7 +555,9 @@ void ModelViewerState::render()
 
 void ModelViewerState::exit()
 {
-
+   // The state doesn't play anything while it's inactive, so it lets the clip library evict its clip
+   // Entering the state again requests the clip again
+   mAnimationData.currentClip = nullptr;
 }
 
 void ModelViewerState::configureLights(const std::shared_ptr<Shader>& shader)
@@ -646,15 +646,15 @@ void ModelViewerState::switchFromCPUToGPU()
                                       influencesAttribLocOfAnimatedShader);
    }
 
-   // TODO: This is inefficient. We just need to load the positions and normals.
    // Load the original positions and normals because the CPU skinning algorithm
    // has been modifying them every frame
+   // They live in the dynamic buffer, so that's the only buffer we need to reload
    for (unsigned int i = 0,
         size = static_cast<unsigned int>(mAnimatedMeshes.size());
         i < size;
         ++i)
    {
-      mAnimatedMeshes[i].LoadBuffers();
+      mAnimatedMeshes[i].LoadDynamicBuffer();
    }
 }
 
@@ -695,12 +695,12 @@ void ModelViewerState::userInterface()
 
       ImGui::SliderFloat("Playback Speed", &mSelectedPlaybackSpeed, 0.0f, 2.0f, "%.3f");
 
-      float durationOfCurrClip = mClips[mAnimationData.currentClipIndex].GetDuration();
+      float durationOfCurrClip = mAnimationData.currentClip->GetDuration();
       char progress[32];
       snprintf(progress, 32, "%.3f / %.3f", mAnimationData.playbackTime, durationOfCurrClip);
       ImGui::ProgressBar(mAnimationData.playbackTime / durationOfCurrClip, ImVec2(0.0f, 0.0f), progress);
 
-      //float normalizedPlaybackTime = (mAnimationData.playbackTime - mClips[mAnimationData.currentClipIndex].GetStartTime()) / mClips[mAnimationData.currentClipIndex].GetDuration();
+      //float normalizedPlaybackTime = (mAnimationData.playbackTime - mCharacter->clips[mAnimationData.currentClipIndex].GetStartTime()) / mCharacter->clips[mAnimationData.currentClipIndex].GetDuration();
       //char progress[32];
       //snprintf(progress, 32, "%.3f", normalizedPlaybackTime);
       //ImGui::ProgressBar(normalizedPlaybackTime, ImVec2(0.0f, 0.0f), progress);
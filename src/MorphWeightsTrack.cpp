@@ -0,0 +1,152 @@
+#include "MorphWeightsTrack.h"
+
+template <typename STRACK>
+TMorphWeightsTrack<STRACK>::TMorphWeightsTrack()
+   : mNodeID(0)
+{
+
+}
+
+template <typename STRACK>
+unsigned int TMorphWeightsTrack<STRACK>::GetNodeID() const
+{
+   return mNodeID;
+}
+
+template <typename STRACK>
+void TMorphWeightsTrack<STRACK>::SetNodeID(unsigned int id)
+{
+   mNodeID = id;
+}
+
+template <typename STRACK>
+unsigned int TMorphWeightsTrack<STRACK>::GetNumberOfTargets() const
+{
+   return static_cast<unsigned int>(mWeightTracks.size());
+}
+
+template <typename STRACK>
+void TMorphWeightsTrack<STRACK>::SetNumberOfTargets(unsigned int numTargets)
+{
+   mWeightTracks.resize(numTargets);
+}
+
+template <typename STRACK>
+STRACK& TMorphWeightsTrack<STRACK>::GetWeightTrack(unsigned int targetIndex)
+{
+   return mWeightTracks[targetIndex];
+}
+
+template <typename STRACK>
+void TMorphWeightsTrack<STRACK>::SetWeightTrack(unsigned int targetIndex, const STRACK& weightTrack)
+{
+   mWeightTracks[targetIndex] = weightTrack;
+}
+
+template <typename STRACK>
+bool TMorphWeightsTrack<STRACK>::IsValid() const
+{
+   for (unsigned int targetIndex = 0,
+        numTargets = static_cast<unsigned int>(mWeightTracks.size());
+        targetIndex < numTargets;
+        ++targetIndex)
+   {
+      if (mWeightTracks[targetIndex].GetNumberOfFrames() > 1)
+      {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+template <typename STRACK>
+float TMorphWeightsTrack<STRACK>::GetStartTime() const
+{
+   // Find the earliest start time out of the weight tracks
+
+   float startTime = 0.0f;
+   bool  initialStartTimeFound = false;
+
+   for (unsigned int targetIndex = 0,
+        numTargets = static_cast<unsigned int>(mWeightTracks.size());
+        targetIndex < numTargets;
+        ++targetIndex)
+   {
+      if (mWeightTracks[targetIndex].GetNumberOfFrames() > 1)
+      {
+         float weightStartTime = mWeightTracks[targetIndex].GetStartTime();
+         if (weightStartTime < startTime || !initialStartTimeFound)
+         {
+            startTime = weightStartTime;
+            initialStartTimeFound = true;
+         }
+      }
+   }
+
+   return startTime;
+}
+
+template <typename STRACK>
+float TMorphWeightsTrack<STRACK>::GetEndTime() const
+{
+   // Find the latest end time out of the weight tracks
+
+   float endTime = 0.0f;
+   bool  initialEndTimeFound = false;
+
+   for (unsigned int targetIndex = 0,
+        numTargets = static_cast<unsigned int>(mWeightTracks.size());
+        targetIndex < numTargets;
+        ++targetIndex)
+   {
+      if (mWeightTracks[targetIndex].GetNumberOfFrames() > 1)
+      {
+         float weightEndTime = mWeightTracks[targetIndex].GetEndTime();
+         if (weightEndTime > endTime || !initialEndTimeFound)
+         {
+            endTime = weightEndTime;
+            initialEndTimeFound = true;
+         }
+      }
+   }
+
+   return endTime;
+}
+
+template <typename STRACK>
+void TMorphWeightsTrack<STRACK>::Sample(std::vector<float>& ioWeights, float time, bool looping) const
+{
+   // Only sample the tracks that are animated
+   // The weights of the morph targets that are not animated keep their default values
+   for (unsigned int targetIndex = 0,
+        numTargets = static_cast<unsigned int>(glm::min(mWeightTracks.size(), ioWeights.size()));
+        targetIndex < numTargets;
+        ++targetIndex)
+   {
+      if (mWeightTracks[targetIndex].GetNumberOfFrames() > 1)
+      {
+         ioWeights[targetIndex] = mWeightTracks[targetIndex].Sample(time, looping);
+      }
+   }
+}
+
+FastMorphWeightsTrack OptimizeMorphWeightsTrack(MorphWeightsTrack& morphWeightsTrack)
+{
+   FastMorphWeightsTrack result;
+
+   result.SetNodeID(morphWeightsTrack.GetNodeID());
+
+   unsigned int numTargets = morphWeightsTrack.GetNumberOfTargets();
+   result.SetNumberOfTargets(numTargets);
+   for (unsigned int targetIndex = 0; targetIndex < numTargets; ++targetIndex)
+   {
+      result.SetWeightTrack(targetIndex, OptimizeTrack<float, 1>(morphWeightsTrack.GetWeightTrack(targetIndex)));
+   }
+
+   return result;
+}
+
+// Instantiate the desired MorphWeightsTrack classes from the MorphWeightsTrack class template
+template class TMorphWeightsTrack<ScalarTrack>;
+template class TMorphWeightsTrack<FastScalarTrack>;
@@ -6,7 +6,7 @@
 #include "shader_loader.h"
 #include "texture_loader.h"
 #include "GLTFLoader.h"
-#include "RearrangeBones.h"
+#include "MeshSimplifier.h"
 #include "MovementState.h"
 
 #ifdef __EMSCRIPTEN__
@@ -15,7 +15,8 @@ extern std::string runInstruction;
 #endif
 
 MovementState::MovementState(const std::shared_ptr<FiniteStateMachine>& finiteStateMachine,
-                             const std::shared_ptr<Window>&             window)
+                             const std::shared_ptr<Window>&             window,
+                             const std::shared_ptr<AssetLoader>&        assetLoader)
    : mFSM(finiteStateMachine)
    , mWindow(window)
    , mCamera3(14.0f, 25.0f, glm::vec3(0.0f), Q::quat(), glm::vec3(0.0f, 3.0f, 0.0f), 0.0f, 30.0f, 0.0f, 90.0f, 45.0f, 1280.0f / 720.0f, 0.1f, 130.0f, 0.25f)
@@ -31,40 +32,29 @@ MovementState::MovementState(const std::shared_ptr<FiniteStateMachine>& finiteSt
    configureLights(mStaticMeshShader);
 
    // Load the diffuse texture of the animated character
-   mDiffuseTexture = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>("resources/models/woman/woman.png");
+   mDiffuseTexture = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>(assetLoader->GetImage("resources/models/woman/woman.png"));
 
    // Load the animated character
-   cgltf_data* data        = LoadGLTFFile("resources/models/woman/woman.gltf");
-   mSkeleton               = LoadSkeleton(data);
-   mAnimatedMeshes         = LoadAnimatedMeshes(data);
-   std::vector<Clip> clips = LoadClips(data);
-   FreeGLTFFile(data);
-
-   // Rearrange the skeleton
-   JointMap jointMap = RearrangeSkeleton(mSkeleton);
+   mCharacter = assetLoader->GetCharacter("resources/models/woman/woman.glb", "resources/models/woman/woman.bake");
+   mSkeleton  = mCharacter->skeleton;
 
-   // Rearrange the meshes
+   // The meshes of the state share the vertices and the static buffers of the meshes of the character,
+   // and they only store what changes when the character is animated, since each state morphs and skins its own vertices
+   mAnimatedMeshes.resize(mCharacter->meshes.size());
    for (unsigned int meshIndex = 0,
         numMeshes = static_cast<unsigned int>(mAnimatedMeshes.size());
         meshIndex < numMeshes;
         ++meshIndex)
    {
-      RearrangeMesh(mAnimatedMeshes[meshIndex], jointMap);
+      mAnimatedMeshes[meshIndex].ShareMeshData(mCharacter->meshes[meshIndex]);
    }
 
-   // Optimize the clips, rearrange them and store them
-   for (unsigned int clipIndex = 0,
-        numClips = static_cast<unsigned int>(clips.size());
-        clipIndex < numClips;
-        ++clipIndex)
-   {
-      FastClip currClip = OptimizeClip(clips[clipIndex]);
-      RearrangeFastClip(currClip, jointMap);
-      mClips.insert(std::make_pair(currClip.GetName(), currClip));
-   }
+   // Copy the jumps, which are released right away so that the clip library can evict them
+   mJumpClip = *mCharacter->clips->GetClip("Jump");
+   mJumpClip.SetLooping(false);
 
-   mClips["Jump"].SetLooping(false);
-   mClips["Jump2"].SetLooping(false);
+   mJump2Clip = *mCharacter->clips->GetClip("Jump2");
+   mJump2Clip.SetLooping(false);
 
    // Configure the VAOs of the animated meshes
    int positionsAttribLocOfAnimatedShader  = mAnimatedMeshShader->getAttributeLocation("position");
@@ -77,6 +67,7 @@ MovementState::MovementState(const std::shared_ptr<FiniteStateMachine>& finiteSt
         i < size;
         ++i)
    {
+      mAnimatedMeshes[i].LoadBuffers();
       mAnimatedMeshes[i].ConfigureVAO(positionsAttribLocOfAnimatedShader,
                                       normalsAttribLocOfAnimatedShader,
                                       texCoordsAttribLocOfAnimatedShader,
@@ -85,7 +76,7 @@ MovementState::MovementState(const std::shared_ptr<FiniteStateMachine>& finiteSt
    }
 
    // Load the ground
-   data = LoadGLTFFile("resources/models/ground/platform.gltf");
+   cgltf_data* data = LoadGLTFFile("resources/models/ground/platform.glb");
    mGroundMeshes = LoadStaticMeshes(data);
    FreeGLTFFile(data);
 
@@ -99,13 +90,11 @@ MovementState::MovementState(const std::shared_ptr<FiniteStateMachine>& finiteSt
    {
       mGroundMeshes[i].ConfigureVAO(positionsAttribLocOfStaticShader,
                                     normalsAttribLocOfStaticShader,
-                                    texCoordsAttribLocOfStaticShader,
-                                    -1,
-                                    -1);
+                                    texCoordsAttribLocOfStaticShader);
    }
 
    // Load the texture of the ground
-   mGroundTexture = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>("resources/models/ground/platform.png");
+   mGroundTexture = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>(assetLoader->GetImage("resources/models/ground/platform.png"));
 
    initializeState();
 
@@ -125,7 +114,7 @@ void MovementState::initializeState()
 
    // Set the initial clip and initialize the crossfade controller
    mCrossFadeController.SetSkeleton(mSkeleton);
-   mCrossFadeController.Play(&mClips["Idle"], false);
+   mCrossFadeController.Play(getClip("Idle"), false);
    mCrossFadeController.Update(0.0f);
    mCrossFadeController.GetCurrentPose().GetMatrixPalette(mPosePalette);
 
@@ -142,6 +131,12 @@ void MovementState::initializeState()
    mWireframeModeForJoints = false;
    mPerformDepthTesting = true;
 #endif
+   mPerformFrustumCulling = true;
+   mNumMeshesSubmitted = 0;
+   mNumMeshesCulled = 0;
+   mPerformLODSelection = true;
+   mMaxScreenSpaceErrorInPix = 1.0f;
+   mCharacterLODIndex = 0;
    mSelectedConstantAttenuation = 1.0f;
    mSelectedLinearAttenuation = 0.0f;
    mSelectedQuadraticAttenuation = 0.009f;
@@ -298,17 +293,17 @@ void MovementState::processInput(float deltaTime)
 
       if (mIsWalking)
       {
-         mCrossFadeController.FadeTo(&mClips["Jump2"], 0.1f, true);
+         mCrossFadeController.FadeTo(getClip("Jump2"), 0.1f, true);
          mJumpingWhileWalking = true;
       }
       else if (mIsRunning)
       {
-         mCrossFadeController.FadeTo(&mClips["Jump2"], 0.1f, true);
+         mCrossFadeController.FadeTo(getClip("Jump2"), 0.1f, true);
          mJumpingWhileRunning = true;
       }
       else
       {
-         mCrossFadeController.FadeTo(&mClips["Jump"], 0.1f, true);
+         mCrossFadeController.FadeTo(getClip("Jump"), 0.1f, true);
          mJumpingWhileIdle = true;
       }
 
@@ -323,17 +318,17 @@ void MovementState::processInput(float deltaTime)
 
          if (mIsWalking)
          {
-            mCrossFadeController.FadeTo(&mClips["Walking"], 0.15f, false);
+            mCrossFadeController.FadeTo(getClip("Walking"), 0.15f, false);
             mJumpingWhileWalking = false;
          }
          else if (mIsRunning)
          {
-            mCrossFadeController.FadeTo(&mClips["Running"], 0.15f, false);
+            mCrossFadeController.FadeTo(getClip("Running"), 0.15f, false);
             mJumpingWhileRunning = false;
          }
          else
          {
-            mCrossFadeController.FadeTo(&mClips["Idle"], 0.1f, false);
+            mCrossFadeController.FadeTo(getClip("Idle"), 0.1f, false);
             mJumpingWhileIdle = false;
          }
 
@@ -348,12 +343,12 @@ void MovementState::processInput(float deltaTime)
          if (runKeyPressed)
          {
             mIsRunning = true;
-            mCrossFadeController.FadeTo(&mClips["Running"], 0.25f, false);
+            mCrossFadeController.FadeTo(getClip("Running"), 0.25f, false);
          }
          else
          {
             mIsWalking = true;
-            mCrossFadeController.FadeTo(&mClips["Walking"], 0.25f, false);
+            mCrossFadeController.FadeTo(getClip("Walking"), 0.25f, false);
          }
       }
       else if (mIsWalking)
@@ -362,7 +357,7 @@ void MovementState::processInput(float deltaTime)
          {
             mIsWalking = false;
             mIsRunning = true;
-            mCrossFadeController.FadeTo(&mClips["Running"], 0.25f, false);
+            mCrossFadeController.FadeTo(getClip("Running"), 0.25f, false);
          }
       }
       else if (mIsRunning)
@@ -371,7 +366,7 @@ void MovementState::processInput(float deltaTime)
          {
             mIsRunning = false;
             mIsWalking = true;
-            mCrossFadeController.FadeTo(&mClips["Walking"], 0.25f, false);
+            mCrossFadeController.FadeTo(getClip("Walking"), 0.25f, false);
          }
       }
    }
@@ -381,7 +376,7 @@ void MovementState::processInput(float deltaTime)
       {
          mIsRunning = false;
          mIsWalking = false;
-         mCrossFadeController.FadeTo(&mClips["Idle"], 0.25f, false);
+         mCrossFadeController.FadeTo(getClip("Idle"), 0.25f, false);
       }
    }
 }
@@ -407,6 +402,11 @@ void MovementState::update(float deltaTime)
    // Ask the crossfade controller to sample the current clip and fade with the next one if necessary
    mCrossFadeController.Update(deltaTime);
 
+   // Release the clips that stopped playing and load the ones that the character is likely to play next
+   releaseClipsThatAreNotPlaying();
+   prefetchNextClips();
+   mCharacter->clips->Update();
+
    // Get the palette of the pose
    mCrossFadeController.GetCurrentPose().GetMatrixPalette(mPosePalette);
 
@@ -422,6 +422,17 @@ void MovementState::update(float deltaTime)
       mSkinMatrices[i] = mPosePalette[i] * inverseBindPose[i];
    }
 
+   // Apply the morph targets of the meshes that have them, which must happen before skinning
+   // The weights are sampled from the current clip of the crossfade controller, since morph weights aren't blended during a fade
+   const FastClip* currClip = mCrossFadeController.GetCurrentClip();
+   if (currClip != nullptr)
+   {
+      for (unsigned int i = 0, size = (unsigned int)mAnimatedMeshes.size(); i < size; ++i)
+      {
+         mAnimatedMeshes[i].ApplyMorphTargetsOfClip(*currClip, mCrossFadeController.GetPlaybackTime(), mCurrentSkinningMode == SkinningMode::GPU);
+      }
+   }
+
    // Skin the meshes on the CPU if that's the current skinning mode
    if (mCurrentSkinningMode == SkinningMode::CPU)
    {
@@ -431,6 +442,18 @@ void MovementState::update(float deltaTime)
       }
    }
 
+   // Calculate the world space bounds of the animated meshes, which are used for frustum culling
+   // Instead of bounding the skinned vertices, we transform the bind pose bounds of each joint by its skin matrix
+   glm::mat4 modelMatrix = transformToMat4(mModelTransform);
+   mAnimatedMeshWorldBounds.resize(mAnimatedMeshes.size());
+   for (unsigned int i = 0,
+        size = static_cast<unsigned int>(mAnimatedMeshes.size());
+        i < size;
+        ++i)
+   {
+      mAnimatedMeshWorldBounds[i] = TransformAABB(modelMatrix, CalculateSkinnedAABB(mAnimatedMeshes[i].GetJointBounds(), mSkinMatrices));
+   }
+
    // Update the skeleton viewer
    mSkeletonViewer.UpdateBones(mCrossFadeController.GetCurrentPose(), mPosePalette);
 }
@@ -451,6 +474,11 @@ void MovementState::render()
    // Enable depth testing for 3D objects
    glEnable(GL_DEPTH_TEST);
 
+   // Reset the culling statistics and extract the planes of the frustum of the camera
+   mNumMeshesSubmitted = 0;
+   mNumMeshesCulled = 0;
+   Frustum frustum(mCamera3.getPerspectiveProjectionViewMatrix());
+
    mStaticMeshShader->use(true);
    mStaticMeshShader->setUniformFloat("constantAtt",  mSelectedConstantAttenuation);
    mStaticMeshShader->setUniformFloat("linearAtt",    mSelectedLinearAttenuation);
@@ -466,7 +494,11 @@ void MovementState::render()
       i < size;
       ++i)
    {
-      mGroundMeshes[i].Render();
+      // The ground meshes are static and their model matrix is the identity, so their bounds are already in world space
+      if (isVisible(frustum, mGroundMeshes[i].GetBounds()))
+      {
+         mGroundMeshes[i].RenderLOD(selectLOD(mGroundMeshes[i].GetLODErrors(), mGroundMeshes[i].GetBounds()));
+      }
    }
 
    mGroundTexture->unbind(0);
@@ -497,7 +529,11 @@ void MovementState::render()
            i < size;
            ++i)
       {
-         mAnimatedMeshes[i].Render();
+         if (isVisible(frustum, mAnimatedMeshWorldBounds[i]))
+         {
+            mCharacterLODIndex = selectLOD(mCharacter->meshes[i].GetLODErrors(), mAnimatedMeshWorldBounds[i]);
+            mAnimatedMeshes[i].RenderLOD(mCharacterLODIndex);
+         }
       }
 
       mDiffuseTexture->unbind(0);
@@ -521,7 +557,11 @@ void MovementState::render()
            i < size;
            ++i)
       {
-         mAnimatedMeshes[i].Render();
+         if (isVisible(frustum, mAnimatedMeshWorldBounds[i]))
+         {
+            mCharacterLODIndex = selectLOD(mCharacter->meshes[i].GetLODErrors(), mAnimatedMeshWorldBounds[i]);
+            mAnimatedMeshes[i].RenderLOD(mCharacterLODIndex);
+         }
       }
 
       mDiffuseTexture->unbind(0);
@@ -580,7 +620,9 @@ void MovementState::render()
 
 void MovementState::exit()
 {
-
+   // The state doesn't play anything while it's inactive, so it lets the clip library evict its clips
+   // Entering the state again plays the idle clip from the start, which requests it again
+   mClipsInUse.clear();
 }
 
 void MovementState::configureLights(const std::shared_ptr<Shader>& shader)
@@ -681,18 +723,43 @@ void MovementState::switchFromCPUToGPU()
                                       influencesAttribLocOfAnimatedShader);
    }
 
-   // TODO: This is inefficient. We just need to load the positions and normals.
    // Load the original positions and normals because the CPU skinning algorithm
    // has been modifying them every frame
+   // They live in the dynamic buffer, so that's the only buffer we need to reload
    for (unsigned int i = 0,
         size = static_cast<unsigned int>(mAnimatedMeshes.size());
         i < size;
         ++i)
    {
-      mAnimatedMeshes[i].LoadBuffers();
+      mAnimatedMeshes[i].LoadDynamicBuffer();
    }
 }
 
+bool MovementState::isVisible(const Frustum& frustum, const AABB& worldBounds)
+{
+   if (mPerformFrustumCulling && !frustum.IsAABBVisible(worldBounds))
+   {
+      ++mNumMeshesCulled;
+      return false;
+   }
+
+   ++mNumMeshesSubmitted;
+   return true;
+}
+
+unsigned int MovementState::selectLOD(const std::vector<float>& lodErrors, const AABB& worldBounds)
+{
+   if (!mPerformLODSelection)
+   {
+      return 0;
+   }
+
+   // The number of pixels that a world unit covers at a distance of one unit from the camera
+   float pixelsPerUnitAtUnitDistance = 0.5f * static_cast<float>(mWindow->getHeightOfViewportInPix()) * mCamera3.getPerspectiveProjectionMatrix()[1][1];
+
+   return SelectLOD(lodErrors, CalculateDistanceToAABB(mCamera3.getPosition(), worldBounds), pixelsPerUnitAtUnitDistance, mMaxScreenSpaceErrorInPix, 0);
+}
+
 void MovementState::userInterface()
 {
    ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f), ImGuiCond_Appearing);
@@ -747,6 +814,16 @@ void MovementState::userInterface()
       ImGui::Checkbox("Perform Depth Testing", &mPerformDepthTesting);
 #endif
 
+      ImGui::Checkbox("Frustum Culling", &mPerformFrustumCulling);
+
+      ImGui::Text("Meshes Submitted: %u, Meshes Culled: %u", mNumMeshesSubmitted, mNumMeshesCulled);
+
+      ImGui::Checkbox("Level of Detail", &mPerformLODSelection);
+
+      ImGui::SliderFloat("Max LOD Error", &mMaxScreenSpaceErrorInPix, 0.1f, 20.0f, "%.1f px");
+
+      ImGui::Text("Character LOD: %u", mCharacterLODIndex);
+
       ImGui::SliderFloat("Constant Att.", &mSelectedConstantAttenuation, 0.0f, 50.0f, "%.3f");
 
       ImGui::SliderFloat("Linear Att.", &mSelectedLinearAttenuation, 0.0f, 1.0f, "%.3f");
@@ -766,3 +843,60 @@ void MovementState::resetCamera()
 {
    mCamera3.reposition(14.0f, 25.0f, mModelTransform.position, mModelTransform.rotation, glm::vec3(0.0f, 3.0f, 0.0f), 0.0f, 30.0f, 0.0f, 90.0f);
 }
+
+const FastClip* MovementState::getClip(const std::string& name)
+{
+   if (name == "Jump")
+   {
+      return &mJumpClip;
+   }
+
+   if (name == "Jump2")
+   {
+      return &mJump2Clip;
+   }
+
+   std::shared_ptr<const FastClip>& clip = mClipsInUse[name];
+   if (!clip)
+   {
+      clip = mCharacter->clips->GetClip(name);
+   }
+
+   return clip.get();
+}
+
+void MovementState::releaseClipsThatAreNotPlaying()
+{
+   for (auto it = mClipsInUse.begin(); it != mClipsInUse.end();)
+   {
+      if (mCrossFadeController.IsPlaying(it->second.get()))
+      {
+         ++it;
+      }
+      else
+      {
+         it = mClipsInUse.erase(it);
+      }
+   }
+}
+
+void MovementState::prefetchNextClips()
+{
+   // The character can only go from idling to walking or running, from walking to running or idling and from running to walking or idling
+   ClipLibrary& clips = *mCharacter->clips;
+   if (mIsWalking)
+   {
+      clips.Prefetch("Running");
+      clips.Prefetch("Idle");
+   }
+   else if (mIsRunning)
+   {
+      clips.Prefetch("Walking");
+      clips.Prefetch("Idle");
+   }
+   else
+   {
+      clips.Prefetch("Walking");
+      clips.Prefetch("Running");
+   }
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "ParallelFor.h"
+
+namespace ParallelForHelpers
+{
+   thread_local const TaskScheduler* taskScheduler = nullptr;
+
+   // The state of a call to ParallelFor is shared with its helpers, which may start after the call has returned
+   // That's why it stores a copy of the task
+   struct SharedState
+   {
+      SharedState(unsigned int numTasks, const std::function<void(unsigned int)>& task)
+         : numTasks(numTasks)
+         , task(task)
+         , nextTaskIndex(0)
+         , numFinishedTasks(0)
+      {
+
+      }
+
+      void RunTasks()
+      {
+         for (unsigned int taskIndex = nextTaskIndex++; taskIndex < numTasks; taskIndex = nextTaskIndex++)
+         {
+            task(taskIndex);
+
+            // The mutex is locked while notifying so that the calling thread can't miss the notification
+            if (++numFinishedTasks == numTasks)
+            {
+               std::lock_guard<std::mutex> lock(mutex);
+               allTasksFinished.notify_all();
+            }
+         }
+      }
+
+      unsigned int                       numTasks;
+      std::function<void(unsigned int)>  task;
+      std::atomic<unsigned int>          nextTaskIndex;
+      std::atomic<unsigned int>          numFinishedTasks;
+      std::mutex                         mutex;
+      std::condition_variable            allTasksFinished;
+   };
+}
+
+const TaskScheduler* SetTaskScheduler(const TaskScheduler* scheduler)
+{
+   const TaskScheduler* previousScheduler = ParallelForHelpers::taskScheduler;
+   ParallelForHelpers::taskScheduler = scheduler;
+   return previousScheduler;
+}
+
+void ParallelFor(unsigned int numTasks, const std::function<void(unsigned int)>& task, unsigned int maxNumThreads)
+{
+   using namespace ParallelForHelpers;
+
+   if (numTasks == 0)
+   {
+      return;
+   }
+
+   // Without a scheduler, the calling thread runs every task
+   if (taskScheduler == nullptr)
+   {
+      for (unsigned int taskIndex = 0; taskIndex < numTasks; ++taskIndex)
+      {
+         task(taskIndex);
+      }
+
+      return;
+   }
+
+   unsigned int numThreads = std::max(1u, std::thread::hardware_concurrency());
+   if (maxNumThreads != 0)
+   {
+      numThreads = std::min(numThreads, maxNumThreads);
+   }
+
+   // There is no point in asking for more helpers than there are tasks
+   numThreads = std::min(numThreads, numTasks);
+
+   std::shared_ptr<SharedState> state = std::make_shared<SharedState>(numTasks, task);
+   for (unsigned int helperIndex = 1; helperIndex < numThreads; ++helperIndex)
+   {
+      (*taskScheduler)([state]()
+      {
+         state->RunTasks();
+      });
+   }
+
+   state->RunTasks();
+
+   // Once every index has been taken, we only need to wait for the tasks that the helpers are still running
+   std::unique_lock<std::mutex> lock(state->mutex);
+   state->allTasksFinished.wait(lock, [&state, numTasks]() { return state->numFinishedTasks == numTasks; });
+}
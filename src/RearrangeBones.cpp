@@ -234,7 +234,6 @@ void RearrangeMesh(AnimatedMesh& mesh, JointMap& jointMap)
       influences[influenceIndex].w = jointMap[influences[influenceIndex].w];
    }
 
-   // TODO: This is inefficient. We only need to load the influences.
-   //       To fix this, create functions like LoadPositions, LoadNormals, etc.
-   mesh.LoadBuffers();
+   // The bounds of the joints are indexed by joint, so they must be recalculated
+   mesh.CalculateBounds();
 }
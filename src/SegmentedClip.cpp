@@ -0,0 +1,642 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "SegmentedClip.h"
+
+namespace SegmentedClipHelpers
+{
+   // Each SegmentedClip gets a unique ID, which the SegmentCache uses to tell apart the segments of different clips
+   unsigned int nextIDOfSegmentedClip = 1;
+
+   const float maxQuantizedValue = 65535.0f;
+
+   template <typename T, unsigned int N>
+   size_t GetSizeOfFrames(const FastTrack<T, N>& track)
+   {
+      return track.GetNumberOfFrames() * sizeof(Frame<N>);
+   }
+
+   size_t GetSizeOfFrames(FastClip& clip)
+   {
+      size_t sizeInBytes = 0;
+      for (unsigned int transfTrackIndex = 0,
+           numTransfTracks = clip.GetNumberOfTransformTracks();
+           transfTrackIndex < numTransfTracks;
+           ++transfTrackIndex)
+      {
+         FastTransformTrack& transfTrack = clip.GetTransformTrackOfJoint(clip.GetJointIDOfTransformTrack(transfTrackIndex));
+         sizeInBytes += GetSizeOfFrames(transfTrack.GetPositionTrack());
+         sizeInBytes += GetSizeOfFrames(transfTrack.GetRotationTrack());
+         sizeInBytes += GetSizeOfFrames(transfTrack.GetScaleTrack());
+      }
+
+      for (unsigned int weightsTrackIndex = 0,
+           numWeightsTracks = clip.GetNumberOfMorphWeightsTracks();
+           weightsTrackIndex < numWeightsTracks;
+           ++weightsTrackIndex)
+      {
+         FastMorphWeightsTrack& weightsTrack = clip.GetMorphWeightsTrackOfNode(clip.GetNodeIDOfMorphWeightsTrack(weightsTrackIndex));
+         for (unsigned int targetIndex = 0, numTargets = weightsTrack.GetNumberOfTargets(); targetIndex < numTargets; ++targetIndex)
+         {
+            sizeInBytes += GetSizeOfFrames(weightsTrack.GetWeightTrack(targetIndex));
+         }
+      }
+
+      return sizeInBytes;
+   }
+
+   // This function repeats the frames of a track, offsetting the times of each repetition by the given period
+   // The map of the track is generated by ShareTimelines once the whole take has been built
+   template <typename T, unsigned int N>
+   void RepeatTrack(const FastTrack<T, N>& track, unsigned int numRepetitions, float period, FastTrack<T, N>& outTrack)
+   {
+      const Frame<N>* frames    = track.GetFrames();
+      unsigned int    numFrames = track.GetNumberOfFrames();
+
+      std::vector<Frame<N>> repeatedFrames;
+      repeatedFrames.reserve(numFrames * numRepetitions);
+      for (unsigned int repetitionIndex = 0; repetitionIndex < numRepetitions; ++repetitionIndex)
+      {
+         for (unsigned int frameIndex = 0; frameIndex < numFrames; ++frameIndex)
+         {
+            Frame<N> frame = frames[frameIndex];
+            frame.mTime += repetitionIndex * period;
+
+            // The last frame of a repetition and the first frame of the next one can have the same time, in which case we only keep the first one
+            if (!repeatedFrames.empty() && frame.mTime <= repeatedFrames.back().mTime)
+            {
+               continue;
+            }
+
+            repeatedFrames.push_back(frame);
+         }
+      }
+
+      outTrack.SetInterpolation(track.GetInterpolation());
+      outTrack.SetFrames(repeatedFrames.data(), static_cast<unsigned int>(repeatedFrames.size()));
+   }
+}
+
+SegmentedClip::SegmentedClip()
+   : mID(0)
+   , mJointIDs()
+   , mNodeIDs()
+   , mNumTargets()
+   , mSegments()
+   , mCache()
+   , mName("Unnamed")
+   , mStartTime(0.0f)
+   , mEndTime(0.0f)
+   , mSegmentDuration(0.0f)
+   , mLooping(true)
+{
+
+}
+
+SegmentedClip::SegmentedClip(FastClip& clip, float segmentDuration, const std::shared_ptr<SegmentCache>& cache)
+   : mID(SegmentedClipHelpers::nextIDOfSegmentedClip++)
+   , mJointIDs()
+   , mNodeIDs()
+   , mNumTargets()
+   , mSegments()
+   , mCache(cache)
+   , mName(clip.GetName())
+   , mStartTime(clip.GetStartTime())
+   , mEndTime(clip.GetEndTime())
+   , mSegmentDuration(segmentDuration)
+   , mLooping(clip.GetLooping())
+{
+   // A clip that is shorter than a segment is stored in a single segment
+   float duration = GetDuration();
+   if (mSegmentDuration <= 0.0f || mSegmentDuration > duration)
+   {
+      mSegmentDuration = duration;
+   }
+
+   unsigned int numSegments = 1;
+   if (mSegmentDuration > 0.0f)
+   {
+      numSegments = std::max(1u, static_cast<unsigned int>(glm::ceil(duration / mSegmentDuration)));
+   }
+
+   for (unsigned int transfTrackIndex = 0,
+        numTransfTracks = clip.GetNumberOfTransformTracks();
+        transfTrackIndex < numTransfTracks;
+        ++transfTrackIndex)
+   {
+      mJointIDs.push_back(clip.GetJointIDOfTransformTrack(transfTrackIndex));
+   }
+
+   for (unsigned int weightsTrackIndex = 0,
+        numWeightsTracks = clip.GetNumberOfMorphWeightsTracks();
+        weightsTrackIndex < numWeightsTracks;
+        ++weightsTrackIndex)
+   {
+      unsigned int nodeID = clip.GetNodeIDOfMorphWeightsTrack(weightsTrackIndex);
+      mNodeIDs.push_back(nodeID);
+      mNumTargets.push_back(clip.GetMorphWeightsTrackOfNode(nodeID).GetNumberOfTargets());
+   }
+
+   mSegments.resize(numSegments);
+   for (unsigned int segmentIndex = 0; segmentIndex < numSegments; ++segmentIndex)
+   {
+      float segmentStartTime = mStartTime + segmentIndex * mSegmentDuration;
+      float segmentEndTime   = (segmentIndex == numSegments - 1) ? mEndTime : segmentStartTime + mSegmentDuration;
+
+      Segment& segment = mSegments[segmentIndex];
+      for (unsigned int jointID : mJointIDs)
+      {
+         FastTransformTrack& transfTrack = clip.GetTransformTrackOfJoint(jointID);
+         CompressTrack(transfTrack.GetPositionTrack(), segmentStartTime, segmentEndTime, segment);
+         CompressTrack(transfTrack.GetRotationTrack(), segmentStartTime, segmentEndTime, segment);
+         CompressTrack(transfTrack.GetScaleTrack(), segmentStartTime, segmentEndTime, segment);
+      }
+
+      for (unsigned int weightsTrackIndex = 0,
+           numWeightsTracks = static_cast<unsigned int>(mNodeIDs.size());
+           weightsTrackIndex < numWeightsTracks;
+           ++weightsTrackIndex)
+      {
+         FastMorphWeightsTrack& weightsTrack = clip.GetMorphWeightsTrackOfNode(mNodeIDs[weightsTrackIndex]);
+         for (unsigned int targetIndex = 0; targetIndex < mNumTargets[weightsTrackIndex]; ++targetIndex)
+         {
+            CompressTrack(weightsTrack.GetWeightTrack(targetIndex), segmentStartTime, segmentEndTime, segment);
+         }
+      }
+
+      segment.tracks.shrink_to_fit();
+      segment.ranges.shrink_to_fit();
+      segment.values.shrink_to_fit();
+   }
+}
+
+unsigned int SegmentedClip::GetID() const
+{
+   return mID;
+}
+
+unsigned int SegmentedClip::GetNumberOfSegments() const
+{
+   return static_cast<unsigned int>(mSegments.size());
+}
+
+float SegmentedClip::GetSegmentDuration() const
+{
+   return mSegmentDuration;
+}
+
+size_t SegmentedClip::GetSizeInBytes() const
+{
+   size_t sizeInBytes = 0;
+   for (const Segment& segment : mSegments)
+   {
+      sizeInBytes += segment.tracks.size() * sizeof(CompressedTrack);
+      sizeInBytes += segment.ranges.size() * sizeof(float);
+      sizeInBytes += segment.values.size() * sizeof(uint16_t);
+   }
+
+   return sizeInBytes;
+}
+
+FastClip SegmentedClip::DecompressSegment(unsigned int segmentIndex) const
+{
+   const Segment& segment = mSegments[segmentIndex];
+
+   FastClip clip;
+   clip.SetName(mName);
+
+   // The segment is only sampled within its own range, so it must not loop
+   clip.SetLooping(false);
+
+   unsigned int trackIndex = 0;
+   for (unsigned int jointID : mJointIDs)
+   {
+      FastTransformTrack& transfTrack = clip.GetTransformTrackOfJoint(jointID);
+      DecompressTrack(segment, trackIndex++, transfTrack.GetPositionTrack());
+      DecompressTrack(segment, trackIndex++, transfTrack.GetRotationTrack());
+      DecompressTrack(segment, trackIndex++, transfTrack.GetScaleTrack());
+   }
+
+   for (unsigned int weightsTrackIndex = 0,
+        numWeightsTracks = static_cast<unsigned int>(mNodeIDs.size());
+        weightsTrackIndex < numWeightsTracks;
+        ++weightsTrackIndex)
+   {
+      FastMorphWeightsTrack& weightsTrack = clip.GetMorphWeightsTrackOfNode(mNodeIDs[weightsTrackIndex]);
+      weightsTrack.SetNumberOfTargets(mNumTargets[weightsTrackIndex]);
+      for (unsigned int targetIndex = 0; targetIndex < mNumTargets[weightsTrackIndex]; ++targetIndex)
+      {
+         DecompressTrack(segment, trackIndex++, weightsTrack.GetWeightTrack(targetIndex));
+      }
+   }
+
+   clip.RecalculateDuration();
+
+   // The tracks of a segment are cut at the same times and their times are quantized identically, so most of them share their timelines,
+   // whose maps are generated here
+   ShareTimelines(clip);
+
+   return clip;
+}
+
+std::string SegmentedClip::GetName() const
+{
+   return mName;
+}
+
+void SegmentedClip::SetName(const std::string& name)
+{
+   mName = name;
+}
+
+float SegmentedClip::GetStartTime() const
+{
+   return mStartTime;
+}
+
+float SegmentedClip::GetEndTime() const
+{
+   return mEndTime;
+}
+
+float SegmentedClip::GetDuration() const
+{
+   return mEndTime - mStartTime;
+}
+
+bool SegmentedClip::IsTimePastEnd(float time) const
+{
+   if (!mLooping && (time >= mEndTime))
+   {
+      return true;
+   }
+
+   return false;
+}
+
+bool SegmentedClip::GetLooping() const
+{
+   return mLooping;
+}
+
+void SegmentedClip::SetLooping(bool looping)
+{
+   mLooping = looping;
+}
+
+float SegmentedClip::Sample(Pose& ioPose, float time) const
+{
+   if (GetDuration() <= 0.0f || mSegments.empty())
+   {
+      // If the duration of the clip is smaller than or equal to zero, it's invalid
+      return 0.0f;
+   }
+
+   // The time is looped or clamped here, since the segment only knows about its own range
+   time = AdjustTimeToBeWithinClip(time);
+
+   std::shared_ptr<const FastClip> segment = mCache->GetSegment(*this, GetSegmentIndex(time));
+   segment->Sample(ioPose, time);
+
+   return time;
+}
+
+void SegmentedClip::SampleMorphWeights(unsigned int nodeID, std::vector<float>& ioWeights, float time) const
+{
+   if (GetDuration() <= 0.0f || mSegments.empty())
+   {
+      // If the duration of the clip is smaller than or equal to zero, it's invalid
+      return;
+   }
+
+   time = AdjustTimeToBeWithinClip(time);
+
+   std::shared_ptr<const FastClip> segment = mCache->GetSegment(*this, GetSegmentIndex(time));
+   segment->SampleMorphWeights(nodeID, ioWeights, time);
+}
+
+template <typename T, unsigned int N>
+void SegmentedClip::CompressTrack(const FastTrack<T, N>& track, float segmentStartTime, float segmentEndTime, Segment& ioSegment)
+{
+   // A frame is made of 3 * N + 1 floats (the values, the in slopes, the out slopes and the time), which we quantize one by one
+   static_assert(sizeof(Frame<N>) == (3 * N + 1) * sizeof(float), "Frames must be tightly packed");
+   const unsigned int numFloatsPerFrame = 3 * N + 1;
+
+   const Frame<N>* frames    = track.GetFrames();
+   unsigned int    numFrames = track.GetNumberOfFrames();
+
+   CompressedTrack compressedTrack;
+   compressedTrack.numFrames      = 0;
+   compressedTrack.interpolation  = static_cast<uint32_t>(track.GetInterpolation());
+   compressedTrack.offsetOfRanges = static_cast<uint32_t>(ioSegment.ranges.size());
+   compressedTrack.offsetOfValues = static_cast<uint32_t>(ioSegment.values.size());
+
+   if (numFrames == 0)
+   {
+      ioSegment.tracks.push_back(compressedTrack);
+      return;
+   }
+
+   // Find the last frame that comes at or before the start of the segment and the first frame that comes at or after its end,
+   // since they are needed to interpolate the times near the edges of the segment
+   const Frame<N>* firstFrameAfterStart = std::upper_bound(frames, frames + numFrames, segmentStartTime,
+                                                           [](float time, const Frame<N>& frame) { return time < frame.mTime; });
+   const Frame<N>* firstFrameAtOrAfterEnd = std::lower_bound(frames, frames + numFrames, segmentEndTime,
+                                                             [](const Frame<N>& frame, float time) { return frame.mTime < time; });
+
+   unsigned int firstFrameIndex = (firstFrameAfterStart == frames) ? 0 : static_cast<unsigned int>(firstFrameAfterStart - frames) - 1;
+   unsigned int lastFrameIndex  = (firstFrameAtOrAfterEnd == frames + numFrames) ? numFrames - 1 : static_cast<unsigned int>(firstFrameAtOrAfterEnd - frames);
+   compressedTrack.numFrames = lastFrameIndex - firstFrameIndex + 1;
+
+   const float* floats = reinterpret_cast<const float*>(frames + firstFrameIndex);
+
+   // Store the minimum and the extent of each float
+   for (unsigned int floatIndex = 0; floatIndex < numFloatsPerFrame; ++floatIndex)
+   {
+      float minimum = floats[floatIndex];
+      float maximum = floats[floatIndex];
+      for (unsigned int frameIndex = 1; frameIndex < compressedTrack.numFrames; ++frameIndex)
+      {
+         float value = floats[(frameIndex * numFloatsPerFrame) + floatIndex];
+         minimum = std::min(minimum, value);
+         maximum = std::max(maximum, value);
+      }
+
+      ioSegment.ranges.push_back(minimum);
+      ioSegment.ranges.push_back(maximum - minimum);
+   }
+
+   // Quantize each float within its range
+   const float* ranges = ioSegment.ranges.data() + compressedTrack.offsetOfRanges;
+   for (unsigned int frameIndex = 0; frameIndex < compressedTrack.numFrames; ++frameIndex)
+   {
+      for (unsigned int floatIndex = 0; floatIndex < numFloatsPerFrame; ++floatIndex)
+      {
+         float minimum = ranges[(floatIndex * 2) + 0];
+         float extent  = ranges[(floatIndex * 2) + 1];
+         float value   = floats[(frameIndex * numFloatsPerFrame) + floatIndex];
+
+         float normalizedValue = (extent > 0.0f) ? ((value - minimum) / extent) : 0.0f;
+         ioSegment.values.push_back(static_cast<uint16_t>(glm::round(glm::clamp(normalizedValue, 0.0f, 1.0f) * SegmentedClipHelpers::maxQuantizedValue)));
+      }
+   }
+
+   ioSegment.tracks.push_back(compressedTrack);
+}
+
+template <typename T, unsigned int N>
+void SegmentedClip::DecompressTrack(const Segment& segment, unsigned int trackIndex, FastTrack<T, N>& outTrack)
+{
+   const unsigned int numFloatsPerFrame = 3 * N + 1;
+
+   const CompressedTrack& compressedTrack = segment.tracks[trackIndex];
+   outTrack.SetInterpolation(static_cast<Interpolation>(compressedTrack.interpolation));
+   if (compressedTrack.numFrames == 0)
+   {
+      return;
+   }
+
+   const float*    ranges = segment.ranges.data() + compressedTrack.offsetOfRanges;
+   const uint16_t* values = segment.values.data() + compressedTrack.offsetOfValues;
+
+   std::vector<Frame<N>> frames(compressedTrack.numFrames);
+   float* floats = reinterpret_cast<float*>(frames.data());
+   for (unsigned int frameIndex = 0; frameIndex < compressedTrack.numFrames; ++frameIndex)
+   {
+      for (unsigned int floatIndex = 0; floatIndex < numFloatsPerFrame; ++floatIndex)
+      {
+         unsigned int i = (frameIndex * numFloatsPerFrame) + floatIndex;
+         floats[i] = ranges[(floatIndex * 2) + 0] + ranges[(floatIndex * 2) + 1] * (values[i] / SegmentedClipHelpers::maxQuantizedValue);
+      }
+   }
+
+   outTrack.SetFrames(frames.data(), compressedTrack.numFrames);
+}
+
+unsigned int SegmentedClip::GetSegmentIndex(float time) const
+{
+   if (mSegmentDuration <= 0.0f)
+   {
+      return 0;
+   }
+
+   // The end time of the clip belongs to the last segment
+   int segmentIndex = static_cast<int>((time - mStartTime) / mSegmentDuration);
+   return static_cast<unsigned int>(glm::clamp(segmentIndex, 0, static_cast<int>(mSegments.size()) - 1));
+}
+
+float SegmentedClip::AdjustTimeToBeWithinClip(float time) const
+{
+   if (mLooping)
+   {
+      float duration = mEndTime - mStartTime;
+      if (duration <= 0.0f)
+      {
+         // If the duration of the clip is smaller than or equal to zero, it's invalid
+         return 0.0f;
+      }
+
+      time = glm::mod(time - mStartTime, duration);
+      if (time < 0.0f)
+      {
+         time += duration;
+      }
+      time += mStartTime;
+   }
+   else
+   {
+      if (time < mStartTime)
+      {
+         time = mStartTime;
+      }
+
+      if (time > mEndTime)
+      {
+         time = mEndTime;
+      }
+   }
+
+   return time;
+}
+
+SegmentCache::SegmentCache(unsigned int maxNumSegments)
+   : mSegments()
+   , mSegmentsByKey()
+   , mMaxNumSegments(std::max(1u, maxNumSegments))
+   , mNumHits(0)
+   , mNumMisses(0)
+{
+
+}
+
+std::shared_ptr<const FastClip> SegmentCache::GetSegment(const SegmentedClip& clip, unsigned int segmentIndex)
+{
+   uint64_t key = (static_cast<uint64_t>(clip.GetID()) << 32) | segmentIndex;
+
+   auto it = mSegmentsByKey.find(key);
+   if (it != mSegmentsByKey.end())
+   {
+      // Move the segment to the front of the list, since it's now the most recently requested one
+      ++mNumHits;
+      mSegments.splice(mSegments.begin(), mSegments, it->second);
+      return it->second->second;
+   }
+
+   ++mNumMisses;
+   mSegments.emplace_front(key, std::make_shared<const FastClip>(clip.DecompressSegment(segmentIndex)));
+   mSegmentsByKey[key] = mSegments.begin();
+
+   // Evict the least recently requested segments
+   while (mSegments.size() > mMaxNumSegments)
+   {
+      mSegmentsByKey.erase(mSegments.back().first);
+      mSegments.pop_back();
+   }
+
+   return mSegments.front().second;
+}
+
+unsigned int SegmentCache::GetNumberOfSegments() const
+{
+   return static_cast<unsigned int>(mSegments.size());
+}
+
+unsigned int SegmentCache::GetMaxNumberOfSegments() const
+{
+   return mMaxNumSegments;
+}
+
+unsigned long long SegmentCache::GetNumberOfHits() const
+{
+   return mNumHits;
+}
+
+unsigned long long SegmentCache::GetNumberOfMisses() const
+{
+   return mNumMisses;
+}
+
+void BenchmarkSegmentedClip(FastClip& clip, const Pose& restPose, float durationOfTake, float segmentDuration)
+{
+   float durationOfClip = clip.GetDuration();
+   if (durationOfClip <= 0.0f || durationOfTake <= 0.0f)
+   {
+      return;
+   }
+
+   // Build the take by repeating every track of the clip
+   unsigned int numRepetitions = static_cast<unsigned int>(glm::ceil(durationOfTake / durationOfClip));
+
+   auto start = std::chrono::steady_clock::now();
+
+   FastClip take;
+   take.SetName(clip.GetName());
+   take.SetLooping(true);
+   for (unsigned int transfTrackIndex = 0,
+        numTransfTracks = clip.GetNumberOfTransformTracks();
+        transfTrackIndex < numTransfTracks;
+        ++transfTrackIndex)
+   {
+      unsigned int jointID = clip.GetJointIDOfTransformTrack(transfTrackIndex);
+      FastTransformTrack& transfTrack     = clip.GetTransformTrackOfJoint(jointID);
+      FastTransformTrack& takeTransfTrack = take.GetTransformTrackOfJoint(jointID);
+      SegmentedClipHelpers::RepeatTrack(transfTrack.GetPositionTrack(), numRepetitions, durationOfClip, takeTransfTrack.GetPositionTrack());
+      SegmentedClipHelpers::RepeatTrack(transfTrack.GetRotationTrack(), numRepetitions, durationOfClip, takeTransfTrack.GetRotationTrack());
+      SegmentedClipHelpers::RepeatTrack(transfTrack.GetScaleTrack(), numRepetitions, durationOfClip, takeTransfTrack.GetScaleTrack());
+   }
+
+   for (unsigned int weightsTrackIndex = 0,
+        numWeightsTracks = clip.GetNumberOfMorphWeightsTracks();
+        weightsTrackIndex < numWeightsTracks;
+        ++weightsTrackIndex)
+   {
+      unsigned int nodeID = clip.GetNodeIDOfMorphWeightsTrack(weightsTrackIndex);
+      FastMorphWeightsTrack& weightsTrack     = clip.GetMorphWeightsTrackOfNode(nodeID);
+      FastMorphWeightsTrack& takeWeightsTrack = take.GetMorphWeightsTrackOfNode(nodeID);
+      takeWeightsTrack.SetNumberOfTargets(weightsTrack.GetNumberOfTargets());
+      for (unsigned int targetIndex = 0, numTargets = weightsTrack.GetNumberOfTargets(); targetIndex < numTargets; ++targetIndex)
+      {
+         SegmentedClipHelpers::RepeatTrack(weightsTrack.GetWeightTrack(targetIndex), numRepetitions, durationOfClip, takeWeightsTrack.GetWeightTrack(targetIndex));
+      }
+   }
+
+   take.RecalculateDuration();
+   ShareTimelines(take);
+
+   auto end = std::chrono::steady_clock::now();
+   double timeToBuildTake = std::chrono::duration<double, std::milli>(end - start).count();
+
+   start = std::chrono::steady_clock::now();
+   std::shared_ptr<SegmentCache> cache = std::make_shared<SegmentCache>();
+   SegmentedClip segmentedTake(take, segmentDuration, cache);
+   end = std::chrono::steady_clock::now();
+   double timeToSegmentTake = std::chrono::duration<double, std::milli>(end - start).count();
+
+   // Sample a window of the take in the middle of it at 60 samples per second, like a character that plays it for a few seconds would
+   const float  windowDuration = 10.0f;
+   const float  sampleInterval = 1.0f / 60.0f;
+   const float  windowStart    = take.GetStartTime() + take.GetDuration() * 0.5f;
+   unsigned int numSamples     = static_cast<unsigned int>(windowDuration / sampleInterval);
+
+   Pose fastPose      = restPose;
+   Pose segmentedPose = restPose;
+
+   // Decompress the segments of the window once, and measure the largest difference between the samples of both clips
+   float maxPositionError = 0.0f;
+   float maxRotationError = 0.0f;
+   start = std::chrono::steady_clock::now();
+   for (unsigned int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+   {
+      float time = windowStart + sampleIndex * sampleInterval;
+      take.Sample(fastPose, time);
+      segmentedTake.Sample(segmentedPose, time);
+
+      for (unsigned int jointIndex = 0, numJoints = fastPose.GetNumberOfJoints(); jointIndex < numJoints; ++jointIndex)
+      {
+         Transform fastTransform      = fastPose.GetLocalTransform(jointIndex);
+         Transform segmentedTransform = segmentedPose.GetLocalTransform(jointIndex);
+         maxPositionError = std::max(maxPositionError, glm::length(fastTransform.position - segmentedTransform.position));
+
+         float cosOfHalfAngle = glm::abs(Q::dot(fastTransform.rotation, segmentedTransform.rotation)) /
+                                (Q::length(fastTransform.rotation) * Q::length(segmentedTransform.rotation));
+         maxRotationError = std::max(maxRotationError, 2.0f * glm::acos(glm::min(cosOfHalfAngle, 1.0f)));
+      }
+   }
+   end = std::chrono::steady_clock::now();
+   double timeToDecompressWindow = std::chrono::duration<double, std::milli>(end - start).count();
+
+   const unsigned int numPasses = 20;
+
+   start = std::chrono::steady_clock::now();
+   for (unsigned int passIndex = 0; passIndex < numPasses; ++passIndex)
+   {
+      for (unsigned int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+      {
+         take.Sample(fastPose, windowStart + sampleIndex * sampleInterval);
+      }
+   }
+   end = std::chrono::steady_clock::now();
+   double timeToSampleFastClip = std::chrono::duration<double, std::milli>(end - start).count();
+
+   start = std::chrono::steady_clock::now();
+   for (unsigned int passIndex = 0; passIndex < numPasses; ++passIndex)
+   {
+      for (unsigned int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+      {
+         segmentedTake.Sample(segmentedPose, windowStart + sampleIndex * sampleInterval);
+      }
+   }
+   end = std::chrono::steady_clock::now();
+   double timeToSampleSegmentedClip = std::chrono::duration<double, std::milli>(end - start).count();
+
+   unsigned int totalNumSamples = numPasses * numSamples;
+   std::cout << "Segmented clip benchmark - " << take.GetDuration() << " s take built from " << clip.GetName() << " in " << timeToBuildTake << " ms" << '\n'
+             << "   FastClip:      " << SegmentedClipHelpers::GetSizeOfFrames(take) / 1024 << " KB of frames" << '\n'
+             << "   SegmentedClip: " << segmentedTake.GetSizeInBytes() / 1024 << " KB in " << segmentedTake.GetNumberOfSegments() << " segments of "
+             << segmentedTake.GetSegmentDuration() << " s, built in " << timeToSegmentTake << " ms" << '\n'
+             << "   Decompressing the " << cache->GetNumberOfMisses() << " segments of a " << windowDuration << " s window took " << timeToDecompressWindow << " ms" << '\n'
+             << "   Sampling the window: " << (timeToSampleFastClip * 1000.0) / totalNumSamples << " us per sample with the FastClip, "
+             << (timeToSampleSegmentedClip * 1000.0) / totalNumSamples << " us per sample with the SegmentedClip" << '\n'
+             << "   Largest difference: " << maxPositionError << " units of position, " << glm::degrees(maxRotationError) << " degrees of rotation" << '\n';
+}
@@ -16,6 +16,14 @@ void Skeleton::Set(const Pose& restPose, const Pose& bindPose, const std::vector
    UpdateInverseBindPose();
 }
 
+void Skeleton::Set(const Pose& restPose, const Pose& bindPose, const std::vector<glm::mat4>& invBindPose, const std::vector<std::string>& jointNames)
+{
+   mRestPose    = restPose;
+   mBindPose    = bindPose;
+   mInvBindPose = invBindPose;
+   mJointNames  = jointNames;
+}
+
 Pose& Skeleton::GetRestPose()
 {
    return mRestPose;
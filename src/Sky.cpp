@@ -1,10 +1,11 @@
-#include <stb_image/stb_image.h>
+#include <algorithm>
+#include <cstdint>
 
 #include "resource_manager.h"
 #include "shader_loader.h"
 #include "Sky.h"
 
-Sky::Sky()
+Sky::Sky(AssetLoader& assetLoader)
    : mSkyVAO(0)
    , mSkyVBO(0)
    , mSkyTexture(0)
@@ -21,7 +22,7 @@ Sky::Sky()
                                     "resources/models/sky/ny.png",
                                     "resources/models/sky/pz.png",
                                     "resources/models/sky/nz.png" };
-   mSkyTexture = LoadCubemap(faces);
+   mSkyTexture = LoadCubemap(assetLoader, faces);
 }
 
 Sky::~Sky()
@@ -119,41 +120,43 @@ void Sky::ConfigureVAO()
    glBindVertexArray(0);
 }
 
-unsigned int Sky::LoadCubemap(const std::vector<std::string>& faces)
+unsigned int Sky::LoadCubemap(AssetLoader& assetLoader, const std::vector<std::string>& faces)
 {
+   // Request all the faces before waiting for any of them so that they can be decoded in parallel
+   for (unsigned int i = 0; i < faces.size(); i++)
+   {
+      assetLoader.LoadImage(faces[i]);
+   }
+
    unsigned int cubemapTexture;
    glGenTextures(1, &cubemapTexture);
    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
 
-   int width, height, numComponents;
+   // Baked faces contain all their mip levels, but we can only use as many levels as the face with the fewest of them has
+   unsigned int numMipLevels = UINT32_MAX;
    for (unsigned int i = 0; i < faces.size(); i++)
    {
-      unsigned char* data = stbi_load(faces[i].c_str(), &width, &height, &numComponents, 0);
-      if (data)
+      std::shared_ptr<const DecodedImage> image = assetLoader.GetImage(faces[i]);
+      if (image)
       {
-         GLenum format;
-         switch (numComponents)
-         {
-         case 3:
-            format = GL_RGB;
-            break;
-         case 4:
-            format = GL_RGBA;
-            break;
-         default:
-            std::cout << "Error - Sky::LoadCubemap - The texture has an invalid number of components: " << numComponents << "\n";
-         }
-         glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-         stbi_image_free(data);
+         numMipLevels = std::min(numMipLevels, TextureLoader::uploadImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, *image, true));
       }
       else
       {
+         numMipLevels = 0;
          std::cout << "Error - Sky::LoadCubemap - Failed to load texture: " << faces[i] << "\n";
-         stbi_image_free(data);
       }
    }
 
-   glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+   if (numMipLevels > 1)
+   {
+      glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+      glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, numMipLevels - 1);
+   }
+   else
+   {
+      glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+   }
    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
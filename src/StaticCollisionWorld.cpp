@@ -0,0 +1,482 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include <glm/gtx/norm.hpp>
+
+#include "Intersection.h"
+#include "StaticCollisionWorld.h"
+
+namespace StaticCollisionWorldHelpers
+{
+   // The size of the cells is a multiple of the average size of the triangles, which keeps the number of cells that each triangle overlaps low
+   const float cellSizeRelativeToTriangles = 1.0f;
+
+   // This limit prevents a scene made of a few huge triangles from generating an absurd number of cells
+   const float maxCellsAlongAxis = 1024.0f;
+
+   // The number of buckets is a power of two that is at least as large as the number of entries, so that most cells get their own bucket
+   const unsigned int minNumBuckets = 64;
+
+   // If the center of a sphere is closer than this to its contact point, the direction between them is undefined
+   const float minCenterToContactDistanceSq = 0.000000000001f;
+
+   inline glm::ivec3 CalculateCell(const glm::vec3& point, float inverseCellSize)
+   {
+      return glm::ivec3(static_cast<int>(std::floor(point.x * inverseCellSize)),
+                        static_cast<int>(std::floor(point.y * inverseCellSize)),
+                        static_cast<int>(std::floor(point.z * inverseCellSize)));
+   }
+
+   // This is the hash function of "Optimized Spatial Hashing for Collision Detection of Deformable Objects" by Teschner et al.
+   // numBuckets must be a power of two
+   inline unsigned int CalculateBucket(int x, int y, int z, unsigned int numBuckets)
+   {
+      return ((static_cast<unsigned int>(x) * 73856093u) ^ (static_cast<unsigned int>(y) * 19349663u) ^ (static_cast<unsigned int>(z) * 83492791u)) & (numBuckets - 1);
+   }
+
+   inline AABB CalculateBoundsOfTriangle(const Triangle& triangle)
+   {
+      AABB bounds;
+      bounds.Expand(triangle.vertexA);
+      bounds.Expand(triangle.vertexB);
+      bounds.Expand(triangle.vertexC);
+      return bounds;
+   }
+
+   inline bool DoAABBsOverlap(const AABB& a, const AABB& b)
+   {
+      return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+             a.min.y <= b.max.y && a.max.y >= b.min.y &&
+             a.min.z <= b.max.z && a.max.z >= b.min.z;
+   }
+
+   // This function calculates the normal of a sweep hit, which points from the contact point towards the center of the sphere at the time of impact
+   glm::vec3 CalculateNormalOfSweepHit(const glm::vec3& start, const glm::vec3& displacement, const Triangle& triangle, float timeOfImpact, const glm::vec3& contactPoint)
+   {
+      glm::vec3 centerToContact = (start + (displacement * timeOfImpact)) - contactPoint;
+      float     distSq          = glm::length2(centerToContact);
+
+      // If the center of the sphere is on the triangle, we use the normal of the triangle that faces the start of the sweep instead
+      if (distSq < minCenterToContactDistanceSq)
+      {
+         return (glm::dot(start - triangle.vertexA, triangle.normal) >= 0.0f) ? triangle.normal : -triangle.normal;
+      }
+
+      return centerToContact / glm::sqrt(distSq);
+   }
+}
+
+StaticCollisionWorld::StaticCollisionWorld()
+   : mTriangles()
+   , mTriangleBounds()
+   , mBucketOffsets()
+   , mBucketTriangleIndices()
+   , mBounds()
+   , mCellSize(1.0f)
+   , mInverseCellSize(1.0f)
+   , mNumBuckets(0)
+   , mQueryIndexOfTriangle()
+   , mCandidateTriangleIndices()
+   , mQueryIndex(0)
+   , mNumTrianglesTested(0)
+{
+
+}
+
+void StaticCollisionWorld::Build(const std::vector<StaticMesh>& meshes)
+{
+   IndexedTriangleStore triangles;
+   triangles.Build(meshes);
+   Build(triangles);
+}
+
+void StaticCollisionWorld::Build(const IndexedTriangleStore& triangles)
+{
+   using namespace StaticCollisionWorldHelpers;
+
+   mTriangles = triangles;
+   mTriangleBounds.clear();
+   mBucketOffsets.clear();
+   mBucketTriangleIndices.clear();
+   mBounds     = AABB();
+   mNumBuckets = 0;
+   mQueryIndexOfTriangle.assign(mTriangles.GetNumberOfTriangles(), 0);
+   mCandidateTriangleIndices.clear();
+   mQueryIndex         = 0;
+   mNumTrianglesTested = 0;
+
+   unsigned int numTriangles = mTriangles.GetNumberOfTriangles();
+   if (numTriangles == 0)
+   {
+      return;
+   }
+
+   // Calculate the bounds of the triangles, and use the average of their largest extents as the size of the cells
+   mTriangleBounds.resize(numTriangles);
+   float sumOfExtents = 0.0f;
+   for (unsigned int triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+   {
+      mTriangleBounds[triangleIndex] = CalculateBoundsOfTriangle(mTriangles.GetTriangle(triangleIndex));
+      mBounds.Expand(mTriangleBounds[triangleIndex]);
+
+      glm::vec3 extents = mTriangleBounds[triangleIndex].max - mTriangleBounds[triangleIndex].min;
+      sumOfExtents += glm::max(extents.x, glm::max(extents.y, extents.z));
+   }
+
+   glm::vec3 extentsOfWorld = mBounds.max - mBounds.min;
+   mCellSize = (sumOfExtents / numTriangles) * cellSizeRelativeToTriangles;
+   mCellSize = glm::max(mCellSize, glm::max(extentsOfWorld.x, glm::max(extentsOfWorld.y, extentsOfWorld.z)) / maxCellsAlongAxis);
+   mCellSize = glm::max(mCellSize, 0.0001f);
+   mInverseCellSize = 1.0f / mCellSize;
+
+   // Count the number of cells that are overlapped by each triangle, which is the number of entries that the buckets will store
+   unsigned int numEntries = 0;
+   for (unsigned int triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+   {
+      glm::ivec3 numCells = CalculateCell(mTriangleBounds[triangleIndex].max, mInverseCellSize) - CalculateCell(mTriangleBounds[triangleIndex].min, mInverseCellSize) + glm::ivec3(1);
+      numEntries += static_cast<unsigned int>(numCells.x * numCells.y * numCells.z);
+   }
+
+   mNumBuckets = minNumBuckets;
+   while (mNumBuckets < numEntries)
+   {
+      mNumBuckets *= 2;
+   }
+
+   // Count the triangles of each bucket, and then turn the counts into offsets
+   // A triangle can overlap two cells that map to the same bucket, in which case it's stored twice in that bucket, which is harmless
+   mBucketOffsets.assign(mNumBuckets + 1, 0);
+   for (unsigned int triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+   {
+      glm::ivec3 minCell = CalculateCell(mTriangleBounds[triangleIndex].min, mInverseCellSize);
+      glm::ivec3 maxCell = CalculateCell(mTriangleBounds[triangleIndex].max, mInverseCellSize);
+      for (int z = minCell.z; z <= maxCell.z; ++z)
+      {
+         for (int y = minCell.y; y <= maxCell.y; ++y)
+         {
+            for (int x = minCell.x; x <= maxCell.x; ++x)
+            {
+               mBucketOffsets[CalculateBucket(x, y, z, mNumBuckets) + 1]++;
+            }
+         }
+      }
+   }
+
+   for (unsigned int bucketIndex = 0; bucketIndex < mNumBuckets; ++bucketIndex)
+   {
+      mBucketOffsets[bucketIndex + 1] += mBucketOffsets[bucketIndex];
+   }
+
+   // Store the indices of the triangles of each bucket
+   mBucketTriangleIndices.resize(mBucketOffsets[mNumBuckets]);
+   std::vector<unsigned int> numTrianglesWrittenForBucket(mNumBuckets, 0);
+   for (unsigned int triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+   {
+      glm::ivec3 minCell = CalculateCell(mTriangleBounds[triangleIndex].min, mInverseCellSize);
+      glm::ivec3 maxCell = CalculateCell(mTriangleBounds[triangleIndex].max, mInverseCellSize);
+      for (int z = minCell.z; z <= maxCell.z; ++z)
+      {
+         for (int y = minCell.y; y <= maxCell.y; ++y)
+         {
+            for (int x = minCell.x; x <= maxCell.x; ++x)
+            {
+               unsigned int bucketIndex = CalculateBucket(x, y, z, mNumBuckets);
+               mBucketTriangleIndices[mBucketOffsets[bucketIndex] + numTrianglesWrittenForBucket[bucketIndex]++] = triangleIndex;
+            }
+         }
+      }
+   }
+}
+
+bool StaticCollisionWorld::SweepSphere(const glm::vec3& start, const glm::vec3& end, float radius, SweepHit& outHit) const
+{
+   using namespace StaticCollisionWorldHelpers;
+
+   GatherCandidateTriangles(AABB(glm::min(start, end) - glm::vec3(radius), glm::max(start, end) + glm::vec3(radius)));
+
+   glm::vec3 displacement = end - start;
+   bool      hit          = false;
+   float     timeOfImpact;
+   glm::vec3 contactPoint;
+   outHit.timeOfImpact = 2.0f;
+   for (unsigned int i = 0, numCandidates = static_cast<unsigned int>(mCandidateTriangleIndices.size()); i < numCandidates; ++i)
+   {
+      unsigned int triangleIndex = mCandidateTriangleIndices[i];
+      if (SweepSphereAgainstTriangle(start, displacement, radius, mTriangles.GetTriangle(triangleIndex), timeOfImpact, contactPoint) && timeOfImpact < outHit.timeOfImpact)
+      {
+         outHit.timeOfImpact  = timeOfImpact;
+         outHit.contactPoint  = contactPoint;
+         outHit.triangleIndex = triangleIndex;
+         hit                  = true;
+      }
+   }
+
+   if (hit)
+   {
+      outHit.normal = CalculateNormalOfSweepHit(start, displacement, mTriangles.GetTriangle(outHit.triangleIndex), outHit.timeOfImpact, outHit.contactPoint);
+   }
+
+   return hit;
+}
+
+unsigned int StaticCollisionWorld::OverlapCapsule(const glm::vec3& segmentStart, const glm::vec3& segmentEnd, float radius, std::vector<OverlapContact>& outContacts) const
+{
+   GatherCandidateTriangles(AABB(glm::min(segmentStart, segmentEnd) - glm::vec3(radius), glm::max(segmentStart, segmentEnd) + glm::vec3(radius)));
+
+   unsigned int   numContacts = 0;
+   OverlapContact contact;
+   for (unsigned int i = 0, numCandidates = static_cast<unsigned int>(mCandidateTriangleIndices.size()); i < numCandidates; ++i)
+   {
+      unsigned int triangleIndex = mCandidateTriangleIndices[i];
+      if (OverlapCapsuleWithTriangle(segmentStart, segmentEnd, radius, mTriangles.GetTriangle(triangleIndex), contact.contactPoint, contact.normal, contact.penetrationDepth))
+      {
+         contact.triangleIndex = triangleIndex;
+         outContacts.push_back(contact);
+         ++numContacts;
+      }
+   }
+
+   return numContacts;
+}
+
+Triangle StaticCollisionWorld::GetTriangle(unsigned int triangleIndex) const
+{
+   return mTriangles.GetTriangle(triangleIndex);
+}
+
+unsigned int StaticCollisionWorld::GetNumberOfTriangles() const
+{
+   return mTriangles.GetNumberOfTriangles();
+}
+
+unsigned int StaticCollisionWorld::GetNumberOfBuckets() const
+{
+   return mNumBuckets;
+}
+
+float StaticCollisionWorld::GetCellSize() const
+{
+   return mCellSize;
+}
+
+AABB StaticCollisionWorld::GetBounds() const
+{
+   return mBounds;
+}
+
+unsigned long long StaticCollisionWorld::GetNumberOfTrianglesTested() const
+{
+   return mNumTrianglesTested;
+}
+
+void StaticCollisionWorld::GatherCandidateTriangles(const AABB& bounds) const
+{
+   using namespace StaticCollisionWorldHelpers;
+
+   mCandidateTriangleIndices.clear();
+
+   if (mNumBuckets == 0 || !DoAABBsOverlap(bounds, mBounds))
+   {
+      return;
+   }
+
+   // Each query gets a new index, and a triangle is only added to the candidates if it hasn't been tagged with the index of the current query yet
+   // If the index wraps around, the tags of the triangles could match it by accident, so we reset them
+   if (++mQueryIndex == 0)
+   {
+      std::fill(mQueryIndexOfTriangle.begin(), mQueryIndexOfTriangle.end(), 0);
+      mQueryIndex = 1;
+   }
+
+   // Only the cells that are inside the bounds of the world can contain triangles
+   glm::ivec3 minCell = CalculateCell(glm::max(bounds.min, mBounds.min), mInverseCellSize);
+   glm::ivec3 maxCell = CalculateCell(glm::min(bounds.max, mBounds.max), mInverseCellSize);
+   glm::ivec3 numCells = maxCell - minCell + glm::ivec3(1);
+
+   // If the query overlaps more cells than there are buckets, we visit every bucket instead of visiting some of them many times
+   if (static_cast<unsigned long long>(numCells.x) * numCells.y * numCells.z >= mNumBuckets)
+   {
+      for (unsigned int triangleIndex = 0, numTriangles = mTriangles.GetNumberOfTriangles(); triangleIndex < numTriangles; ++triangleIndex)
+      {
+         if (DoAABBsOverlap(bounds, mTriangleBounds[triangleIndex]))
+         {
+            mCandidateTriangleIndices.push_back(triangleIndex);
+         }
+      }
+   }
+   else
+   {
+      for (int z = minCell.z; z <= maxCell.z; ++z)
+      {
+         for (int y = minCell.y; y <= maxCell.y; ++y)
+         {
+            for (int x = minCell.x; x <= maxCell.x; ++x)
+            {
+               unsigned int bucketIndex = CalculateBucket(x, y, z, mNumBuckets);
+               for (unsigned int i = mBucketOffsets[bucketIndex], end = mBucketOffsets[bucketIndex + 1]; i < end; ++i)
+               {
+                  unsigned int triangleIndex = mBucketTriangleIndices[i];
+                  if (mQueryIndexOfTriangle[triangleIndex] != mQueryIndex)
+                  {
+                     mQueryIndexOfTriangle[triangleIndex] = mQueryIndex;
+
+                     // The bucket can contain triangles from other cells, so we discard the ones that can't possibly overlap the query
+                     if (DoAABBsOverlap(bounds, mTriangleBounds[triangleIndex]))
+                     {
+                        mCandidateTriangleIndices.push_back(triangleIndex);
+                     }
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   mNumTrianglesTested += mCandidateTriangleIndices.size();
+}
+
+void BenchmarkStaticCollisionWorld(const StaticCollisionWorld& world, unsigned int numQueries)
+{
+   AABB bounds = world.GetBounds();
+   if (bounds.IsEmpty() || numQueries == 0)
+   {
+      return;
+   }
+
+   // The queries are the size of a character relative to the triangles, and they are placed on a grid that covers the world
+   // Half of the sweeps point down like a ground query, and the other half point sideways like a wall query
+   // The capsules stand up like the body of a character, at heights that go from the bottom to the top of the world
+   float radius              = world.GetCellSize() * 0.5f;
+   float lengthOfWallSweeps  = world.GetCellSize() * 4.0f;
+   float heightOfCapsules    = world.GetCellSize() * 2.0f;
+   unsigned int queriesPerSide = static_cast<unsigned int>(glm::ceil(glm::sqrt(static_cast<float>(numQueries))));
+
+   std::vector<glm::vec3> sweepStarts, sweepEnds, capsuleStarts, capsuleEnds;
+   for (unsigned int z = 0; z < queriesPerSide; ++z)
+   {
+      for (unsigned int x = 0; x < queriesPerSide; ++x)
+      {
+         unsigned int queryIndex = (z * queriesPerSide) + x;
+         float fractionOfHeight = (((queryIndex * 7) % queriesPerSide) + 0.5f) / queriesPerSide;
+         float angle            = queryIndex * 2.39996f;
+         glm::vec3 pointOnGrid(glm::mix(bounds.min.x, bounds.max.x, (x + 0.5f) / queriesPerSide),
+                               glm::mix(bounds.min.y, bounds.max.y, fractionOfHeight),
+                               glm::mix(bounds.min.z, bounds.max.z, (z + 0.5f) / queriesPerSide));
+
+         if (queryIndex % 2 == 0)
+         {
+            sweepStarts.push_back(glm::vec3(pointOnGrid.x, bounds.max.y + radius * 2.0f, pointOnGrid.z));
+            sweepEnds.push_back(glm::vec3(pointOnGrid.x, bounds.min.y - radius * 2.0f, pointOnGrid.z));
+         }
+         else
+         {
+            sweepStarts.push_back(pointOnGrid);
+            sweepEnds.push_back(pointOnGrid + glm::vec3(glm::cos(angle), 0.0f, glm::sin(angle)) * lengthOfWallSweeps);
+         }
+
+         capsuleStarts.push_back(pointOnGrid);
+         capsuleEnds.push_back(pointOnGrid + glm::vec3(0.0f, heightOfCapsules, 0.0f));
+      }
+   }
+
+   unsigned int numTriangles = world.GetNumberOfTriangles();
+   unsigned int numBenchmarkQueries = static_cast<unsigned int>(sweepStarts.size());
+
+   // Brute force: test every query against every triangle
+   std::vector<float>        bruteForceTimesOfImpact(numBenchmarkQueries, 2.0f);
+   std::vector<unsigned int> bruteForceNumContacts(numBenchmarkQueries, 0);
+   auto start = std::chrono::steady_clock::now();
+   for (unsigned int queryIndex = 0; queryIndex < numBenchmarkQueries; ++queryIndex)
+   {
+      float     timeOfImpact;
+      glm::vec3 contactPoint;
+      for (unsigned int triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+      {
+         if (SweepSphereAgainstTriangle(sweepStarts[queryIndex], sweepEnds[queryIndex] - sweepStarts[queryIndex], radius, world.GetTriangle(triangleIndex), timeOfImpact, contactPoint) &&
+             timeOfImpact < bruteForceTimesOfImpact[queryIndex])
+         {
+            bruteForceTimesOfImpact[queryIndex] = timeOfImpact;
+         }
+      }
+   }
+   auto end = std::chrono::steady_clock::now();
+   double bruteForceSweepsSeconds = std::chrono::duration<double>(end - start).count();
+
+   start = std::chrono::steady_clock::now();
+   for (unsigned int queryIndex = 0; queryIndex < numBenchmarkQueries; ++queryIndex)
+   {
+      glm::vec3 contactPoint, normal;
+      float     penetrationDepth;
+      for (unsigned int triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+      {
+         if (OverlapCapsuleWithTriangle(capsuleStarts[queryIndex], capsuleEnds[queryIndex], radius, world.GetTriangle(triangleIndex), contactPoint, normal, penetrationDepth))
+         {
+            ++bruteForceNumContacts[queryIndex];
+         }
+      }
+   }
+   end = std::chrono::steady_clock::now();
+   double bruteForceOverlapsSeconds = std::chrono::duration<double>(end - start).count();
+
+   // The hashed queries are much faster, so we repeat them to get a measurement that isn't dominated by the resolution of the clock
+   const unsigned int numRepetitions = 16;
+
+   unsigned long long numTrianglesTestedBefore = world.GetNumberOfTrianglesTested();
+
+   std::vector<float> hashedTimesOfImpact(numBenchmarkQueries, 2.0f);
+   start = std::chrono::steady_clock::now();
+   for (unsigned int repetition = 0; repetition < numRepetitions; ++repetition)
+   {
+      for (unsigned int queryIndex = 0; queryIndex < numBenchmarkQueries; ++queryIndex)
+      {
+         SweepHit hit;
+         hashedTimesOfImpact[queryIndex] = world.SweepSphere(sweepStarts[queryIndex], sweepEnds[queryIndex], radius, hit) ? hit.timeOfImpact : 2.0f;
+      }
+   }
+   end = std::chrono::steady_clock::now();
+   double hashedSweepsSeconds = std::chrono::duration<double>(end - start).count();
+
+   std::vector<unsigned int>   hashedNumContacts(numBenchmarkQueries, 0);
+   std::vector<OverlapContact> contacts;
+   start = std::chrono::steady_clock::now();
+   for (unsigned int repetition = 0; repetition < numRepetitions; ++repetition)
+   {
+      for (unsigned int queryIndex = 0; queryIndex < numBenchmarkQueries; ++queryIndex)
+      {
+         contacts.clear();
+         hashedNumContacts[queryIndex] = world.OverlapCapsule(capsuleStarts[queryIndex], capsuleEnds[queryIndex], radius, contacts);
+      }
+   }
+   end = std::chrono::steady_clock::now();
+   double hashedOverlapsSeconds = std::chrono::duration<double>(end - start).count();
+
+   double averageTrianglesTested = static_cast<double>(world.GetNumberOfTrianglesTested() - numTrianglesTestedBefore) / (2.0 * numBenchmarkQueries * numRepetitions);
+
+   // Count the queries whose results don't match between both methods
+   unsigned int numSweepHits  = 0;
+   unsigned int numMismatches = 0;
+   for (unsigned int queryIndex = 0; queryIndex < numBenchmarkQueries; ++queryIndex)
+   {
+      numSweepHits += (bruteForceTimesOfImpact[queryIndex] <= 1.0f) ? 1 : 0;
+
+      if (glm::abs(bruteForceTimesOfImpact[queryIndex] - hashedTimesOfImpact[queryIndex]) > 0.00001f ||
+          bruteForceNumContacts[queryIndex] != hashedNumContacts[queryIndex])
+      {
+         ++numMismatches;
+      }
+   }
+
+   double bruteForceSweepsPerSecond   = numBenchmarkQueries / glm::max(bruteForceSweepsSeconds, 1e-9);
+   double bruteForceOverlapsPerSecond = numBenchmarkQueries / glm::max(bruteForceOverlapsSeconds, 1e-9);
+   double hashedSweepsPerSecond       = (numBenchmarkQueries * numRepetitions) / glm::max(hashedSweepsSeconds, 1e-9);
+   double hashedOverlapsPerSecond     = (numBenchmarkQueries * numRepetitions) / glm::max(hashedOverlapsSeconds, 1e-9);
+
+   std::cout << "Static collision world - Triangles: " << numTriangles << ", Queries: " << numBenchmarkQueries << ", Mismatches: " << numMismatches
+             << ", Sweep hits: " << numSweepHits << ", Average triangles tested per query: " << averageTrianglesTested << '\n'
+             << "   Brute force sweeps:   " << bruteForceSweepsPerSecond << " queries/s" << '\n'
+             << "   Hashed sweeps:        " << hashedSweepsPerSecond << " queries/s (" << (hashedSweepsPerSecond / bruteForceSweepsPerSecond) << "x)" << '\n'
+             << "   Brute force overlaps: " << bruteForceOverlapsPerSecond << " queries/s" << '\n'
+             << "   Hashed overlaps:      " << hashedOverlapsPerSecond << " queries/s (" << (hashedOverlapsPerSecond / bruteForceOverlapsPerSecond) << "x)" << '\n';
+}
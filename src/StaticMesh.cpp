@@ -0,0 +1,247 @@
+#ifdef __EMSCRIPTEN__
+#include <GLES3/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+
+#include <cstddef>
+#include <utility>
+
+#include "StaticMesh.h"
+
+StaticMesh::StaticMesh()
+   : mUse16BitIndices(false)
+{
+   glGenVertexArrays(1, &mVAO);
+   glGenBuffers(1, &mVBO);
+   glGenBuffers(1, &mEBO);
+}
+
+StaticMesh::~StaticMesh()
+{
+   glDeleteVertexArrays(1, &mVAO);
+   glDeleteBuffers(1, &mVBO);
+   glDeleteBuffers(1, &mEBO);
+}
+
+StaticMesh::StaticMesh(StaticMesh&& rhs) noexcept
+   : mPositions(std::move(rhs.mPositions))
+   , mNormals(std::move(rhs.mNormals))
+   , mTexCoords(std::move(rhs.mTexCoords))
+   , mIndices(std::move(rhs.mIndices))
+   , mLODIndices(std::move(rhs.mLODIndices))
+   , mLODErrors(std::move(rhs.mLODErrors))
+   , mLODFirstIndices(std::move(rhs.mLODFirstIndices))
+   , mBounds(rhs.mBounds)
+   , mVAO(std::exchange(rhs.mVAO, 0))
+   , mVBO(std::exchange(rhs.mVBO, 0))
+   , mEBO(std::exchange(rhs.mEBO, 0))
+   , mUse16BitIndices(rhs.mUse16BitIndices)
+{
+
+}
+
+StaticMesh& StaticMesh::operator=(StaticMesh&& rhs) noexcept
+{
+   mPositions       = std::move(rhs.mPositions);
+   mNormals         = std::move(rhs.mNormals);
+   mTexCoords       = std::move(rhs.mTexCoords);
+   mIndices         = std::move(rhs.mIndices);
+   mLODIndices      = std::move(rhs.mLODIndices);
+   mLODErrors       = std::move(rhs.mLODErrors);
+   mLODFirstIndices = std::move(rhs.mLODFirstIndices);
+   mBounds          = rhs.mBounds;
+   mVAO             = std::exchange(rhs.mVAO, 0);
+   mVBO             = std::exchange(rhs.mVBO, 0);
+   mEBO             = std::exchange(rhs.mEBO, 0);
+   mUse16BitIndices = rhs.mUse16BitIndices;
+   return *this;
+}
+
+void StaticMesh::CalculateBounds()
+{
+   mBounds = AABB();
+
+   for (unsigned int vertexIndex = 0,
+        numVertices = static_cast<unsigned int>(mPositions.size());
+        vertexIndex < numVertices;
+        ++vertexIndex)
+   {
+      mBounds.Expand(mPositions[vertexIndex]);
+   }
+}
+
+void StaticMesh::LoadBuffers()
+{
+   unsigned int numVertices = static_cast<unsigned int>(mPositions.size());
+   if (numVertices == 0)
+   {
+      return;
+   }
+
+   // Interleave the attributes of the vertices
+   // Note that a glTF file is not required to contain normals or texture coordinates, so we fill in the missing ones:
+   // The missing normals point up (0, 1, 0), and the missing texture coordinates are zeroes
+   std::vector<InterleavedVertex> interleavedVertices(numVertices);
+   for (unsigned int vertexIndex = 0; vertexIndex < numVertices; ++vertexIndex)
+   {
+      InterleavedVertex& vertex = interleavedVertices[vertexIndex];
+      vertex.position = mPositions[vertexIndex];
+      vertex.normal   = (vertexIndex < mNormals.size())   ? mNormals[vertexIndex]   : glm::vec3(0.0f, 1.0f, 0.0f);
+      vertex.texCoord = (vertexIndex < mTexCoords.size()) ? mTexCoords[vertexIndex] : glm::vec2(0.0f);
+   }
+
+   glBindVertexArray(mVAO);
+
+   // Load the interleaved vertices into the VBO
+   glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+   glBufferData(GL_ARRAY_BUFFER, interleavedVertices.size() * sizeof(InterleavedVertex), &interleavedVertices[0], GL_STATIC_DRAW);
+   glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+   // Indices
+   LoadIndexBuffer();
+
+   // Unbind the VAO first, then the EBO
+   glBindVertexArray(0);
+   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+/*
+   If a mesh has fewer than 65535 vertices, all of its indices fit in 16 bits, which halves the size of its index buffer
+   Note that we can't use 65535 itself as an index, since WebGL 2 always enables primitive restart with a fixed index,
+   which means that the largest index of the type (0xFFFF for 16-bit indices) is interpreted as the end of a primitive
+*/
+void StaticMesh::LoadIndexBuffer()
+{
+   mUse16BitIndices = false;
+   mLODFirstIndices.clear();
+
+   if (mIndices.size() == 0)
+   {
+      return;
+   }
+
+   // Concatenate the indices of all the LODs
+   std::vector<unsigned int> indicesOfAllLODs(mIndices.begin(), mIndices.end());
+   mLODFirstIndices.push_back(0);
+   for (unsigned int lodIndex = 0,
+        numLODs = static_cast<unsigned int>(mLODIndices.size());
+        lodIndex < numLODs;
+        ++lodIndex)
+   {
+      mLODFirstIndices.push_back(static_cast<unsigned int>(indicesOfAllLODs.size()));
+      indicesOfAllLODs.insert(indicesOfAllLODs.end(), mLODIndices[lodIndex].begin(), mLODIndices[lodIndex].end());
+   }
+
+   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
+
+   if (mPositions.size() < 65535)
+   {
+      std::vector<unsigned short> indices16Bit(indicesOfAllLODs.begin(), indicesOfAllLODs.end());
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices16Bit.size() * sizeof(unsigned short), &indices16Bit[0], GL_STATIC_DRAW);
+      mUse16BitIndices = true;
+   }
+   else
+   {
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, indicesOfAllLODs.size() * sizeof(unsigned int), &indicesOfAllLODs[0], GL_STATIC_DRAW);
+   }
+}
+
+void StaticMesh::ConfigureVAO(int posAttribLocation,
+                              int normalAttribLocation,
+                              int texCoordsAttribLocation)
+{
+   glBindVertexArray(mVAO);
+   glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+
+   // Set the vertex attribute pointers
+   // All of them point into the same buffer, so they only differ in their offsets
+   BindFloatAttribute(posAttribLocation,       3, offsetof(InterleavedVertex, position));
+   BindFloatAttribute(normalAttribLocation,    3, offsetof(InterleavedVertex, normal));
+   BindFloatAttribute(texCoordsAttribLocation, 2, offsetof(InterleavedVertex, texCoord));
+
+   glBindBuffer(GL_ARRAY_BUFFER, 0);
+   glBindVertexArray(0);
+}
+
+void StaticMesh::UnconfigureVAO(int posAttribLocation,
+                                int normalAttribLocation,
+                                int texCoordsAttribLocation)
+{
+   glBindVertexArray(mVAO);
+
+   // Unset the vertex attribute pointers
+   UnbindAttribute(posAttribLocation);
+   UnbindAttribute(normalAttribLocation);
+   UnbindAttribute(texCoordsAttribLocation);
+
+   glBindVertexArray(0);
+}
+
+// Note that this function assumes that the VAO and the VBO are bound
+void StaticMesh::BindFloatAttribute(int attribLocation, int numComponents, unsigned int offset)
+{
+   if (attribLocation >= 0)
+   {
+      glEnableVertexAttribArray(attribLocation);
+      glVertexAttribPointer(attribLocation, numComponents, GL_FLOAT, GL_FALSE, sizeof(InterleavedVertex), (void*)static_cast<std::size_t>(offset));
+   }
+}
+
+// Note that this function assumes that the VAO is bound
+void StaticMesh::UnbindAttribute(int attribLocation)
+{
+   if (attribLocation >= 0)
+   {
+      glDisableVertexAttribArray(attribLocation);
+   }
+}
+
+void StaticMesh::Render()
+{
+   RenderLOD(0);
+}
+
+// TODO: GL_TRIANGLES shouldn't be hardcoded here
+//       Can we load that from the GLTF file?
+void StaticMesh::RenderLOD(unsigned int lodIndex)
+{
+   glBindVertexArray(mVAO);
+
+   if (mIndices.size() > 0)
+   {
+      // The first index of each LOD is only known once the index buffer is loaded, and until then only the original mesh can be rendered
+      unsigned int numLODsInIndexBuffer = static_cast<unsigned int>(mLODFirstIndices.size());
+      lodIndex = (numLODsInIndexBuffer > 0) ? glm::min(lodIndex, numLODsInIndexBuffer - 1) : 0;
+
+      unsigned int numIndices  = (lodIndex == 0) ? static_cast<unsigned int>(mIndices.size()) : static_cast<unsigned int>(mLODIndices[lodIndex - 1].size());
+      std::size_t  indexSize   = mUse16BitIndices ? sizeof(unsigned short) : sizeof(unsigned int);
+      std::size_t  indexOffset = (lodIndex == 0) ? 0 : (mLODFirstIndices[lodIndex] * indexSize);
+
+      glDrawElements(GL_TRIANGLES, numIndices, mUse16BitIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)indexOffset);
+   }
+   else
+   {
+      glDrawArrays(GL_TRIANGLES, 0, static_cast<unsigned int>(mPositions.size()));
+   }
+
+   glBindVertexArray(0);
+}
+
+// TODO: GL_TRIANGLES shouldn't be hardcoded here
+//       Can we load that from the GLTF file?
+void StaticMesh::RenderInstanced(unsigned int numInstances)
+{
+   glBindVertexArray(mVAO);
+
+   if (mIndices.size() > 0)
+   {
+      glDrawElementsInstanced(GL_TRIANGLES, static_cast<unsigned int>(mIndices.size()), mUse16BitIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, 0, numInstances);
+   }
+   else
+   {
+      glDrawArraysInstanced(GL_TRIANGLES, 0, static_cast<unsigned int>(mPositions.size()), numInstances);
+   }
+
+   glBindVertexArray(0);
+}
@@ -0,0 +1,148 @@
+#include <limits>
+
+#include <glm/glm.hpp>
+
+#include "Timeline.h"
+
+Timeline::Timeline(const std::vector<float>& times, const std::vector<unsigned int>& sampleToFrameIndexMap)
+   : mTimes(times)
+   , mSampleToFrameIndexMap(sampleToFrameIndexMap)
+   , mTimeOfLastLookup(std::numeric_limits<float>::quiet_NaN()) // NaN is never equal to a time, so the first lookup always misses
+   , mLoopingOfLastLookup(false)
+   , mFrameIndexOfLastLookup(-1)
+   , mInterpolationFactorOfLastLookup(0.0f)
+{
+
+}
+
+const std::vector<float>& Timeline::GetTimes() const
+{
+   return mTimes;
+}
+
+const std::vector<unsigned int>& Timeline::GetSampleToFrameIndexMap() const
+{
+   return mSampleToFrameIndexMap;
+}
+
+int Timeline::GetIndexOfLastFrameBeforeTime(float time, bool looping, float& outInterpolationFactor) const
+{
+   // The tracks of a clip are sampled one after the other with the same time, so every track after the first one finds the result here
+   if (time == mTimeOfLastLookup && looping == mLoopingOfLastLookup)
+   {
+      outInterpolationFactor = mInterpolationFactorOfLastLookup;
+      return mFrameIndexOfLastLookup;
+   }
+
+   int   thisFrame           = FindIndexOfLastFrameBeforeTime(time, looping);
+   float interpolationFactor = 0.0f;
+
+   // We need a next frame to be able to interpolate, and the time between both frames must be positive
+   int numFrames = static_cast<int>(mTimes.size());
+   if (thisFrame < 0 || thisFrame >= numFrames - 1 || mTimes[thisFrame + 1] - mTimes[thisFrame] <= 0.0f)
+   {
+      thisFrame = -1;
+   }
+   else
+   {
+      float timelineTime = AdjustTimeToBeWithinTimeline(time, looping);
+      interpolationFactor = (timelineTime - mTimes[thisFrame]) / (mTimes[thisFrame + 1] - mTimes[thisFrame]);
+   }
+
+   mTimeOfLastLookup                = time;
+   mLoopingOfLastLookup             = looping;
+   mFrameIndexOfLastLookup          = thisFrame;
+   mInterpolationFactorOfLastLookup = interpolationFactor;
+
+   outInterpolationFactor = interpolationFactor;
+   return thisFrame;
+}
+
+// This function is identical to FastTrack::GetIndexOfLastFrameBeforeTime, except that it reads the times from the timeline
+int Timeline::FindIndexOfLastFrameBeforeTime(float time, bool looping) const
+{
+   unsigned int numFrames = static_cast<unsigned int>(mTimes.size());
+   if (numFrames <= 1)
+   {
+      return -1;
+   }
+
+   float startTime = mTimes[0];
+   float endTime   = mTimes[numFrames - 1];
+   float duration  = endTime - startTime;
+
+   if (looping)
+   {
+      time = glm::mod(time - startTime, duration);
+      if (time < 0.0f)
+      {
+         time += duration;
+      }
+      time += startTime;
+   }
+   else
+   {
+      if (time <= startTime)
+      {
+         return 0;
+      }
+
+      if (time >= mTimes[numFrames - 2])
+      {
+         return static_cast<int>(numFrames - 2);
+      }
+   }
+
+   unsigned int numSamples = 60 + static_cast<unsigned int>(duration * 60.0f);
+   float nTime = (time - startTime) / duration;
+
+   unsigned int indexOfSample = static_cast<unsigned int>(nTime * static_cast<float>(numSamples));
+   if (indexOfSample >= mSampleToFrameIndexMap.size())
+   {
+      return -1;
+   }
+
+   return static_cast<int>(mSampleToFrameIndexMap[indexOfSample]);
+}
+
+// This function is identical to Track::AdjustTimeToBeWithinTrack, except that it reads the times from the timeline
+float Timeline::AdjustTimeToBeWithinTimeline(float time, bool looping) const
+{
+   unsigned int numFrames = static_cast<unsigned int>(mTimes.size());
+   if (numFrames <= 1)
+   {
+      return 0.0f;
+   }
+
+   float startTime = mTimes[0];
+   float endTime   = mTimes[numFrames - 1];
+   float duration  = endTime - startTime;
+   if (duration <= 0.0f)
+   {
+      return 0.0f;
+   }
+
+   if (looping)
+   {
+      time = glm::mod(time - startTime, duration);
+      if (time < 0.0f)
+      {
+         time += duration;
+      }
+      time += startTime;
+   }
+   else
+   {
+      if (time <= startTime)
+      {
+         time = startTime;
+      }
+
+      if (time >= endTime)
+      {
+         time = endTime;
+      }
+   }
+
+   return time;
+}
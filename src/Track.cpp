@@ -1,3 +1,5 @@
+#include <cstring>
+
 #include <glm/gtx/compatibility.hpp>
 
 #include "Track.h"
@@ -52,6 +54,18 @@ void Track<T, N>::SetNumberOfFrames(unsigned int numFrames)
    mFrames.resize(numFrames);
 }
 
+template<typename T, unsigned int N>
+const Frame<N>* Track<T, N>::GetFrames() const
+{
+   return mFrames.data();
+}
+
+template<typename T, unsigned int N>
+void Track<T, N>::SetFrames(const Frame<N>* frames, unsigned int numFrames)
+{
+   mFrames.assign(frames, frames + numFrames);
+}
+
 template<typename T, unsigned int N>
 Interpolation Track<T, N>::GetInterpolation() const
 {
@@ -291,12 +305,7 @@ T Track<T, N>::SampleLinear(float time, bool looping) const
    float trackTime = AdjustTimeToBeWithinTrack(time, looping);
    float t = (trackTime - mFrames[thisFrame].mTime) / timeBetweenFrames;
 
-   // Cast the values of the frames we found to be able to call the appropriate interpolation function
-   T start = Cast(&mFrames[thisFrame].mValue[0]);
-   T end = Cast(&mFrames[nextFrame].mValue[0]);
-
-   // lerp floats and vectors or nlerp quaternions with a neighborhood check
-   return TrackHelpers::Interpolate(start, end, t);
+   return InterpolateLinear(thisFrame, t);
 }
 
 template<typename T, unsigned int N>
@@ -323,6 +332,28 @@ T Track<T, N>::SampleCubic(float time, bool looping) const
    float trackTime = AdjustTimeToBeWithinTrack(time, looping);
    float t = (trackTime - mFrames[thisFrame].mTime) / timeBetweenFrames;
 
+   return InterpolateCubic(thisFrame, t);
+}
+
+template<typename T, unsigned int N>
+T Track<T, N>::InterpolateLinear(int thisFrame, float t) const
+{
+   int nextFrame = thisFrame + 1;
+
+   // Cast the values of the frames we found to be able to call the appropriate interpolation function
+   T start = Cast(&mFrames[thisFrame].mValue[0]);
+   T end = Cast(&mFrames[nextFrame].mValue[0]);
+
+   // lerp floats and vectors or nlerp quaternions with a neighborhood check
+   return TrackHelpers::Interpolate(start, end, t);
+}
+
+template<typename T, unsigned int N>
+T Track<T, N>::InterpolateCubic(int thisFrame, float t) const
+{
+   int nextFrame = thisFrame + 1;
+   float timeBetweenFrames = mFrames[nextFrame].mTime - mFrames[thisFrame].mTime;
+
    // Get the first point and its output tangent from the first frame
    T p1 = Cast(&mFrames[thisFrame].mValue[0]);
    // We use memcpy instead of the Cast function to get the slope because
@@ -401,21 +432,25 @@ int FastTrack<T, N>::GetIndexOfLastFrameBeforeTime(float time, bool looping) con
    unsigned int numSamples = 60 + static_cast<unsigned int>(durationOfTrack * 60.0f);
 
    // Calculate the normalized time
-   float nTime = time / durationOfTrack;
+   // The time is relative to the start of the track, since a track doesn't have to start at zero (e.g. the tracks of a segment of a SegmentedClip)
+   float nTime = (time - this->GetStartTime()) / durationOfTrack;
 
    // Transform the time into its closest sample
    unsigned int indexOfSample = static_cast<unsigned int>(nTime * static_cast<float>(numSamples));
-   if (indexOfSample >= mSampleToFrameIndexMap.size())
+   const std::vector<unsigned int>& sampleToFrameIndexMap = GetSampleToFrameIndexMap();
+   if (indexOfSample >= sampleToFrameIndexMap.size())
    {
       return -1;
    }
 
-   return static_cast<int>(mSampleToFrameIndexMap[indexOfSample]);
+   return static_cast<int>(sampleToFrameIndexMap[indexOfSample]);
 }
 
 template<typename T, unsigned int N>
 void FastTrack<T, N>::GenerateSampleToFrameIndexMap()
 {
+   mTimeline = nullptr;
+
    int numFrames = static_cast<int>(this->mFrames.size());
    if (numFrames <= 1)
    {
@@ -430,7 +465,10 @@ void FastTrack<T, N>::GenerateSampleToFrameIndexMap()
    //       even if they are shorter than 1 second
    unsigned int numSamples = 60 + static_cast<unsigned int>(durationOfTrack * 60.0f);
    // Loop over all the samples and store their corresponding frame indices in the map
+   // The time of each sample only increases, and so do the times of the frames, so instead of searching for the frame of each sample,
+   // we sweep over the frames and the samples at the same time, which visits each frame and each sample once
    mSampleToFrameIndexMap.resize(numSamples);
+   int indexOfFirstFrameBeforeSample = 0;
    for (unsigned int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
    {
       // Calculate the normalized sample
@@ -439,29 +477,74 @@ void FastTrack<T, N>::GenerateSampleToFrameIndexMap()
       // Calculate the time of the sample
       float sampleTime = nSample * durationOfTrack + this->GetStartTime();
 
-      // Loop backwards over the array of frames until we find the first one that comes
-      // before the time of the sample
-      // TODO: This can be optimized further
-      //       If we remember the indexOfFirstFrameBeforeSample of the previous iteration,
-      //       we can start the next iteration there, since the time of each sample only increases
-      unsigned int indexOfFirstFrameBeforeSample = 0;
-      for (int frameIndex = numFrames - 1; frameIndex >= 0; --frameIndex)
+      // Advance to the last frame that comes before the time of the sample
+      // If that's the last frame, we stop at the second to last frame instead, since we need a frame after it to interpolate
+      while (indexOfFirstFrameBeforeSample < numFrames - 2 && sampleTime >= this->mFrames[indexOfFirstFrameBeforeSample + 1].mTime)
       {
-         if (sampleTime >= this->mFrames[frameIndex].mTime)
-         {
-            indexOfFirstFrameBeforeSample = static_cast<unsigned int>(frameIndex);
-
-            // If the first frame that comes before the time of the sample is the last frame,
-            // store the index of the second to last frame instead
-            if (static_cast<int>(indexOfFirstFrameBeforeSample) >= numFrames - 2)
-            {
-               indexOfFirstFrameBeforeSample = numFrames - 2;
-            }
-            break;
-         }
+         ++indexOfFirstFrameBeforeSample;
       }
 
-      mSampleToFrameIndexMap[sampleIndex] = indexOfFirstFrameBeforeSample;
+      mSampleToFrameIndexMap[sampleIndex] = static_cast<unsigned int>(indexOfFirstFrameBeforeSample);
+   }
+}
+
+template<typename T, unsigned int N>
+const std::vector<unsigned int>& FastTrack<T, N>::GetSampleToFrameIndexMap() const
+{
+   return mTimeline ? mTimeline->GetSampleToFrameIndexMap() : mSampleToFrameIndexMap;
+}
+
+template<typename T, unsigned int N>
+void FastTrack<T, N>::SetSampleToFrameIndexMap(const unsigned int* sampleToFrameIndexMap, unsigned int numSamples)
+{
+   mTimeline = nullptr;
+   mSampleToFrameIndexMap.assign(sampleToFrameIndexMap, sampleToFrameIndexMap + numSamples);
+}
+
+template<typename T, unsigned int N>
+const std::shared_ptr<const Timeline>& FastTrack<T, N>::GetTimeline() const
+{
+   return mTimeline;
+}
+
+template<typename T, unsigned int N>
+void FastTrack<T, N>::SetTimeline(const std::shared_ptr<const Timeline>& timeline)
+{
+   mTimeline = timeline;
+
+   // The map of the timeline replaces the one of the track
+   std::vector<unsigned int>().swap(mSampleToFrameIndexMap);
+}
+
+template<typename T, unsigned int N>
+T FastTrack<T, N>::Sample(float time, bool looping) const
+{
+   // A track that doesn't share a timeline finds its frame on its own
+   if (!mTimeline)
+   {
+      return Track<T, N>::Sample(time, looping);
+   }
+
+   // If another track that shares the timeline was just sampled with the same time, the timeline returns the frame and the interpolation factor that it found for it
+   float t;
+   int thisFrame = mTimeline->GetIndexOfLastFrameBeforeTime(time, looping, t);
+   if (thisFrame < 0)
+   {
+      // Return a zero float, zero vector or unit quaternion, just like Track::Sample does when there are no frames to interpolate between
+      return T();
+   }
+
+   if (this->mInterpolation == Interpolation::Constant)
+   {
+      return this->Cast(&this->mFrames[thisFrame].mValue[0]);
+   }
+   else if (this->mInterpolation == Interpolation::Linear)
+   {
+      return this->InterpolateLinear(thisFrame, t);
+   }
+   else
+   {
+      return this->InterpolateCubic(thisFrame, t);
    }
 }
 
@@ -12,3 +12,19 @@ Triangle::Triangle(const glm::vec3& vA, const glm::vec3& vB, const glm::vec3& vC
 {
    normal = glm::normalize(glm::cross(vertexB - vertexA, vertexC - vertexA));
 }
+
+PrecomputedTriangle::PrecomputedTriangle()
+   : vertexA(0.0f)
+   , edgeAB(0.0f)
+   , edgeAC(0.0f)
+{
+
+}
+
+PrecomputedTriangle::PrecomputedTriangle(const Triangle& triangle)
+   : vertexA(triangle.vertexA)
+   , edgeAB(triangle.vertexB - triangle.vertexA)
+   , edgeAC(triangle.vertexC - triangle.vertexA)
+{
+
+}
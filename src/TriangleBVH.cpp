@@ -0,0 +1,618 @@
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include <glm/gtx/norm.hpp>
+
+#include "Intersection.h"
+#include "TriangleBVH.h"
+
+namespace TriangleBVHHelpers
+{
+   // The number of bins along each axis that are used to evaluate the SAH
+   // More bins result in better splits but slower builds, and 16 is usually enough to get very close to a full sweep
+   const unsigned int numBins = 16;
+
+   // The cost of visiting a node relative to the cost of intersecting a triangle
+   const float traversalCost = 1.0f;
+
+   // Nodes with more triangles than this are always split, even if the SAH says that it isn't worth it
+   const unsigned int maxTrianglesPerLeaf = 8;
+
+   // The triangles of the leaves are tested in packets of four, so a leaf with five triangles costs as much as one with eight
+   inline unsigned int CalculateNumberOfPackets(unsigned int numTriangles)
+   {
+      return (numTriangles + 3) / 4;
+   }
+
+   // The maximum depth of the tree, where the root has a depth of zero
+   // The nodes at this depth become leaves even if they have more than maxTrianglesPerLeaf triangles, which only happens with degenerate inputs
+   const unsigned int maxDepth = 64;
+
+   // The size of the stack that is used to traverse the tree
+   // A traversal pushes at most one node for each interior node on the path from the root to the current node, plus the two children of
+   // the current node, and the interior nodes are never deeper than maxDepth - 1, so the stack can't overflow and no node is ever skipped
+   const unsigned int maxStackSize = maxDepth + 1;
+
+   struct Bin
+   {
+      Bin()
+         : numTriangles(0)
+      {
+
+      }
+
+      AABB         bounds;
+      unsigned int numTriangles;
+   };
+
+   float CalculateHalfSurfaceArea(const AABB& aabb)
+   {
+      if (aabb.IsEmpty())
+      {
+         return 0.0f;
+      }
+
+      glm::vec3 size = aabb.max - aabb.min;
+      return (size.x * size.y) + (size.y * size.z) + (size.z * size.x);
+   }
+
+   void ExpandWithTriangle(AABB& aabb, const Triangle& triangle)
+   {
+      aabb.Expand(triangle.vertexA);
+      aabb.Expand(triangle.vertexB);
+      aabb.Expand(triangle.vertexC);
+   }
+
+   // The components of the direction of a ray can be zero (e.g. a ray that shoots straight down), which would make its inverse infinite
+   // Multiplying an infinite value by zero results in a NaN, so we replace those components with tiny values instead
+   glm::vec3 CalculateInverseDirection(const glm::vec3& direction)
+   {
+      glm::vec3 safeDirection;
+      for (int i = 0; i < 3; ++i)
+      {
+         safeDirection[i] = (glm::abs(direction[i]) > 1e-20f) ? direction[i] : ((direction[i] < 0.0f) ? -1e-20f : 1e-20f);
+      }
+
+      return 1.0f / safeDirection;
+   }
+
+   // This function implements the slab test, which intersects a ray with the three pairs of planes that bound an AABB
+   // It returns the distance along the ray to the point where it enters the AABB, or FLT_MAX if the ray misses it
+   // or if it enters it after maxDistance
+   float IntersectRayAABB(const glm::vec3& origin, const glm::vec3& inverseDirection, const glm::vec3& min, const glm::vec3& max, float maxDistance)
+   {
+      glm::vec3 t0 = (min - origin) * inverseDirection;
+      glm::vec3 t1 = (max - origin) * inverseDirection;
+
+      glm::vec3 tNear = glm::min(t0, t1);
+      glm::vec3 tFar  = glm::max(t0, t1);
+
+      float entry = glm::max(glm::max(tNear.x, tNear.y), glm::max(tNear.z, 0.0f));
+      float exit  = glm::min(glm::min(tFar.x, tFar.y), glm::min(tFar.z, maxDistance));
+
+      return (entry <= exit) ? entry : FLT_MAX;
+   }
+}
+
+TriangleBVH::TriangleBVH()
+   : mNodes()
+   , mPackets()
+   , mOriginalTriangleIndices()
+   , mNumTriangles(0)
+{
+
+}
+
+void TriangleBVH::Build(const IndexedTriangleStore& triangles)
+{
+   using namespace TriangleBVHHelpers;
+
+   mNodes.clear();
+   mPackets.clear();
+   mOriginalTriangleIndices.clear();
+   mNumTriangles = triangles.GetNumberOfTriangles();
+   if (mNumTriangles == 0)
+   {
+      return;
+   }
+
+   // The triangles are reordered while the tree is built, so we work on a copy of them
+   // That copy is only needed while the tree is built, since the leaves end up storing the triangles in packets
+   std::vector<Triangle>     sortedTriangles(mNumTriangles);
+   std::vector<unsigned int> originalTriangleIndices(mNumTriangles);
+   std::vector<glm::vec3>    centroids(mNumTriangles);
+   for (unsigned int triangleIndex = 0; triangleIndex < mNumTriangles; ++triangleIndex)
+   {
+      sortedTriangles[triangleIndex] = triangles.GetTriangle(triangleIndex);
+      const Triangle& triangle = sortedTriangles[triangleIndex];
+      originalTriangleIndices[triangleIndex] = triangleIndex;
+      centroids[triangleIndex] = (triangle.vertexA + triangle.vertexB + triangle.vertexC) / 3.0f;
+   }
+
+   // A binary tree with N leaves has 2N - 1 nodes, and each leaf has at least one triangle,
+   // so reserving 2N nodes guarantees that the vector is never reallocated while we build the tree
+   mNodes.reserve(mNumTriangles * 2);
+
+   Node root;
+   root.firstChildOrPacket = 0;
+   root.numTriangles       = mNumTriangles;
+   mNodes.push_back(root);
+
+   Subdivide(0, 0, sortedTriangles, originalTriangleIndices, centroids);
+
+   mNodes.shrink_to_fit();
+
+   // Pack the triangles of each leaf into packets of four
+   // While the tree is being built, firstChildOrPacket stores the index of the first triangle of each leaf,
+   // so here we replace it with the index of its first packet
+   for (unsigned int nodeIndex = 0,
+        numNodes = static_cast<unsigned int>(mNodes.size());
+        nodeIndex < numNodes;
+        ++nodeIndex)
+   {
+      Node& node = mNodes[nodeIndex];
+      if (node.numTriangles == 0)
+      {
+         continue;
+      }
+
+      unsigned int firstTriangle = node.firstChildOrPacket;
+      unsigned int firstPacket   = static_cast<unsigned int>(mPackets.size());
+      unsigned int numPackets    = CalculateNumberOfPackets(node.numTriangles);
+
+      mPackets.resize(firstPacket + numPackets);
+      mOriginalTriangleIndices.resize((firstPacket + numPackets) * 4, static_cast<unsigned int>(-1));
+      for (unsigned int i = 0; i < node.numTriangles; ++i)
+      {
+         mPackets[firstPacket + (i / 4)].SetTriangle(i % 4, PrecomputedTriangle(sortedTriangles[firstTriangle + i]));
+         mOriginalTriangleIndices[(firstPacket * 4) + i] = originalTriangleIndices[firstTriangle + i];
+      }
+
+      node.firstChildOrPacket = firstPacket;
+   }
+}
+
+void TriangleBVH::Subdivide(unsigned int               nodeIndex,
+                            unsigned int               depth,
+                            std::vector<Triangle>&     triangles,
+                            std::vector<unsigned int>& originalTriangleIndices,
+                            std::vector<glm::vec3>&    centroids)
+{
+   using namespace TriangleBVHHelpers;
+
+   unsigned int firstTriangle = mNodes[nodeIndex].firstChildOrPacket;
+   unsigned int numTriangles  = mNodes[nodeIndex].numTriangles;
+   unsigned int endTriangle   = firstTriangle + numTriangles;
+
+   // Calculate the bounds of the triangles and of their centroids
+   AABB nodeBounds;
+   AABB centroidBounds;
+   for (unsigned int triangleIndex = firstTriangle; triangleIndex < endTriangle; ++triangleIndex)
+   {
+      ExpandWithTriangle(nodeBounds, triangles[triangleIndex]);
+      centroidBounds.Expand(centroids[triangleIndex]);
+   }
+
+   mNodes[nodeIndex].min = nodeBounds.min;
+   mNodes[nodeIndex].max = nodeBounds.max;
+
+   if (numTriangles <= 1 || depth >= maxDepth)
+   {
+      return;
+   }
+
+   // Find the best split by evaluating the SAH at the boundaries between the bins along each axis
+   float bestCost     = FLT_MAX;
+   int   bestAxis     = -1;
+   int   bestBinIndex = -1;
+   for (int axis = 0; axis < 3; ++axis)
+   {
+      float centroidMin    = centroidBounds.min[axis];
+      float centroidExtent = centroidBounds.max[axis] - centroidMin;
+      if (centroidExtent <= 0.0f)
+      {
+         continue;
+      }
+
+      float binsPerUnit = static_cast<float>(numBins) / centroidExtent;
+
+      Bin bins[numBins];
+      for (unsigned int triangleIndex = firstTriangle; triangleIndex < endTriangle; ++triangleIndex)
+      {
+         unsigned int binIndex = std::min(numBins - 1, static_cast<unsigned int>((centroids[triangleIndex][axis] - centroidMin) * binsPerUnit));
+         bins[binIndex].numTriangles++;
+         ExpandWithTriangle(bins[binIndex].bounds, triangles[triangleIndex]);
+      }
+
+      // Sweep from the left and from the right to calculate the areas and the triangle counts on both sides of each boundary
+      float        leftAreas[numBins - 1];
+      float        rightAreas[numBins - 1];
+      unsigned int leftCounts[numBins - 1];
+      unsigned int rightCounts[numBins - 1];
+      AABB         leftBounds;
+      AABB         rightBounds;
+      unsigned int leftCount  = 0;
+      unsigned int rightCount = 0;
+      for (unsigned int i = 0; i < numBins - 1; ++i)
+      {
+         leftCount += bins[i].numTriangles;
+         leftBounds.Expand(bins[i].bounds);
+         leftCounts[i] = leftCount;
+         leftAreas[i]  = CalculateHalfSurfaceArea(leftBounds);
+
+         rightCount += bins[numBins - 1 - i].numTriangles;
+         rightBounds.Expand(bins[numBins - 1 - i].bounds);
+         rightCounts[numBins - 2 - i] = rightCount;
+         rightAreas[numBins - 2 - i]  = CalculateHalfSurfaceArea(rightBounds);
+      }
+
+      for (unsigned int i = 0; i < numBins - 1; ++i)
+      {
+         float cost = (CalculateNumberOfPackets(leftCounts[i]) * leftAreas[i]) + (CalculateNumberOfPackets(rightCounts[i]) * rightAreas[i]);
+         if (cost < bestCost)
+         {
+            bestCost     = cost;
+            bestAxis     = axis;
+            bestBinIndex = static_cast<int>(i);
+         }
+      }
+   }
+
+   // All the centroids are in the same spot, so there's no way to split this node
+   if (bestAxis == -1)
+   {
+      return;
+   }
+
+   // Don't split the node if it's cheaper to intersect all of its triangles
+   // Both costs are relative to the area of the node, so we multiply the cost of the leaf by it instead of dividing the cost of the split
+   float nodeArea  = CalculateHalfSurfaceArea(nodeBounds);
+   float leafCost  = CalculateNumberOfPackets(numTriangles) * nodeArea;
+   float splitCost = (traversalCost * nodeArea) + bestCost;
+   if (splitCost >= leafCost && numTriangles <= maxTrianglesPerLeaf)
+   {
+      return;
+   }
+
+   // Partition the triangles in place so that the ones on the left side of the split come first
+   float centroidMin = centroidBounds.min[bestAxis];
+   float binsPerUnit = static_cast<float>(numBins) / (centroidBounds.max[bestAxis] - centroidMin);
+   unsigned int i = firstTriangle;
+   unsigned int j = endTriangle;
+   while (i < j)
+   {
+      unsigned int binIndex = std::min(numBins - 1, static_cast<unsigned int>((centroids[i][bestAxis] - centroidMin) * binsPerUnit));
+      if (binIndex <= static_cast<unsigned int>(bestBinIndex))
+      {
+         ++i;
+      }
+      else
+      {
+         --j;
+         std::swap(triangles[i], triangles[j]);
+         std::swap(originalTriangleIndices[i], originalTriangleIndices[j]);
+         std::swap(centroids[i], centroids[j]);
+      }
+   }
+
+   unsigned int numLeftTriangles = i - firstTriangle;
+   if (numLeftTriangles == 0 || numLeftTriangles == numTriangles)
+   {
+      return;
+   }
+
+   // Create the children next to each other and turn the current node into an interior node
+   unsigned int leftChildIndex = static_cast<unsigned int>(mNodes.size());
+
+   Node leftChild;
+   leftChild.firstChildOrPacket = firstTriangle;
+   leftChild.numTriangles       = numLeftTriangles;
+   mNodes.push_back(leftChild);
+
+   Node rightChild;
+   rightChild.firstChildOrPacket = i;
+   rightChild.numTriangles       = numTriangles - numLeftTriangles;
+   mNodes.push_back(rightChild);
+
+   mNodes[nodeIndex].firstChildOrPacket = leftChildIndex;
+   mNodes[nodeIndex].numTriangles       = 0;
+
+   Subdivide(leftChildIndex, depth + 1, triangles, originalTriangleIndices, centroids);
+   Subdivide(leftChildIndex + 1, depth + 1, triangles, originalTriangleIndices, centroids);
+}
+
+bool TriangleBVH::IntersectRayClosest(const Ray& ray, glm::vec3& hitPoint) const
+{
+   unsigned int triangleIndex;
+   return IntersectRayClosest(ray, hitPoint, triangleIndex);
+}
+
+bool TriangleBVH::IntersectRayClosest(const Ray& ray, glm::vec3& hitPoint, unsigned int& triangleIndex) const
+{
+   using namespace TriangleBVHHelpers;
+
+   if (mNodes.size() == 0)
+   {
+      return false;
+   }
+
+   glm::vec3 inverseDirection = CalculateInverseDirection(ray.direction);
+
+   float closestDistance = FLT_MAX;
+   bool  hit             = false;
+
+   if (IntersectRayAABB(ray.origin, inverseDirection, mNodes[0].min, mNodes[0].max, closestDistance) == FLT_MAX)
+   {
+      return false;
+   }
+
+   unsigned int stack[maxStackSize];
+   unsigned int stackSize = 0;
+   unsigned int nodeIndex = 0;
+   while (true)
+   {
+      const Node& node = mNodes[nodeIndex];
+      if (node.numTriangles > 0)
+      {
+         // Test the ray against every packet of the leaf and keep the closest hit
+         float distances[4];
+         for (unsigned int packetIndex = node.firstChildOrPacket, end = node.firstChildOrPacket + CalculateNumberOfPackets(node.numTriangles); packetIndex < end; ++packetIndex)
+         {
+            int hitMask = IntersectRayWithTrianglePacket(ray, mPackets[packetIndex], closestDistance, distances);
+            for (unsigned int lane = 0; hitMask != 0; ++lane, hitMask >>= 1)
+            {
+               if ((hitMask & 1) && distances[lane] < closestDistance)
+               {
+                  closestDistance = distances[lane];
+                  triangleIndex   = mOriginalTriangleIndices[(packetIndex * 4) + lane];
+                  hit             = true;
+               }
+            }
+         }
+      }
+      else
+      {
+         // Visit the closest child first, and push the other one onto the stack if the ray also hits it
+         // Children that are further away than the closest hit are skipped
+         unsigned int nearChild    = node.firstChildOrPacket;
+         unsigned int farChild     = node.firstChildOrPacket + 1;
+         float        nearDistance = IntersectRayAABB(ray.origin, inverseDirection, mNodes[nearChild].min, mNodes[nearChild].max, closestDistance);
+         float        farDistance  = IntersectRayAABB(ray.origin, inverseDirection, mNodes[farChild].min, mNodes[farChild].max, closestDistance);
+         if (nearDistance > farDistance)
+         {
+            std::swap(nearChild, farChild);
+            std::swap(nearDistance, farDistance);
+         }
+
+         if (nearDistance != FLT_MAX)
+         {
+            if (farDistance != FLT_MAX)
+            {
+               stack[stackSize++] = farChild;
+            }
+
+            nodeIndex = nearChild;
+            continue;
+         }
+      }
+
+      if (stackSize == 0)
+      {
+         break;
+      }
+
+      nodeIndex = stack[--stackSize];
+   }
+
+   if (hit)
+   {
+      hitPoint = (ray.direction * closestDistance) + ray.origin;
+   }
+
+   return hit;
+}
+
+bool TriangleBVH::IntersectRayAny(const Ray& ray, float maxDistance) const
+{
+   using namespace TriangleBVHHelpers;
+
+   if (mNodes.size() == 0)
+   {
+      return false;
+   }
+
+   glm::vec3 inverseDirection = CalculateInverseDirection(ray.direction);
+
+   // The packet test only accepts hits that are strictly closer than the maximum distance
+   float maxDistanceOfPacketTest = (maxDistance < FLT_MAX) ? std::nextafter(maxDistance, FLT_MAX) : FLT_MAX;
+
+   unsigned int stack[maxStackSize];
+   unsigned int stackSize = 0;
+   stack[stackSize++] = 0;
+   while (stackSize > 0)
+   {
+      const Node& node = mNodes[stack[--stackSize]];
+      if (IntersectRayAABB(ray.origin, inverseDirection, node.min, node.max, maxDistance) == FLT_MAX)
+      {
+         continue;
+      }
+
+      if (node.numTriangles > 0)
+      {
+         float distances[4];
+         for (unsigned int packetIndex = node.firstChildOrPacket, end = node.firstChildOrPacket + CalculateNumberOfPackets(node.numTriangles); packetIndex < end; ++packetIndex)
+         {
+            if (IntersectRayWithTrianglePacket(ray, mPackets[packetIndex], maxDistanceOfPacketTest, distances) != 0)
+            {
+               return true;
+            }
+         }
+      }
+      else
+      {
+         stack[stackSize++] = node.firstChildOrPacket + 1;
+         stack[stackSize++] = node.firstChildOrPacket;
+      }
+   }
+
+   return false;
+}
+
+AABB TriangleBVH::GetBounds() const
+{
+   if (mNodes.size() == 0)
+   {
+      return AABB();
+   }
+
+   return AABB(mNodes[0].min, mNodes[0].max);
+}
+
+unsigned int TriangleBVH::GetNumberOfNodes() const
+{
+   return static_cast<unsigned int>(mNodes.size());
+}
+
+unsigned int TriangleBVH::GetNumberOfTriangles() const
+{
+   return mNumTriangles;
+}
+
+void BenchmarkTriangleBVH(const TriangleBVH& bvh, const IndexedTriangleStore& store, unsigned int numRays)
+{
+   AABB bounds = bvh.GetBounds();
+   if (bounds.IsEmpty() || numRays == 0)
+   {
+      return;
+   }
+
+   // Shoot the rays straight down from above the bounds of the BVH, on a grid that covers them, just like the ground rays of the IK states
+   unsigned int raysPerSide = static_cast<unsigned int>(glm::ceil(glm::sqrt(static_cast<float>(numRays))));
+   std::vector<Ray> rays;
+   rays.reserve(raysPerSide * raysPerSide);
+   for (unsigned int z = 0; z < raysPerSide; ++z)
+   {
+      for (unsigned int x = 0; x < raysPerSide; ++x)
+      {
+         glm::vec3 origin(glm::mix(bounds.min.x, bounds.max.x, (x + 0.5f) / raysPerSide),
+                          bounds.max.y + 1.0f,
+                          glm::mix(bounds.min.z, bounds.max.z, (z + 0.5f) / raysPerSide));
+         rays.push_back(Ray(origin, glm::vec3(0.0f, -1.0f, 0.0f)));
+      }
+   }
+
+   // The brute force tests need the triangles with their normals
+   unsigned int numTriangles = store.GetNumberOfTriangles();
+   std::vector<Triangle> triangles(numTriangles);
+   for (unsigned int triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+   {
+      triangles[triangleIndex] = store.GetTriangle(triangleIndex);
+   }
+
+   unsigned int numBenchmarkRays = static_cast<unsigned int>(rays.size());
+
+   // Brute force: test every ray against every triangle and keep the closest hit
+   std::vector<bool>      bruteForceHits(numBenchmarkRays, false);
+   std::vector<glm::vec3> bruteForceHitPoints(numBenchmarkRays);
+   auto start = std::chrono::steady_clock::now();
+   for (unsigned int rayIndex = 0; rayIndex < numBenchmarkRays; ++rayIndex)
+   {
+      float     closestDistance = FLT_MAX;
+      glm::vec3 hitPoint;
+      float     distance;
+      for (unsigned int triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+      {
+         if (DoesRayIntersectTriangle(rays[rayIndex], triangles[triangleIndex], hitPoint, distance) && distance < closestDistance)
+         {
+            closestDistance               = distance;
+            bruteForceHitPoints[rayIndex] = hitPoint;
+            bruteForceHits[rayIndex]      = true;
+         }
+      }
+   }
+   auto end = std::chrono::steady_clock::now();
+   double bruteForceSeconds = std::chrono::duration<double>(end - start).count();
+
+   // Brute force with packets: test every ray against every packet of four triangles with SIMD instructions
+   std::vector<TrianglePacket> packets = CreateTrianglePackets(triangles);
+   unsigned int numPackets = static_cast<unsigned int>(packets.size());
+   unsigned int numPacketHits = 0;
+   start = std::chrono::steady_clock::now();
+   for (unsigned int rayIndex = 0; rayIndex < numBenchmarkRays; ++rayIndex)
+   {
+      float closestDistance = FLT_MAX;
+      float distances[4];
+      for (unsigned int packetIndex = 0; packetIndex < numPackets; ++packetIndex)
+      {
+         int hitMask = IntersectRayWithTrianglePacket(rays[rayIndex], packets[packetIndex], closestDistance, distances);
+         for (unsigned int lane = 0; hitMask != 0; ++lane, hitMask >>= 1)
+         {
+            if ((hitMask & 1) && distances[lane] < closestDistance)
+            {
+               closestDistance = distances[lane];
+            }
+         }
+      }
+
+      numPacketHits += (closestDistance != FLT_MAX) ? 1 : 0;
+   }
+   end = std::chrono::steady_clock::now();
+   double bruteForcePacketsSeconds = std::chrono::duration<double>(end - start).count();
+
+   // The BVH queries are much faster, so we repeat them to get a measurement that isn't dominated by the resolution of the clock
+   const unsigned int numRepetitions = 16;
+
+   std::vector<bool>      bvhHits(numBenchmarkRays, false);
+   std::vector<glm::vec3> bvhHitPoints(numBenchmarkRays);
+   start = std::chrono::steady_clock::now();
+   for (unsigned int repetition = 0; repetition < numRepetitions; ++repetition)
+   {
+      for (unsigned int rayIndex = 0; rayIndex < numBenchmarkRays; ++rayIndex)
+      {
+         glm::vec3 hitPoint;
+         bvhHits[rayIndex] = bvh.IntersectRayClosest(rays[rayIndex], hitPoint);
+         bvhHitPoints[rayIndex] = hitPoint;
+      }
+   }
+   end = std::chrono::steady_clock::now();
+   double bvhClosestSeconds = std::chrono::duration<double>(end - start).count();
+
+   unsigned int numAnyHits = 0;
+   start = std::chrono::steady_clock::now();
+   for (unsigned int repetition = 0; repetition < numRepetitions; ++repetition)
+   {
+      for (unsigned int rayIndex = 0; rayIndex < numBenchmarkRays; ++rayIndex)
+      {
+         numAnyHits += bvh.IntersectRayAny(rays[rayIndex], FLT_MAX) ? 1 : 0;
+      }
+   }
+   end = std::chrono::steady_clock::now();
+   double bvhAnySeconds = std::chrono::duration<double>(end - start).count();
+
+   // Count the rays whose results don't match between both methods
+   unsigned int numMismatches = 0;
+   for (unsigned int rayIndex = 0; rayIndex < numBenchmarkRays; ++rayIndex)
+   {
+      if (bruteForceHits[rayIndex] != bvhHits[rayIndex] ||
+          (bvhHits[rayIndex] && glm::length2(bruteForceHitPoints[rayIndex] - bvhHitPoints[rayIndex]) > 1e-8f))
+      {
+         ++numMismatches;
+      }
+   }
+
+   double bruteForceRaysPerSecond = numBenchmarkRays / glm::max(bruteForceSeconds, 1e-9);
+   double bruteForcePacketsRaysPerSecond = numBenchmarkRays / glm::max(bruteForcePacketsSeconds, 1e-9);
+   double bvhClosestRaysPerSecond = (numBenchmarkRays * numRepetitions) / glm::max(bvhClosestSeconds, 1e-9);
+   double bvhAnyRaysPerSecond     = (numBenchmarkRays * numRepetitions) / glm::max(bvhAnySeconds, 1e-9);
+
+   std::cout << "Triangle BVH - Triangles: " << bvh.GetNumberOfTriangles() << ", Nodes: " << bvh.GetNumberOfNodes()
+             << ", Rays: " << numBenchmarkRays << ", Mismatches: " << numMismatches
+             << ", Hits (brute force / packets / any): " << (numBenchmarkRays - std::count(bruteForceHits.begin(), bruteForceHits.end(), false)) << " / " << numPacketHits << " / " << (numAnyHits / numRepetitions) << '\n'
+             << "   Brute force:         " << bruteForceRaysPerSecond << " rays/s" << '\n'
+             << "   Brute force packets: " << bruteForcePacketsRaysPerSecond << " rays/s (" << (bruteForcePacketsRaysPerSecond / bruteForceRaysPerSecond) << "x)" << '\n'
+             << "   BVH closest hit:     " << bvhClosestRaysPerSecond << " rays/s (" << (bvhClosestRaysPerSecond / bruteForceRaysPerSecond) << "x)" << '\n'
+             << "   BVH any hit:         " << bvhAnyRaysPerSecond << " rays/s (" << (bvhAnyRaysPerSecond / bruteForceRaysPerSecond) << "x)" << '\n';
+}
@@ -0,0 +1,181 @@
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define TRIANGLE_PACKET_USE_SSE
+#endif
+
+#include "TrianglePacket.h"
+
+namespace TrianglePacketHelpers
+{
+   /*
+      The functions below wrap the few SIMD operations that the packet test needs, so that it can be written once for WebAssembly SIMD and SSE
+      WebAssembly only supports 128-bit vectors, which is why the packets contain four triangles instead of eight
+   */
+
+#if defined(__wasm_simd128__)
+   typedef v128_t Float4;
+
+   inline Float4 Load(const float* values)           { return wasm_v128_load(values); }
+   inline Float4 Splat(float value)                  { return wasm_f32x4_splat(value); }
+   inline void   Store(float* values, Float4 a)      { wasm_v128_store(values, a); }
+   inline Float4 Add(Float4 a, Float4 b)             { return wasm_f32x4_add(a, b); }
+   inline Float4 Sub(Float4 a, Float4 b)             { return wasm_f32x4_sub(a, b); }
+   inline Float4 Mul(Float4 a, Float4 b)             { return wasm_f32x4_mul(a, b); }
+   inline Float4 Div(Float4 a, Float4 b)             { return wasm_f32x4_div(a, b); }
+   inline Float4 GreaterEqual(Float4 a, Float4 b)    { return wasm_f32x4_ge(a, b); }
+   inline Float4 Less(Float4 a, Float4 b)            { return wasm_f32x4_lt(a, b); }
+   inline Float4 LessEqual(Float4 a, Float4 b)       { return wasm_f32x4_le(a, b); }
+   inline Float4 And(Float4 a, Float4 b)             { return wasm_v128_and(a, b); }
+   inline int    MoveMask(Float4 a)                  { return static_cast<int>(wasm_i32x4_bitmask(a)); }
+#elif defined(TRIANGLE_PACKET_USE_SSE)
+   typedef __m128 Float4;
+
+   inline Float4 Load(const float* values)           { return _mm_load_ps(values); }
+   inline Float4 Splat(float value)                  { return _mm_set1_ps(value); }
+   inline void   Store(float* values, Float4 a)      { _mm_storeu_ps(values, a); }
+   inline Float4 Add(Float4 a, Float4 b)             { return _mm_add_ps(a, b); }
+   inline Float4 Sub(Float4 a, Float4 b)             { return _mm_sub_ps(a, b); }
+   inline Float4 Mul(Float4 a, Float4 b)             { return _mm_mul_ps(a, b); }
+   inline Float4 Div(Float4 a, Float4 b)             { return _mm_div_ps(a, b); }
+   inline Float4 GreaterEqual(Float4 a, Float4 b)    { return _mm_cmpge_ps(a, b); }
+   inline Float4 Less(Float4 a, Float4 b)            { return _mm_cmplt_ps(a, b); }
+   inline Float4 LessEqual(Float4 a, Float4 b)       { return _mm_cmple_ps(a, b); }
+   inline Float4 And(Float4 a, Float4 b)             { return _mm_and_ps(a, b); }
+   inline int    MoveMask(Float4 a)                  { return _mm_movemask_ps(a); }
+#endif
+}
+
+TrianglePacket::TrianglePacket()
+{
+   // Fill every lane with a degenerate triangle
+   for (unsigned int lane = 0; lane < 4; ++lane)
+   {
+      SetTriangle(lane, PrecomputedTriangle());
+   }
+}
+
+void TrianglePacket::SetTriangle(unsigned int lane, const PrecomputedTriangle& triangle)
+{
+   vertexAX[lane] = triangle.vertexA.x;
+   vertexAY[lane] = triangle.vertexA.y;
+   vertexAZ[lane] = triangle.vertexA.z;
+   edgeABX[lane]  = triangle.edgeAB.x;
+   edgeABY[lane]  = triangle.edgeAB.y;
+   edgeABZ[lane]  = triangle.edgeAB.z;
+   edgeACX[lane]  = triangle.edgeAC.x;
+   edgeACY[lane]  = triangle.edgeAC.y;
+   edgeACZ[lane]  = triangle.edgeAC.z;
+}
+
+// This function is the SIMD version of DoesRayIntersectTriangle(const Ray&, const PrecomputedTriangle&, glm::vec3&, float&)
+// Instead of returning as soon as a test fails, it calculates a mask for each test and combines them at the end
+int IntersectRayWithTrianglePacket(const Ray& ray, const TrianglePacket& packet, float maxDistance, float outDistances[4])
+{
+   using namespace TrianglePacketHelpers;
+
+#if defined(__wasm_simd128__) || defined(TRIANGLE_PACKET_USE_SSE)
+   Float4 dirX = Splat(ray.direction.x);
+   Float4 dirY = Splat(ray.direction.y);
+   Float4 dirZ = Splat(ray.direction.z);
+
+   Float4 edgeABX = Load(packet.edgeABX);
+   Float4 edgeABY = Load(packet.edgeABY);
+   Float4 edgeABZ = Load(packet.edgeABZ);
+   Float4 edgeACX = Load(packet.edgeACX);
+   Float4 edgeACY = Load(packet.edgeACY);
+   Float4 edgeACZ = Load(packet.edgeACZ);
+
+   // p = direction x edgeAC
+   Float4 pX = Sub(Mul(dirY, edgeACZ), Mul(dirZ, edgeACY));
+   Float4 pY = Sub(Mul(dirZ, edgeACX), Mul(dirX, edgeACZ));
+   Float4 pZ = Sub(Mul(dirX, edgeACY), Mul(dirY, edgeACX));
+
+   // det = edgeAB dot p
+   Float4 det = Add(Add(Mul(edgeABX, pX), Mul(edgeABY, pY)), Mul(edgeABZ, pZ));
+   Float4 mask = GreaterEqual(det, Splat(minMollerTrumboreDeterminant));
+
+   // Dividing by a determinant of zero produces infinities and NaNs in the lanes that have already failed, but they are masked out
+   Float4 invDet = Div(Splat(1.0f), det);
+
+   // originToA = origin - A
+   Float4 originToAX = Sub(Splat(ray.origin.x), Load(packet.vertexAX));
+   Float4 originToAY = Sub(Splat(ray.origin.y), Load(packet.vertexAY));
+   Float4 originToAZ = Sub(Splat(ray.origin.z), Load(packet.vertexAZ));
+
+   // u = (originToA dot p) / det
+   Float4 u = Mul(Add(Add(Mul(originToAX, pX), Mul(originToAY, pY)), Mul(originToAZ, pZ)), invDet);
+   mask = And(mask, And(GreaterEqual(u, Splat(0.0f)), LessEqual(u, Splat(1.0f))));
+
+   // q = originToA x edgeAB
+   Float4 qX = Sub(Mul(originToAY, edgeABZ), Mul(originToAZ, edgeABY));
+   Float4 qY = Sub(Mul(originToAZ, edgeABX), Mul(originToAX, edgeABZ));
+   Float4 qZ = Sub(Mul(originToAX, edgeABY), Mul(originToAY, edgeABX));
+
+   // v = (direction dot q) / det
+   Float4 v = Mul(Add(Add(Mul(dirX, qX), Mul(dirY, qY)), Mul(dirZ, qZ)), invDet);
+   mask = And(mask, And(GreaterEqual(v, Splat(0.0f)), LessEqual(Add(u, v), Splat(1.0f))));
+
+   // t = (edgeAC dot q) / det
+   Float4 t = Mul(Add(Add(Mul(edgeACX, qX), Mul(edgeACY, qY)), Mul(edgeACZ, qZ)), invDet);
+   mask = And(mask, And(GreaterEqual(t, Splat(0.0f)), Less(t, Splat(maxDistance))));
+
+   Store(outDistances, t);
+   return MoveMask(mask);
+#else
+   int mask = 0;
+   for (unsigned int lane = 0; lane < 4; ++lane)
+   {
+      glm::vec3 edgeAB(packet.edgeABX[lane], packet.edgeABY[lane], packet.edgeABZ[lane]);
+      glm::vec3 edgeAC(packet.edgeACX[lane], packet.edgeACY[lane], packet.edgeACZ[lane]);
+
+      glm::vec3 p = glm::cross(ray.direction, edgeAC);
+      float det = glm::dot(edgeAB, p);
+      if (det < minMollerTrumboreDeterminant)
+      {
+         continue;
+      }
+
+      float invDet = 1.0f / det;
+
+      glm::vec3 originToA = ray.origin - glm::vec3(packet.vertexAX[lane], packet.vertexAY[lane], packet.vertexAZ[lane]);
+      float u = glm::dot(originToA, p) * invDet;
+      if (u < 0.0f || u > 1.0f)
+      {
+         continue;
+      }
+
+      glm::vec3 q = glm::cross(originToA, edgeAB);
+      float v = glm::dot(ray.direction, q) * invDet;
+      if (v < 0.0f || (u + v) > 1.0f)
+      {
+         continue;
+      }
+
+      float t = glm::dot(edgeAC, q) * invDet;
+      if (t < 0.0f || t >= maxDistance)
+      {
+         continue;
+      }
+
+      outDistances[lane] = t;
+      mask |= (1 << lane);
+   }
+
+   return mask;
+#endif
+}
+
+std::vector<TrianglePacket> CreateTrianglePackets(const std::vector<Triangle>& triangles)
+{
+   unsigned int numTriangles = static_cast<unsigned int>(triangles.size());
+
+   std::vector<TrianglePacket> packets((numTriangles + 3) / 4);
+   for (unsigned int triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+   {
+      packets[triangleIndex / 4].SetTriangle(triangleIndex % 4, PrecomputedTriangle(triangles[triangleIndex]));
+   }
+
+   return packets;
+}
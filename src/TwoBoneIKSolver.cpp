@@ -0,0 +1,252 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <glm/gtx/norm.hpp>
+#include <glm/gtx/vector_angle.hpp>
+
+#include "FABRIKSolver.h"
+#include "TwoBoneIKSolver.h"
+
+namespace TwoBoneIKSolverHelpers
+{
+   bool IsKneeBackwards(const glm::vec3& hipPos, const glm::vec3& kneePos, const glm::vec3& anklePos, const glm::vec3& characterRight)
+   {
+      float angleInDeg = glm::degrees(glm::orientedAngle(glm::normalize(anklePos - kneePos), glm::normalize(hipPos - kneePos), characterRight));
+      return angleInDeg < 0.0f && (180.0f + angleInDeg) > 10.0f;
+   }
+}
+
+TwoBoneIKSolver::TwoBoneIKSolver()
+{
+
+}
+
+Transform TwoBoneIKSolver::GetLocalTransform(unsigned int jointIndex) const
+{
+   return mIKChain[jointIndex];
+}
+
+void TwoBoneIKSolver::SetLocalTransform(unsigned int jointIndex, const Transform& transform)
+{
+   mIKChain[jointIndex] = transform;
+}
+
+Transform TwoBoneIKSolver::GetGlobalTransform(unsigned int jointIndex) const
+{
+   // The IK chain is organized so that each joint is preceded by its parent
+   Transform result = mIKChain[jointIndex];
+
+   for (int parentIndex = static_cast<int>(jointIndex) - 1; parentIndex >= 0; --parentIndex)
+   {
+      result = combine(mIKChain[parentIndex], result);
+   }
+
+   return result;
+}
+
+bool TwoBoneIKSolver::Solve(const Transform& target, const glm::vec3& characterRight)
+{
+   glm::vec3 hipPos   = GetGlobalTransform(0).position;
+   glm::vec3 kneePos  = GetGlobalTransform(1).position;
+   glm::vec3 anklePos = GetGlobalTransform(2).position;
+
+   float lengthOfThigh = glm::length(kneePos - hipPos);
+   float lengthOfShin  = glm::length(anklePos - kneePos);
+
+   glm::vec3 hipToTarget  = target.position - hipPos;
+   float     distToTarget = glm::length(hipToTarget);
+
+   // We cannot solve the IK chain if one of its bones has a length of zero or if the target is on top of the hip
+   if (lengthOfThigh < 0.00001f || lengthOfShin < 0.00001f || distToTarget < 0.00001f)
+   {
+      return false;
+   }
+
+   float minDist = glm::abs(lengthOfThigh - lengthOfShin);
+   float maxDist = lengthOfThigh + lengthOfShin;
+   bool  isTargetWithinReach = (distToTarget >= minDist) && (distToTarget <= maxDist);
+
+   // --- Bend the knee ---
+
+   // The normal of the plane of the leg points to the right of the character when the knee is bent forward,
+   // so if it points to the left we flip it, which turns the rotation below into a backwards knee correction
+   // A straight leg doesn't have a plane, so in that case we bend it around the right vector of the character
+   glm::vec3 kneeToAnkle = anklePos - kneePos;
+   glm::vec3 kneeToHip   = hipPos - kneePos;
+   glm::vec3 normalOfLeg = glm::cross(kneeToAnkle, kneeToHip);
+   if (glm::length2(normalOfLeg) < 0.0000001f * lengthOfThigh * lengthOfThigh * lengthOfShin * lengthOfShin)
+   {
+      normalOfLeg = characterRight;
+   }
+   normalOfLeg = glm::normalize(normalOfLeg);
+   if (glm::dot(normalOfLeg, characterRight) < 0.0f)
+   {
+      normalOfLeg = -normalOfLeg;
+   }
+
+   // Law of cosines
+   float clampedDistToTarget = glm::clamp(distToTarget, minDist, maxDist);
+   float cosOfDesiredAngle   = (lengthOfThigh * lengthOfThigh + lengthOfShin * lengthOfShin - clampedDistToTarget * clampedDistToTarget) / (2.0f * lengthOfThigh * lengthOfShin);
+   float desiredAngle        = glm::acos(glm::clamp(cosOfDesiredAngle, -1.0f, 1.0f));
+   float currAngle           = glm::orientedAngle(glm::normalize(kneeToAnkle), glm::normalize(kneeToHip), normalOfLeg);
+
+   // Rotating the shin around the normal of the leg by a positive angle closes the knee, so we rotate it by the difference between both angles
+   ApplyWorldRotation(1, Q::angleAxis(currAngle - desiredAngle, normalOfLeg));
+
+   // --- Point the leg at the target ---
+
+   glm::vec3 dirToTarget = hipToTarget / distToTarget;
+
+   anklePos = GetGlobalTransform(2).position;
+   ApplyWorldRotation(0, Q::fromTo(anklePos - hipPos, hipToTarget));
+
+   // --- Twist the leg around the line that goes from the hip to the target so that the knee bends forward ---
+
+   // The pole vector is the component of the right vector of the character that's perpendicular to the line that goes from the hip to the target
+   // If the target is directly to the right or to the left of the hip, the pole vector is undefined, so we leave the leg as it is
+   glm::vec3 poleVector = characterRight - dirToTarget * glm::dot(characterRight, dirToTarget);
+   if (glm::length2(poleVector) > 0.000001f)
+   {
+      kneePos  = GetGlobalTransform(1).position;
+      anklePos = GetGlobalTransform(2).position;
+
+      glm::vec3 currNormalOfLeg = glm::cross(anklePos - kneePos, hipPos - kneePos);
+      currNormalOfLeg -= dirToTarget * glm::dot(currNormalOfLeg, dirToTarget);
+      if (glm::length2(currNormalOfLeg) > 0.0000001f * lengthOfThigh * lengthOfThigh * lengthOfShin * lengthOfShin)
+      {
+         float twistAngle = glm::orientedAngle(glm::normalize(currNormalOfLeg), glm::normalize(poleVector), dirToTarget);
+         ApplyWorldRotation(0, Q::angleAxis(twistAngle, dirToTarget));
+      }
+   }
+
+   return isTargetWithinReach;
+}
+
+// This function applies a world rotation to a joint of the chain by converting it into a local rotation,
+// just like FABRIKSolver::ApplyBackwardsKneeCorrection does
+void TwoBoneIKSolver::ApplyWorldRotation(unsigned int jointIndex, const Q::quat& worldRotation)
+{
+   Q::quat worldRotOfJoint    = GetGlobalTransform(jointIndex).rotation;
+   Q::quat newWorldRotOfJoint = worldRotOfJoint * worldRotation;
+   Q::quat newLocalRotOfJoint = newWorldRotOfJoint * Q::inverse(worldRotOfJoint);
+   mIKChain[jointIndex].rotation = Q::normalized(newLocalRotOfJoint * mIKChain[jointIndex].rotation);
+}
+
+void BenchmarkTwoBoneIKSolver(const Transform& hip, const Transform& knee, const Transform& ankle, const glm::vec3& characterRight, unsigned int numIterations, unsigned int numTargets)
+{
+   if (numTargets == 0)
+   {
+      return;
+   }
+
+   glm::vec3 worldPosOfKnee  = combine(hip, knee).position;
+   glm::vec3 worldPosOfAnkle = combine(hip, combine(knee, ankle)).position;
+   float     lengthOfLeg     = glm::length(worldPosOfKnee - hip.position) + glm::length(worldPosOfAnkle - worldPosOfKnee);
+
+   // Place the targets on a grid inside a box around the ankle, which is where the ground ends up when the character walks on uneven terrain
+   unsigned int targetsPerSide = static_cast<unsigned int>(glm::ceil(glm::pow(static_cast<float>(numTargets), 1.0f / 3.0f)));
+   float        halfSizeOfBox  = 0.25f * lengthOfLeg;
+   std::vector<glm::vec3> targets;
+   targets.reserve(targetsPerSide * targetsPerSide * targetsPerSide);
+   for (unsigned int z = 0; z < targetsPerSide; ++z)
+   {
+      for (unsigned int y = 0; y < targetsPerSide; ++y)
+      {
+         for (unsigned int x = 0; x < targetsPerSide; ++x)
+         {
+            glm::vec3 offset(glm::mix(-halfSizeOfBox, halfSizeOfBox, (x + 0.5f) / targetsPerSide),
+                             glm::mix(-halfSizeOfBox, halfSizeOfBox, (y + 0.5f) / targetsPerSide),
+                             glm::mix(-halfSizeOfBox, halfSizeOfBox, (z + 0.5f) / targetsPerSide));
+            targets.push_back(worldPosOfAnkle + offset);
+         }
+      }
+   }
+
+   unsigned int numBenchmarkTargets = static_cast<unsigned int>(targets.size());
+
+   // Both solvers are reset before each target, just like the IK legs reset them every frame
+   std::vector<glm::vec3> fabrikKneePositions(numBenchmarkTargets);
+   std::vector<glm::vec3> fabrikAnklePositions(numBenchmarkTargets);
+   FABRIKSolver fabrikSolver;
+   fabrikSolver.SetNumberOfJointsInIKChain(3);
+   fabrikSolver.SetNumberOfIterations(numIterations);
+   auto start = std::chrono::steady_clock::now();
+   for (unsigned int targetIndex = 0; targetIndex < numBenchmarkTargets; ++targetIndex)
+   {
+      fabrikSolver.SetLocalTransform(0, hip);
+      fabrikSolver.SetLocalTransform(1, knee);
+      fabrikSolver.SetLocalTransform(2, ankle);
+      fabrikSolver.SolveThreeJointLegWithConstraints(Transform(targets[targetIndex], Q::quat(), glm::vec3(1.0f)), 1, characterRight);
+      fabrikKneePositions[targetIndex]  = fabrikSolver.GetGlobalTransform(1).position;
+      fabrikAnklePositions[targetIndex] = fabrikSolver.GetGlobalTransform(2).position;
+   }
+   auto end = std::chrono::steady_clock::now();
+   double fabrikSeconds = std::chrono::duration<double>(end - start).count();
+
+   std::vector<glm::vec3> analyticKneePositions(numBenchmarkTargets);
+   std::vector<glm::vec3> analyticAnklePositions(numBenchmarkTargets);
+   std::vector<bool>      isTargetWithinReach(numBenchmarkTargets);
+   TwoBoneIKSolver analyticSolver;
+   start = std::chrono::steady_clock::now();
+   for (unsigned int targetIndex = 0; targetIndex < numBenchmarkTargets; ++targetIndex)
+   {
+      analyticSolver.SetLocalTransform(0, hip);
+      analyticSolver.SetLocalTransform(1, knee);
+      analyticSolver.SetLocalTransform(2, ankle);
+      isTargetWithinReach[targetIndex] = analyticSolver.Solve(Transform(targets[targetIndex], Q::quat(), glm::vec3(1.0f)), characterRight);
+      analyticKneePositions[targetIndex]  = analyticSolver.GetGlobalTransform(1).position;
+      analyticAnklePositions[targetIndex] = analyticSolver.GetGlobalTransform(2).position;
+   }
+   end = std::chrono::steady_clock::now();
+   double analyticSeconds = std::chrono::duration<double>(end - start).count();
+
+   // Measure the errors relative to the length of the leg, so that they don't depend on the scale of the character
+   // Targets that are out of reach are skipped, since neither solver can touch them
+   unsigned int numReachableTargets       = 0;
+   float        fabrikAnkleError          = 0.0f;
+   float        fabrikMaxAnkleError       = 0.0f;
+   float        analyticAnkleError        = 0.0f;
+   float        analyticMaxAnkleError     = 0.0f;
+   float        kneeDifference            = 0.0f;
+   float        maxKneeDifference         = 0.0f;
+   unsigned int numBackwardsKneesFABRIK   = 0;
+   unsigned int numBackwardsKneesAnalytic = 0;
+   for (unsigned int targetIndex = 0; targetIndex < numBenchmarkTargets; ++targetIndex)
+   {
+      if (!isTargetWithinReach[targetIndex])
+      {
+         continue;
+      }
+
+      ++numReachableTargets;
+
+      float currFABRIKAnkleError   = glm::length(fabrikAnklePositions[targetIndex] - targets[targetIndex]) / lengthOfLeg;
+      float currAnalyticAnkleError = glm::length(analyticAnklePositions[targetIndex] - targets[targetIndex]) / lengthOfLeg;
+      float currKneeDifference     = glm::length(fabrikKneePositions[targetIndex] - analyticKneePositions[targetIndex]) / lengthOfLeg;
+
+      fabrikAnkleError      += currFABRIKAnkleError;
+      fabrikMaxAnkleError    = glm::max(fabrikMaxAnkleError, currFABRIKAnkleError);
+      analyticAnkleError    += currAnalyticAnkleError;
+      analyticMaxAnkleError  = glm::max(analyticMaxAnkleError, currAnalyticAnkleError);
+      kneeDifference        += currKneeDifference;
+      maxKneeDifference      = glm::max(maxKneeDifference, currKneeDifference);
+
+      // A knee is backwards if it bends towards the back of the character by more than a few degrees,
+      // which is the same test that FABRIKSolver::ApplyBackwardsKneeCorrection performs
+      numBackwardsKneesFABRIK   += TwoBoneIKSolverHelpers::IsKneeBackwards(hip.position, fabrikKneePositions[targetIndex], fabrikAnklePositions[targetIndex], characterRight) ? 1 : 0;
+      numBackwardsKneesAnalytic += TwoBoneIKSolverHelpers::IsKneeBackwards(hip.position, analyticKneePositions[targetIndex], analyticAnklePositions[targetIndex], characterRight) ? 1 : 0;
+   }
+
+   float invNumReachableTargets = 1.0f / glm::max(numReachableTargets, 1u);
+
+   double fabrikLegsPerSecond   = numBenchmarkTargets / glm::max(fabrikSeconds, 1e-9);
+   double analyticLegsPerSecond = numBenchmarkTargets / glm::max(analyticSeconds, 1e-9);
+
+   std::cout << "Two-bone IK - Targets: " << numBenchmarkTargets << ", Reachable: " << numReachableTargets << ", FABRIK iterations: " << numIterations << '\n'
+             << "   FABRIK with constraints: " << fabrikLegsPerSecond << " legs/s, Ankle error (avg / max): " << (fabrikAnkleError * invNumReachableTargets) << " / " << fabrikMaxAnkleError
+             << " leg lengths, Backwards knees: " << numBackwardsKneesFABRIK << '\n'
+             << "   Analytic:                " << analyticLegsPerSecond << " legs/s (" << (analyticLegsPerSecond / fabrikLegsPerSecond) << "x), Ankle error (avg / max): " << (analyticAnkleError * invNumReachableTargets) << " / " << analyticMaxAnkleError
+             << " leg lengths, Backwards knees: " << numBackwardsKneesAnalytic << '\n'
+             << "   Knee difference (avg / max): " << (kneeDifference * invNumReachableTargets) << " / " << maxKneeDifference << " leg lengths" << '\n';
+}
@@ -3,7 +3,7 @@
 #include "texture_loader.h"
 #include "Water.h"
 
-Water::Water(const Transform& modelTransform)
+Water::Water(const Transform& modelTransform, AssetLoader& assetLoader)
    : mModelTransform(modelTransform)
    , mWaterVAO(0)
    , mWaterVBO(0)
@@ -23,9 +23,9 @@ Water::Water(const Transform& modelTransform)
    mWaterShader = ResourceManager<Shader>().loadUnmanagedResource<ShaderLoader>("resources/shaders/water.vert",
                                                                                 "resources/shaders/water.frag");
 
-   mDuDvMap = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>("resources/models/water/dudv.png");
+   mDuDvMap = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>(assetLoader.GetImage("resources/models/water/dudv.png"));
 
-   mNormalMap = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>("resources/models/water/normal.png");
+   mNormalMap = ResourceManager<Texture>().loadUnmanagedResource<TextureLoader>(assetLoader.GetImage("resources/models/water/normal.png"));
 
    ConfigureVAO();
    ConfigureReflectionFBO();
@@ -55,6 +55,17 @@ void FiniteStateMachine::changeState(const std::string& newStateID)
    }
 }
 
+void FiniteStateMachine::addState(const std::string& stateID, const std::shared_ptr<State>& state)
+{
+   if (mStates.find(stateID) != mStates.end())
+   {
+      std::cout << "Error - FiniteStateMachine::addState - A state with the following ID already exists: " << stateID << "\n";
+      return;
+   }
+
+   mStates[stateID] = state;
+}
+
 std::shared_ptr<State> FiniteStateMachine::getPreviousState()
 {
    return mStates[mPreviousStateID];
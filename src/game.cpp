@@ -4,11 +4,13 @@
 #include "IKState.h"
 #include "MovementState.h"
 #include "IKMovementState.h"
+#include "LoadingState.h"
 #include "game.h"
 
 Game::Game()
    : mFSM()
    , mWindow()
+   , mAssetLoader()
 #ifndef USE_THIRD_PERSON_CAMERA
    , mCamera()
 #endif
@@ -52,35 +54,87 @@ bool Game::initialize(const std::string& title)
    // Create the FSM
    mFSM = std::make_shared<FiniteStateMachine>();
 
-   // Initialize the states
-   std::unordered_map<std::string, std::shared_ptr<State>> mStates;
+   // Create the asset loader, which loads assets on as many worker threads as there are cores, minus the one that runs the main thread
+   unsigned int numCores = std::thread::hardware_concurrency();
+   mAssetLoader = std::make_shared<AssetLoader>((numCores > 1) ? numCores - 1 : 1);
+
+   // Request the assets that take the longest to load so that the worker threads can start loading them right away
+   // The states request them again when they are created, at which point they are ready
+   mAssetLoader->LoadCharacter("resources/models/woman/woman.glb", "resources/models/woman/woman.bake");
+   std::vector<std::string> images { "resources/models/woman/woman.png",
+                                     "resources/models/table/wooden_floor.jpg",
+                                     "resources/models/ground/platform.png",
+                                     "resources/models/ground/catwalk_uv.png",
+                                     "resources/models/ground/grass.png",
+                                     "resources/models/ground/lights.png",
+                                     "resources/models/water/dudv.png",
+                                     "resources/models/water/normal.png",
+                                     "resources/models/sky/px.png",
+                                     "resources/models/sky/nx.png",
+                                     "resources/models/sky/py.png",
+                                     "resources/models/sky/ny.png",
+                                     "resources/models/sky/pz.png",
+                                     "resources/models/sky/nz.png" };
+   for (const std::string& image : images)
+   {
+      mAssetLoader->LoadImage(image);
+   }
+
+   // Describe how to create the states, which is done by the loading state over several frames
+   std::vector<std::pair<std::string, LoadingState::StateFactory>> stateFactories;
 
+   stateFactories.emplace_back("viewer", [this]()
+   {
 #ifdef USE_THIRD_PERSON_CAMERA
-   mStates["viewer"] = std::make_shared<ModelViewerState>(mFSM,
-                                                          mWindow);
+      return std::make_shared<ModelViewerState>(mFSM,
+                                                mWindow,
+                                                mAssetLoader);
 #else
-   mStates["viewer"] = std::make_shared<ModelViewerState>(mFSM,
-                                                          mWindow,
-                                                          mCamera);
+      return std::make_shared<ModelViewerState>(mFSM,
+                                                mWindow,
+                                                mAssetLoader,
+                                                mCamera);
 #endif
+   });
 
-   mStates["movement"] = std::make_shared<MovementState>(mFSM,
-                                                         mWindow);
+   stateFactories.emplace_back("movement", [this]()
+   {
+      return std::make_shared<MovementState>(mFSM,
+                                             mWindow,
+                                             mAssetLoader);
+   });
 
+   stateFactories.emplace_back("ik", [this]()
+   {
 #ifdef USE_THIRD_PERSON_CAMERA
-   mStates["ik"] = std::make_shared<IKState>(mFSM,
-                                             mWindow);
+      return std::make_shared<IKState>(mFSM,
+                                       mWindow,
+                                       mAssetLoader);
 #else
-   mStates["ik"] = std::make_shared<IKState>(mFSM,
-                                             mWindow,
-                                             mCamera);
+      return std::make_shared<IKState>(mFSM,
+                                       mWindow,
+                                       mAssetLoader,
+                                       mCamera);
 #endif
+   });
+
+   stateFactories.emplace_back("ik_movement", [this]()
+   {
+      return std::make_shared<IKMovementState>(mFSM,
+                                               mWindow,
+                                               mAssetLoader);
+   });
+
+   // Initialize the FSM with the loading state, which creates the other states and then switches to the initial one
+   std::unordered_map<std::string, std::shared_ptr<State>> mStates;
 
-   mStates["ik_movement"] = std::make_shared<IKMovementState>(mFSM,
-                                                              mWindow);
+   mStates["loading"] = std::make_shared<LoadingState>(mFSM,
+                                                       mWindow,
+                                                       mAssetLoader,
+                                                       std::move(stateFactories),
+                                                       "ik_movement");
 
-   // Initialize the FSM
-   mFSM->initialize(std::move(mStates), "ik_movement");
+   mFSM->initialize(std::move(mStates), "loading");
 
    return true;
 }
@@ -1,10 +1,15 @@
 #include <iostream>
+#include <string>
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten/emscripten.h>
 #endif
 
 #include "game.h"
+#include "BakedAsset.h"
+#include "GLTFLoader.h"
+#include "BakedTexture.h"
+#include "Benchmarks.h"
 
 #ifdef __EMSCRIPTEN__
 Game game;
@@ -33,8 +38,56 @@ int runKey;
 std::string runInstruction;
 #endif
 
-int main()
+int main(int argc, char* argv[])
 {
+#ifndef __EMSCRIPTEN__
+   // The native builds double as the asset baker and the glTF to GLB converter, which don't need a window:
+   // Animation-Experiments --bake resources/models/woman/woman.glb resources/models/woman/woman.bake
+   // Animation-Experiments --glb model.gltf model.glb
+   // Animation-Experiments --bake-texture resources/models/platform/grass.png resources/models/platform/grass.tex [--linear] [--compress]
+   // They also run the benchmarks, which don't need a window either (see Benchmarks.h):
+   // Animation-Experiments --benchmark
+   if (argc == 4 && std::string(argv[1]) == "--bake")
+   {
+      return BakeCharacterAsset(argv[2], argv[3]) ? 0 : -1;
+   }
+
+   if (argc == 2 && std::string(argv[1]) == "--benchmark")
+   {
+      return RunBenchmarks() ? 0 : -1;
+   }
+
+   if (argc == 4 && std::string(argv[1]) == "--glb")
+   {
+      return ConvertGLTFFileToGLB(argv[2], argv[3]) ? 0 : -1;
+   }
+
+   if (argc >= 4 && std::string(argv[1]) == "--bake-texture")
+   {
+      bool linear   = false;
+      bool compress = false;
+      for (int argIndex = 4; argIndex < argc; ++argIndex)
+      {
+         std::string option = argv[argIndex];
+         if (option == "--linear")
+         {
+            linear = true;
+         }
+         else if (option == "--compress")
+         {
+            compress = true;
+         }
+         else
+         {
+            std::cout << "Texture baker - Unknown option: " << option << '\n';
+            return -1;
+         }
+      }
+
+      return BakeTexture(argv[2], argv[3], linear, compress) ? 0 : -1;
+   }
+#endif
+
 #ifdef __EMSCRIPTEN__
    if (runningOnFirefox())
    {
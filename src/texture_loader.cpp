@@ -1,8 +1,34 @@
 #include <stb_image/stb_image.h>
 
+#include <cstring>
 #include <iostream>
 
 #include "texture_loader.h"
+#include "BakedTexture.h"
+
+DecodedImage::DecodedImage(unsigned char* pixels, int width, int height, int numComponents)
+   : pixels(pixels, stbi_image_free)
+   , bakedFile()
+   , width(width)
+   , height(height)
+   , numComponents(numComponents)
+   , compressedFormat(0)
+   , mipLevels(1, MipLevel{width, height, pixels, static_cast<size_t>(width) * height * numComponents})
+{
+
+}
+
+DecodedImage::DecodedImage(const std::shared_ptr<const MappedFile>& bakedFile, int numComponents, unsigned int compressedFormat, std::vector<MipLevel>&& mipLevels)
+   : pixels(nullptr, stbi_image_free)
+   , bakedFile(bakedFile)
+   , width(mipLevels[0].width)
+   , height(mipLevels[0].height)
+   , numComponents(numComponents)
+   , compressedFormat(compressedFormat)
+   , mipLevels(std::move(mipLevels))
+{
+
+}
 
 std::shared_ptr<Texture> TextureLoader::loadResource(const std::string& texFilePath,
                                                      unsigned int       wrapS,
@@ -11,32 +37,52 @@ std::shared_ptr<Texture> TextureLoader::loadResource(const std::string& texFileP
                                                      unsigned int       magFilter,
                                                      bool               genMipmap) const
 {
-   int width, height, numComponents;
-   std::unique_ptr<unsigned char, void(*)(void*)> texData(stbi_load(texFilePath.c_str(), &width, &height, &numComponents, 0), stbi_image_free);
+   return loadResource(decodeImage(texFilePath), wrapS, wrapT, minFilter, magFilter, genMipmap);
+}
 
-   if (!texData)
+std::shared_ptr<Texture> TextureLoader::loadResource(const std::shared_ptr<const DecodedImage>& image,
+                                                     unsigned int                               wrapS,
+                                                     unsigned int                               wrapT,
+                                                     unsigned int                               minFilter,
+                                                     unsigned int                               magFilter,
+                                                     bool                                       genMipmap) const
+{
+   // We expect decodeImage to print an error message when it's unable to decode an image, which is why we don't print anything here
+   if (!image)
    {
-      std::cout << "Error - TextureLoader::loadResource - The following texture could not be loaded: " << texFilePath << "\n";
       return nullptr;
    }
 
-   unsigned int texID = generateTexture(texData, width, height, numComponents, wrapS, wrapT, minFilter, magFilter, genMipmap);
+   unsigned int texID = generateTexture(*image, wrapS, wrapT, minFilter, magFilter, genMipmap);
 
    return std::make_shared<Texture>(texID);
 }
 
-unsigned int TextureLoader::generateTexture(const std::unique_ptr<unsigned char, void(*)(void*)>& texData,
-                                            int          width,
-                                            int          height,
-                                            int          numComponents,
-                                            unsigned int wrapS,
-                                            unsigned int wrapT,
-                                            unsigned int minFilter,
-                                            unsigned int magFilter,
-                                            bool         genMipmap) const
+std::shared_ptr<DecodedImage> TextureLoader::decodeImage(const std::string& texFilePath)
+{
+   // Baked textures don't need to be decoded, so they are preferred over the images that they were baked from
+   std::shared_ptr<DecodedImage> bakedImage = LoadBakedTexture(GetBakedTexturePath(texFilePath));
+   if (bakedImage)
+   {
+      return bakedImage;
+   }
+
+   int width, height, numComponents;
+   unsigned char* texData = stbi_load(texFilePath.c_str(), &width, &height, &numComponents, 0);
+
+   if (!texData)
+   {
+      std::cout << "Error - TextureLoader::decodeImage - The following texture could not be loaded: " << texFilePath << "\n";
+      return nullptr;
+   }
+
+   return std::make_shared<DecodedImage>(texData, width, height, numComponents);
+}
+
+unsigned int TextureLoader::uploadImage(unsigned int target, const DecodedImage& image, bool uploadAllMipLevels)
 {
    GLenum format;
-   switch (numComponents)
+   switch (image.numComponents)
    {
    case 3:
       format = GL_RGB;
@@ -45,17 +91,87 @@ unsigned int TextureLoader::generateTexture(const std::unique_ptr<unsigned char,
       format = GL_RGBA;
       break;
    default:
-      std::cout << "Error - TextureLoader::generateTexture - The texture has an invalid number of components: " << numComponents << "\n";
+      std::cout << "Error - TextureLoader::uploadImage - The texture has an invalid number of components: " << image.numComponents << "\n";
+      return 0;
+   }
+
+   // The rows of the smaller mip levels of a baked texture are not aligned to 4 bytes, which is what OpenGL expects by default
+   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+   // The GPUs that don't support block compression receive the compressed levels decompressed
+   bool decompress = (image.compressedFormat != 0) && !supportsBlockCompression();
+
+   unsigned int numMipLevels = uploadAllMipLevels ? static_cast<unsigned int>(image.mipLevels.size()) : 1;
+   for (unsigned int level = 0; level < numMipLevels; ++level)
+   {
+      const DecodedImage::MipLevel& mipLevel = image.mipLevels[level];
+      if (image.compressedFormat == 0)
+      {
+         glTexImage2D(target, level, format, mipLevel.width, mipLevel.height, 0, format, GL_UNSIGNED_BYTE, mipLevel.data);
+      }
+      else if (!decompress)
+      {
+         glCompressedTexImage2D(target, level, image.compressedFormat, mipLevel.width, mipLevel.height, 0, static_cast<GLsizei>(mipLevel.size), mipLevel.data);
+      }
+      else
+      {
+         std::vector<unsigned char> pixels = DecompressMipLevel(mipLevel, image.compressedFormat);
+         glTexImage2D(target, level, GL_RGBA, mipLevel.width, mipLevel.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+      }
    }
 
+   glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+   return numMipLevels;
+}
+
+bool TextureLoader::supportsBlockCompression()
+{
+   // The BC1 and BC3 formats are exposed by the EXT_texture_compression_s3tc extension in OpenGL
+   // and by the WEBGL_compressed_texture_s3tc extension in WebGL, which Emscripten reports with a "GL_" prefix
+   static bool supported = []()
+   {
+      int numExtensions = 0;
+      glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+      for (int extensionIndex = 0; extensionIndex < numExtensions; ++extensionIndex)
+      {
+         const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, extensionIndex));
+         if (extension != nullptr && (strstr(extension, "texture_compression_s3tc") != nullptr || strstr(extension, "compressed_texture_s3tc") != nullptr))
+         {
+            return true;
+         }
+      }
+
+      return false;
+   }();
+
+   return supported;
+}
+
+unsigned int TextureLoader::generateTexture(const DecodedImage& image,
+                                            unsigned int        wrapS,
+                                            unsigned int        wrapT,
+                                            unsigned int        minFilter,
+                                            unsigned int        magFilter,
+                                            bool                genMipmap) const
+{
    unsigned int texID;
    glGenTextures(1, &texID);
    glBindTexture(GL_TEXTURE_2D, texID);
-   glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, texData.get());
+
+   unsigned int numMipLevels = uploadImage(GL_TEXTURE_2D, image, genMipmap);
 
    if (genMipmap)
    {
-      glGenerateMipmap(GL_TEXTURE_2D);
+      // Baked textures already contain all their mip levels
+      if (image.bakedFile)
+      {
+         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (numMipLevels > 0) ? (numMipLevels - 1) : 0);
+      }
+      else
+      {
+         glGenerateMipmap(GL_TEXTURE_2D);
+      }
    }
 
    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapS);